@@ -17,6 +17,7 @@
 #include <time.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 #include "../../iodevices/unix_terminal.h"
 #include "../../frontpanel/frontpanel.h"
 
@@ -182,6 +183,10 @@ void run_cpu(void)
 		printf("\r\nUser Interrupt at %04x\r\n",
 		       (unsigned int)(PC - ram));
 		break;
+	case INTERROR:
+		printf("\r\nInterrupt op-code not implemented at %04x\r\n",
+		       (unsigned int)(PC - ram));
+		break;
 	case POWEROFF:
 		break;
 	default:
@@ -232,6 +237,10 @@ void step_cpu(void)
 		printf("\r\nUser Interrupt at %04x\r\n",
 		       (unsigned int)(PC - ram));
 		break;
+	case INTERROR:
+		printf("\r\nInterrupt op-code not implemented at %04x\r\n",
+		       (unsigned int)(PC - ram));
+		break;
 	case POWEROFF:
 		break;
 	default:
@@ -355,12 +364,14 @@ void deposit_clicked(int state, int val)
 
 	switch (state) {
 	case FP_SW_UP:
-		fp_led_data = *PC = address_switch & 0xff;
+		memwrt(PC - ram, address_switch & 0xff);
+		fp_led_data = *PC;
 		break;
 	case FP_SW_DOWN:
 		PC++;
 		fp_led_address++;
-		fp_led_data = *PC = address_switch & 0xff;
+		memwrt(PC - ram, address_switch & 0xff);
+		fp_led_data = *PC;
 		break;
 	default:
 		break;
@@ -380,9 +391,16 @@ void protect_clicked(int state, int val)
 
 	switch (state) {
 	case FP_SW_UP:
+#ifdef WANT_MMIO
+		/* write protect the 4KB memory board addressed */
+		mm_rom((PC - ram) & 0xf000, 4096);
+#endif
 		mem_wp = 1;
 		break;
 	case FP_SW_DOWN:
+#ifdef WANT_MMIO
+		mm_ram((PC - ram) & 0xf000, 4096);
+#endif
 		mem_wp = 0;
 		break;
 	default:
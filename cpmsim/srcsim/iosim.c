@@ -64,9 +64,12 @@
  *
  *	17 - FDC sector high
  *
+ *	19 - MMU status, initialization of n + 1 banks
  *	20 - MMU initialization
  *	21 - MMU bank select
  *	22 - MMU select segment size (in pages a 256 bytes)
+ *	23 - MMU select 4KB page of the segment
+ *	24 - MMU bank select for the page
  *
  *	25 - clock command
  *	26 - clock data
@@ -75,6 +78,7 @@
  *	29 - hardware control
  *	30 - CPU speed low
  *	31 - CPU speed high
+ *	32 - CPU speed slip
  *
  *	40 - passive socket #1 status
  *	41 - passive socket #1 data
@@ -89,6 +93,10 @@
  *	51 - client socket #1 data
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* memfd_create() */
+#endif
+
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -100,6 +108,7 @@
 #include <time.h>
 #include <netdb.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -107,10 +116,13 @@
 #include <netinet/in.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #define BUFSIZE 256		/* max line lenght of command buffer */
 #define MAX_BUSY_COUNT 10	/* max counter to detect I/O busy waiting
 				   on the console status port */
+#define INT_TIMER 0		/* timer is the first device in the
+				   interrupt daisy chain */
 
 extern int boot(void);
 
@@ -156,6 +168,7 @@ static int drivep;		/* fd for file "drivep.cpm" */
 static int printer;		/* fd for file "printer.cpm" */
 static char last_char;		/* buffer for 1 character (console status) */
 static int speed;		/* to reset CPU speed */
+static int speed_in;		/* latched achieved CPU speed */
 
 #ifdef PIPES
 static int auxin;		/* fd for pipe "auxin" */
@@ -225,13 +238,51 @@ static struct dskdef disks[16] = {
  * The segment size now can be configured via port 22.
  * If the segment size isn't configured the default is 48KB as it was
  * before, to maintain compatibility.
- */
-#define MAXSEG 16		/* max. number of memory banks */
+ *
+ * Up to 255 banks can be initialized via port 20, port 19 initializes
+ * data + 1 banks, so that 256 banks are possible. The segment is
+ * divided into pages of 4KB, port 21 shows a bank in all pages of
+ * the segment, ports 23 and 24 show a bank in one page only.
+ *
+ * The banks are one file in the host memory, whose pages are only
+ * allocated when they are written. The 4KB pages of the segment
+ * are mapped from this file into the memory of the CPU, so that
+ * a bank switch only changes the page table of the host and
+ * nothing is copied. A last page of the segment smaller than 4KB,
+ * or all pages on hosts with pages larger than 4KB, are copied
+ * out and in on a switch.
+ */
+#define MAXSEG 256		/* max. number of memory banks */
 #define SEGSIZ 49152		/* default size of one bank = 48KBytes */
+#define MMU_PAGE 4096		/* banks are switched in pages of 4KB */
+#define MMU_NPG (65536 / MMU_PAGE) /* max. number of pages of a segment */
 static char *mmu[MAXSEG];	/* MMU with pointers to the banks */
-static int selbnk;		/* current bank */
+static int selbnk;		/* bank selected with port 21 */
 static int maxbnk;		/* number of initialized banks */
 static int segsize;		/* segment size of one bank, default 48KB */
+static BYTE mmu_pg[MMU_NPG];	/* bank shown in the pages of the segment */
+static int mmu_sel;		/* page selected with port 23 */
+static int mmu_fd = -1;		/* file with the banks */
+static char *mmu_all;		/* mapping of the file, mmu[] points into it */
+static size_t mmu_len;		/* size of the file */
+static size_t mmu_stride;	/* size of one bank in the file */
+static int mmu_mapped;		/* bytes of the segment mapped from the file */
+
+#ifdef WANT_SNAP
+/*
+ *	State of the devices in a snapshot, see io_snap()
+ */
+struct iostate {
+	BYTE	drive, track;		/* FDC */
+	int	sector;
+	BYTE	status;
+	BYTE	dmadl, dmadh;		/* DMA address */
+	BYTE	clkcmd, clkfmt;		/* clock */
+	BYTE	timer;			/* 10ms timer running */
+	BYTE	mmu_pg[MMU_NPG];	/* MMU banks shown in the pages */
+	BYTE	mmu_sel;		/* and the page selected */
+};
+#endif
 
 /*
  *	Forward declaration of the I/O handlers for all used ports
@@ -248,25 +299,31 @@ static BYTE fdco_in(void), fdco_out(BYTE);
 static BYTE fdcx_in(void), fdcx_out(BYTE);
 static BYTE dmal_in(void), dmal_out(BYTE);
 static BYTE dmah_in(void), dmah_out(BYTE);
+static BYTE mmux_in(void), mmux_out(BYTE);
 static BYTE mmui_in(void), mmui_out(BYTE), mmus_in(void), mmus_out(BYTE);
 static BYTE mmuc_in(void), mmuc_out(BYTE);
+static BYTE mmup_in(void), mmup_out(BYTE), mmub_in(void), mmub_out(BYTE);
 static BYTE clkc_in(void), clkc_out(BYTE), clkd_in(void), clkd_out(BYTE);
 static BYTE time_in(void), time_out(BYTE);
 static BYTE delay_in(void), delay_out(BYTE);
 static BYTE hwctl_in(void), hwctl_out(BYTE);
 static BYTE speedl_in(void), speedl_out(BYTE);
 static BYTE speedh_in(void), speedh_out(BYTE);
+static BYTE slip_in(void), slip_out(BYTE);
 static BYTE cond1_in(void), cond1_out(BYTE), cons1_in(void), cons1_out(BYTE);
 static BYTE cond2_in(void), cond2_out(BYTE), cons2_in(void), cons2_out(BYTE);
 static BYTE cond3_in(void), cond3_out(BYTE), cons3_in(void), cons3_out(BYTE);
 static BYTE cond4_in(void), cond4_out(BYTE), cons4_in(void), cons4_out(BYTE);
 static BYTE netd1_in(void), netd1_out(BYTE), nets1_in(void), nets1_out(BYTE);
+static int cond_blk_out(BYTE *, int);
 
 /*
  *	Forward declaration of support functions
  */
 static int to_bcd(int), get_date(struct tm *);
 static void int_timer(int);
+static int mmu_map(int);
+static void mmu_init(int), mmu_free(void), mmu_show(int, int, int);
 
 #ifdef NETWORKING
 static void net_server_config(void), net_client_config(void);
@@ -300,12 +357,12 @@ static BYTE (*port[256][2]) () = {
 	{ dmah_in, dmah_out },		/* port 16 */
 	{ fdcsh_in, fdcsh_out },	/* port 17 */
 	{ io_trap, io_trap  },		/* port 18 */
-	{ io_trap, io_trap  },		/* port 19 */
+	{ mmux_in, mmux_out },		/* port 19 */
 	{ mmui_in, mmui_out },		/* port 20 */
 	{ mmus_in, mmus_out },		/* port 21 */
 	{ mmuc_in, mmuc_out },		/* port 22 */
-	{ io_trap, io_trap  },		/* port 23 */
-	{ io_trap, io_trap  },		/* port 24 */
+	{ mmup_in, mmup_out },		/* port 23 */
+	{ mmub_in, mmub_out },		/* port 24 */
 	{ clkc_in, clkc_out },		/* port 25 */
 	{ clkd_in, clkd_out },		/* port 26 */
 	{ time_in, time_out },		/* port 27 */
@@ -313,7 +370,7 @@ static BYTE (*port[256][2]) () = {
 	{ hwctl_in, hwctl_out  },	/* port 29 */
 	{ speedl_in, speedl_out  },	/* port 30 */
 	{ speedh_in, speedh_out  },	/* port 31 */
-	{ io_trap, io_trap  },		/* port 32 */
+	{ slip_in, slip_out  },		/* port 32 */
 	{ io_trap, io_trap  },		/* port 33 */
 	{ io_trap, io_trap  },		/* port 34 */
 	{ io_trap, io_trap  },		/* port 35 */
@@ -539,6 +596,16 @@ static BYTE (*port[256][2]) () = {
 	{ io_trap, io_trap }		/* port	255 */
 };
 
+/*
+ *	This array contains the function pointers of the ports, which
+ *	can transfer a block of bytes for INIR/OTIR etc. at once, NULL
+ *	for all others. The first entry is input, the second output.
+ */
+static int (*port_blk[256][2]) (BYTE *, int) = {
+	{ NULL, NULL },			/* port 0 */
+	{ NULL, cond_blk_out }		/* port 1 */
+};
+
 /*
  *	This function initializes the I/O handlers:
  *	1. Initialize the MMU with NULL pointers and defaults.
@@ -767,22 +834,16 @@ void exit_io(void)
  */
 void reset_system(void)
 {
-	register int i;
-
 	/* reset hardware */
 	time_out(0);			/* stop timer */
-	for (i = 0; i < MAXSEG; i++) {	/* reset MMU */
-		if (mmu[i] != NULL) {
-			free(mmu[i]);
-			mmu[i] = NULL;
-		}
-	}
+	mmu_free();			/* reset MMU */
 	selbnk = 0;
 	segsize = SEGSIZ;
 
 	/* reset CPU */
 	IFF = 0;			/* disable interrupts */
 	int_mode = 0;			/* reset interrupt mode */
+	int_reset();			/* remove interrupt requests */
 	wrk_ram	= PC = ram;		/* PC = 0 */
 	STACK = ram + 0xffff;		/* SP = FFFF */
 
@@ -790,6 +851,96 @@ void reset_system(void)
 	boot();
 }
 
+#ifdef WANT_SNAP
+/*
+ *	This function saves (restore == 0) or restores the state
+ *	of the devices and the MMU for a snapshot, see simsnp.c.
+ *	On save the copied pages of the segment are written back
+ *	into their banks and the modified pages of the segment are
+ *	assigned to the banks shown. On restore the banks are
+ *	allocated and shown again, their memory is read from the
+ *	snapshot afterwards. Returns 0, if the MMU state of the
+ *	snapshot is invalid.
+ */
+int io_snap(struct snapio *s, int restore)
+{
+	struct iostate st;
+	register int i, off, len, npg;
+
+	if (!restore) {
+		s->s_nbank = maxbnk;
+		s->s_segsize = segsize;
+		s->s_selbnk = selbnk;
+		st.drive = drive;
+		st.track = track;
+		st.sector = sector;
+		st.status = status;
+		st.dmadl = dmadl;
+		st.dmadh = dmadh;
+		st.clkcmd = clkcmd;
+		st.clkfmt = clkfmt;
+		st.timer = timer;
+		memcpy(st.mmu_pg, mmu_pg, sizeof(mmu_pg));
+		st.mmu_sel = mmu_sel;
+		memcpy(s->s_dev, (char *) &st, sizeof(st));
+		for (off = 0; off < segsize && maxbnk > 0; off += MMU_PAGE) {
+			len = (segsize - off < MMU_PAGE) ? segsize - off
+							 : MMU_PAGE;
+			i = mmu_pg[off / MMU_PAGE];
+			if (off >= mmu_mapped)
+				memcpy(mmu[i] + off, (char *) ram + off, len);
+			sn_bank(i, off >> 8, len >> 8, 0);
+		}
+		return(1);
+	}
+
+	memcpy((char *) &st, s->s_dev, sizeof(st));
+	if (s->s_segsize <= 0 || s->s_segsize > 65536
+	    || (s->s_segsize & 0xff) || s->s_nbank < 0
+	    || s->s_nbank > MAXSEG || s->s_selbnk < 0
+	    || (s->s_nbank > 0 && s->s_selbnk >= s->s_nbank))
+		return(0);
+	npg = (s->s_segsize + MMU_PAGE - 1) / MMU_PAGE;
+	for (i = 0; i < npg && s->s_nbank > 0; i++)
+		if (st.mmu_pg[i] >= s->s_nbank)
+			return(0);
+
+	time_out(0);			/* stop timer */
+	mmu_free();			/* reset MMU */
+	selbnk = 0;
+	segsize = s->s_segsize;
+	if (s->s_nbank > 0) {
+		mmu_init(s->s_nbank);
+		for (i = 0; i < npg; i++)
+			mmu_show(i, 1, st.mmu_pg[i]);
+		selbnk = s->s_selbnk;
+		mmu_sel = st.mmu_sel % MMU_NPG;
+	}
+
+	drive = st.drive;
+	track = st.track;
+	sector = st.sector;
+	status = st.status;
+	dmadl = st.dmadl;
+	dmadh = st.dmadh;
+	clkcmd = st.clkcmd;
+	clkfmt = st.clkfmt;
+	if (st.timer)
+		time_out(1);
+	return(1);
+}
+
+/*
+ *	Memory of bank n for a snapshot, NULL if not allocated
+ */
+BYTE *io_bank(int n)
+{
+	if (n >= maxbnk)
+		return(NULL);
+	return((BYTE *) mmu[n]);
+}
+#endif
+
 /*
  *	This function is called for every IN opcode from the
  *	CPU emulation. It calls the handler for the port,
@@ -797,7 +948,14 @@ void reset_system(void)
  */
 BYTE io_in(BYTE adr)
 {
-	return((*port[adr][0]) ());
+	register BYTE data;
+
+	data = (*port[adr][0]) ();
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_IN, adr, data, 1);
+#endif
+	return(data);
 }
 
 /*
@@ -809,10 +967,50 @@ BYTE io_out(BYTE adr, BYTE data)
 {
 	busy_loop_cnt[0] = 0;
 
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_OUT, adr, data, 1);
+#endif
 	(*port[adr][1]) (data);
 	return((BYTE) 0);
 }
 
+/*
+ *	This function is called for the block I/O opcodes from
+ *	the CPU emulation. It calls the block handler for the port,
+ *	from which n bytes of input are wanted. If the port has
+ *	none, 0 is returned and the bytes are read one by one.
+ */
+int io_blk_in(BYTE adr, BYTE *buf, int n)
+{
+	if (port_blk[adr][0] == NULL || !(*port_blk[adr][0]) (buf, n))
+		return(0);
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_IN, adr, buf[0], n);
+#endif
+	return(1);
+}
+
+/*
+ *	This function is called for the block I/O opcodes from
+ *	the CPU emulation. It calls the block handler for the port,
+ *	to which n bytes of output are wanted. If the port has
+ *	none, 0 is returned and the bytes are written one by one.
+ */
+int io_blk_out(BYTE adr, BYTE *buf, int n)
+{
+	if (port_blk[adr][1] == NULL)
+		return(0);
+	busy_loop_cnt[0] = 0;
+
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_OUT, adr, buf[0], n);
+#endif
+	return((*port_blk[adr][1]) (buf, n));
+}
+
 /*
  *	I/O trap handler
  */
@@ -1466,6 +1664,31 @@ again:
 	return((BYTE) 0);
 }
 
+/*
+ *	I/O handler for write console 0 data block:
+ *	the n bytes are written with one system call
+ */
+static int cond_blk_out(BYTE *buf, int n)
+{
+	register int i, w;
+
+	for (i = 0; i < n; i += w) {
+		if ((w = write(fileno(stdout), (char *) buf + i, n - i))
+		    == -1) {
+			if (errno == EINTR) {
+				w = 0;
+				continue;
+			}
+			perror("write console 0");
+			cpu_error = IOERROR;
+			cpu_state = STOPPED;
+			break;
+		}
+	}
+	fflush(stdout);
+	return(n);
+}
+
 /*
  *	I/O handler for write console 1 data:
  *	the output is written to the socket
@@ -1890,6 +2113,9 @@ static BYTE fdco_out(BYTE data)
 			status = 5;
 		else
 			status = 0;
+#ifdef WANT_SNAP
+		memdty((dmadh << 8) + dmadl, 128);
+#endif
 		break;
 	case 1:			/* write */
 		if (write(*disks[drive].fd, (char *) ram + (dmadh << 8) +
@@ -1963,9 +2189,31 @@ static BYTE dmah_out(BYTE data)
 	return((BYTE) 0);
 }
 
+/*
+ *	I/O handler for read MMU status:
+ *	returns 1 if the banks are initialized, 0 if not
+ */
+static BYTE mmux_in(void)
+{
+	return((BYTE) (mmu_all != NULL));
+}
+
+/*
+ *	I/O handler for write MMU initialization:
+ *	for the FIRST call data + 1 banks are initialized,
+ *	so that 256 banks can be initialized too
+ */
+static BYTE mmux_out(BYTE data)
+{
+	if (mmu_all == NULL)
+		mmu_init(data + 1);
+	return((BYTE) 0);
+}
+
 /*
  *	I/O handler for read MMU initialization:
- *	return number of initialized MMU banks
+ *	return number of initialized MMU banks, 0 for 256,
+ *	see port 19 for the status
  */
 static BYTE mmui_in(void)
 {
@@ -1974,28 +2222,175 @@ static BYTE mmui_in(void)
 
 /*
  *	I/O handler for write MMU initialization:
- *	for the FIRST call the memory for the wanted number of banks
- *	is allocated and pointers to the memory is stored in the MMU array
+ *	for the FIRST call the wanted number of banks is initialized,
+ *	0 does nothing, use port 19 for 256 banks
  */
 static BYTE mmui_out(BYTE data)
+{
+	if (mmu_all == NULL && data > 0)
+		mmu_init(data);
+	return((BYTE) 0);
+}
+
+/*
+ *	Initialize n banks, the contents of the segment becomes
+ *	bank 0, which is shown in the segment
+ */
+static void mmu_init(int n)
 {
 	register int i;
 
-	if (mmu[0] != NULL)
-		return((BYTE) 0);
-	if (data > MAXSEG) {
-		printf("Try to init %d banks, available %d banks\r\n",
-		       data, MAXSEG);
+	if (!mmu_map(n)) {
+		printf("can't allocate memory for %d banks\r\n", n);
 		exit(1);
 	}
-	for (i = 0; i < data; i++) {
-		if ((mmu[i] = malloc(segsize)) == NULL) {
-			printf("can't allocate memory for bank %d\r\n", i+1);
+	for (i = 0; i < n; i++)
+		mmu[i] = mmu_all + i * mmu_stride;
+	maxbnk = n;
+	selbnk = 0;
+	mmu_sel = 0;
+	memset((char *) mmu_pg, 0, sizeof(mmu_pg));
+	memcpy(mmu[0], (char *) ram, segsize);
+	if (mmu_mapped > 0 && mmap((char *) ram, mmu_mapped,
+				   PROT_READ | PROT_WRITE,
+				   MAP_SHARED | MAP_FIXED, mmu_fd, 0)
+			      == MAP_FAILED) {
+		perror("MMU");
+		exit(1);
+	}
+}
+
+/*
+ *	Create the file for n banks and map it, the pages of the
+ *	file are allocated by the host when they are written first.
+ *	The pages of the segment can be mapped from the file too,
+ *	if the host pages aren't larger than the MMU pages.
+ *	Returns 0 if the banks can't be mapped.
+ */
+static int mmu_map(int n)
+{
+	register char *p;
+	register int fd;
+	long pg = sysconf(_SC_PAGESIZE);
+#ifndef __linux__
+	char fn[] = "/tmp/cpmsimXXXXXX";
+#endif
+
+	mmu_stride = (segsize + MMU_PAGE - 1) / MMU_PAGE * MMU_PAGE;
+	mmu_len = (size_t) n * mmu_stride;
+	if (mmu_len == 0)
+		return(0);
+#ifdef __linux__
+	fd = memfd_create("cpmsim", 0);
+#else
+	if ((fd = mkstemp(fn)) != -1)
+		unlink(fn);
+#endif
+	if (fd == -1)
+		return(0);
+	if (ftruncate(fd, mmu_len) == -1
+	    || (p = mmap(NULL, mmu_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+			 fd, 0)) == MAP_FAILED) {
+		close(fd);
+		return(0);
+	}
+	mmu_fd = fd;
+	mmu_all = p;
+	mmu_mapped = 0;
+#ifndef WANT_MIRROR
+	if (pg > 0 && pg <= MMU_PAGE && MMU_PAGE % pg == 0
+	    && ((unsigned long) ram % MMU_PAGE) == 0)
+		mmu_mapped = segsize / MMU_PAGE * MMU_PAGE;
+#endif
+	return(1);
+}
+
+/*
+ *	Release the banks, the segment keeps the contents shown
+ *	in its own memory
+ */
+static void mmu_free(void)
+{
+	register int i;
+
+	if (mmu_all != NULL) {
+		if (mmu_mapped > 0) {
+			if (mmap((char *) ram, mmu_mapped,
+				 PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+				 -1, 0) == MAP_FAILED) {
+				perror("MMU");
+				exit(1);
+			}
+			for (i = 0; i < mmu_mapped; i += MMU_PAGE)
+				memcpy((char *) ram + i,
+				       mmu[mmu_pg[i / MMU_PAGE]] + i, MMU_PAGE);
+		}
+		munmap(mmu_all, mmu_len);
+		close(mmu_fd);
+		mmu_all = NULL;
+		mmu_fd = -1;
+		mmu_mapped = 0;
+	}
+	for (i = 0; i < MAXSEG; i++)
+		mmu[i] = NULL;
+	maxbnk = 0;
+	mmu_sel = 0;
+	memset((char *) mmu_pg, 0, sizeof(mmu_pg));
+}
+
+/*
+ *	Show bank b in the MMU pages p to p + n - 1 of the segment.
+ *	The pages inside of mmu_mapped are mapped from the file,
+ *	consecutive pages with one mmap(), so that a switch only
+ *	changes the page table of the host. The other pages are
+ *	copied out into their bank and in from bank b.
+ */
+static void mmu_show(int p, int n, int b)
+{
+	register int i, j, off, len;
+
+	for (i = p; i < p + n; i = j) {
+		if (mmu_pg[i] == b) {
+			j = i + 1;
+			continue;
+		}
+		for (j = i; j < p + n && mmu_pg[j] != b; j++) {
+			off = j * MMU_PAGE;
+			len = (segsize - off < MMU_PAGE) ? segsize - off
+							 : MMU_PAGE;
+#ifdef WANT_SNAP
+			sn_bank(mmu_pg[j], off >> 8, len >> 8, 1);
+#endif
+			if (off + len > mmu_mapped) {
+				memcpy(mmu[mmu_pg[j]] + off, (char *) ram + off,
+				       len);
+				memcpy((char *) ram + off, mmu[b] + off, len);
+			}
+			mmu_pg[j] = b;
+		}
+		off = i * MMU_PAGE;
+		len = ((j * MMU_PAGE < mmu_mapped) ? j * MMU_PAGE : mmu_mapped)
+		      - off;
+		if (len > 0 && mmap((char *) ram + off, len,
+				    PROT_READ | PROT_WRITE,
+				    MAP_SHARED | MAP_FIXED, mmu_fd,
+				    b * mmu_stride + off) == MAP_FAILED) {
+			perror("MMU");
 			exit(1);
 		}
 	}
-	maxbnk = data;
-	return((BYTE) 0);
+}
+
+/*
+ *	Check that bank b can be selected, stops the simulation if not
+ */
+static void mmu_check(int b)
+{
+	if (b >= maxbnk) {
+		printf("Try to select unallocated bank %d\r\n", b);
+		exit(1);
+	}
 }
 
 /*
@@ -2009,26 +2404,67 @@ static BYTE mmus_in(void)
 
 /*
  *	I/O handler for write MMU bank select:
- *	if the current selected bank is not equal the wanted bank,
- *	the current bank is saved. Then the memory of the wanted
- *	bank is copied into the CPU address space and this bank is
- *	set to be the current one now.
+ *	the wanted bank is shown in all pages of the segment
+ *	and set to be the current one now
  */
 static BYTE mmus_out(BYTE data)
 {
-	if (data == selbnk)
-		return((BYTE) 0);
-	if (data > maxbnk) {
-		printf("Try to select unallocated bank %d\r\n", data);
-		exit(1);
-	}
+	if (maxbnk == 0 && data == 0)
+		return((BYTE) 0);	/* no banks, bank 0 is the memory */
+	mmu_check(data);
 	//printf("SIM: memory select bank %d from %d\r\n", data, PC-ram);
-	memcpy(mmu[selbnk], (char *) ram, segsize);
-	memcpy((char *) ram, mmu[data], segsize);
+	mmu_show(0, (segsize + MMU_PAGE - 1) / MMU_PAGE, data);
 	selbnk = data;
 	return((BYTE) 0);
 }
 
+/*
+ *	I/O handler for read MMU page select:
+ *	return the 4KB page of the segment selected for port 24
+ */
+static BYTE mmup_in(void)
+{
+	return((BYTE) mmu_sel);
+}
+
+/*
+ *	I/O handler for write MMU page select:
+ *	select a 4KB page of the segment for port 24
+ */
+static BYTE mmup_out(BYTE data)
+{
+	mmu_sel = data % MMU_NPG;
+	return((BYTE) 0);
+}
+
+/*
+ *	I/O handler for read MMU page bank:
+ *	return the bank shown in the page selected with port 23
+ */
+static BYTE mmub_in(void)
+{
+	return((BYTE) mmu_pg[mmu_sel]);
+}
+
+/*
+ *	I/O handler for write MMU page bank:
+ *	show the wanted bank in the page selected with port 23,
+ *	the other pages of the segment are unchanged
+ */
+static BYTE mmub_out(BYTE data)
+{
+	if (mmu_sel * MMU_PAGE >= segsize) {
+		printf("Try to select bank for page %d outside of segment\r\n",
+		       mmu_sel);
+		exit(1);
+	}
+	if (maxbnk == 0 && data == 0)
+		return((BYTE) 0);
+	mmu_check(data);
+	mmu_show(mmu_sel, 1, data);
+	return((BYTE) 0);
+}
+
 /*
  *	I/O handler for read MMU segment size configuration:
  *	returns size of the bank segments in pages a 256 bytes
@@ -2045,7 +2481,7 @@ static BYTE mmuc_in(void)
  */
 static BYTE mmuc_out(BYTE data)
 {
-	if (mmu[0] != NULL) {
+	if (mmu_all != NULL) {
 		printf("Not possible to resize already allocated segments\r\n");
 		exit(1);
 	}
@@ -2300,10 +2736,13 @@ static BYTE speedl_out(BYTE data)
 
 /*
  *	I/O handler for read CPU speed low
+ *	returns the CPU speed in MHz achieved by the speed adjustment,
+ *	0 if the speed isn't limited, the high byte is latched
  */
 static BYTE speedl_in(void)
 {
-	return(f_flag & 0xff);
+	speed_in = (ev_khz() + 500) / 1000;
+	return(speed_in & 0xff);
 }
 
 /*
@@ -2312,8 +2751,8 @@ static BYTE speedl_in(void)
 static BYTE speedh_out(BYTE data)
 {
 	speed += data << 8;
-	tmax = speed * 10000;
 	f_flag = speed;
+	ev_init();
 	return((BYTE) 0);
 }
 
@@ -2322,7 +2761,33 @@ static BYTE speedh_out(BYTE data)
  */
 static BYTE speedh_in(void)
 {
-	return(f_flag  >> 8);
+	return(speed_in >> 8);
+}
+
+/*
+ *	I/O handler for read CPU speed slip
+ *	returns the time lost by the speed adjustment since
+ *	the last read in 10ms, max. 255
+ */
+static BYTE slip_in(void)
+{
+	static long last;
+	register long slip = ev_slip();
+	register long n;
+
+	if (slip < last)	/* CPU was restarted */
+		last = 0;
+	n = (slip - last) / 10;
+	last += n * 10;
+	return((n > 255) ? 255 : n);
+}
+
+/*
+ *	I/O handler for write CPU speed slip
+ */
+static BYTE slip_out(BYTE data)
+{
+	return((BYTE) 0);
 }
 
 /*
@@ -2330,7 +2795,7 @@ static BYTE speedh_in(void)
  */
 static void int_timer(int sig)
 {
-	int_type = INT_INT;
+	int_request(INT_TIMER, 0xff);
 }
 
 #if defined(NETWORKING) && defined(TCPASYNC)
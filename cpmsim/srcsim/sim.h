@@ -41,6 +41,13 @@
 /*#define SBSIZE  10*/	/* no breakpoints */
 /*#define FRONTPANEL*/	/* no frontpanel emulation */
 /*#define BUS_8080*/	/* no emulation of 8080 bus status */
+/*#define WANT_THREADED*/	/* threaded code dispatch, needs GNU C */
+/*#define WANT_LAZYF*/	/* lazy evaluation of the flags */
+#define WANT_TRACE	/* execution trace into a file, needs pthreads */
+#define WANT_WATCH	/* watchpoints on memory reads and writes */
+#define WANT_SNAP	/* snapshots with dirty pages, needs pthreads */
+/*#define WANT_MIRROR*/	/* memory mapped 3 times, no PC/SP wrap checks */
+/*#define WANT_MMIO*/	/* pages of ROM and memory mapped I/O */
 #define PIPES		/* use named pipes for auxiliary device */
 #define NETWORKING	/* TCP/IP networked serial ports */
 #define NUMSOC	4	/* number of server sockets */
@@ -53,6 +60,17 @@
 #undef TCPASYNC		/* SIGIO on BSD sockets not working */
 #endif
 
+#ifndef __linux__
+#undef WANT_MIRROR	/* needs memfd_create() */
+#endif
+
+#undef WANT_HOST		/* z80sim only, the I/O devices are global */
+
+#ifdef WANT_MIRROR
+#undef WANT_SPC		/* PC and SP wrap around in the mirrors */
+#undef WANT_PCC
+#endif
+
 /*
  *	The following lines of this file should not be modified by user
  */
@@ -60,6 +78,7 @@
 #define RELEASE	"1.17"
 
 #define LENCMD		80		/* length of command buffers etc */
+#define MEM_ALIGN	4096		/* MMU pages are mapped into the memory */
 
 #define	S_FLAG		128		/* bit definitions of CPU flags */
 #define Z_FLAG		64
@@ -93,6 +112,9 @@
 #define	OPTRAP2		5		/* illegal 2 byte op-code trap */
 #define	OPTRAP4		6		/* illegal 4 byte op-code trap */
 #define	USERINT		7		/* user	interrupt */
+#define	BRKPOINT	8		/* breakpoint reached */
+#define	WATCHPT		9		/* watchpoint hit */
+#define	INTERROR	10		/* interrupt op-code not implemented */
 #define POWEROFF	255		/* CPU off, no error */
 
 					/* type of CPU interrupt */
@@ -104,27 +126,90 @@ typedef	unsigned short WORD;		/* 16 bit unsigned */
 typedef	unsigned char  BYTE;		/* 8 bit unsigned */
 
 #ifdef HISIZE
+#define H_REGS		7		/* registers in a history entry */
+#define H_BLOCK		4096		/* size of a block of the history */
+#define H_RAW		256		/* entries buffered uncompressed */
+
 struct history {			/* structure of a history entry */
 	WORD	h_adr;			/* address of execution */
-	WORD	h_af;			/* register AF */
-	WORD	h_bc;			/* register BC */
-	WORD	h_de;			/* register DE */
-	WORD	h_hl;			/* register HL */
-	WORD	h_ix;			/* register IX */
-	WORD	h_iy;			/* register IY */
-	WORD	h_sp;			/* register SP */
+	WORD	h_reg[H_REGS];		/* registers AF, BC, DE, HL, IX, IY, SP */
+};
+
+struct hfind {				/* search in the history */
+	WORD	hf_lo, hf_hi;		/* range of the addresses */
+	int	hf_reg;			/* register to test, -1 none */
+	int	hf_op;			/* test '=', '<' or '>' */
+	WORD	hf_val;			/* value to compare with */
+	int	hf_blk, hf_pos;		/* position in the history */
+	unsigned long long hf_n;	/* number of the entry found */
+	struct history hf_e;		/* entry found */
+};
+#endif
+
+#ifdef WANT_TRACE
+#define TR_RING		65536		/* records in the ring */
+#define TR_CHUNK	4096		/* records published at once */
+#define TR_MAGIC	"Z80TRC2\n"	/* start of a trace file */
+
+#define TR_MEM		1		/* effects of a trace record */
+#define TR_IN		2
+#define TR_OUT		4
+
+struct trace {				/* structure of a trace record */
+	unsigned t_clock;		/* T-states, low 32 bits */
+	WORD	t_pc;			/* address of execution */
+	BYTE	t_op[4];		/* opcode bytes */
+	WORD	t_reg[7];		/* registers AF, BC, DE, HL, IX, IY, SP */
+	WORD	t_madr;			/* first memory address written */
+	WORD	t_mcnt;			/* number of bytes written */
+	BYTE	t_mval;			/* first byte written */
+	BYTE	t_eff;			/* effects TR_MEM, TR_IN, TR_OUT */
+	BYTE	t_port;			/* I/O port */
+	BYTE	t_pval;			/* first byte of I/O data */
+	WORD	t_pcnt;			/* number of bytes transferred */
 };
 #endif
 
 #ifdef SBSIZE
 struct softbreak {			/* structure of a breakpoint */
 	WORD	sb_adr;			/* address of breakpoint */
-	BYTE	sb_oldopc;		/* op-code at address of breakpoint */
 	int	sb_passcount;		/* pass counter of breakpoint */
-	int	sb_pass;		/* no. of pass to break */
+	int	sb_pass;		/* no. of pass to break, 0 = unused */
+	int	sb_reg;			/* register of condition, -1 none */
+	int	sb_op;			/* condition '=', '<' or '>' */
+	WORD	sb_val;			/* value to compare with */
+};
+#endif
+
+#ifdef WANT_WATCH
+#define WP_READ		1		/* accesses watched */
+#define WP_WRITE	2
+
+struct watch {				/* structure of a watchpoint */
+	WORD	wp_lo, wp_hi;		/* range of the addresses watched */
+	int	wp_kind;		/* WP_READ and/or WP_WRITE, 0 = unused */
+	int	wp_val;			/* value to match, -1 any */
 };
 #endif
 
+#ifdef WANT_SNAP
+#define SN_FILE		"core.z80"	/* file of the snapshots */
+#define SN_DEV		256		/* bytes for the state of the devices */
+#define SN_BANKS	256		/* max. number of memory banks */
+
+struct snapio {				/* state of the I/O in a snapshot */
+	int	s_nbank;		/* number of memory banks, 0 none */
+	int	s_segsize;		/* size of the banked segment */
+	int	s_selbnk;		/* bank selected */
+	BYTE	s_dev[SN_DEV];		/* state of the devices */
+};
+#endif
+
+#ifdef WANT_MMIO
+#define MM_RD		1		/* reads of the page diverted */
+#define MM_WR		2		/* writes of the page diverted */
+#endif
+
 #ifndef isxdigit
 #define	isxdigit(c) ((c<='f'&&c>='a')||(c<='F'&&c>='A')||(c<='9'&&c>='0'))
 #endif
@@ -93,6 +93,17 @@ void mon(void)
 	case USERINT:
 		printf("\nUser Interrupt at %04x\n", (unsigned int)(PC - ram));
 		break;
+	case INTERROR:
+		printf("\nInterrupt op-code not implemented at %04x\n",
+		       (unsigned int)(PC - ram));
+		break;
+#ifdef WANT_WATCH
+	case WATCHPT:
+		printf("\nWatchpoint %d hit at %04x, %s %04x=%02x\n", wp_last,
+		       (unsigned int)(PC - ram),
+		       (wp_how == WP_READ) ? "read" : "write", wp_adr, wp_data);
+		break;
+#endif
 	case POWEROFF:
 		break;
 	default:
@@ -132,5 +143,8 @@ int boot(void)
 		return(1);
 	}
 	close(fd);
+#ifdef WANT_SNAP
+	sn_all();
+#endif
 	return(0);
 }
@@ -14,6 +14,7 @@
 #include "sim.h"
 #include "simglb.h"
 #include "../../iodevices/io_config.h"
+#include "../../iodevices/vdm1.h"
 #include "../../iodevices/imsai-sio2.h"
 
 extern WORD address_switch;
@@ -299,16 +300,19 @@ static BYTE (*port[256][2]) () = {
 void init_io(void)
 {
 	io_config();
+	if (vdm1_init()) {		/* VDM-1 video board installed */
+		port[VDM1_STAT][0] = io_no_card;
+		port[VDM1_STAT][1] = vdm1_stat_out;
+	}
 }
 
 /*
  *	This function is to stop the I/O devices. It is
  *	called from the CPU simulation on exit.
- *
- *	Nothing to do here.
  */
 void exit_io(void)
 {
+	vdm1_exit();
 }
 
 /*
@@ -318,7 +322,14 @@ void exit_io(void)
  */
 BYTE io_in(BYTE adr)
 {
-	return((*port[adr][0]) ());
+	register BYTE data;
+
+	data = (*port[adr][0]) ();
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_IN, adr, data, 1);
+#endif
+	return(data);
 }
 
 /*
@@ -328,6 +339,10 @@ BYTE io_in(BYTE adr)
  */
 void io_out(BYTE adr, BYTE data)
 {
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_OUT, adr, data, 1);
+#endif
 	(*port[adr][1])	(data);
 }
 
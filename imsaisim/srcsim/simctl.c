@@ -17,6 +17,7 @@
 #include <time.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 #include "../../iodevices/unix_terminal.h"
 #include "../../frontpanel/frontpanel.h"
 
@@ -180,6 +181,10 @@ void run_cpu(void)
 		printf("\r\nUser Interrupt at %04x\r\n",
 		       (unsigned int)(PC - ram));
 		break;
+	case INTERROR:
+		printf("\r\nInterrupt op-code not implemented at %04x\r\n",
+		       (unsigned int)(PC - ram));
+		break;
 	case POWEROFF:
 		break;
 	default:
@@ -230,6 +235,10 @@ void step_cpu(void)
 		printf("\r\nUser Interrupt at %04x\r\n",
 		       (unsigned int)(PC - ram));
 		break;
+	case INTERROR:
+		printf("\r\nInterrupt op-code not implemented at %04x\r\n",
+		       (unsigned int)(PC - ram));
+		break;
 	case POWEROFF:
 		break;
 	default:
@@ -353,12 +362,14 @@ void deposit_clicked(int state, int val)
 
 	switch (state) {
 	case FP_SW_UP:
-		fp_led_data = *PC = address_switch & 0xff;
+		memwrt(PC - ram, address_switch & 0xff);
+		fp_led_data = *PC;
 		break;
 	case FP_SW_DOWN:
 		PC++;
 		fp_led_address++;
-		fp_led_data = *PC = address_switch & 0xff;
+		memwrt(PC - ram, address_switch & 0xff);
+		fp_led_data = *PC;
 		break;
 	default:
 		break;
@@ -20,6 +20,7 @@
 
 extern int sio_upper_case;	/* SIO boards translate input to upper case */
 extern int sio_strip_parity;	/* SIO boards strip parity from output */
+extern char vdm1_tty[];		/* terminal of the VDM-1 video board */
 
 void io_config(void)
 {
@@ -58,6 +59,13 @@ void io_config(void)
 					printf("iodev.conf: illegal value for %s: %s\n", t1, t2);
 					break;
 				}
+			} else if (!strcmp(t1, "vdm1_tty")) {
+				if (t2 == NULL || *t2 == '\n') {
+					printf("iodev.conf: no terminal for %s\n", t1);
+					continue;
+				}
+				t2[strcspn(t2, "\r\n")] = '\0';
+				strncpy(vdm1_tty, t2, 255);
 			} else {
 				printf("iodev.conf unknown command: %s\n", s);
 			}
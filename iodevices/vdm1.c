@@ -0,0 +1,209 @@
+/*
+ * Z80SIM  -  a Z80-CPU simulator
+ *
+ * Common I/O devices used by various simulated machines
+ *
+ * Copyright (C) 2008 by Udo Munk
+ *
+ * Emulation of a Processor Technology VDM-1 S100 video board
+ *
+ * The board displays its 1KB memory at CC00 as 16 lines of
+ * 64 characters, a character with bit 7 set is shown inverse
+ * (cursor). Output to the status port selects the first line
+ * of the memory shown at the top of the screen (bits 0-3) and
+ * the number of lines blanked from the top (bits 4-7).
+ *
+ * The screen is mirrored with ANSI sequences onto the terminal
+ * configured with vdm1_tty in conf/iodev.conf. The memory of
+ * the board is a memory mapped I/O page, its write handler
+ * marks the characters modified in a dirty bitmap with one
+ * 64 bit word per line. A thread draws only the characters
+ * marked every frame, so an idle screen costs nothing.
+ *
+ * History:
+ * 17-OCT-26 first version of the VDM-1 emulation
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include "sim.h"
+#include "simglb.h"
+#include "vdm1.h"
+
+#define VDM_ADR		0xcc00	/* address of the video memory */
+#define VDM_LINES	16	/* lines of the screen */
+#define VDM_COLS	64	/* characters of a line */
+#define VDM_FRAME	33	/* ms between the frames, 30 Hz */
+
+char vdm1_tty[256];		/* terminal for the screen, none if empty */
+
+#ifdef WANT_MMIO
+
+static BYTE *vdm_mem;		/* the video memory in ram[] */
+static unsigned long long vdm_dirty[VDM_LINES]; /* characters modified */
+static BYTE vdm_stat;		/* status port */
+static int vdm_fd = -1;		/* the terminal */
+static int vdm_done;		/* thread has to stop */
+static pthread_t vdm_thread;
+
+/*
+ *	Write handler of the video memory: store the character
+ *	and mark it modified. The character is stored before it
+ *	is marked, so that the thread can't miss it.
+ */
+static int vdm1_write(WORD adr, BYTE data)
+{
+	register int i = adr - VDM_ADR;
+
+	if (*(vdm_mem + i) != data) {
+		*(vdm_mem + i) = data;
+		__atomic_or_fetch(&vdm_dirty[i >> 6], 1ULL << (i & 63),
+				  __ATOMIC_RELEASE);
+	}
+	return(0);
+}
+
+/*
+ *	Draw the characters modified since the last frame with
+ *	the status stat, the whole screen if all is set
+ */
+static void vdm1_draw(int all, BYTE stat)
+{
+	static char buf[VDM_LINES * VDM_COLS * 16];
+	register char *p = buf;
+	register int c, l, s;
+	register unsigned long long d;
+	int next, inv = 0, first, blank;
+	BYTE ch;
+
+	first = stat & 0x0f;
+	blank = stat >> 4;
+	if (all)
+		p += sprintf(p, "\033[m\033[H\033[2J");
+	for (l = 0; l < VDM_LINES; l++) {
+		d = __atomic_exchange_n(&vdm_dirty[l], 0, __ATOMIC_ACQUIRE);
+		if (all)
+			d = ~0ULL;
+		s = (l - first) & (VDM_LINES - 1);	/* line of the screen */
+		if (!d || s < blank)
+			continue;
+		for (c = 0, next = -1; c < VDM_COLS; c++) {
+			if (!(d & (1ULL << c)))
+				continue;
+			if (c != next)		/* not behind the last one */
+				p += sprintf(p, "\033[%d;%dH", s + 1, c + 1);
+			next = c + 1;
+			ch = *(vdm_mem + l * VDM_COLS + c);
+			if ((ch & 0x80) && !inv) {
+				p += sprintf(p, "\033[7m");
+				inv = 1;
+			} else if (!(ch & 0x80) && inv) {
+				p += sprintf(p, "\033[m");
+				inv = 0;
+			}
+			ch &= 0x7f;
+			*p++ = (ch < 0x20 || ch == 0x7f) ? ' ' : ch;
+		}
+	}
+	if (inv)
+		p += sprintf(p, "\033[m");
+	if (p != buf)
+		write(vdm_fd, buf, p - buf);
+}
+
+/*
+ *	Thread drawing the screen every VDM_FRAME ms, the whole
+ *	screen again if the status port was modified
+ */
+static void *vdm1_thread(void *arg)
+{
+	struct timespec t;
+	BYTE stat, last;
+
+	t.tv_sec = 0;
+	t.tv_nsec = VDM_FRAME * 1000000L;
+	last = __atomic_load_n(&vdm_stat, __ATOMIC_RELAXED);
+	vdm1_draw(1, last);
+	while (!__atomic_load_n(&vdm_done, __ATOMIC_ACQUIRE)) {
+		nanosleep(&t, NULL);
+		stat = __atomic_load_n(&vdm_stat, __ATOMIC_RELAXED);
+		vdm1_draw(stat != last, stat);
+		last = stat;
+	}
+	return(NULL);
+}
+
+/*
+ *	Install the board, if a terminal is configured,
+ *	returns 1 if the board is installed
+ */
+int vdm1_init(void)
+{
+	sigset_t set, oset;
+
+	if (vdm1_tty[0] == '\0')
+		return(0);
+	if ((vdm_fd = open(vdm1_tty, O_WRONLY | O_NOCTTY)) == -1) {
+		printf("VDM-1: can't open terminal %s\n", vdm1_tty);
+		return(0);
+	}
+	vdm_mem = ram + VDM_ADR;
+	mm_io(VDM_ADR, VDM_LINES * VDM_COLS, NULL, vdm1_write);
+
+	/* signals are handled by the main thread only */
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGQUIT);
+	pthread_sigmask(SIG_BLOCK, &set, &oset);
+	if (pthread_create(&vdm_thread, NULL, vdm1_thread, NULL)) {
+		puts("VDM-1: can't start the display");
+		mm_ram(VDM_ADR, VDM_LINES * VDM_COLS);
+		close(vdm_fd);
+		vdm_fd = -1;
+	}
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+	return(vdm_fd != -1);
+}
+
+/*
+ *	Stop the display
+ */
+void vdm1_exit(void)
+{
+	if (vdm_fd == -1)
+		return;
+	__atomic_store_n(&vdm_done, 1, __ATOMIC_RELEASE);
+	pthread_join(vdm_thread, NULL);
+	close(vdm_fd);
+	vdm_fd = -1;
+}
+
+#else
+
+int vdm1_init(void)
+{
+	if (vdm1_tty[0] != '\0')
+		puts("VDM-1 needs WANT_MMIO");
+	return(0);
+}
+
+void vdm1_exit(void)
+{
+}
+
+#endif
+
+/*
+ *	Write status port
+ */
+BYTE vdm1_stat_out(BYTE data)
+{
+#ifdef WANT_MMIO
+	__atomic_store_n(&vdm_stat, data, __ATOMIC_RELAXED);
+#endif
+	return(0);
+}
@@ -0,0 +1,20 @@
+/*
+ * Z80SIM  -  a Z80-CPU simulator
+ *
+ * Common I/O devices used by various simulated machines
+ *
+ * Copyright (C) 2008 by Udo Munk
+ *
+ * Emulation of a Processor Technology VDM-1 S100 video board
+ *
+ * History:
+ * 17-OCT-26 first version of the VDM-1 emulation
+ */
+
+#define VDM1_STAT	0xc8	/* status port of the board */
+
+extern char vdm1_tty[];
+
+extern int vdm1_init(void);
+extern void vdm1_exit(void);
+extern BYTE vdm1_stat_out(BYTE);
@@ -0,0 +1,332 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This program tests the flag tables of init_alu(). Every 8 bit
+ * ADD, ADC, SUB, SBC, CP, AND, OR, XOR, INC, DEC and NEG opcode
+ * is executed with the CPU emulation for all combinations of A,
+ * the operand and the carry. A and the operand are compared with
+ * the results of the handlers used before the tables, which are
+ * kept below as reference, F is compared as a whole. The other
+ * bits of F are set with a pattern, which changes with A and
+ * the operand, so that it is seen if a bit is left unchanged
+ * when it must not or the other way around.
+ *
+ * The program is linked with the objects of z80sim without
+ * sim0.o, so it tests the configuration in sim.h, e.g. with
+ * or without WANT_LAZYF. It is built and run with "make test".
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "simglb.h"
+
+#define ADR	0x1000		/* address of the opcode */
+#define ADR_HL	0x2000		/* address of (HL) */
+#define ADR_X	0x3000		/* IX and IY */
+#define DISP	0x05		/* displacement of (IX+d) and (IY+d) */
+#define MAXERR	10		/* errors printed */
+
+				/* operations */
+#define OP_ADD	0
+#define OP_ADC	1
+#define OP_SUB	2
+#define OP_SBC	3
+#define OP_AND	4
+#define OP_XOR	5
+#define OP_OR	6
+#define OP_CP	7
+#define OP_INC	8
+#define OP_DEC	9
+#define OP_NEG	10
+
+				/* operands, 0-7 like in the opcodes */
+#define R_HL	6		/* (HL) */
+#define R_A	7
+#define R_N	8		/* immediate */
+#define R_IXD	9		/* (IX+d) */
+#define R_IYD	10		/* (IY+d) */
+#define R_IXL	11
+#define R_NONE	12		/* NEG */
+
+static char *op_name[] = {
+	"ADD", "ADC", "SUB", "SBC", "AND", "XOR", "OR", "CP", "INC", "DEC",
+	"NEG"
+};
+
+static char *r_name[] = {
+	"B", "C", "D", "E", "H", "L", "(HL)", "A", "n", "(IX+d)", "(IY+d)",
+	"IXL", ""
+};
+
+extern void cpu(void), init_alu(void);
+
+static int errors;
+static long cases;
+
+int load_file(char *s)		/* the loader is in sim0.o */
+{
+	return(1);
+}
+
+/*
+ *	The flags of the ALU opcodes as computed by the handlers
+ *	before the flag tables. Operation op is done with A a,
+ *	operand n and flags f, the results are returned in
+ *	*ra, *rn and *rf.
+ */
+static void ref_alu(int op, BYTE a, BYTE n, int f, BYTE *ra, BYTE *rn,
+		    int *rf)
+{
+	register int i, carry;
+
+	carry = (f & C_FLAG) ? 1 : 0;
+	switch (op) {
+	case OP_ADD:
+		((a & 0xf) + (n & 0xf) > 0xf) ? (f |= H_FLAG) : (f &= ~H_FLAG);
+		(a + n > 255) ? (f |= C_FLAG) : (f &= ~C_FLAG);
+		a = i = (signed char) a + (signed char) n;
+		(i < -128 || i > 127) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(i & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(a) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f &= ~N_FLAG;
+		break;
+	case OP_ADC:
+		((a & 0xf) + (n & 0xf) + carry > 0xf) ? (f |= H_FLAG)
+						       : (f &= ~H_FLAG);
+		(a + n + carry > 255) ? (f |= C_FLAG) : (f &= ~C_FLAG);
+		a = i = (signed char) a + (signed char) n + carry;
+		(i < -128 || i > 127) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(i & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(a) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f &= ~N_FLAG;
+		break;
+	case OP_SUB:
+	case OP_CP:
+		((n & 0xf) > (a & 0xf)) ? (f |= H_FLAG) : (f &= ~H_FLAG);
+		(n > a) ? (f |= C_FLAG) : (f &= ~C_FLAG);
+		i = (signed char) a - (signed char) n;
+		(i < -128 || i > 127) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(i & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(i) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f |= N_FLAG;
+		if (op == OP_SUB)
+			a = i;
+		break;
+	case OP_SBC:
+		((n & 0xf) + carry > (a & 0xf)) ? (f |= H_FLAG)
+						: (f &= ~H_FLAG);
+		(n + carry > a) ? (f |= C_FLAG) : (f &= ~C_FLAG);
+		a = i = (signed char) a - (signed char) n - carry;
+		(i < -128 || i > 127) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(i & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(a) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f |= N_FLAG;
+		break;
+	case OP_AND:
+	case OP_XOR:
+	case OP_OR:
+		if (op == OP_AND)
+			a &= n;
+		else if (op == OP_XOR)
+			a ^= n;
+		else
+			a |= n;
+		(a & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(a) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		(parrity[a]) ? (f &= ~P_FLAG) : (f |= P_FLAG);
+		if (op == OP_AND) {
+			f |= H_FLAG;
+			f &= ~(N_FLAG | C_FLAG);
+		} else
+			f &= ~(H_FLAG | N_FLAG | C_FLAG);
+		break;
+	case OP_INC:
+		((n & 0xf) + 1 > 0xf) ? (f |= H_FLAG) : (f &= ~H_FLAG);
+		n++;
+		(n == 128) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(n & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(n) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f &= ~N_FLAG;
+		break;
+	case OP_DEC:
+		(((n - 1) & 0xf) == 0xf) ? (f |= H_FLAG) : (f &= ~H_FLAG);
+		n--;
+		(n == 127) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(n & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		(n) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		f |= N_FLAG;
+		break;
+	case OP_NEG:
+		(a) ? (f |= C_FLAG) : (f &= ~C_FLAG);
+		(a == 0x80) ? (f |= P_FLAG) : (f &= ~P_FLAG);
+		(0 - ((signed char) a & 0xf) < 0) ? (f |= H_FLAG)
+						   : (f &= ~H_FLAG);
+		a = 0 - a;
+		f |= N_FLAG;
+		(a) ? (f &= ~Z_FLAG) : (f |= Z_FLAG);
+		(a & 128) ? (f |= S_FLAG) : (f &= ~S_FLAG);
+		break;
+	}
+	*ra = a;
+	*rn = n;
+	*rf = f;
+}
+
+/*
+ *	Store value n into operand r
+ */
+static void put_reg(int r, BYTE n)
+{
+	switch (r) {
+	case 0:		B = n; break;
+	case 1:		C = n; break;
+	case 2:		D = n; break;
+	case 3:		E = n; break;
+	case 4:		H = n; break;
+	case 5:		L = n; break;
+	case R_HL:	*(ram + ADR_HL) = n; break;
+	case R_A:	A = n; break;
+	case R_N:	*(ram + ADR + 1) = n; break;
+	case R_IXD:	*(ram + ADR_X + DISP) = n; break;
+	case R_IYD:	*(ram + ADR_X + DISP) = n; break;
+	case R_IXL:	IX = (IX & 0xff00) | n; break;
+	}
+}
+
+/*
+ *	Get the value of operand r
+ */
+static BYTE get_reg(int r)
+{
+	switch (r) {
+	case 0:		return(B);
+	case 1:		return(C);
+	case 2:		return(D);
+	case 3:		return(E);
+	case 4:		return(H);
+	case 5:		return(L);
+	case R_HL:	return(*(ram + ADR_HL));
+	case R_A:	return(A);
+	case R_N:	return(*(ram + ADR + 1));
+	case R_IXD:
+	case R_IYD:	return(*(ram + ADR_X + DISP));
+	case R_IXL:	return(IX & 0xff);
+	}
+	return(0);
+}
+
+/*
+ *	Test operation op with operand r for all values,
+ *	the opcode of len bytes is in code
+ */
+static void test(int op, int r, BYTE *code, int len)
+{
+	register int a, n, c;
+	BYTE ra, rn;
+	int f, rf;
+
+	memcpy(ram + ADR, code, len);
+	for (a = 0; a < 256; a++) {
+		for (n = 0; n < 256; n++) {
+			/* the operand is A itself or doesn't use A */
+			if ((r == R_A && n != a) || (r == R_NONE && n > 0))
+				continue;
+			if ((op == OP_INC || op == OP_DEC) && r != R_A && a > 0)
+				continue;
+			for (c = 0; c < 2; c++) {
+				f = c | ((a * 7 ^ n * 13) & 0xfe);
+				H = ADR_HL >> 8;
+				L = ADR_HL & 0xff;
+				IX = IY = ADR_X;
+				A = a;
+				put_reg(r, n);
+				F = f;
+				PC = ram + ADR;
+				cpu_error = NONE;
+				cpu_state = SINGLE_STEP;
+				cpu();
+				ref_alu(op, a, n, f, &ra, &rn, &rf);
+				if (r == R_A) {	/* A is the operand too */
+					if (op == OP_INC || op == OP_DEC)
+						ra = rn;
+					else
+						rn = ra;
+				}
+				cases++;
+				if (cpu_error == NONE && A == ra
+				    && (r == R_NONE || get_reg(r) == rn)
+				    && F == rf && PC == ram + ADR + len)
+					continue;
+				if (++errors > MAXERR)
+					continue;
+				printf("%s %s: A=%02x n=%02x F=%02x: ",
+				       op_name[op], r_name[r], a, n, f);
+				printf("A=%02x n=%02x F=%02x, expected ",
+				       A, get_reg(r), F);
+				printf("A=%02x n=%02x F=%02x\n", ra, rn, rf);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	register int op, r;
+	BYTE code[4];
+
+#ifdef WANT_MIRROR
+	if ((cpu0.mem = mem_map()) == NULL) {
+		perror("memory");
+		return(1);
+	}
+	ram = cpu0.mem;
+#endif
+	memset((char *) ram, 0, 65536);
+#ifdef WANT_MMIO
+	mm_init(&cpu0);
+#endif
+	init_alu();
+	b_flag = 1;			/* no history etc. */
+
+	for (op = OP_ADD; op <= OP_CP; op++) {
+		for (r = 0; r <= R_A; r++) {
+			code[0] = 0x80 | (op << 3) | r;
+			test(op, r, code, 1);
+		}
+		code[0] = 0xc6 | (op << 3);	/* immediate */
+		code[1] = 0;
+		test(op, R_N, code, 2);
+		code[0] = 0xdd;
+		code[1] = 0x86 | (op << 3);
+		code[2] = DISP;
+		test(op, R_IXD, code, 3);
+		code[0] = 0xfd;
+		test(op, R_IYD, code, 3);
+	}
+	for (op = OP_INC; op <= OP_DEC; op++) {
+		for (r = 0; r <= R_A; r++) {
+			code[0] = 0x04 | (r << 3) | (op - OP_INC);
+			test(op, r, code, 1);
+		}
+		code[0] = 0xdd;
+		code[1] = 0x34 | (op - OP_INC);
+		code[2] = DISP;
+		test(op, R_IXD, code, 3);
+		code[0] = 0xfd;
+		test(op, R_IYD, code, 3);
+	}
+#ifdef Z80_UNDOC
+	code[0] = 0xdd;				/* CP IXL */
+	code[1] = 0xbd;
+	test(OP_CP, R_IXL, code, 2);
+#endif
+	code[0] = 0xed;				/* NEG */
+	code[1] = 0x44;
+	test(OP_NEG, R_NONE, code, 2);
+
+	printf("%ld cases tested, %d errors\n", cases, errors);
+	return(errors > 0);
+}
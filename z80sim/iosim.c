@@ -34,14 +34,30 @@
  *	Port 1 input:	reads the next byte from stdin
  *	Port 1 output:	writes the byte to stdout
  *
+ *	Port 1 can transfer blocks for INIR/OTIR etc. in one go.
+ *
  *	All the other ports are connected to an I/O-trap handler,
  *	I/O to this ports stops the simulation with an I/O error.
+ *
+ *	In host mode every machine has its own console, see
+ *	host_io(), instead of stdin and stdout.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "sim.h"
 #include "simglb.h"
 
+/*
+ *	Console of a machine, the I/O state in the CPU context
+ */
+struct console {
+	FILE *in;
+	FILE *out;
+};
+
+static struct console con_std;	/* stdin/stdout for the monitor */
+
 /*
  *	Forward declarations of the I/O functions
  *	for all port addresses.
@@ -49,6 +65,7 @@
 static BYTE io_trap(void);
 static BYTE p001_in(void);
 static void p001_out(BYTE);
+static int p001_blk_in(BYTE *, int), p001_blk_out(BYTE *, int);
 
 /*
  *	This two dimensional array contains function pointers
@@ -60,6 +77,16 @@ static BYTE (*port[256][2]) () = {
 	{ p001_in, p001_out }		/* port	1 */
 };
 
+/*
+ *	This array contains the function pointers of the ports,
+ *	which can transfer a block of bytes at once, NULL for the
+ *	others. The first entry is for input, the second for output.
+ */
+static int (*port_blk[256][2]) (BYTE *, int) = {
+	{ NULL, NULL },			/* port 0 */
+	{ p001_blk_in, p001_blk_out }	/* port 1 */
+};
+
 /*
  *	This function is to initiate the I/O devices.
  *	It will be called from the CPU simulation before
@@ -78,8 +105,53 @@ void init_io(void)
 
 	for (i = 2; i <= 255; i++)
 		port[i][0] = port[i][1]	= io_trap;
+	con_std.in = stdin;
+	con_std.out = stdout;
+	cpu0.io = &con_std;
 }
 
+#ifdef WANT_HOST
+/*
+ *	Create the console of machine n in host mode.
+ *	Input is read from the file conin.n, if it exists,
+ *	output is written into the file conout.n.
+ */
+void *host_io(int n)
+{
+	register struct console *con;
+	char fn[LENCMD];
+
+	if ((con = malloc(sizeof(struct console))) == NULL)
+		return(NULL);
+	sprintf(fn, "conin.%d", n);
+	if ((con->in = fopen(fn, "r")) == NULL)
+		con->in = fopen("/dev/null", "r");
+	sprintf(fn, "conout.%d", n);
+	if ((con->out = fopen(fn, "w")) == NULL || con->in == NULL) {
+		printf("can't open console files of machine %d\n", n);
+		if (con->out != NULL)
+			fclose(con->out);
+		if (con->in != NULL)
+			fclose(con->in);
+		free(con);
+		return(NULL);
+	}
+	return(con);
+}
+
+/*
+ *	Close the console of a machine in host mode
+ */
+void host_io_close(void *io)
+{
+	register struct console *con = io;
+
+	fclose(con->in);
+	fclose(con->out);
+	free(con);
+}
+#endif
+
 /*
  *	This function is to stop the I/O devices. It is
  *	called from the CPU simulation on exit.
@@ -91,6 +163,33 @@ void exit_io(void)
 {
 }
 
+#ifdef WANT_SNAP
+/*
+ *	This function saves (restore == 0) or restores the state
+ *	of the I/O devices for a snapshot, see simsnp.c.
+ *
+ *	The console has no state and there is no MMU, see
+ *	the I/O simulation of CP/M for a more complex example.
+ */
+int io_snap(struct snapio *s, int restore)
+{
+	if (!restore) {
+		s->s_nbank = 0;
+		s->s_segsize = 0;
+		s->s_selbnk = 0;
+	}
+	return(1);
+}
+
+/*
+ *	Memory of bank n for a snapshot, there are no banks
+ */
+BYTE *io_bank(int n)
+{
+	return(NULL);
+}
+#endif
+
 /*
  *	This is the main handler for all IN op-codes,
  *	called by the simulator. It calls the input
@@ -98,7 +197,14 @@ void exit_io(void)
  */
 BYTE io_in(BYTE adr)
 {
-	return((*port[adr][0]) ());
+	register BYTE data;
+
+	data = (*port[adr][0]) ();
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_IN, adr, data, 1);
+#endif
+	return(data);
 }
 
 /*
@@ -108,9 +214,47 @@ BYTE io_in(BYTE adr)
  */
 void io_out(BYTE adr, BYTE data)
 {
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_OUT, adr, data, 1);
+#endif
 	(*port[adr][1])	(data);
 }
 
+/*
+ *	This is the handler for the block I/O op-codes,
+ *	called by the simulator. It calls the block input
+ *	function for port adr, if there is one, to read
+ *	n bytes into buf. Returns 0 if the port has none.
+ */
+int io_blk_in(BYTE adr, BYTE *buf, int n)
+{
+	if (port_blk[adr][0] == NULL || !(*port_blk[adr][0]) (buf, n))
+		return(0);
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_IN, adr, buf[0], n);
+#endif
+	return(1);
+}
+
+/*
+ *	This is the handler for the block I/O op-codes,
+ *	called by the simulator. It calls the block output
+ *	function for port adr, if there is one, to write
+ *	n bytes from buf. Returns 0 if the port has none.
+ */
+int io_blk_out(BYTE adr, BYTE *buf, int n)
+{
+	if (port_blk[adr][1] == NULL)
+		return(0);
+#ifdef WANT_TRACE
+	if (tr_cur != NULL)
+		tr_io(TR_OUT, adr, buf[0], n);
+#endif
+	return((*port_blk[adr][1]) (buf, n));
+}
+
 /*
  *	I/O trap function
  *	This function should be added into all unused
@@ -128,19 +272,48 @@ static BYTE io_trap(void)
 
 /*
  *	I/O function port 1 read:
- *	Read next byte from stdin.
+ *	Read next byte from the console, stdin for the monitor.
  */
 static BYTE p001_in(void)
 {
-	return((BYTE) getchar());
+	return((BYTE) getc(((struct console *) cpu_ctx->io)->in));
 }
 
 /*
  *	I/O function port 1 write:
- *	Write byte to stdout and flush the output.
+ *	Write byte to the console and flush the output.
  */
 static void p001_out(BYTE data)
 {
-	putchar((int) data);
-	fflush(stdout);
+	register struct console *con = cpu_ctx->io;
+
+	putc((int) data, con->out);
+	fflush(con->out);
+}
+
+/*
+ *	I/O function port 1 block read:
+ *	Read n bytes from the console, like p001_in() for every byte.
+ */
+static int p001_blk_in(BYTE *buf, int n)
+{
+	register int i;
+
+	i = fread(buf, 1, n, ((struct console *) cpu_ctx->io)->in);
+	for (; i < n; i++)
+		buf[i] = (BYTE) EOF;
+	return(n);
+}
+
+/*
+ *	I/O function port 1 block write:
+ *	Write n bytes to the console and flush the output once.
+ */
+static int p001_blk_out(BYTE *buf, int n)
+{
+	register struct console *con = cpu_ctx->io;
+
+	fwrite(buf, 1, n, con->out);
+	fflush(con->out);
+	return(n);
 }
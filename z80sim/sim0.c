@@ -42,6 +42,7 @@
 #include <memory.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #define BUFSIZE	256		/* buffer size for file I/O */
 
@@ -49,17 +50,25 @@ int load_core(void);
 static void save_core(void);
 static int load_mos(int, char *), load_hex(char *), checksum(char *);
 extern void int_on(void), int_off(void), mon(void);
-extern void init_io(void), exit_io(void);
+extern void init_io(void), exit_io(void), init_alu(void);
 extern int exatoi(char *);
+#ifdef WANT_HOST
+extern int load_file(char *), host_run(int, int);
+#endif
 
 int main(int argc, char *argv[])
 {
 	register char *s, *p;
 	register char *pn = argv[0];
+#ifdef WANT_HOST
+	int n_flag = 0, w_flag = 0;
+#endif
+#ifdef WANT_TRACE
+	char *tfn = NULL;
+#endif
 
 #ifdef CPU_SPEED
 	f_flag = CPU_SPEED;
-	tmax = CPU_SPEED * 10000;
 #endif
 
 	while (--argc >	0 && (*++argv)[0] == '-')
@@ -71,10 +80,26 @@ int main(int argc, char *argv[])
 			case 'l':	/* load core and CPU from file */
 				l_flag = 1;
 				break;
+#ifdef WANT_SNAP
+			case 'k':	/* snapshot every n seconds */
+				sn_period = atoi(s+1);
+				s += strlen(s+1);
+				break;
+#endif
 #ifdef Z80_UNDOC
 			case 'z':	/* trap undocumented Z80 ops */
 				z_flag = 1;
 				break;
+#endif
+			case 'b':	/* batch, no debugging features */
+				b_flag = 1;
+				break;
+#ifdef HISIZE
+			case 'h':	/* number of history entries */
+				if ((h_size = atol(s+1)) <= 0)
+					h_size = HISIZE;
+				s += strlen(s+1);
+				break;
 #endif
 			case 'i':	/* trap I/O on unused ports */
 				i_flag = 1;
@@ -86,8 +111,17 @@ int main(int argc, char *argv[])
 			case 'f':	/* set emulation speed */
 				f_flag = atoi(s+1);
 				s += strlen(s+1);
-				tmax = f_flag * 10000;
 				break;
+#ifdef WANT_HOST
+			case 'n':	/* number of machines in host mode */
+				n_flag = atoi(s+1);
+				s += strlen(s+1);
+				break;
+			case 'w':	/* number of worker threads */
+				w_flag = atoi(s+1);
+				s += strlen(s+1);
+				break;
+#endif
 			case 'x':	/* get filename with Z80 executable */
 				x_flag = 1;
 				s++;
@@ -97,17 +131,50 @@ int main(int argc, char *argv[])
 				*p = '\0';
 				s--;
 				break;
+#ifdef WANT_TRACE
+			case 't':	/* get filename for execution trace */
+				tfn = s+1;
+				s += strlen(s+1);
+				break;
+#endif
+#ifdef WANT_WATCH
+			case 'W':	/* set a watchpoint */
+				if (wp_set(-1, s+1) < 0)
+					exit(1);
+				s += strlen(s+1);
+				break;
+#endif
 			case '?':
 				goto usage;
 			default:
 				printf("illegal option %c\n", *s);
-#ifndef Z80_UNDOC
-usage:				printf("usage:\t%s -s -l -i -mn -fn -xfilename\n", pn);
-#else
-usage:				printf("usage:\t%s -s -l -i -z -mn -fn -xfilename\n", pn);
+usage:				printf("usage:\t%s -s -l -b -i", pn);
+#ifdef Z80_UNDOC
+				printf(" -z");
+#endif
+				printf(" -mn -fn -xfilename");
+#ifdef HISIZE
+				printf(" -hn");
+#endif
+#ifdef WANT_SNAP
+				printf(" -kn");
+#endif
+#ifdef WANT_TRACE
+				printf(" -tfilename");
 #endif
+#ifdef WANT_WATCH
+				printf(" -Wwatchpoint");
+#endif
+#ifdef WANT_HOST
+				printf(" -nn -wn");
+#endif
+				putchar('\n');
 				puts("\ts = save core and cpu");
 				puts("\tl = load core and cpu");
+				puts("\tb = run without history and runtime measurement");
+#ifdef HISIZE
+				puts("\th = keep n entries in the history");
+#endif
 				puts("\ti = trap on I/O to unused ports");
 #ifdef Z80_UNDOC
 				puts("\tz = trap on undocumented Z80 ops");
@@ -115,6 +182,19 @@ usage:				printf("usage:\t%s -s -l -i -z -mn -fn -xfilename\n", pn);
 				puts("\tm = init memory with n");
 				puts("\tf = CPU frequenzy n in MHz");
 				puts("\tx = load and execute filename");
+#ifdef WANT_SNAP
+				puts("\tk = snapshot into core.z80 every n seconds");
+#endif
+#ifdef WANT_TRACE
+				puts("\tt = trace execution into filename");
+#endif
+#ifdef WANT_WATCH
+				puts("\tW = set watchpoint address[,to][r][w][=value]");
+#endif
+#ifdef WANT_HOST
+				puts("\tn = run n machines in host mode");
+				puts("\tw = use n worker threads in host mode");
+#endif
 				exit(1);
 			}
 
@@ -136,17 +216,55 @@ usage:				printf("usage:\t%s -s -l -i -z -mn -fn -xfilename\n", pn);
 #endif
 	fflush(stdout);
 
+#ifdef WANT_MIRROR
+	if ((cpu0.mem = mem_map()) == NULL) {
+		perror("memory");
+		return(1);
+	}
+	ram = cpu0.mem;
+#ifdef WANT_TIM
+	t_start = t_end = ram + 65535;
+#endif
+#endif
 	wrk_ram	= PC = ram;
 	STACK = ram + 0xffff;
 	memset((char *)	ram, m_flag, 65536);
+#ifdef WANT_MMIO
+	mm_init(&cpu0);
+#endif
+	init_alu();
+	int_on();
+	init_io();
 	if (l_flag)
 		if (load_core())
 			return(1);
-	int_on();
-	init_io();
+#ifdef WANT_TRACE
+	if (tfn != NULL && *tfn && !tr_open(tfn))
+		printf("can't create trace file %s\n", tfn);
+#endif
+#ifdef WANT_HOST
+	if (n_flag > 0) {
+		if (!x_flag)
+			puts("host mode needs a program to execute");
+		else if (load_file(xfn) == 0)
+			host_run(n_flag, w_flag);
+#ifdef WANT_TRACE
+		tr_close();
+#endif
+		exit_io();
+		int_off();
+		return(0);
+	}
+#endif
 	mon();
+#ifdef WANT_TRACE
+	tr_close();
+#endif
 	if (s_flag)
 		save_core();
+#ifdef WANT_SNAP
+	sn_close();			/* wait for the last snapshot */
+#endif
 	exit_io();
 	int_off();
 	return(0);
@@ -154,10 +272,13 @@ usage:				printf("usage:\t%s -s -l -i -z -mn -fn -xfilename\n", pn);
 
 /*
  *	This function saves the CPU and the memory into the file core.z80
- *
+ *	With WANT_SNAP it's a snapshot of the whole machine, see simsnp.c
  */
 static void save_core(void)
 {
+#ifdef WANT_SNAP
+	sn_save(SN_FILE);
+#else
 	int fd;
 
 	if ((fd	= open("core.z80", O_WRONLY | O_CREAT, 0600)) == -1) {
@@ -189,16 +310,23 @@ static void save_core(void)
 	write(fd, (char	*) &IY,	sizeof(IY));
 	write(fd, (char	*) ram,	65536);
 	close(fd);
+#endif
 }
 
 /*
  *	This function loads the CPU and memory from the file core.z80
- *
+ *	With WANT_SNAP it's a snapshot of the whole machine, see simsnp.c,
+ *	a core file written without WANT_SNAP is still loaded
  */
 int load_core(void)
 {
 	int fd;
 
+#ifdef WANT_SNAP
+	if (sn_test(SN_FILE))
+		return(!sn_load(SN_FILE));
+#endif
+
 	if ((fd	= open("core.z80", O_RDONLY)) == -1) {
 		puts("can't open file core.z80");
 		return(1);
@@ -228,6 +356,9 @@ int load_core(void)
 	read(fd, (char *) &IY, sizeof(IY));
 	read(fd, (char *) ram, 65536);
 	close(fd);
+#ifdef WANT_SNAP
+	sn_all();
+#endif
 
 	return(0);
 }
@@ -298,6 +429,9 @@ static int load_mos(int fd, char *fn)
 		rc = 1;
 	}
 	close(fd);
+#ifdef WANT_SNAP
+	sn_all();
+#endif
 	printf("\nLoader statistics for file %s:\n", fn);
 	printf("START : %04x\n", (unsigned int)(wrk_ram - ram));
 	printf("END   : %04x\n", (unsigned int)(wrk_ram - ram + readed - 1));
@@ -369,7 +503,7 @@ static int load_hex(char *fn)
 			data += (*s <= '9') ? (*s - '0') :
 					      (*s - 'A' + 10);
 			s++;
-			*(ram + addr + i) = data;
+			memwrt(addr + i, data);
 		}
 	}
 
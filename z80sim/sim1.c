@@ -27,9 +27,12 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
@@ -115,407 +118,934 @@ static int op_rst20(void), op_rst28(void), op_rst30(void), op_rst38(void);
 extern int op_cb_handel(void), op_dd_handel(void);
 extern int op_ed_handel(void), op_fd_handel(void);
 
+#define CPU_HIS		1	/* write history */
+#define CPU_TIM		2	/* runtime measurement */
+#define CPU_TRC		4	/* write execution trace */
+#define CPU_PRF		8	/* profile the execution */
+#define CPU_BRK		16	/* check for breakpoints */
+#define CPU_DYN		(CPU_TRC | CPU_PRF | CPU_BRK) /* only in cpu_any() */
+
+#if defined(WANT_TRACE) || defined(WANT_PROF) || defined(SBSIZE)
+#define CPU_ANY			/* build cpu_any() */
+#endif
+
+static TLOCAL int cpu_feat;	/* debugging features switched on */
+#ifdef WANT_PROF
+static TLOCAL WORD p_adr;	/* address of the opcode profiled */
+#endif
+
+#ifdef WANT_INT
 /*
- *	This function builds the Z80 central processing unit.
- *	The opcode where PC points to is fetched from the memory
- *	and PC incremented by one. The opcode is used as an
- *	index to an array with function pointers, to execute a
- *	function which emulates this Z80 opcode.
+ *	Push PC onto the stack for an interrupt
  */
-void cpu(void)
+static inline void int_push(void)
 {
-	static int (*op_sim[256]) (void) =	{
-		op_nop,				/* 0x00	*/
-		op_ldbcnn,			/* 0x01	*/
-		op_ldbca,			/* 0x02	*/
-		op_incbc,			/* 0x03	*/
-		op_incb,			/* 0x04	*/
-		op_decb,			/* 0x05	*/
-		op_ldbn,			/* 0x06	*/
-		op_rlca,			/* 0x07	*/
-		op_exafaf,			/* 0x08	*/
-		op_adhlbc,			/* 0x09	*/
-		op_ldabc,			/* 0x0a	*/
-		op_decbc,			/* 0x0b	*/
-		op_incc,			/* 0x0c	*/
-		op_decc,			/* 0x0d	*/
-		op_ldcn,			/* 0x0e	*/
-		op_rrca,			/* 0x0f	*/
-		op_djnz,			/* 0x10	*/
-		op_lddenn,			/* 0x11	*/
-		op_lddea,			/* 0x12	*/
-		op_incde,			/* 0x13	*/
-		op_incd,			/* 0x14	*/
-		op_decd,			/* 0x15	*/
-		op_lddn,			/* 0x16	*/
-		op_rla,				/* 0x17	*/
-		op_jr,				/* 0x18	*/
-		op_adhlde,			/* 0x19	*/
-		op_ldade,			/* 0x1a	*/
-		op_decde,			/* 0x1b	*/
-		op_ince,			/* 0x1c	*/
-		op_dece,			/* 0x1d	*/
-		op_lden,			/* 0x1e	*/
-		op_rra,				/* 0x1f	*/
-		op_jrnz,			/* 0x20	*/
-		op_ldhlnn,			/* 0x21	*/
-		op_ldinhl,			/* 0x22	*/
-		op_inchl,			/* 0x23	*/
-		op_inch,			/* 0x24	*/
-		op_dech,			/* 0x25	*/
-		op_ldhn,			/* 0x26	*/
-		op_daa,				/* 0x27	*/
-		op_jrz,				/* 0x28	*/
-		op_adhlhl,			/* 0x29	*/
-		op_ldhlin,			/* 0x2a	*/
-		op_dechl,			/* 0x2b	*/
-		op_incl,			/* 0x2c	*/
-		op_decl,			/* 0x2d	*/
-		op_ldln,			/* 0x2e	*/
-		op_cpl,				/* 0x2f	*/
-		op_jrnc,			/* 0x30	*/
-		op_ldspnn,			/* 0x31	*/
-		op_ldnna,			/* 0x32	*/
-		op_incsp,			/* 0x33	*/
-		op_incihl,			/* 0x34	*/
-		op_decihl,			/* 0x35	*/
-		op_ldhl1,			/* 0x36	*/
-		op_scf,				/* 0x37	*/
-		op_jrc,				/* 0x38	*/
-		op_adhlsp,			/* 0x39	*/
-		op_ldann,			/* 0x3a	*/
-		op_decsp,			/* 0x3b	*/
-		op_inca,			/* 0x3c	*/
-		op_deca,			/* 0x3d	*/
-		op_ldan,			/* 0x3e	*/
-		op_ccf,				/* 0x3f	*/
-		op_ldbb,			/* 0x40	*/
-		op_ldbc,			/* 0x41	*/
-		op_ldbd,			/* 0x42	*/
-		op_ldbe,			/* 0x43	*/
-		op_ldbh,			/* 0x44	*/
-		op_ldbl,			/* 0x45	*/
-		op_ldbhl,			/* 0x46	*/
-		op_ldba,			/* 0x47	*/
-		op_ldcb,			/* 0x48	*/
-		op_ldcc,			/* 0x49	*/
-		op_ldcd,			/* 0x4a	*/
-		op_ldce,			/* 0x4b	*/
-		op_ldch,			/* 0x4c	*/
-		op_ldcl,			/* 0x4d	*/
-		op_ldchl,			/* 0x4e	*/
-		op_ldca,			/* 0x4f	*/
-		op_lddb,			/* 0x50	*/
-		op_lddc,			/* 0x51	*/
-		op_lddd,			/* 0x52	*/
-		op_ldde,			/* 0x53	*/
-		op_lddh,			/* 0x54	*/
-		op_lddl,			/* 0x55	*/
-		op_lddhl,			/* 0x56	*/
-		op_ldda,			/* 0x57	*/
-		op_ldeb,			/* 0x58	*/
-		op_ldec,			/* 0x59	*/
-		op_lded,			/* 0x5a	*/
-		op_ldee,			/* 0x5b	*/
-		op_ldeh,			/* 0x5c	*/
-		op_ldel,			/* 0x5d	*/
-		op_ldehl,			/* 0x5e	*/
-		op_ldea,			/* 0x5f	*/
-		op_ldhb,			/* 0x60	*/
-		op_ldhc,			/* 0x61	*/
-		op_ldhd,			/* 0x62	*/
-		op_ldhe,			/* 0x63	*/
-		op_ldhh,			/* 0x64	*/
-		op_ldhl,			/* 0x65	*/
-		op_ldhhl,			/* 0x66	*/
-		op_ldha,			/* 0x67	*/
-		op_ldlb,			/* 0x68	*/
-		op_ldlc,			/* 0x69	*/
-		op_ldld,			/* 0x6a	*/
-		op_ldle,			/* 0x6b	*/
-		op_ldlh,			/* 0x6c	*/
-		op_ldll,			/* 0x6d	*/
-		op_ldlhl,			/* 0x6e	*/
-		op_ldla,			/* 0x6f	*/
-		op_ldhlb,			/* 0x70	*/
-		op_ldhlc,			/* 0x71	*/
-		op_ldhld,			/* 0x72	*/
-		op_ldhle,			/* 0x73	*/
-		op_ldhlh,			/* 0x74	*/
-		op_ldhll,			/* 0x75	*/
-		op_halt,			/* 0x76	*/
-		op_ldhla,			/* 0x77	*/
-		op_ldab,			/* 0x78	*/
-		op_ldac,			/* 0x79	*/
-		op_ldad,			/* 0x7a	*/
-		op_ldae,			/* 0x7b	*/
-		op_ldah,			/* 0x7c	*/
-		op_ldal,			/* 0x7d	*/
-		op_ldahl,			/* 0x7e	*/
-		op_ldaa,			/* 0x7f	*/
-		op_addb,			/* 0x80	*/
-		op_addc,			/* 0x81	*/
-		op_addd,			/* 0x82	*/
-		op_adde,			/* 0x83	*/
-		op_addh,			/* 0x84	*/
-		op_addl,			/* 0x85	*/
-		op_addhl,			/* 0x86	*/
-		op_adda,			/* 0x87	*/
-		op_adcb,			/* 0x88	*/
-		op_adcc,			/* 0x89	*/
-		op_adcd,			/* 0x8a	*/
-		op_adce,			/* 0x8b	*/
-		op_adch,			/* 0x8c	*/
-		op_adcl,			/* 0x8d	*/
-		op_adchl,			/* 0x8e	*/
-		op_adca,			/* 0x8f	*/
-		op_subb,			/* 0x90	*/
-		op_subc,			/* 0x91	*/
-		op_subd,			/* 0x92	*/
-		op_sube,			/* 0x93	*/
-		op_subh,			/* 0x94	*/
-		op_subl,			/* 0x95	*/
-		op_subhl,			/* 0x96	*/
-		op_suba,			/* 0x97	*/
-		op_sbcb,			/* 0x98	*/
-		op_sbcc,			/* 0x99	*/
-		op_sbcd,			/* 0x9a	*/
-		op_sbce,			/* 0x9b	*/
-		op_sbch,			/* 0x9c	*/
-		op_sbcl,			/* 0x9d	*/
-		op_sbchl,			/* 0x9e	*/
-		op_sbca,			/* 0x9f	*/
-		op_andb,			/* 0xa0	*/
-		op_andc,			/* 0xa1	*/
-		op_andd,			/* 0xa2	*/
-		op_ande,			/* 0xa3	*/
-		op_andh,			/* 0xa4	*/
-		op_andl,			/* 0xa5	*/
-		op_andhl,			/* 0xa6	*/
-		op_anda,			/* 0xa7	*/
-		op_xorb,			/* 0xa8	*/
-		op_xorc,			/* 0xa9	*/
-		op_xord,			/* 0xaa	*/
-		op_xore,			/* 0xab	*/
-		op_xorh,			/* 0xac	*/
-		op_xorl,			/* 0xad	*/
-		op_xorhl,			/* 0xae	*/
-		op_xora,			/* 0xaf	*/
-		op_orb,				/* 0xb0	*/
-		op_orc,				/* 0xb1	*/
-		op_ord,				/* 0xb2	*/
-		op_ore,				/* 0xb3	*/
-		op_orh,				/* 0xb4	*/
-		op_orl,				/* 0xb5	*/
-		op_orhl,			/* 0xb6	*/
-		op_ora,				/* 0xb7	*/
-		op_cpb,				/* 0xb8	*/
-		op_cpc,				/* 0xb9	*/
-		op_cpd,				/* 0xba	*/
-		op_cpe,				/* 0xbb	*/
-		op_cph,				/* 0xbc	*/
-		op_cplr,			/* 0xbd	*/
-		op_cphl,			/* 0xbe	*/
-		op_cpa,				/* 0xbf	*/
-		op_retnz,			/* 0xc0	*/
-		op_popbc,			/* 0xc1	*/
-		op_jpnz,			/* 0xc2	*/
-		op_jp,				/* 0xc3	*/
-		op_calnz,			/* 0xc4	*/
-		op_pushbc,			/* 0xc5	*/
-		op_addn,			/* 0xc6	*/
-		op_rst00,			/* 0xc7	*/
-		op_retz,			/* 0xc8	*/
-		op_ret,				/* 0xc9	*/
-		op_jpz,				/* 0xca	*/
-		op_cb_handel,			/* 0xcb	*/
-		op_calz,			/* 0xcc	*/
-		op_call,			/* 0xcd	*/
-		op_adcn,			/* 0xce	*/
-		op_rst08,			/* 0xcf	*/
-		op_retnc,			/* 0xd0	*/
-		op_popde,			/* 0xd1	*/
-		op_jpnc,			/* 0xd2	*/
-		op_out,				/* 0xd3	*/
-		op_calnc,			/* 0xd4	*/
-		op_pushde,			/* 0xd5	*/
-		op_subn,			/* 0xd6	*/
-		op_rst10,			/* 0xd7	*/
-		op_retc,			/* 0xd8	*/
-		op_exx,				/* 0xd9	*/
-		op_jpc,				/* 0xda	*/
-		op_in,				/* 0xdb	*/
-		op_calc,			/* 0xdc	*/
-		op_dd_handel,			/* 0xdd	*/
-		op_sbcn,			/* 0xde	*/
-		op_rst18,			/* 0xdf	*/
-		op_retpo,			/* 0xe0	*/
-		op_pophl,			/* 0xe1	*/
-		op_jppo,			/* 0xe2	*/
-		op_exsphl,			/* 0xe3	*/
-		op_calpo,			/* 0xe4	*/
-		op_pushhl,			/* 0xe5	*/
-		op_andn,			/* 0xe6	*/
-		op_rst20,			/* 0xe7	*/
-		op_retpe,			/* 0xe8	*/
-		op_jphl,			/* 0xe9	*/
-		op_jppe,			/* 0xea	*/
-		op_exdehl,			/* 0xeb	*/
-		op_calpe,			/* 0xec	*/
-		op_ed_handel,			/* 0xed	*/
-		op_xorn,			/* 0xee	*/
-		op_rst28,			/* 0xef	*/
-		op_retp,			/* 0xf0	*/
-		op_popaf,			/* 0xf1	*/
-		op_jpp,				/* 0xf2	*/
-		op_di,				/* 0xf3	*/
-		op_calp,			/* 0xf4	*/
-		op_pushaf,			/* 0xf5	*/
-		op_orn,				/* 0xf6	*/
-		op_rst30,			/* 0xf7	*/
-		op_retm,			/* 0xf8	*/
-		op_ldsphl,			/* 0xf9	*/
-		op_jpm,				/* 0xfa	*/
-		op_ei,				/* 0xfb	*/
-		op_calm,			/* 0xfc	*/
-		op_fd_handel,			/* 0xfd	*/
-		op_cpn,				/* 0xfe	*/
-		op_rst38			/* 0xff	*/
-	};
-
-#ifdef WANT_TIM
-	register int t = 0;
-	struct timespec timer;
-#ifdef FRONTPANEL
-	register int states;
+#ifdef WANT_SPC
+	if (STACK <= ram)
+		STACK =	ram + 65536L;
 #endif
+	memwrt(--STACK - ram, (PC - ram) >> 8);
+#ifdef WANT_SPC
+	if (STACK <= ram)
+		STACK =	ram + 65536L;
 #endif
+	memwrt(--STACK - ram, (PC - ram));
+}
+
+/*
+ *	This function handles the CPU interrupts, it's called
+ *	before an opcode, if int_type was set or EI executed and
+ *	ev_attn() called. A maskable interrupt isn't accepted
+ *	before the opcode following EI.
+ *	Maskable interrupts are requested by the devices with
+ *	int_request(), the device with the highest priority
+ *	puts its vector onto the data bus.
+ */
+static void cpu_int(void)
+{
+	register unsigned dev;
+	register BYTE data;
+	register WORD adr;
+
+	if (cpu_ctx->int_ei) {	/* the opcode after EI runs first */
+		cpu_ctx->int_ei = 0;
+		ev_attn();	/* look again before the one after it */
+		if (int_type != INT_NMI)
+			return;
+	}
+
+	switch (int_type) {
+	case INT_NMI:	/* non maskable interrupt */
+		int_type = INT_NONE;
+		IFF <<= 1;
+		int_push();
+		PC = ram + 0x66;
+		ev_clock += 11;
+		break;
+	case INT_INT:	/* maskable interrupt */
+		if (IFF != 3)
+			break;
+		if (!int_ready())
+			break;
+		dev = __builtin_ctz(__atomic_load_n(&cpu_ctx->int_req,
+						    __ATOMIC_SEQ_CST));
+		data = cpu_ctx->int_vec[dev];
+		if (int_mode == 0 && (data & 0xc7) != 0xc7 && data != 0xcd) {
+			cpu_error = INTERROR;	/* only RST and CALL */
+			cpu_state = STOPPED;
+			break;
+		}
+		int_type = INT_NONE;
+		__atomic_fetch_and(&cpu_ctx->int_req, ~(1U << dev),
+				   __ATOMIC_SEQ_CST);
+		if (int_mode == 2)	/* daisy chain of Z80 devices */
+			cpu_ctx->int_ack |= 1U << dev;
+		IFF = 0;
+		int_push();
+		switch (int_mode) {
+		case 0:	/* execute RST or CALL from the data bus */
+			if (data == 0xcd) {
+				PC = ram + cpu_ctx->int_adr[dev];
+				ev_clock += 19;
+			} else {
+				PC = ram + (data & 0x38);
+				ev_clock += 13;
+			}
+			break;
+		case 1:	/* RST 38H */
+			PC = ram + 0x38;
+			ev_clock += 13;
+			break;
+		case 2:	/* call address from table at I and vector */
+			adr = (I << 8) + data;
+			PC = ram + memrdr(adr) + (memrdr((WORD) (adr + 1)) << 8);
+			ev_clock += 19;
+			break;
+		}
+		break;
+	}
+}
+
+/*
+ *	Check if the pending interrupt can be accepted, if the
+ *	interrupts are enabled. In IM 2 a device can't interrupt,
+ *	until the devices before it in the daisy chain, which
+ *	interrupted before, are done with RETI. In IM 0 and IM 1
+ *	the devices are prioritized only, so that interrupt handlers
+ *	ending with EI, RET still work. int_type is reset, if there
+ *	is no request, which can be accepted.
+ */
+int int_ready(void)
+{
+	register unsigned req;
+
+	if (int_type == INT_NMI)
+		return(1);
+	int_type = INT_NONE;	/* a new request sets it again */
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	req = __atomic_load_n(&cpu_ctx->int_req, __ATOMIC_SEQ_CST);
+	if (req == 0 || (cpu_ctx->int_ack & ((2U << __builtin_ctz(req)) - 1)))
+		return(0);
+	int_type = INT_INT;
+	return(1);
+}
+
+/*
+ *	Interrupt request of device dev (0 - INT_DEV-1) with vector
+ *	data. The devices are in a daisy chain, device 0 has the
+ *	highest priority. The request is removed, when the CPU
+ *	accepts it. Can be called by signal handlers.
+ */
+void int_request(int dev, BYTE data)
+{
+	cpu_ctx->int_vec[dev] = data;
+	__atomic_fetch_or(&cpu_ctx->int_req, 1U << dev, __ATOMIC_SEQ_CST);
+	int_type = INT_INT;
+	ev_attn();
+}
+
+/*
+ *	Interrupt request of device dev, which puts CALL adr onto
+ *	the data bus in IM 0. In IM 1 and IM 2 it's handled like
+ *	int_request() with vector 0xcd.
+ */
+void int_request_call(int dev, WORD adr)
+{
+	cpu_ctx->int_adr[dev] = adr;
+	int_request(dev, 0xcd);
+}
+
+/*
+ *	Remove the interrupt request of device dev, if it wasn't
+ *	accepted by the CPU yet
+ */
+void int_cancel(int dev)
+{
+	__atomic_fetch_and(&cpu_ctx->int_req, ~(1U << dev), __ATOMIC_SEQ_CST);
+}
+
+/*
+ *	RETI was executed, the device with the highest priority
+ *	in service is done and the devices behind it can interrupt
+ */
+void int_reti(void)
+{
+	if (cpu_ctx->int_ack == 0)
+		return;
+	cpu_ctx->int_ack &= cpu_ctx->int_ack - 1;
+	if (__atomic_load_n(&cpu_ctx->int_req, __ATOMIC_SEQ_CST)) {
+		int_type = INT_INT;
+		ev_attn();
+	}
+}
 
-	do {
+/*
+ *	Remove all interrupt requests and the devices in service
+ */
+void int_reset(void)
+{
+	__atomic_store_n(&cpu_ctx->int_req, 0, __ATOMIC_SEQ_CST);
+	cpu_ctx->int_ack = 0;
+	cpu_ctx->int_ei = 0;
+	int_type = INT_NONE;
+}
+#endif
 
+/*
+ *	This function does all the work needed before an opcode
+ *	is executed: frontpanel and history update, start of the
+ *	runtime measurement, handling of the scheduled events
+ *	and CPU interrupts, the record of the execution trace and
+ *	the profile count.
+ *	feat are the debugging features switched on, it's a
+ *	constant in the specialized run loops.
+ */
+static inline __attribute__ ((always_inline)) void pre_op_f(const int feat)
+{
 #ifdef FRONTPANEL	/* update frontpanel */
-		fp_led_address = PC - ram;
-		fp_led_data = *PC;
-		fp_sampleData();
+	fp_led_address = PC - ram;
+	fp_led_data = *PC;
+	fp_sampleData();
 #endif
 
 #ifdef BUS_8080
-		cpu_bus = CPU_WO | CPU_M1 | CPU_MEMR;
+	cpu_bus = CPU_WO | CPU_M1 | CPU_MEMR;
 #endif
 #ifdef FRONTPANEL
-		fp_clock += 7;
-		fp_sampleLightGroup(0, 0);
+	fp_clock += 7;
+	fp_sampleLightGroup(0, 0);
 #endif
 
 #ifdef HISIZE		/* write history */
-		his[h_next].h_adr = PC - ram;
-		his[h_next].h_af = (A << 8) + F;
-		his[h_next].h_bc = (B << 8) + C;
-		his[h_next].h_de = (D << 8) + E;
-		his[h_next].h_hl = (H << 8) + L;
-		his[h_next].h_ix = IX;
-		his[h_next].h_iy = IY;
-		his[h_next].h_sp = STACK - ram;
-		h_next++;
-		if (h_next == HISIZE) {
-			h_flag = 1;
-			h_next = 0;
-		}
+	if (feat & CPU_HIS) {
+		register struct history *e = &h_raw[h_nraw];
+
+		LF_EVAL();
+		e->h_adr = PC - ram;
+		e->h_reg[0] = (A << 8) + F;
+		e->h_reg[1] = (B << 8) + C;
+		e->h_reg[2] = (D << 8) + E;
+		e->h_reg[3] = (H << 8) + L;
+		e->h_reg[4] = IX;
+		e->h_reg[5] = IY;
+		e->h_reg[6] = STACK - ram;
+		if (++h_nraw == H_RAW)	/* compress them into the history */
+			his_flush();
+	}
 #endif
 
 #ifdef WANT_TIM		/* check for start address of runtime measurement */
-		if (PC == t_start && !t_flag) {
-			t_flag = 1;	/* switch measurement on */
-			t_states = 0L;	/* initialize counted T-states */
-		}
+	if ((feat & CPU_TIM) && PC == t_start && !t_flag) {
+		t_flag = 1;	/* switch measurement on */
+		t_states = 0L;	/* initialize counted T-states */
+	}
 #endif
 
-#ifdef WANT_INT		/* CPU interrupt handling */
-		if (int_type)
-			switch (int_type) {
-			case INT_NMI:	/* non maskable interrupt */
-				int_type = INT_NONE;
-				IFF <<= 1;
-#ifdef WANT_SPC
-				if (STACK <= ram)
-					STACK =	ram + 65536L;
-#endif
-				*--STACK = (PC - ram) >> 8;
-#ifdef WANT_SPC
-				if (STACK <= ram)
-					STACK =	ram + 65536L;
-#endif
-				*--STACK = (PC - ram);
-				PC = ram + 0x66;
-				break;
-			case INT_INT:	/* maskable interrupt */
-				if (IFF != 3)
-					break;
-				IFF = 0;
-				switch (int_mode) {
-				case 0:
-					break;
-				case 1:
-					int_type = INT_NONE;
-#ifdef WANT_SPC
-					if (STACK <= ram)
-						STACK =	ram + 65536L;
-#endif
-					*--STACK = (PC - ram) >> 8;
-#ifdef WANT_SPC
-					if (STACK <= ram)
-						STACK =	ram + 65536L;
-#endif
-					*--STACK = (PC - ram);
-					PC = ram + 0x38;
-					break;
-				case 2:
-					break;
-				}
-				break;
-			}
+	if (ev_clock >= ev_next) {	/* events due or attention */
+#ifdef WANT_TRACE
+		tr_cur = NULL;	/* no effects of the last opcode */
 #endif
-
-#ifdef WANT_TIM
-#ifdef FRONTPANEL
-		states = (*op_sim[*PC++]) ();	/* execute next opcode */
-		t += states;
-		fp_clock += states;
-#else
-		t += (*op_sim[*PC++]) ();
+		ev_run();
+#ifdef WANT_INT
+		if (int_type || cpu_ctx->int_ei)
+			cpu_int();
 #endif
-		if (f_flag) {		/* adjust CPU speed */
-			if (t > tmax) {
-				timer.tv_sec = 0;
-				timer.tv_nsec = 10000000;
-				nanosleep(&timer, NULL);
-				t = 0;
-			}
+	}
+
+#ifdef WANT_TRACE	/* write trace record */
+	if (feat & CPU_TRC) {
+		register struct trace *t;
+		register WORD adr = PC - ram;
+
+		if (!(tr_head & (TR_CHUNK - 1)))
+			tr_next();	/* publish the chunk, wait for room */
+		t = tr_cur = &tr_ring[tr_head++ & (TR_RING - 1)];
+		LF_EVAL();
+		t->t_clock = ev_clock;
+		t->t_pc = adr;
+		if (adr <= 65532)
+			memcpy(t->t_op, PC, 4);
+		else {
+			t->t_op[0] = *(ram + adr);
+			t->t_op[1] = *(ram + (WORD) (adr + 1));
+			t->t_op[2] = *(ram + (WORD) (adr + 2));
+			t->t_op[3] = *(ram + (WORD) (adr + 3));
 		}
-#else
-		(*op_sim[*PC++]) ();
+		t->t_reg[0] = (A << 8) + F;
+		t->t_reg[1] = (B << 8) + C;
+		t->t_reg[2] = (D << 8) + E;
+		t->t_reg[3] = (H << 8) + L;
+		t->t_reg[4] = IX;
+		t->t_reg[5] = IY;
+		t->t_reg[6] = STACK - ram;
+		t->t_mcnt = 0;
+		t->t_eff = 0;
+	}
+#endif
+
+#ifdef WANT_PROF	/* count execution, prefixes belong to the opcode */
+	if (feat & CPU_PRF) {
+		p_adr = PC - ram;
+		p_cnt[p_adr]++;
+	}
+#endif
+}
+
+/*
+ *	This function does all the work needed after an opcode
+ *	was executed: counting of the T-states, PC overrun handling,
+ *	refresh register, runtime measurement, profile and the
+ *	check for a breakpoint at the next opcode.
+ *	states are the T-states used by the opcode.
+ */
+static inline __attribute__ ((always_inline)) void post_op_f(const int feat,
+							     int states)
+{
+	ev_clock += states;	/* time for the event scheduler */
+#if defined(WANT_TIM) && defined(FRONTPANEL)
+	fp_clock += states;
 #endif
 
 #ifdef WANT_PCC
-		if (PC > ram + 65535)	/* check for PC overrun */
-			PC = ram;
+	if (PC > ram + 65535)	/* check for PC overrun */
+		PC = ram;
 #endif
 
-		R++;			/* increment refresh register */
+	R++;			/* increment refresh register */
+#ifdef WANT_HOST
+	cpu_ctx->ops++;		/* count instructions of the machine */
+#endif
 
 #ifdef WANT_TIM				/* do runtime measurement */
-		if (t_flag) {
-			t_states += t;	/* add T-states for this opcode */
-			if (PC == t_end) /* check for end address */
-				t_flag = 0; /* if reached, switch off */
+	if ((feat & CPU_TIM) && t_flag) {
+		t_states += states; /* add T-states for this opcode */
+		if (PC == t_end) /* check for end address */
+			t_flag = 0; /* if reached, switch off */
+	}
+#endif
+
+#ifdef WANT_PROF			/* add T-states to the profile */
+	if (feat & CPU_PRF)
+		p_tim[p_adr] += states;
+#endif
+
+#ifdef SBSIZE				/* stop before a breakpoint */
+	if (feat & CPU_BRK) {
+		register WORD adr = PC - ram;
+
+		if ((sb_map[adr >> 6] >> (adr & 63)) & 1 && sb_hit()) {
+			cpu_error = BRKPOINT;
+			cpu_state = STOPPED;
 		}
+	}
 #endif
 
 #ifdef WANT_GUI
-                check_gui_break();
+	check_gui_break();
+#endif
+}
+
+/*
+ *	Initialize the flag tables used by the 8 bit arithmetic
+ *	and logical opcodes, so that they can compute the flags
+ *	without any tests and branches. The undocumented flag
+ *	bits 3 and 5 aren't part of the tables.
+ */
+void init_alu(void)
+{
+	register int a, b, c, r, f;
+
+	for (a = 0; a < 256; a++) {
+		sz_flag[a] = ((a & 128) ? S_FLAG : 0) | (a ? 0 : Z_FLAG);
+		szp_flag[a] = sz_flag[a] | (parrity[a] ? 0 : P_FLAG);
+		szhv_inc[a] = sz_flag[a] | ((a & 0xf) ? 0 : H_FLAG)
+			      | ((a == 128) ? P_FLAG : 0);
+		szhv_dec[a] = sz_flag[a] | (((a & 0xf) == 0xf) ? H_FLAG : 0)
+			      | ((a == 127) ? P_FLAG : 0) | N_FLAG;
+	}
+	for (c = 0; c < 2; c++)
+		for (a = 0; a < 256; a++)
+			for (b = 0; b < 256; b++) {
+				r = a + b + c;
+				f = sz_flag[r & 0xff] | ((a ^ b ^ r) & H_FLAG);
+				if (r > 255)
+					f |= C_FLAG;
+				if ((a ^ r) & (b ^ r) & 128)
+					f |= P_FLAG;	/* overflow */
+				add_flag[c][a][b] = f;
+				r = a - b - c;
+				f = sz_flag[r & 0xff] | ((a ^ b ^ r) & H_FLAG) | N_FLAG;
+				if (r < 0)
+					f |= C_FLAG;
+				if ((a ^ b) & (a ^ r) & 128)
+					f |= P_FLAG;	/* overflow */
+				sub_flag[c][a][b] = f;
+			}
+}
+
+#ifdef WANT_LAZYF
+/*
+ *	Lazy evaluation of the flags.
+ *	The 8 bit arithmetic and logical opcodes without prefix
+ *	don't compute the flags, they only save the operands or
+ *	the result and the kind of the operation. Most of the time
+ *	the flags are overwritten by the next such opcode before
+ *	they are used. All opcodes using F call LF_EVAL() first,
+ *	which computes F with lf_flags() if flags are pending,
+ *	opcodes only using the carry get it from lf_carry().
+ *	The prefix handlers do this for the opcodes with prefix,
+ *	and cpu() before it returns, so that F is always valid
+ *	outside of the CPU emulation (register display, save_core()).
+ */
+#define LF_NONE		0	/* F is valid */
+#define LF_ADD		1	/* ADD/ADC lf_a + lf_b + lf_c */
+#define LF_SUB		2	/* SUB/SBC/CP lf_a - lf_b - lf_c */
+#define LF_AND		3	/* AND with result lf_a */
+#define LF_OR		4	/* OR/XOR with result lf_a */
+#define LF_INC		5	/* INC with result lf_a, carry lf_c */
+#define LF_DEC		6	/* DEC with result lf_a, carry lf_c */
+
+/*
+ *	Compute the pending flags into F, the undocumented
+ *	flag bits 3 and 5 aren't modified, like in the opcodes
+ */
+void lf_flags(void)
+{
+	register int f;
+
+	switch (lf_op) {
+	case LF_ADD:
+		f = add_flag[lf_c][lf_a][lf_b];
+		break;
+	case LF_SUB:
+		f = sub_flag[lf_c][lf_a][lf_b];
+		break;
+	case LF_AND:
+		f = szp_flag[lf_a] | H_FLAG;
+		break;
+	case LF_OR:
+		f = szp_flag[lf_a];
+		break;
+	case LF_INC:
+		f = szhv_inc[lf_a] | lf_c;
+		break;
+	case LF_DEC:
+		f = szhv_dec[lf_a] | lf_c;
+		break;
+	default:
+		return;
+	}
+	F = (F & (N2_FLAG | N1_FLAG)) | f;
+	lf_op = LF_NONE;
+}
+
+/*
+ *	Carry flag of the pending flags
+ */
+static inline int lf_carry(void)
+{
+	switch (lf_op) {
+	case LF_ADD:
+		return((lf_a + lf_b + lf_c) >> 8);
+	case LF_SUB:
+		return((lf_a - lf_b - lf_c) < 0);
+	case LF_AND:
+	case LF_OR:
+		return(0);
+	case LF_INC:
+	case LF_DEC:
+		return(lf_c);
+	default:
+		return(F & C_FLAG);
+	}
+}
+
+static inline void lf_add(BYTE n)	/* A = A + n */
+{
+	lf_a = A;
+	lf_b = n;
+	lf_c = 0;
+	lf_op = LF_ADD;
+	A += n;
+}
+
+static inline void lf_adc(BYTE n)	/* A = A + n + carry */
+{
+	lf_c = lf_carry();
+	lf_a = A;
+	lf_b = n;
+	lf_op = LF_ADD;
+	A += n + lf_c;
+}
+
+static inline void lf_sub(BYTE n)	/* A = A - n */
+{
+	lf_a = A;
+	lf_b = n;
+	lf_c = 0;
+	lf_op = LF_SUB;
+	A -= n;
+}
+
+static inline void lf_sbc(BYTE n)	/* A = A - n - carry */
+{
+	lf_c = lf_carry();
+	lf_a = A;
+	lf_b = n;
+	lf_op = LF_SUB;
+	A -= n + lf_c;
+}
+
+static inline void lf_cp(BYTE n)	/* compare A with n */
+{
+	lf_a = A;
+	lf_b = n;
+	lf_c = 0;
+	lf_op = LF_SUB;
+}
+
+static inline void lf_and(BYTE n)	/* A = A & n */
+{
+	lf_a = A &= n;
+	lf_op = LF_AND;
+}
+
+static inline void lf_or(BYTE n)	/* A = A | n */
+{
+	lf_a = A |= n;
+	lf_op = LF_OR;
+}
+
+static inline void lf_xor(BYTE n)	/* A = A ^ n */
+{
+	lf_a = A ^= n;
+	lf_op = LF_OR;
+}
+
+static inline void lf_inc(BYTE r)	/* r is the incremented value */
+{
+	lf_c = lf_carry();		/* carry isn't modified */
+	lf_a = r;
+	lf_op = LF_INC;
+}
+
+static inline void lf_dec(BYTE r)	/* r is the decremented value */
+{
+	lf_c = lf_carry();		/* carry isn't modified */
+	lf_a = r;
+	lf_op = LF_DEC;
+}
+#endif
+
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for the
+ *	first byte of all opcodes.
+ */
+static int (*op_sim[256]) (void) =	{
+	op_nop,				/* 0x00	*/
+	op_ldbcnn,			/* 0x01	*/
+	op_ldbca,			/* 0x02	*/
+	op_incbc,			/* 0x03	*/
+	op_incb,			/* 0x04	*/
+	op_decb,			/* 0x05	*/
+	op_ldbn,			/* 0x06	*/
+	op_rlca,			/* 0x07	*/
+	op_exafaf,			/* 0x08	*/
+	op_adhlbc,			/* 0x09	*/
+	op_ldabc,			/* 0x0a	*/
+	op_decbc,			/* 0x0b	*/
+	op_incc,			/* 0x0c	*/
+	op_decc,			/* 0x0d	*/
+	op_ldcn,			/* 0x0e	*/
+	op_rrca,			/* 0x0f	*/
+	op_djnz,			/* 0x10	*/
+	op_lddenn,			/* 0x11	*/
+	op_lddea,			/* 0x12	*/
+	op_incde,			/* 0x13	*/
+	op_incd,			/* 0x14	*/
+	op_decd,			/* 0x15	*/
+	op_lddn,			/* 0x16	*/
+	op_rla,				/* 0x17	*/
+	op_jr,				/* 0x18	*/
+	op_adhlde,			/* 0x19	*/
+	op_ldade,			/* 0x1a	*/
+	op_decde,			/* 0x1b	*/
+	op_ince,			/* 0x1c	*/
+	op_dece,			/* 0x1d	*/
+	op_lden,			/* 0x1e	*/
+	op_rra,				/* 0x1f	*/
+	op_jrnz,			/* 0x20	*/
+	op_ldhlnn,			/* 0x21	*/
+	op_ldinhl,			/* 0x22	*/
+	op_inchl,			/* 0x23	*/
+	op_inch,			/* 0x24	*/
+	op_dech,			/* 0x25	*/
+	op_ldhn,			/* 0x26	*/
+	op_daa,				/* 0x27	*/
+	op_jrz,				/* 0x28	*/
+	op_adhlhl,			/* 0x29	*/
+	op_ldhlin,			/* 0x2a	*/
+	op_dechl,			/* 0x2b	*/
+	op_incl,			/* 0x2c	*/
+	op_decl,			/* 0x2d	*/
+	op_ldln,			/* 0x2e	*/
+	op_cpl,				/* 0x2f	*/
+	op_jrnc,			/* 0x30	*/
+	op_ldspnn,			/* 0x31	*/
+	op_ldnna,			/* 0x32	*/
+	op_incsp,			/* 0x33	*/
+	op_incihl,			/* 0x34	*/
+	op_decihl,			/* 0x35	*/
+	op_ldhl1,			/* 0x36	*/
+	op_scf,				/* 0x37	*/
+	op_jrc,				/* 0x38	*/
+	op_adhlsp,			/* 0x39	*/
+	op_ldann,			/* 0x3a	*/
+	op_decsp,			/* 0x3b	*/
+	op_inca,			/* 0x3c	*/
+	op_deca,			/* 0x3d	*/
+	op_ldan,			/* 0x3e	*/
+	op_ccf,				/* 0x3f	*/
+	op_ldbb,			/* 0x40	*/
+	op_ldbc,			/* 0x41	*/
+	op_ldbd,			/* 0x42	*/
+	op_ldbe,			/* 0x43	*/
+	op_ldbh,			/* 0x44	*/
+	op_ldbl,			/* 0x45	*/
+	op_ldbhl,			/* 0x46	*/
+	op_ldba,			/* 0x47	*/
+	op_ldcb,			/* 0x48	*/
+	op_ldcc,			/* 0x49	*/
+	op_ldcd,			/* 0x4a	*/
+	op_ldce,			/* 0x4b	*/
+	op_ldch,			/* 0x4c	*/
+	op_ldcl,			/* 0x4d	*/
+	op_ldchl,			/* 0x4e	*/
+	op_ldca,			/* 0x4f	*/
+	op_lddb,			/* 0x50	*/
+	op_lddc,			/* 0x51	*/
+	op_lddd,			/* 0x52	*/
+	op_ldde,			/* 0x53	*/
+	op_lddh,			/* 0x54	*/
+	op_lddl,			/* 0x55	*/
+	op_lddhl,			/* 0x56	*/
+	op_ldda,			/* 0x57	*/
+	op_ldeb,			/* 0x58	*/
+	op_ldec,			/* 0x59	*/
+	op_lded,			/* 0x5a	*/
+	op_ldee,			/* 0x5b	*/
+	op_ldeh,			/* 0x5c	*/
+	op_ldel,			/* 0x5d	*/
+	op_ldehl,			/* 0x5e	*/
+	op_ldea,			/* 0x5f	*/
+	op_ldhb,			/* 0x60	*/
+	op_ldhc,			/* 0x61	*/
+	op_ldhd,			/* 0x62	*/
+	op_ldhe,			/* 0x63	*/
+	op_ldhh,			/* 0x64	*/
+	op_ldhl,			/* 0x65	*/
+	op_ldhhl,			/* 0x66	*/
+	op_ldha,			/* 0x67	*/
+	op_ldlb,			/* 0x68	*/
+	op_ldlc,			/* 0x69	*/
+	op_ldld,			/* 0x6a	*/
+	op_ldle,			/* 0x6b	*/
+	op_ldlh,			/* 0x6c	*/
+	op_ldll,			/* 0x6d	*/
+	op_ldlhl,			/* 0x6e	*/
+	op_ldla,			/* 0x6f	*/
+	op_ldhlb,			/* 0x70	*/
+	op_ldhlc,			/* 0x71	*/
+	op_ldhld,			/* 0x72	*/
+	op_ldhle,			/* 0x73	*/
+	op_ldhlh,			/* 0x74	*/
+	op_ldhll,			/* 0x75	*/
+	op_halt,			/* 0x76	*/
+	op_ldhla,			/* 0x77	*/
+	op_ldab,			/* 0x78	*/
+	op_ldac,			/* 0x79	*/
+	op_ldad,			/* 0x7a	*/
+	op_ldae,			/* 0x7b	*/
+	op_ldah,			/* 0x7c	*/
+	op_ldal,			/* 0x7d	*/
+	op_ldahl,			/* 0x7e	*/
+	op_ldaa,			/* 0x7f	*/
+	op_addb,			/* 0x80	*/
+	op_addc,			/* 0x81	*/
+	op_addd,			/* 0x82	*/
+	op_adde,			/* 0x83	*/
+	op_addh,			/* 0x84	*/
+	op_addl,			/* 0x85	*/
+	op_addhl,			/* 0x86	*/
+	op_adda,			/* 0x87	*/
+	op_adcb,			/* 0x88	*/
+	op_adcc,			/* 0x89	*/
+	op_adcd,			/* 0x8a	*/
+	op_adce,			/* 0x8b	*/
+	op_adch,			/* 0x8c	*/
+	op_adcl,			/* 0x8d	*/
+	op_adchl,			/* 0x8e	*/
+	op_adca,			/* 0x8f	*/
+	op_subb,			/* 0x90	*/
+	op_subc,			/* 0x91	*/
+	op_subd,			/* 0x92	*/
+	op_sube,			/* 0x93	*/
+	op_subh,			/* 0x94	*/
+	op_subl,			/* 0x95	*/
+	op_subhl,			/* 0x96	*/
+	op_suba,			/* 0x97	*/
+	op_sbcb,			/* 0x98	*/
+	op_sbcc,			/* 0x99	*/
+	op_sbcd,			/* 0x9a	*/
+	op_sbce,			/* 0x9b	*/
+	op_sbch,			/* 0x9c	*/
+	op_sbcl,			/* 0x9d	*/
+	op_sbchl,			/* 0x9e	*/
+	op_sbca,			/* 0x9f	*/
+	op_andb,			/* 0xa0	*/
+	op_andc,			/* 0xa1	*/
+	op_andd,			/* 0xa2	*/
+	op_ande,			/* 0xa3	*/
+	op_andh,			/* 0xa4	*/
+	op_andl,			/* 0xa5	*/
+	op_andhl,			/* 0xa6	*/
+	op_anda,			/* 0xa7	*/
+	op_xorb,			/* 0xa8	*/
+	op_xorc,			/* 0xa9	*/
+	op_xord,			/* 0xaa	*/
+	op_xore,			/* 0xab	*/
+	op_xorh,			/* 0xac	*/
+	op_xorl,			/* 0xad	*/
+	op_xorhl,			/* 0xae	*/
+	op_xora,			/* 0xaf	*/
+	op_orb,				/* 0xb0	*/
+	op_orc,				/* 0xb1	*/
+	op_ord,				/* 0xb2	*/
+	op_ore,				/* 0xb3	*/
+	op_orh,				/* 0xb4	*/
+	op_orl,				/* 0xb5	*/
+	op_orhl,			/* 0xb6	*/
+	op_ora,				/* 0xb7	*/
+	op_cpb,				/* 0xb8	*/
+	op_cpc,				/* 0xb9	*/
+	op_cpd,				/* 0xba	*/
+	op_cpe,				/* 0xbb	*/
+	op_cph,				/* 0xbc	*/
+	op_cplr,			/* 0xbd	*/
+	op_cphl,			/* 0xbe	*/
+	op_cpa,				/* 0xbf	*/
+	op_retnz,			/* 0xc0	*/
+	op_popbc,			/* 0xc1	*/
+	op_jpnz,			/* 0xc2	*/
+	op_jp,				/* 0xc3	*/
+	op_calnz,			/* 0xc4	*/
+	op_pushbc,			/* 0xc5	*/
+	op_addn,			/* 0xc6	*/
+	op_rst00,			/* 0xc7	*/
+	op_retz,			/* 0xc8	*/
+	op_ret,				/* 0xc9	*/
+	op_jpz,				/* 0xca	*/
+	op_cb_handel,			/* 0xcb	*/
+	op_calz,			/* 0xcc	*/
+	op_call,			/* 0xcd	*/
+	op_adcn,			/* 0xce	*/
+	op_rst08,			/* 0xcf	*/
+	op_retnc,			/* 0xd0	*/
+	op_popde,			/* 0xd1	*/
+	op_jpnc,			/* 0xd2	*/
+	op_out,				/* 0xd3	*/
+	op_calnc,			/* 0xd4	*/
+	op_pushde,			/* 0xd5	*/
+	op_subn,			/* 0xd6	*/
+	op_rst10,			/* 0xd7	*/
+	op_retc,			/* 0xd8	*/
+	op_exx,				/* 0xd9	*/
+	op_jpc,				/* 0xda	*/
+	op_in,				/* 0xdb	*/
+	op_calc,			/* 0xdc	*/
+	op_dd_handel,			/* 0xdd	*/
+	op_sbcn,			/* 0xde	*/
+	op_rst18,			/* 0xdf	*/
+	op_retpo,			/* 0xe0	*/
+	op_pophl,			/* 0xe1	*/
+	op_jppo,			/* 0xe2	*/
+	op_exsphl,			/* 0xe3	*/
+	op_calpo,			/* 0xe4	*/
+	op_pushhl,			/* 0xe5	*/
+	op_andn,			/* 0xe6	*/
+	op_rst20,			/* 0xe7	*/
+	op_retpe,			/* 0xe8	*/
+	op_jphl,			/* 0xe9	*/
+	op_jppe,			/* 0xea	*/
+	op_exdehl,			/* 0xeb	*/
+	op_calpe,			/* 0xec	*/
+	op_ed_handel,			/* 0xed	*/
+	op_xorn,			/* 0xee	*/
+	op_rst28,			/* 0xef	*/
+	op_retp,			/* 0xf0	*/
+	op_popaf,			/* 0xf1	*/
+	op_jpp,				/* 0xf2	*/
+	op_di,				/* 0xf3	*/
+	op_calp,			/* 0xf4	*/
+	op_pushaf,			/* 0xf5	*/
+	op_orn,				/* 0xf6	*/
+	op_rst30,			/* 0xf7	*/
+	op_retm,			/* 0xf8	*/
+	op_ldsphl,			/* 0xf9	*/
+	op_jpm,				/* 0xfa	*/
+	op_ei,				/* 0xfb	*/
+	op_calm,			/* 0xfc	*/
+	op_fd_handel,			/* 0xfd	*/
+	op_cpn,				/* 0xfe	*/
+	op_rst38			/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch. The opcode
+ *	functions are called direct, so that the compiler can inline
+ *	them, and every opcode dispatches the next one by itself.
+ */
+#define OP_THR(f)	l_##f: post_op_f(CPU_FEAT, f());		\
+			if (__atomic_load_n(&cpu_state, __ATOMIC_RELAXED) \
+			    != CONTIN_RUN) goto leave;			\
+			pre_op_f(CPU_FEAT);				\
+			goto *op_sim_thr[*PC++]
+#endif
+
+/*
+ *	Specialized run loops, see simloop.h
+ */
+#define CPU_LOOP	cpu_fast
+#define CPU_FEAT	0
+#include "simloop.h"
+#ifdef HISIZE
+#define CPU_LOOP	cpu_his
+#define CPU_FEAT	CPU_HIS
+#include "simloop.h"
+#endif
+#ifdef WANT_TIM
+#define CPU_LOOP	cpu_tim
+#define CPU_FEAT	CPU_TIM
+#include "simloop.h"
+#endif
+#if defined(HISIZE) && defined(WANT_TIM)
+#define CPU_LOOP	cpu_his_tim
+#define CPU_FEAT	(CPU_HIS | CPU_TIM)
+#include "simloop.h"
+#endif
+#ifdef CPU_ANY
+#define CPU_LOOP	cpu_any		/* features selected at runtime */
+#define CPU_FEAT	cpu_feat
+#include "simloop.h"
+#endif
+
+/*
+ *	This function builds the Z80 central processing unit.
+ *	The opcode where PC points to is fetched from the memory
+ *	and PC incremented by one. The opcode is used as an
+ *	index to an array with function pointers, to execute a
+ *	function which emulates this Z80 opcode.
+ *	With WANT_THREADED the array contains the addresses of labels
+ *	inside of this function instead, and the opcodes are dispatched
+ *	with computed gotos (GNU C), without indirect function calls.
+ *	A run loop specialized for the debugging features switched
+ *	on is used, so that option -b (batch) or the history switched
+ *	off with "h off" runs the CPU without their overhead. With the
+ *	execution trace, the profiler or breakpoints a run loop for
+ *	all features is used.
+ *	Watchpoints are checked by the memory functions in simmem.h.
+ */
+void cpu(void)
+{
+	ev_init();		/* schedule CPU speed adjustment */
+
+	cpu_feat = 0;		/* select the debugging features */
+#ifdef HISIZE			/* only for the machine of the monitor */
+	if (!b_flag && h_on && cpu_ctx == &cpu0 && his_init())
+		cpu_feat |= CPU_HIS;
+#endif
+#ifdef WANT_TIM
+	if (!b_flag)
+		cpu_feat |= CPU_TIM;
+#endif
+#ifdef WANT_TRACE		/* only for the machine of the monitor */
+	if (tr_on && cpu_ctx == &cpu0)
+		cpu_feat |= CPU_TRC;
+#endif
+#ifdef WANT_PROF
+	if (!b_flag && p_on && cpu_ctx == &cpu0)
+		cpu_feat |= CPU_PRF;
+#endif
+#ifdef SBSIZE
+	if (sb_armed && cpu_ctx == &cpu0)
+		cpu_feat |= CPU_BRK;
+#endif
+#ifdef WANT_WATCH		/* only for the machine of the monitor */
+	wp_run = (wp_armed && cpu_ctx == &cpu0);
+#endif
+
+	switch (cpu_feat) {
+#if defined(HISIZE) && defined(WANT_TIM)
+	case CPU_HIS | CPU_TIM:
+		cpu_his_tim();
+		break;
+#endif
+#ifdef HISIZE
+	case CPU_HIS:
+		cpu_his();
+		break;
+#endif
+#ifdef WANT_TIM
+	case CPU_TIM:
+		cpu_tim();
+		break;
+#endif
+	default:
+#ifdef CPU_ANY
+		if (cpu_feat & CPU_DYN) {
+			cpu_any();
+			break;
+		}
+#endif
+		cpu_fast();
+		break;
+	}
+
+#ifdef WANT_TRACE
+	if (cpu_feat & CPU_TRC)
+		tr_sync();		/* trace complete in the file */
+#endif
+#ifdef WANT_WATCH
+	wp_run = 0;			/* the monitor may write the memory */
+#endif
+#ifdef WANT_MIRROR
+	mem_wrap();			/* PC and SP out of the mirrors */
 #endif
 
-	} while	(cpu_state == CONTIN_RUN);
+	LF_EVAL();			/* F must be valid outside */
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_M1 | CPU_MEMR;
@@ -541,7 +1071,9 @@ static int op_nop(void)			/* NOP */
 static int op_halt(void)		/* HALT */
 {
 	extern int busy_loop_cnt[];
+#ifdef FRONTPANEL
 	struct timespec timer;
+#endif
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_HLTA | CPU_MEMR;
@@ -552,17 +1084,27 @@ static int op_halt(void)		/* HALT */
 		cpu_error = OPHALT;
 		cpu_state = STOPPED;
 	} else
-#endif
-		while ((int_type == 0) && (cpu_state == CONTIN_RUN)) {
-#ifdef FRONTPANEL
-			fp_clock += 4;
-			fp_sampleData();
-#endif
-			timer.tv_sec = 0;
-			timer.tv_nsec = 1000000L;
-			nanosleep(&timer, NULL);
-			R += 9999;
+		ev_idle();
+#else
+	/* the frontpanel must be sampled while the CPU is halted */
+	while ((int_type == 0) && (cpu_state == CONTIN_RUN)) {
+		if (ev_next != EV_NEVER) {
+			/* let the time pass until the next event */
+			if (ev_next > ev_clock) {
+				R += (ev_next - ev_clock) / 4;
+				ev_clock = ev_next;
+			}
+			ev_run();
+			continue;
 		}
+		fp_clock += 4;
+		fp_sampleData();
+		timer.tv_sec = 0;
+		timer.tv_nsec = 1000000L;
+		nanosleep(&timer, NULL);
+		R += 9999;
+	}
+#endif
 
 	busy_loop_cnt[0] = 0;
 
@@ -571,6 +1113,7 @@ static int op_halt(void)		/* HALT */
 
 static int op_scf(void)			/* SCF */
 {
+	LF_EVAL();
 	F |= C_FLAG;
 	F &= ~(N_FLAG |	H_FLAG);
 	return(4);
@@ -578,6 +1121,7 @@ static int op_scf(void)			/* SCF */
 
 static int op_ccf(void)			/* CCF */
 {
+	LF_EVAL();
 	if (F &	C_FLAG)	{
 		F |= H_FLAG;
 		F &= ~C_FLAG;
@@ -591,6 +1135,7 @@ static int op_ccf(void)			/* CCF */
 
 static int op_cpl(void)			/* CPL */
 {
+	LF_EVAL();
 	A = ~A;
 	F |= H_FLAG | N_FLAG;
 	return(4);
@@ -600,6 +1145,7 @@ static int op_daa(void)			/* DAA */
 {
 	register int old_a;
 
+	LF_EVAL();
 	old_a =	A;
 	if (F &	N_FLAG)	{		/* subtractions */
 		if (((A	& 0x0f)	> 9) ||	(F & H_FLAG)) {
@@ -631,6 +1177,10 @@ static int op_daa(void)			/* DAA */
 static int op_ei(void)			/* EI */
 {
 	IFF = 3;
+#ifdef WANT_INT
+	cpu_ctx->int_ei = 1;	/* no interrupt before the next opcode, */
+	ev_attn();		/* also if it's requested after EI */
+#endif
 	return(4);
 }
 
@@ -760,7 +1310,7 @@ static int op_ldabc(void)		/* LD A,(BC) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A = *(ram + (B << 8) + C);
+	A = memrdr((B << 8) + C);
 	return(7);
 }
 
@@ -772,7 +1322,7 @@ static int op_ldade(void)		/* LD A,(DE) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A = *(ram + (D << 8) + E);
+	A = memrdr((D << 8) + E);
 	return(7);
 }
 
@@ -788,7 +1338,7 @@ static int op_ldann(void)		/* LD A,(nn) */
 #endif
 	i = *PC++;
 	i += *PC++ << 8;
-	A = *(ram + i);
+	A = memrdr(i);
 	return(13);
 }
 
@@ -800,7 +1350,7 @@ static int op_ldbca(void)		/* LD (BC),A */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(B << 8) + C) =	A;
+	memwrt((B << 8) + C, A);
 	return(7);
 }
 
@@ -812,7 +1362,7 @@ static int op_lddea(void)		/* LD (DE),A */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(D << 8) + E) =	A;
+	memwrt((D << 8) + E, A);
 	return(7);
 }
 
@@ -828,7 +1378,7 @@ static int op_ldnna(void)		/* LD (nn),A */
 #endif
 	i = *PC++;
 	i += *PC++ << 8;
-	*(ram +	i) = A;
+	memwrt(i, A);
 	return(13);
 }
 
@@ -840,7 +1390,7 @@ static int op_ldhla(void)		/* LD (HL),A */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	A;
+	memwrt((H << 8) + L, A);
 	return(7);
 }
 
@@ -852,7 +1402,7 @@ static int op_ldhlb(void)		/* LD (HL),B */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	B;
+	memwrt((H << 8) + L, B);
 	return(7);
 }
 
@@ -864,7 +1414,7 @@ static int op_ldhlc(void)		/* LD (HL),C */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	C;
+	memwrt((H << 8) + L, C);
 	return(7);
 }
 
@@ -876,7 +1426,7 @@ static int op_ldhld(void)		/* LD (HL),D */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	D;
+	memwrt((H << 8) + L, D);
 	return(7);
 }
 
@@ -888,7 +1438,7 @@ static int op_ldhle(void)		/* LD (HL),E */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	E;
+	memwrt((H << 8) + L, E);
 	return(7);
 }
 
@@ -900,7 +1450,7 @@ static int op_ldhlh(void)		/* LD (HL),H */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	H;
+	memwrt((H << 8) + L, H);
 	return(7);
 }
 
@@ -912,7 +1462,7 @@ static int op_ldhll(void)		/* LD (HL),L */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	L;
+	memwrt((H << 8) + L, L);
 	return(7);
 }
 
@@ -924,7 +1474,7 @@ static int op_ldhl1(void)		/* LD (HL),n */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	*PC++;
+	memwrt((H << 8) + L, *PC++);
 	return(10);
 }
 
@@ -977,7 +1527,7 @@ static int op_ldahl(void)		/* LD A,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A = *(ram + (H << 8) + L);
+	A = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1030,7 +1580,7 @@ static int op_ldbhl(void)		/* LD B,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	B = *(ram + (H << 8) + L);
+	B = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1083,7 +1633,7 @@ static int op_ldchl(void)		/* LD C,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	C = *(ram + (H << 8) + L);
+	C = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1136,7 +1686,7 @@ static int op_lddhl(void)		/* LD D,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	D = *(ram + (H << 8) + L);
+	D = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1189,7 +1739,7 @@ static int op_ldehl(void)		/* LD E,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	E = *(ram + (H << 8) + L);
+	E = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1242,7 +1792,7 @@ static int op_ldhhl(void)		/* LD H,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	H = *(ram + (H << 8) + L);
+	H = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1295,7 +1845,7 @@ static int op_ldlhl(void)		/* LD L,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	L = *(ram + (H << 8) + L);
+	L = memrdr((H << 8) + L);
 	return(7);
 }
 
@@ -1369,8 +1919,8 @@ static int op_ldhlin(void)		/* LD HL,(nn) */
 #endif
 	i = *PC++;
 	i += *PC++ << 8;
-	L = *(ram + i);
-	H = *(ram + i +	1);
+	L = memrdr(i);
+	H = memrdr(i +	1);
 	return(16);
 }
 
@@ -1386,8 +1936,8 @@ static int op_ldinhl(void)		/* LD (nn),HL */
 #endif
 	i = *PC++;
 	i += *PC++ << 8;
-	*(ram +	i) = L;
-	*(ram +	i + 1) = H;
+	memwrt(i, L);
+	memwrt(i + 1, H);
 	return(16);
 }
 
@@ -1463,6 +2013,7 @@ static int op_adhlbc(void)		/* ADD HL,BC */
 {
 	register int carry;
 
+	LF_EVAL();
 	carry = (L + C > 255) ? 1 : 0;
 	L += C;
 	((H & 0xf) + (B & 0xf) + carry > 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
@@ -1476,6 +2027,7 @@ static int op_adhlde(void)		/* ADD HL,DE */
 {
 	register int carry;
 
+	LF_EVAL();
 	carry = (L + E > 255) ? 1 : 0;
 	L += E;
 	((H & 0xf) + (D & 0xf) + carry > 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
@@ -1489,6 +2041,7 @@ static int op_adhlhl(void)		/* ADD HL,HL */
 {
 	register int carry;
 
+	LF_EVAL();
 	carry = (L << 1 > 255) ? 1 : 0;
 	L <<= 1;
 	((H & 0xf) + (H & 0xf) + carry > 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
@@ -1504,6 +2057,7 @@ static int op_adhlsp(void)		/* ADD HL,SP */
 	BYTE spl = (STACK - ram) & 0xff;
 	BYTE sph = (STACK - ram) >> 8;
 	
+	LF_EVAL();
 	carry = (L + spl > 255) ? 1 : 0;
 	L += spl;
 	((H & 0xf) + (sph & 0xf) + carry > 0xf) ? (F |= H_FLAG)
@@ -1516,77 +2070,77 @@ static int op_adhlsp(void)		/* ADD HL,SP */
 
 static int op_anda(void)		/* AND A */
 {
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+#ifdef WANT_LAZYF
+	lf_and(A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_andb(void)		/* AND B */
 {
+#ifdef WANT_LAZYF
+	lf_and(B);
+#else
 	A &= B;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_andc(void)		/* AND C */
 {
+#ifdef WANT_LAZYF
+	lf_and(C);
+#else
 	A &= C;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_andd(void)		/* AND D */
 {
+#ifdef WANT_LAZYF
+	lf_and(D);
+#else
 	A &= D;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_ande(void)		/* AND E */
 {
+#ifdef WANT_LAZYF
+	lf_and(E);
+#else
 	A &= E;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_andh(void)		/* AND H */
 {
+#ifdef WANT_LAZYF
+	lf_and(H);
+#else
 	A &= H;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
 static int op_andl(void)		/* AND L */
 {
+#ifdef WANT_LAZYF
+	lf_and(L);
+#else
 	A &= L;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(4);
 }
 
@@ -1598,12 +2152,12 @@ static int op_andhl(void)		/* AND (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A &= *(ram + (H	<< 8) +	L);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+#ifdef WANT_LAZYF
+	lf_and(memrdr((H	<< 8) +	L));
+#else
+	A &= memrdr((H	<< 8) +	L);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(7);
 }
 
@@ -1615,81 +2169,88 @@ static int op_andn(void)		/* AND n */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
+#ifdef WANT_LAZYF
+	lf_and(*PC++);
+#else
 	A &= *PC++;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
+#endif
 	return(7);
 }
 
 static int op_ora(void)			/* OR A */
 {
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+#ifdef WANT_LAZYF
+	lf_or(A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_orb(void)			/* OR B */
 {
+#ifdef WANT_LAZYF
+	lf_or(B);
+#else
 	A |= B;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_orc(void)			/* OR C */
 {
+#ifdef WANT_LAZYF
+	lf_or(C);
+#else
 	A |= C;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_ord(void)			/* OR D */
 {
+#ifdef WANT_LAZYF
+	lf_or(D);
+#else
 	A |= D;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_ore(void)			/* OR E */
 {
+#ifdef WANT_LAZYF
+	lf_or(E);
+#else
 	A |= E;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_orh(void)			/* OR H */
 {
+#ifdef WANT_LAZYF
+	lf_or(H);
+#else
 	A |= H;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_orl(void)			/* OR L */
 {
+#ifdef WANT_LAZYF
+	lf_or(L);
+#else
 	A |= L;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
@@ -1701,11 +2262,12 @@ static int op_orhl(void)		/* OR (HL)	*/
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A |= *(ram + (H	<< 8) +	L);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+#ifdef WANT_LAZYF
+	lf_or(memrdr((H	<< 8) +	L));
+#else
+	A |= memrdr((H	<< 8) +	L);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(7);
 }
 
@@ -1717,79 +2279,89 @@ static int op_orn(void)			/* OR n */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
+#ifdef WANT_LAZYF
+	lf_or(*PC++);
+#else
 	A |= *PC++;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(7);
 }
 
 static int op_xora(void)		/* XOR A */
 {
+#ifdef WANT_LAZYF
+	lf_xor(A);
+#else
 	A = 0;
-	F &= ~(S_FLAG |	H_FLAG | N_FLAG	| C_FLAG);
-	F |= Z_FLAG | P_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xorb(void)		/* XOR B */
 {
+#ifdef WANT_LAZYF
+	lf_xor(B);
+#else
 	A ^= B;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xorc(void)		/* XOR C */
 {
+#ifdef WANT_LAZYF
+	lf_xor(C);
+#else
 	A ^= C;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xord(void)		/* XOR D */
 {
+#ifdef WANT_LAZYF
+	lf_xor(D);
+#else
 	A ^= D;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xore(void)		/* XOR E */
 {
+#ifdef WANT_LAZYF
+	lf_xor(E);
+#else
 	A ^= E;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xorh(void)		/* XOR H */
 {
+#ifdef WANT_LAZYF
+	lf_xor(H);
+#else
 	A ^= H;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
 static int op_xorl(void)		/* XOR L */
 {
+#ifdef WANT_LAZYF
+	lf_xor(L);
+#else
 	A ^= L;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(4);
 }
 
@@ -1801,11 +2373,12 @@ static int op_xorhl(void)		/* XOR (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A ^= *(ram + (H	<< 8) +	L);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+#ifdef WANT_LAZYF
+	lf_xor(memrdr((H	<< 8) +	L));
+#else
+	A ^= memrdr((H	<< 8) +	L);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(7);
 }
 
@@ -1817,115 +2390,94 @@ static int op_xorn(void)		/* XOR n */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
+#ifdef WANT_LAZYF
+	lf_xor(*PC++);
+#else
 	A ^= *PC++;
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
+#endif
 	return(7);
 }
 
 static int op_adda(void)		/* ADD A,A */
 {
-	register int i;
-
-	((A & 0xf) + (A	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	((A << 1) > 255) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	A = i =	((signed char)	A) << 1;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][A];
+	A += A;
+#endif
 	return(4);
 }
 
 static int op_addb(void)		/* ADD A,B */
 {
-	register int i;
-
-	((A & 0xf) + (B	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + B > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) B;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(B);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][B];
+	A += B;
+#endif
 	return(4);
 }
 
 static int op_addc(void)		/* ADD A,C */
 {
-	register int i;
-
-	((A & 0xf) + (C	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + C > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) C;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(C);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][C];
+	A += C;
+#endif
 	return(4);
 }
 
 static int op_addd(void)		/* ADD A,D */
 {
-	register int i;
-
-	((A & 0xf) + (D	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + D > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) D;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(D);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][D];
+	A += D;
+#endif
 	return(4);
 }
 
 static int op_adde(void)		/* ADD A,E */
 {
-	register int i;
-
-	((A & 0xf) + (E	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + E > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) E;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(E);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][E];
+	A += E;
+#endif
 	return(4);
 }
 
 static int op_addh(void)		/* ADD A,H */
 {
-	register int i;
-
-	((A & 0xf) + (H	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + H > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) H;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(H);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][H];
+	A += H;
+#endif
 	return(4);
 }
 
 static int op_addl(void)		/* ADD A,L */
 {
-	register int i;
-
-	((A & 0xf) + (L	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + L > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) L;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(L);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][L];
+	A += L;
+#endif
 	return(4);
 }
 
 static int op_addhl(void)		/* ADD A,(HL) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -1934,20 +2486,18 @@ static int op_addhl(void)		/* ADD A,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + (H << 8) + L);
-	((A & 0xf) + (P	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr((H << 8) + L);
+#ifdef WANT_LAZYF
+	lf_add(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][P];
+	A += P;
+#endif
 	return(7);
 }
 
 static int op_addn(void)		/* ADD A,n */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -1957,124 +2507,118 @@ static int op_addn(void)		/* ADD A,n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	P = *PC++;
-	((A & 0xf) + (P	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_add(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][P];
+	A += P;
+#endif
 	return(7);
 }
 
 static int op_adca(void)		/* ADC A,A */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(A);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (A	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	((A << 1) + carry > 255) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	A = i =	(((signed char) A) << 1) + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][A];
+	A += A + carry;
+#endif
 	return(4);
 }
 
 static int op_adcb(void)		/* ADC A,B */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(B);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (B	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + B + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) B + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][B];
+	A += B + carry;
+#endif
 	return(4);
 }
 
 static int op_adcc(void)		/* ADC A,C */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(C);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (C	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + C + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) C + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][C];
+	A += C + carry;
+#endif
 	return(4);
 }
 
 static int op_adcd(void)		/* ADC A,D */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(D);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (D	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + D + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) D + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][D];
+	A += D + carry;
+#endif
 	return(4);
 }
 
 static int op_adce(void)		/* ADC A,E */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(E);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (E	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + E + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) E + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][E];
+	A += E + carry;
+#endif
 	return(4);
 }
 
 static int op_adch(void)		/* ADC A,H */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(H);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (H	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + H + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) H + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][H];
+	A += H + carry;
+#endif
 	return(4);
 }
 
 static int op_adcl(void)		/* ADC A,L */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_adc(L);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (L	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + L + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) L + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][L];
+	A += L + carry;
+#endif
 	return(4);
 }
 
 static int op_adchl(void)		/* ADC A,(HL) */
 {
-	register int i,	carry;
+#ifndef WANT_LAZYF
+	register int carry;
+#endif
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2083,21 +2627,22 @@ static int op_adchl(void)		/* ADC A,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + (H << 8) + L);
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((A & 0xf) + (P	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr((H << 8) + L);
+#ifdef WANT_LAZYF
+	lf_adc(P);
+#else
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][P];
+	A += P + carry;
+#endif
 	return(7);
 }
 
 static int op_adcn(void)		/* ADC A,n */
 {
-	register int i,	carry;
+#ifndef WANT_LAZYF
+	register int carry;
+#endif
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2106,113 +2651,96 @@ static int op_adcn(void)		/* ADC A,n */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	carry =	(F & C_FLAG) ? 1 : 0;
 	P = *PC++;
-	((A & 0xf) + (P	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_adc(P);
+#else
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][P];
+	A += P + carry;
+#endif
 	return(7);
 }
 
 static int op_suba(void)		/* SUB A,A */
 {
-	A = 0;
-	F &= ~(S_FLAG |	H_FLAG | P_FLAG	| C_FLAG);
-	F |= Z_FLAG | N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][A];
+	A -= A;
+#endif
 	return(4);
 }
 
 static int op_subb(void)		/* SUB A,B */
 {
-	register int i;
-
-	((B & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(B > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) B;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(B);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][B];
+	A -= B;
+#endif
 	return(4);
 }
 
 static int op_subc(void)		/* SUB A,C */
 {
-	register int i;
-
-	((C & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(C > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) C;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(C);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][C];
+	A -= C;
+#endif
 	return(4);
 }
 
 static int op_subd(void)		/* SUB A,D */
 {
-	register int i;
-
-	((D & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(D > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) D;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(D);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][D];
+	A -= D;
+#endif
 	return(4);
 }
 
 static int op_sube(void)		/* SUB A,E */
 {
-	register int i;
-
-	((E & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(E > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) E;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(E);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][E];
+	A -= E;
+#endif
 	return(4);
 }
 
 static int op_subh(void)		/* SUB A,H */
 {
-	register int i;
-
-	((H & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(H > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) H;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(H);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][H];
+	A -= H;
+#endif
 	return(4);
 }
 
 static int op_subl(void)		/* SUB A,L */
 {
-	register int i;
-
-	((L & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(L > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) L;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(L);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][L];
+	A -= L;
+#endif
 	return(4);
 }
 
 static int op_subhl(void)		/* SUB A,(HL) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2221,20 +2749,18 @@ static int op_subhl(void)		/* SUB A,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + (H << 8) + L);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr((H << 8) + L);
+#ifdef WANT_LAZYF
+	lf_sub(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+	A -= P;
+#endif
 	return(7);
 }
 
 static int op_subn(void)		/* SUB A,n */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2244,123 +2770,118 @@ static int op_subn(void)		/* SUB A,n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	P = *PC++;
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sub(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+	A -= P;
+#endif
 	return(7);
 }
 
 static int op_sbca(void)		/* SBC A,A */
 {
-	if (F &	C_FLAG)	{
-		F |= S_FLAG | H_FLAG | N_FLAG |	C_FLAG;
-		F &= ~(Z_FLAG |	P_FLAG);
-		A = 255;
-	} else {
-		F |= Z_FLAG | N_FLAG;
-		F &= ~(S_FLAG |	H_FLAG | P_FLAG	| C_FLAG);
-		A = 0;
-	}
+#ifdef WANT_LAZYF
+	lf_sbc(A);
+#else
+	register int carry;
+
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][A];
+	A -= A + carry;
+#endif
 	return(4);
 }
 
 static int op_sbcb(void)		/* SBC A,B */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(B);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((B & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(B + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) B - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][B];
+	A -= B + carry;
+#endif
 	return(4);
 }
 
 static int op_sbcc(void)		/* SBC A,C */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(C);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((C & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(C + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) C - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][C];
+	A -= C + carry;
+#endif
 	return(4);
 }
 
 static int op_sbcd(void)		/* SBC A,D */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(D);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((D & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(D + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) D - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][D];
+	A -= D + carry;
+#endif
 	return(4);
 }
 
 static int op_sbce(void)		/* SBC A,E */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(E);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((E & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(E + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) E - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][E];
+	A -= E + carry;
+#endif
 	return(4);
 }
 
 static int op_sbch(void)		/* SBC A,H */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(H);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((H & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(H + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) H - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][H];
+	A -= H + carry;
+#endif
 	return(4);
 }
 
 static int op_sbcl(void)		/* SBC A,L */
 {
-	register int i,	carry;
+#ifdef WANT_LAZYF
+	lf_sbc(L);
+#else
+	register int carry;
 
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((L & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(L + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) L - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][L];
+	A -= L + carry;
+#endif
 	return(4);
 }
 
 static int op_sbchl(void)		/* SBC A,(HL) */
 {
-	register int i,	carry;
+#ifndef WANT_LAZYF
+	register int carry;
+#endif
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2369,21 +2890,22 @@ static int op_sbchl(void)		/* SBC A,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + (H << 8) + L);
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((P & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr((H << 8) + L);
+#ifdef WANT_LAZYF
+	lf_sbc(P);
+#else
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][P];
+	A -= P + carry;
+#endif
 	return(7);
 }
 
 static int op_sbcn(void)		/* SBC A,n */
 {
-	register int i,	carry;
+#ifndef WANT_LAZYF
+	register int carry;
+#endif
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2393,111 +2915,88 @@ static int op_sbcn(void)		/* SBC A,n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	P = *PC++;
-	carry =	(F & C_FLAG) ? 1 : 0;
-	((P & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_sbc(P);
+#else
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][P];
+	A -= P + carry;
+#endif
 	return(7);
 }
 
 static int op_cpa(void)			/* CP A */
 {
-	F &= ~(S_FLAG |	H_FLAG | P_FLAG	| C_FLAG);
-	F |= Z_FLAG | N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][A];
+#endif
 	return(4);
 }
 
 static int op_cpb(void)			/* CP B */
 {
-	register int i;
-
-	((B & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(B > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) B;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(B);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][B];
+#endif
 	return(4);
 }
 
 static int op_cpc(void)			/* CP C */
 {
-	register int i;
-
-	((C & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(C > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) C;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(C);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][C];
+#endif
 	return(4);
 }
 
 static int op_cpd(void)			/* CP D */
 {
-	register int i;
-
-	((D & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(D > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) D;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(D);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][D];
+#endif
 	return(4);
 }
 
 static int op_cpe(void)			/* CP E */
 {
-	register int i;
-
-	((E & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(E > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) E;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(E);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][E];
+#endif
 	return(4);
 }
 
 static int op_cph(void)			/* CP H */
 {
-	register int i;
-
-	((H & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(H > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) H;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(H);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][H];
+#endif
 	return(4);
 }
 
 static int op_cplr(void)		/* CP L */
 {
-	register int i;
-
-	((L & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(L > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) L;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(L);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][L];
+#endif
 	return(4);
 }
 
 static int op_cphl(void)		/* CP (HL) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2506,20 +3005,17 @@ static int op_cphl(void)		/* CP (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + (H << 8) + L);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr((H << 8) + L);
+#ifdef WANT_LAZYF
+	lf_cp(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+#endif
 	return(7);
 }
 
 static int op_cpn(void)			/* CP n */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -2529,96 +3025,88 @@ static int op_cpn(void)			/* CP n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	P = *PC++;
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_cp(P);
+#else
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+#endif
 	return(7);
 }
 
 static int op_inca(void)		/* INC A */
 {
-	((A & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	A++;
-	(A == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++A];
+#endif
 	return(4);
 }
 
 static int op_incb(void)		/* INC B */
 {
-	((B & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	B++;
-	(B == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(B & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(B) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++B);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++B];
+#endif
 	return(4);
 }
 
 static int op_incc(void)		/* INC C */
 {
-	((C & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	C++;
-	(C == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(C & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(C) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++C);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++C];
+#endif
 	return(4);
 }
 
 static int op_incd(void)		/* INC D */
 {
-	((D & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	D++;
-	(D == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(D & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(D) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++D);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++D];
+#endif
 	return(4);
 }
 
 static int op_ince(void)		/* INC E */
 {
-	((E & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	E++;
-	(E == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(E & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(E) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++E);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++E];
+#endif
 	return(4);
 }
 
 static int op_inch(void)		/* INC H */
 {
-	((H & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	H++;
-	(H == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(H & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(H) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++H);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++H];
+#endif
 	return(4);
 }
 
 static int op_incl(void)		/* INC L */
 {
-	((L & 0xf) + 1 > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	L++;
-	(L == 128) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(L & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(L) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+#ifdef WANT_LAZYF
+	lf_inc(++L);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[++L];
+#endif
 	return(4);
 }
 
 static int op_incihl(void)		/* INC (HL) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -2626,96 +3114,91 @@ static int op_incihl(void)		/* INC (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	((*p & 0xf) + 1	> 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	(*p)++;
-	(*p == 128) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F &= ~N_FLAG;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	memwrt(addr, ++val);
+#ifdef WANT_LAZYF
+	lf_inc(val);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[val];
+#endif
 	return(11);
 }
 
 static int op_deca(void)		/* DEC A */
 {
-	(((A - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	A--;
-	(A == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--A);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--A];
+#endif
 	return(4);
 }
 
 static int op_decb(void)		/* DEC B */
 {
-	(((B - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	B--;
-	(B == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(B & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(B) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--B);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--B];
+#endif
 	return(4);
 }
 
 static int op_decc(void)		/* DEC C */
 {
-	(((C - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	C--;
-	(C == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(C & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(C) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--C);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--C];
+#endif
 	return(4);
 }
 
 static int op_decd(void)		/* DEC D */
 {
-	(((D - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	D--;
-	(D == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(D & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(D) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--D);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--D];
+#endif
 	return(4);
 }
 
 static int op_dece(void)		/* DEC E */
 {
-	(((E - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	E--;
-	(E == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(E & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(E) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--E);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--E];
+#endif
 	return(4);
 }
 
 static int op_dech(void)		/* DEC H */
 {
-	(((H - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	H--;
-	(H == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(H & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(H) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--H);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--H];
+#endif
 	return(4);
 }
 
 static int op_decl(void)		/* DEC L */
 {
-	(((L - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	L--;
-	(L == 127) ? (F	|= P_FLAG) : (F	&= ~P_FLAG);
-	(L & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(L) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+#ifdef WANT_LAZYF
+	lf_dec(--L);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[--L];
+#endif
 	return(4);
 }
 
 static int op_decihl(void)		/* DEC (HL) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -2723,13 +3206,14 @@ static int op_decihl(void)		/* DEC (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	(((*p - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	(*p)--;
-	(*p == 127) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F |= N_FLAG;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	memwrt(addr, --val);
+#ifdef WANT_LAZYF
+	lf_dec(val);
+#else
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[val];
+#endif
 	return(11);
 }
 
@@ -2737,6 +3221,7 @@ static int op_rlca(void)		/* RLCA */
 {
 	register int i;
 
+	LF_EVAL();
 	i = (A & 128) ?	1 : 0;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
@@ -2749,6 +3234,7 @@ static int op_rrca(void)		/* RRCA */
 {
 	register int i;
 
+	LF_EVAL();
 	i = A &	1;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
@@ -2761,6 +3247,7 @@ static int op_rla(void)			/* RLA */
 {
 	register int old_c_flag;
 
+	LF_EVAL();
 	old_c_flag = F & C_FLAG;
 	(A & 128) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
@@ -2773,6 +3260,7 @@ static int op_rra(void)			/* RRA */
 {
 	register int i,	old_c_flag;
 
+	LF_EVAL();
 	old_c_flag = F & C_FLAG;
 	i = A &	1;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
@@ -2799,6 +3287,7 @@ static int op_exafaf(void)		/* EX AF,AF' */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	i = A;
 	A = A_;
 	A_ = i;
@@ -2843,11 +3332,11 @@ static int op_exsphl(void)		/* EX (SP),HL */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK;
-	*STACK = L;
+	i = memrdr(STACK - ram);
+	memwrt(STACK - ram, L);
 	L = i;
-	i = *(STACK + 1);
-	*(STACK	+ 1) = H;
+	i = memrdr(STACK + 1 - ram);
+	memwrt(STACK - ram + 1, H);
 	H = i;
 #ifdef BUS_8080
 	cpu_bus = CPU_STACK;
@@ -2860,6 +3349,7 @@ static int op_exsphl(void)		/* EX (SP),HL */
 
 static int op_pushaf(void)		/* PUSH AF */
 {
+	LF_EVAL();
 #ifdef BUS_8080
 	cpu_bus = CPU_STACK;
 #endif
@@ -2870,12 +3360,12 @@ static int op_pushaf(void)		/* PUSH AF */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = A;
+	memwrt(--STACK - ram, A);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = F;
+	memwrt(--STACK - ram, F);
 	return(11);
 }
 
@@ -2891,12 +3381,12 @@ static int op_pushbc(void)		/* PUSH BC */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = B;
+	memwrt(--STACK - ram, B);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = C;
+	memwrt(--STACK - ram, C);
 	return(11);
 }
 
@@ -2912,12 +3402,12 @@ static int op_pushde(void)		/* PUSH DE */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = D;
+	memwrt(--STACK - ram, D);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = E;
+	memwrt(--STACK - ram, E);
 	return(11);
 }
 
@@ -2933,29 +3423,30 @@ static int op_pushhl(void)		/* PUSH HL */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = H;
+	memwrt(--STACK - ram, H);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = L;
+	memwrt(--STACK - ram, L);
 	return(11);
 }
 
 static int op_popaf(void)		/* POP AF */
 {
+	LF_EVAL();
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
 #endif
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	F = *STACK++;
+	F = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	A = *STACK++;
+	A = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
@@ -2971,12 +3462,12 @@ static int op_popbc(void)		/* POP BC */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	C = *STACK++;
+	C = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	B = *STACK++;
+	B = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
@@ -2992,12 +3483,12 @@ static int op_popde(void)		/* POP DE */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	E = *STACK++;
+	E = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	D = *STACK++;
+	D = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
@@ -3013,12 +3504,12 @@ static int op_pophl(void)		/* POP HL */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	L = *STACK++;
+	L = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	H = *STACK++;
+	H = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
@@ -3101,12 +3592,12 @@ static int op_call(void)		/* CALL */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + i;
 	return(17);
 }
@@ -3121,12 +3612,12 @@ static int op_ret(void)			/* RET */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK++;
+	i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	i += *STACK++ << 8;
+	i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
@@ -3139,6 +3630,7 @@ static int op_jpz(void)			/* JP Z,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	Z_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3158,6 +3650,7 @@ static int op_jpnz(void)		/* JP NZ,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& Z_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3177,6 +3670,7 @@ static int op_jpc(void)			/* JP C,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	C_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3196,6 +3690,7 @@ static int op_jpnc(void)		/* JP NC,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& C_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3215,6 +3710,7 @@ static int op_jppe(void)		/* JP PE,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	P_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3234,6 +3730,7 @@ static int op_jppo(void)		/* JP PO,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& P_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3253,6 +3750,7 @@ static int op_jpm(void)			/* JP M,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	S_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3272,6 +3770,7 @@ static int op_jpp(void)			/* JP P,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& S_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3291,6 +3790,7 @@ static int op_calz(void)		/* CALL Z,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	Z_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3304,12 +3804,12 @@ static int op_calz(void)		/* CALL Z,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3328,6 +3828,7 @@ static int op_calnz(void)		/* CALL NZ,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& Z_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3341,12 +3842,12 @@ static int op_calnz(void)		/* CALL NZ,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3365,6 +3866,7 @@ static int op_calc(void)		/* CALL C,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	C_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3378,12 +3880,12 @@ static int op_calc(void)		/* CALL C,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
 #endif
@@ -3402,6 +3904,7 @@ static int op_calnc(void)		/* CALL NC,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& C_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3415,7 +3918,7 @@ static int op_calnc(void)		/* CALL NC,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
@@ -3426,7 +3929,7 @@ static int op_calnc(void)		/* CALL NC,nn */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 		PC = ram + i;
 		return(17);
 	} else {
@@ -3439,6 +3942,7 @@ static int op_calpe(void)		/* CALL PE,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	P_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3452,12 +3956,12 @@ static int op_calpe(void)		/* CALL PE,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3476,6 +3980,7 @@ static int op_calpo(void)		/* CALL PO,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& P_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3489,12 +3994,12 @@ static int op_calpo(void)		/* CALL PO,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3513,6 +4018,7 @@ static int op_calm(void)		/* CALL M,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	S_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3526,12 +4032,12 @@ static int op_calm(void)		/* CALL M,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3550,6 +4056,7 @@ static int op_calp(void)		/* CALL P,nn */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& S_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3563,12 +4070,12 @@ static int op_calp(void)		/* CALL P,nn */
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram) >> 8;
+		memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 		if (STACK <= ram)
 			STACK =	ram + 65536L;
 #endif
-		*--STACK = (PC - ram);
+		memwrt(--STACK - ram, (PC - ram));
 #ifdef BUS_8080
 		cpu_bus = CPU_STACK;
 #endif
@@ -3587,6 +4094,7 @@ static int op_retz(void)		/* RET Z */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	Z_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3594,12 +4102,12 @@ static int op_retz(void)		/* RET Z */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3615,6 +4123,7 @@ static int op_retnz(void)		/* RET NZ */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& Z_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3622,12 +4131,12 @@ static int op_retnz(void)		/* RET NZ */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3643,6 +4152,7 @@ static int op_retc(void)		/* RET C */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	C_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3650,12 +4160,12 @@ static int op_retc(void)		/* RET C */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3671,6 +4181,7 @@ static int op_retnc(void)		/* RET NC */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& C_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3678,12 +4189,12 @@ static int op_retnc(void)		/* RET NC */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3699,6 +4210,7 @@ static int op_retpe(void)		/* RET PE */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	P_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3706,12 +4218,12 @@ static int op_retpe(void)		/* RET PE */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3727,6 +4239,7 @@ static int op_retpo(void)		/* RET PO */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& P_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3734,12 +4247,12 @@ static int op_retpo(void)		/* RET PO */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3755,6 +4268,7 @@ static int op_retm(void)		/* RET M */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (F &	S_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3762,12 +4276,12 @@ static int op_retm(void)		/* RET M */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3783,6 +4297,7 @@ static int op_retp(void)		/* RET P */
 {
 	register unsigned i;
 
+	LF_EVAL();
 	if (!(F	& S_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_STACK | CPU_MEMR;
@@ -3790,12 +4305,12 @@ static int op_retp(void)		/* RET P */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		i = *STACK++;
+		i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
 #endif
-		i += *STACK++ << 8;
+		i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 		if (STACK >= ram + 65536L)
 			STACK =	ram;
@@ -3809,6 +4324,7 @@ static int op_retp(void)		/* RET P */
 
 static int op_jrz(void)			/* JR Z,n */
 {
+	LF_EVAL();
 	if (F &	Z_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3826,6 +4342,7 @@ static int op_jrz(void)			/* JR Z,n */
 
 static int op_jrnz(void)		/* JR NZ,n */
 {
+	LF_EVAL();
 	if (!(F	& Z_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3843,6 +4360,7 @@ static int op_jrnz(void)		/* JR NZ,n */
 
 static int op_jrc(void)			/* JR C,n */
 {
+	LF_EVAL();
 	if (F &	C_FLAG)	{
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3860,6 +4378,7 @@ static int op_jrc(void)			/* JR C,n */
 
 static int op_jrnc(void)		/* JR NC,n */
 {
+	LF_EVAL();
 	if (!(F	& C_FLAG)) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -3887,12 +4406,12 @@ static int op_rst00(void)		/* RST 00 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram;
 	return(11);
 }
@@ -3909,12 +4428,12 @@ static int op_rst08(void)		/* RST 08 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x08;
 	return(11);
 }
@@ -3931,12 +4450,12 @@ static int op_rst10(void)		/* RST 10 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x10;
 	return(11);
 }
@@ -3953,12 +4472,12 @@ static int op_rst18(void)		/* RST 18 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x18;
 	return(11);
 }
@@ -3975,12 +4494,12 @@ static int op_rst20(void)		/* RST 20 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x20;
 	return(11);
 }
@@ -3997,12 +4516,12 @@ static int op_rst28(void)		/* RST 28 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x28;
 	return(11);
 }
@@ -4019,12 +4538,12 @@ static int op_rst30(void)		/* RST 30 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x30;
 	return(11);
 }
@@ -4041,12 +4560,12 @@ static int op_rst38(void)		/* RST 38 */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram) >> 8;
+	memwrt(--STACK - ram, (PC - ram) >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = (PC - ram);
+	memwrt(--STACK - ram, (PC - ram));
 	PC = ram + 0x38;
 	return(11);
 }
@@ -32,6 +32,7 @@
 
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
@@ -108,273 +109,802 @@ static int op_tb4l(void), op_tb5l(void), op_tb6l(void), op_tb7l(void);
 static int op_tb0hl(void), op_tb1hl(void), op_tb2hl(void), op_tb3hl(void);
 static int op_tb4hl(void), op_tb5hl(void), op_tb6hl(void), op_tb7hl(void);
 
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xcb.
+ */
+static int (*op_cb[256]) (void) = {
+	op_rlcb,			/* 0x00 */
+	op_rlcc,			/* 0x01	*/
+	op_rlcd,			/* 0x02	*/
+	op_rlce,			/* 0x03	*/
+	op_rlch,			/* 0x04	*/
+	op_rlcl,			/* 0x05	*/
+	op_rlchl,			/* 0x06	*/
+	op_rlcra,			/* 0x07	*/
+	op_rrcb,			/* 0x08	*/
+	op_rrcc,			/* 0x09	*/
+	op_rrcd,			/* 0x0a	*/
+	op_rrce,			/* 0x0b	*/
+	op_rrch,			/* 0x0c	*/
+	op_rrcl,			/* 0x0d	*/
+	op_rrchl,			/* 0x0e	*/
+	op_rrcra,			/* 0x0f	*/
+	op_rlb,				/* 0x10	*/
+	op_rlc,				/* 0x11	*/
+	op_rld,				/* 0x12	*/
+	op_rle,				/* 0x13	*/
+	op_rlh,				/* 0x14	*/
+	op_rll,				/* 0x15	*/
+	op_rlhl,			/* 0x16	*/
+	op_rlra,			/* 0x17	*/
+	op_rrb,				/* 0x18	*/
+	op_rrc,				/* 0x19	*/
+	op_rrd,				/* 0x1a	*/
+	op_rre,				/* 0x1b	*/
+	op_rrh,				/* 0x1c	*/
+	op_rrl,				/* 0x1d	*/
+	op_rrhl,			/* 0x1e	*/
+	op_rrra,			/* 0x1f	*/
+	op_slab,			/* 0x20	*/
+	op_slac,			/* 0x21	*/
+	op_slad,			/* 0x22	*/
+	op_slae,			/* 0x23	*/
+	op_slah,			/* 0x24	*/
+	op_slal,			/* 0x25	*/
+	op_slahl,			/* 0x26	*/
+	op_slaa,			/* 0x27	*/
+	op_srab,			/* 0x28	*/
+	op_srac,			/* 0x29	*/
+	op_srad,			/* 0x2a	*/
+	op_srae,			/* 0x2b	*/
+	op_srah,			/* 0x2c	*/
+	op_sral,			/* 0x2d	*/
+	op_srahl,			/* 0x2e	*/
+	op_sraa,			/* 0x2f	*/
+	trap_cb,			/* 0x30	*/
+	trap_cb,			/* 0x31	*/
+	trap_cb,			/* 0x32	*/
+	trap_cb,			/* 0x33	*/
+	trap_cb,			/* 0x34	*/
+	trap_cb,			/* 0x35	*/
+	trap_cb,			/* 0x36	*/
+	trap_cb,			/* 0x37	*/
+	op_srlb,			/* 0x38	*/
+	op_srlc,			/* 0x39	*/
+	op_srld,			/* 0x3a	*/
+	op_srle,			/* 0x3b	*/
+	op_srlh,			/* 0x3c	*/
+	op_srll,			/* 0x3d	*/
+	op_srlhl,			/* 0x3e	*/
+	op_srla,			/* 0x3f	*/
+	op_tb0b,			/* 0x40	*/
+	op_tb0c,			/* 0x41	*/
+	op_tb0d,			/* 0x42	*/
+	op_tb0e,			/* 0x43	*/
+	op_tb0h,			/* 0x44	*/
+	op_tb0l,			/* 0x45	*/
+	op_tb0hl,			/* 0x46	*/
+	op_tb0a,			/* 0x47	*/
+	op_tb1b,			/* 0x48	*/
+	op_tb1c,			/* 0x49	*/
+	op_tb1d,			/* 0x4a	*/
+	op_tb1e,			/* 0x4b	*/
+	op_tb1h,			/* 0x4c	*/
+	op_tb1l,			/* 0x4d	*/
+	op_tb1hl,			/* 0x4e	*/
+	op_tb1a,			/* 0x4f	*/
+	op_tb2b,			/* 0x50	*/
+	op_tb2c,			/* 0x51	*/
+	op_tb2d,			/* 0x52	*/
+	op_tb2e,			/* 0x53	*/
+	op_tb2h,			/* 0x54	*/
+	op_tb2l,			/* 0x55	*/
+	op_tb2hl,			/* 0x56	*/
+	op_tb2a,			/* 0x57	*/
+	op_tb3b,			/* 0x58	*/
+	op_tb3c,			/* 0x59	*/
+	op_tb3d,			/* 0x5a	*/
+	op_tb3e,			/* 0x5b	*/
+	op_tb3h,			/* 0x5c	*/
+	op_tb3l,			/* 0x5d	*/
+	op_tb3hl,			/* 0x5e	*/
+	op_tb3a,			/* 0x5f	*/
+	op_tb4b,			/* 0x60	*/
+	op_tb4c,			/* 0x61	*/
+	op_tb4d,			/* 0x62	*/
+	op_tb4e,			/* 0x63	*/
+	op_tb4h,			/* 0x64	*/
+	op_tb4l,			/* 0x65	*/
+	op_tb4hl,			/* 0x66	*/
+	op_tb4a,			/* 0x67	*/
+	op_tb5b,			/* 0x68	*/
+	op_tb5c,			/* 0x69	*/
+	op_tb5d,			/* 0x6a	*/
+	op_tb5e,			/* 0x6b	*/
+	op_tb5h,			/* 0x6c	*/
+	op_tb5l,			/* 0x6d	*/
+	op_tb5hl,			/* 0x6e	*/
+	op_tb5a,			/* 0x6f	*/
+	op_tb6b,			/* 0x70	*/
+	op_tb6c,			/* 0x71	*/
+	op_tb6d,			/* 0x72	*/
+	op_tb6e,			/* 0x73	*/
+	op_tb6h,			/* 0x74	*/
+	op_tb6l,			/* 0x75	*/
+	op_tb6hl,			/* 0x76	*/
+	op_tb6a,			/* 0x77	*/
+	op_tb7b,			/* 0x78	*/
+	op_tb7c,			/* 0x79	*/
+	op_tb7d,			/* 0x7a	*/
+	op_tb7e,			/* 0x7b	*/
+	op_tb7h,			/* 0x7c	*/
+	op_tb7l,			/* 0x7d	*/
+	op_tb7hl,			/* 0x7e	*/
+	op_tb7a,			/* 0x7f	*/
+	op_rb0b,			/* 0x80	*/
+	op_rb0c,			/* 0x81	*/
+	op_rb0d,			/* 0x82	*/
+	op_rb0e,			/* 0x83	*/
+	op_rb0h,			/* 0x84	*/
+	op_rb0l,			/* 0x85	*/
+	op_rb0hl,			/* 0x86	*/
+	op_rb0a,			/* 0x87	*/
+	op_rb1b,			/* 0x88	*/
+	op_rb1c,			/* 0x89	*/
+	op_rb1d,			/* 0x8a	*/
+	op_rb1e,			/* 0x8b	*/
+	op_rb1h,			/* 0x8c	*/
+	op_rb1l,			/* 0x8d	*/
+	op_rb1hl,			/* 0x8e	*/
+	op_rb1a,			/* 0x8f	*/
+	op_rb2b,			/* 0x90	*/
+	op_rb2c,			/* 0x91	*/
+	op_rb2d,			/* 0x92	*/
+	op_rb2e,			/* 0x93	*/
+	op_rb2h,			/* 0x94	*/
+	op_rb2l,			/* 0x95	*/
+	op_rb2hl,			/* 0x96	*/
+	op_rb2a,			/* 0x97	*/
+	op_rb3b,			/* 0x98	*/
+	op_rb3c,			/* 0x99	*/
+	op_rb3d,			/* 0x9a	*/
+	op_rb3e,			/* 0x9b	*/
+	op_rb3h,			/* 0x9c	*/
+	op_rb3l,			/* 0x9d	*/
+	op_rb3hl,			/* 0x9e	*/
+	op_rb3a,			/* 0x9f	*/
+	op_rb4b,			/* 0xa0	*/
+	op_rb4c,			/* 0xa1	*/
+	op_rb4d,			/* 0xa2	*/
+	op_rb4e,			/* 0xa3	*/
+	op_rb4h,			/* 0xa4	*/
+	op_rb4l,			/* 0xa5	*/
+	op_rb4hl,			/* 0xa6	*/
+	op_rb4a,			/* 0xa7	*/
+	op_rb5b,			/* 0xa8	*/
+	op_rb5c,			/* 0xa9	*/
+	op_rb5d,			/* 0xaa	*/
+	op_rb5e,			/* 0xab	*/
+	op_rb5h,			/* 0xac	*/
+	op_rb5l,			/* 0xad	*/
+	op_rb5hl,			/* 0xae	*/
+	op_rb5a,			/* 0xaf	*/
+	op_rb6b,			/* 0xb0	*/
+	op_rb6c,			/* 0xb1	*/
+	op_rb6d,			/* 0xb2	*/
+	op_rb6e,			/* 0xb3	*/
+	op_rb6h,			/* 0xb4	*/
+	op_rb6l,			/* 0xb5	*/
+	op_rb6hl,			/* 0xb6	*/
+	op_rb6a,			/* 0xb7	*/
+	op_rb7b,			/* 0xb8	*/
+	op_rb7c,			/* 0xb9	*/
+	op_rb7d,			/* 0xba	*/
+	op_rb7e,			/* 0xbb	*/
+	op_rb7h,			/* 0xbc	*/
+	op_rb7l,			/* 0xbd	*/
+	op_rb7hl,			/* 0xbe	*/
+	op_rb7a,			/* 0xbf	*/
+	op_sb0b,			/* 0xc0	*/
+	op_sb0c,			/* 0xc1	*/
+	op_sb0d,			/* 0xc2	*/
+	op_sb0e,			/* 0xc3	*/
+	op_sb0h,			/* 0xc4	*/
+	op_sb0l,			/* 0xc5	*/
+	op_sb0hl,			/* 0xc6	*/
+	op_sb0a,			/* 0xc7	*/
+	op_sb1b,			/* 0xc8	*/
+	op_sb1c,			/* 0xc9	*/
+	op_sb1d,			/* 0xca	*/
+	op_sb1e,			/* 0xcb	*/
+	op_sb1h,			/* 0xcc	*/
+	op_sb1l,			/* 0xcd	*/
+	op_sb1hl,			/* 0xce	*/
+	op_sb1a,			/* 0xcf	*/
+	op_sb2b,			/* 0xd0	*/
+	op_sb2c,			/* 0xd1	*/
+	op_sb2d,			/* 0xd2	*/
+	op_sb2e,			/* 0xd3	*/
+	op_sb2h,			/* 0xd4	*/
+	op_sb2l,			/* 0xd5	*/
+	op_sb2hl,			/* 0xd6	*/
+	op_sb2a,			/* 0xd7	*/
+	op_sb3b,			/* 0xd8	*/
+	op_sb3c,			/* 0xd9	*/
+	op_sb3d,			/* 0xda	*/
+	op_sb3e,			/* 0xdb	*/
+	op_sb3h,			/* 0xdc	*/
+	op_sb3l,			/* 0xdd	*/
+	op_sb3hl,			/* 0xde	*/
+	op_sb3a,			/* 0xdf	*/
+	op_sb4b,			/* 0xe0	*/
+	op_sb4c,			/* 0xe1	*/
+	op_sb4d,			/* 0xe2	*/
+	op_sb4e,			/* 0xe3	*/
+	op_sb4h,			/* 0xe4	*/
+	op_sb4l,			/* 0xe5	*/
+	op_sb4hl,			/* 0xe6	*/
+	op_sb4a,			/* 0xe7	*/
+	op_sb5b,			/* 0xe8	*/
+	op_sb5c,			/* 0xe9	*/
+	op_sb5d,			/* 0xea	*/
+	op_sb5e,			/* 0xeb	*/
+	op_sb5h,			/* 0xec	*/
+	op_sb5l,			/* 0xed	*/
+	op_sb5hl,			/* 0xee	*/
+	op_sb5a,			/* 0xef	*/
+	op_sb6b,			/* 0xf0	*/
+	op_sb6c,			/* 0xf1	*/
+	op_sb6d,			/* 0xf2	*/
+	op_sb6e,			/* 0xf3	*/
+	op_sb6h,			/* 0xf4	*/
+	op_sb6l,			/* 0xf5	*/
+	op_sb6hl,			/* 0xf6	*/
+	op_sb6a,			/* 0xf7	*/
+	op_sb7b,			/* 0xf8	*/
+	op_sb7c,			/* 0xf9	*/
+	op_sb7d,			/* 0xfa	*/
+	op_sb7e,			/* 0xfb	*/
+	op_sb7h,			/* 0xfc	*/
+	op_sb7l,			/* 0xfd	*/
+	op_sb7hl,			/* 0xfe	*/
+	op_sb7a				/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(); goto done
+#endif
+
 int op_cb_handel(void)
 {
 	register int t;
 
-	static int (*op_cb[256]) (void) = {
-		op_rlcb,			/* 0x00 */
-		op_rlcc,			/* 0x01	*/
-		op_rlcd,			/* 0x02	*/
-		op_rlce,			/* 0x03	*/
-		op_rlch,			/* 0x04	*/
-		op_rlcl,			/* 0x05	*/
-		op_rlchl,			/* 0x06	*/
-		op_rlcra,			/* 0x07	*/
-		op_rrcb,			/* 0x08	*/
-		op_rrcc,			/* 0x09	*/
-		op_rrcd,			/* 0x0a	*/
-		op_rrce,			/* 0x0b	*/
-		op_rrch,			/* 0x0c	*/
-		op_rrcl,			/* 0x0d	*/
-		op_rrchl,			/* 0x0e	*/
-		op_rrcra,			/* 0x0f	*/
-		op_rlb,				/* 0x10	*/
-		op_rlc,				/* 0x11	*/
-		op_rld,				/* 0x12	*/
-		op_rle,				/* 0x13	*/
-		op_rlh,				/* 0x14	*/
-		op_rll,				/* 0x15	*/
-		op_rlhl,			/* 0x16	*/
-		op_rlra,			/* 0x17	*/
-		op_rrb,				/* 0x18	*/
-		op_rrc,				/* 0x19	*/
-		op_rrd,				/* 0x1a	*/
-		op_rre,				/* 0x1b	*/
-		op_rrh,				/* 0x1c	*/
-		op_rrl,				/* 0x1d	*/
-		op_rrhl,			/* 0x1e	*/
-		op_rrra,			/* 0x1f	*/
-		op_slab,			/* 0x20	*/
-		op_slac,			/* 0x21	*/
-		op_slad,			/* 0x22	*/
-		op_slae,			/* 0x23	*/
-		op_slah,			/* 0x24	*/
-		op_slal,			/* 0x25	*/
-		op_slahl,			/* 0x26	*/
-		op_slaa,			/* 0x27	*/
-		op_srab,			/* 0x28	*/
-		op_srac,			/* 0x29	*/
-		op_srad,			/* 0x2a	*/
-		op_srae,			/* 0x2b	*/
-		op_srah,			/* 0x2c	*/
-		op_sral,			/* 0x2d	*/
-		op_srahl,			/* 0x2e	*/
-		op_sraa,			/* 0x2f	*/
-		trap_cb,			/* 0x30	*/
-		trap_cb,			/* 0x31	*/
-		trap_cb,			/* 0x32	*/
-		trap_cb,			/* 0x33	*/
-		trap_cb,			/* 0x34	*/
-		trap_cb,			/* 0x35	*/
-		trap_cb,			/* 0x36	*/
-		trap_cb,			/* 0x37	*/
-		op_srlb,			/* 0x38	*/
-		op_srlc,			/* 0x39	*/
-		op_srld,			/* 0x3a	*/
-		op_srle,			/* 0x3b	*/
-		op_srlh,			/* 0x3c	*/
-		op_srll,			/* 0x3d	*/
-		op_srlhl,			/* 0x3e	*/
-		op_srla,			/* 0x3f	*/
-		op_tb0b,			/* 0x40	*/
-		op_tb0c,			/* 0x41	*/
-		op_tb0d,			/* 0x42	*/
-		op_tb0e,			/* 0x43	*/
-		op_tb0h,			/* 0x44	*/
-		op_tb0l,			/* 0x45	*/
-		op_tb0hl,			/* 0x46	*/
-		op_tb0a,			/* 0x47	*/
-		op_tb1b,			/* 0x48	*/
-		op_tb1c,			/* 0x49	*/
-		op_tb1d,			/* 0x4a	*/
-		op_tb1e,			/* 0x4b	*/
-		op_tb1h,			/* 0x4c	*/
-		op_tb1l,			/* 0x4d	*/
-		op_tb1hl,			/* 0x4e	*/
-		op_tb1a,			/* 0x4f	*/
-		op_tb2b,			/* 0x50	*/
-		op_tb2c,			/* 0x51	*/
-		op_tb2d,			/* 0x52	*/
-		op_tb2e,			/* 0x53	*/
-		op_tb2h,			/* 0x54	*/
-		op_tb2l,			/* 0x55	*/
-		op_tb2hl,			/* 0x56	*/
-		op_tb2a,			/* 0x57	*/
-		op_tb3b,			/* 0x58	*/
-		op_tb3c,			/* 0x59	*/
-		op_tb3d,			/* 0x5a	*/
-		op_tb3e,			/* 0x5b	*/
-		op_tb3h,			/* 0x5c	*/
-		op_tb3l,			/* 0x5d	*/
-		op_tb3hl,			/* 0x5e	*/
-		op_tb3a,			/* 0x5f	*/
-		op_tb4b,			/* 0x60	*/
-		op_tb4c,			/* 0x61	*/
-		op_tb4d,			/* 0x62	*/
-		op_tb4e,			/* 0x63	*/
-		op_tb4h,			/* 0x64	*/
-		op_tb4l,			/* 0x65	*/
-		op_tb4hl,			/* 0x66	*/
-		op_tb4a,			/* 0x67	*/
-		op_tb5b,			/* 0x68	*/
-		op_tb5c,			/* 0x69	*/
-		op_tb5d,			/* 0x6a	*/
-		op_tb5e,			/* 0x6b	*/
-		op_tb5h,			/* 0x6c	*/
-		op_tb5l,			/* 0x6d	*/
-		op_tb5hl,			/* 0x6e	*/
-		op_tb5a,			/* 0x6f	*/
-		op_tb6b,			/* 0x70	*/
-		op_tb6c,			/* 0x71	*/
-		op_tb6d,			/* 0x72	*/
-		op_tb6e,			/* 0x73	*/
-		op_tb6h,			/* 0x74	*/
-		op_tb6l,			/* 0x75	*/
-		op_tb6hl,			/* 0x76	*/
-		op_tb6a,			/* 0x77	*/
-		op_tb7b,			/* 0x78	*/
-		op_tb7c,			/* 0x79	*/
-		op_tb7d,			/* 0x7a	*/
-		op_tb7e,			/* 0x7b	*/
-		op_tb7h,			/* 0x7c	*/
-		op_tb7l,			/* 0x7d	*/
-		op_tb7hl,			/* 0x7e	*/
-		op_tb7a,			/* 0x7f	*/
-		op_rb0b,			/* 0x80	*/
-		op_rb0c,			/* 0x81	*/
-		op_rb0d,			/* 0x82	*/
-		op_rb0e,			/* 0x83	*/
-		op_rb0h,			/* 0x84	*/
-		op_rb0l,			/* 0x85	*/
-		op_rb0hl,			/* 0x86	*/
-		op_rb0a,			/* 0x87	*/
-		op_rb1b,			/* 0x88	*/
-		op_rb1c,			/* 0x89	*/
-		op_rb1d,			/* 0x8a	*/
-		op_rb1e,			/* 0x8b	*/
-		op_rb1h,			/* 0x8c	*/
-		op_rb1l,			/* 0x8d	*/
-		op_rb1hl,			/* 0x8e	*/
-		op_rb1a,			/* 0x8f	*/
-		op_rb2b,			/* 0x90	*/
-		op_rb2c,			/* 0x91	*/
-		op_rb2d,			/* 0x92	*/
-		op_rb2e,			/* 0x93	*/
-		op_rb2h,			/* 0x94	*/
-		op_rb2l,			/* 0x95	*/
-		op_rb2hl,			/* 0x96	*/
-		op_rb2a,			/* 0x97	*/
-		op_rb3b,			/* 0x98	*/
-		op_rb3c,			/* 0x99	*/
-		op_rb3d,			/* 0x9a	*/
-		op_rb3e,			/* 0x9b	*/
-		op_rb3h,			/* 0x9c	*/
-		op_rb3l,			/* 0x9d	*/
-		op_rb3hl,			/* 0x9e	*/
-		op_rb3a,			/* 0x9f	*/
-		op_rb4b,			/* 0xa0	*/
-		op_rb4c,			/* 0xa1	*/
-		op_rb4d,			/* 0xa2	*/
-		op_rb4e,			/* 0xa3	*/
-		op_rb4h,			/* 0xa4	*/
-		op_rb4l,			/* 0xa5	*/
-		op_rb4hl,			/* 0xa6	*/
-		op_rb4a,			/* 0xa7	*/
-		op_rb5b,			/* 0xa8	*/
-		op_rb5c,			/* 0xa9	*/
-		op_rb5d,			/* 0xaa	*/
-		op_rb5e,			/* 0xab	*/
-		op_rb5h,			/* 0xac	*/
-		op_rb5l,			/* 0xad	*/
-		op_rb5hl,			/* 0xae	*/
-		op_rb5a,			/* 0xaf	*/
-		op_rb6b,			/* 0xb0	*/
-		op_rb6c,			/* 0xb1	*/
-		op_rb6d,			/* 0xb2	*/
-		op_rb6e,			/* 0xb3	*/
-		op_rb6h,			/* 0xb4	*/
-		op_rb6l,			/* 0xb5	*/
-		op_rb6hl,			/* 0xb6	*/
-		op_rb6a,			/* 0xb7	*/
-		op_rb7b,			/* 0xb8	*/
-		op_rb7c,			/* 0xb9	*/
-		op_rb7d,			/* 0xba	*/
-		op_rb7e,			/* 0xbb	*/
-		op_rb7h,			/* 0xbc	*/
-		op_rb7l,			/* 0xbd	*/
-		op_rb7hl,			/* 0xbe	*/
-		op_rb7a,			/* 0xbf	*/
-		op_sb0b,			/* 0xc0	*/
-		op_sb0c,			/* 0xc1	*/
-		op_sb0d,			/* 0xc2	*/
-		op_sb0e,			/* 0xc3	*/
-		op_sb0h,			/* 0xc4	*/
-		op_sb0l,			/* 0xc5	*/
-		op_sb0hl,			/* 0xc6	*/
-		op_sb0a,			/* 0xc7	*/
-		op_sb1b,			/* 0xc8	*/
-		op_sb1c,			/* 0xc9	*/
-		op_sb1d,			/* 0xca	*/
-		op_sb1e,			/* 0xcb	*/
-		op_sb1h,			/* 0xcc	*/
-		op_sb1l,			/* 0xcd	*/
-		op_sb1hl,			/* 0xce	*/
-		op_sb1a,			/* 0xcf	*/
-		op_sb2b,			/* 0xd0	*/
-		op_sb2c,			/* 0xd1	*/
-		op_sb2d,			/* 0xd2	*/
-		op_sb2e,			/* 0xd3	*/
-		op_sb2h,			/* 0xd4	*/
-		op_sb2l,			/* 0xd5	*/
-		op_sb2hl,			/* 0xd6	*/
-		op_sb2a,			/* 0xd7	*/
-		op_sb3b,			/* 0xd8	*/
-		op_sb3c,			/* 0xd9	*/
-		op_sb3d,			/* 0xda	*/
-		op_sb3e,			/* 0xdb	*/
-		op_sb3h,			/* 0xdc	*/
-		op_sb3l,			/* 0xdd	*/
-		op_sb3hl,			/* 0xde	*/
-		op_sb3a,			/* 0xdf	*/
-		op_sb4b,			/* 0xe0	*/
-		op_sb4c,			/* 0xe1	*/
-		op_sb4d,			/* 0xe2	*/
-		op_sb4e,			/* 0xe3	*/
-		op_sb4h,			/* 0xe4	*/
-		op_sb4l,			/* 0xe5	*/
-		op_sb4hl,			/* 0xe6	*/
-		op_sb4a,			/* 0xe7	*/
-		op_sb5b,			/* 0xe8	*/
-		op_sb5c,			/* 0xe9	*/
-		op_sb5d,			/* 0xea	*/
-		op_sb5e,			/* 0xeb	*/
-		op_sb5h,			/* 0xec	*/
-		op_sb5l,			/* 0xed	*/
-		op_sb5hl,			/* 0xee	*/
-		op_sb5a,			/* 0xef	*/
-		op_sb6b,			/* 0xf0	*/
-		op_sb6c,			/* 0xf1	*/
-		op_sb6d,			/* 0xf2	*/
-		op_sb6e,			/* 0xf3	*/
-		op_sb6h,			/* 0xf4	*/
-		op_sb6l,			/* 0xf5	*/
-		op_sb6hl,			/* 0xf6	*/
-		op_sb6a,			/* 0xf7	*/
-		op_sb7b,			/* 0xf8	*/
-		op_sb7c,			/* 0xf9	*/
-		op_sb7d,			/* 0xfa	*/
-		op_sb7e,			/* 0xfb	*/
-		op_sb7h,			/* 0xfc	*/
-		op_sb7l,			/* 0xfd	*/
-		op_sb7hl,			/* 0xfe	*/
-		op_sb7a				/* 0xff	*/
+#ifdef WANT_THREADED
+	static void *op_cb_thr[256] = {
+		&&l_op_rlcb,			/* 0x00 */
+		&&l_op_rlcc,			/* 0x01	*/
+		&&l_op_rlcd,			/* 0x02	*/
+		&&l_op_rlce,			/* 0x03	*/
+		&&l_op_rlch,			/* 0x04	*/
+		&&l_op_rlcl,			/* 0x05	*/
+		&&l_op_rlchl,			/* 0x06	*/
+		&&l_op_rlcra,			/* 0x07	*/
+		&&l_op_rrcb,			/* 0x08	*/
+		&&l_op_rrcc,			/* 0x09	*/
+		&&l_op_rrcd,			/* 0x0a	*/
+		&&l_op_rrce,			/* 0x0b	*/
+		&&l_op_rrch,			/* 0x0c	*/
+		&&l_op_rrcl,			/* 0x0d	*/
+		&&l_op_rrchl,			/* 0x0e	*/
+		&&l_op_rrcra,			/* 0x0f	*/
+		&&l_op_rlb,			/* 0x10	*/
+		&&l_op_rlc,			/* 0x11	*/
+		&&l_op_rld,			/* 0x12	*/
+		&&l_op_rle,			/* 0x13	*/
+		&&l_op_rlh,			/* 0x14	*/
+		&&l_op_rll,			/* 0x15	*/
+		&&l_op_rlhl,			/* 0x16	*/
+		&&l_op_rlra,			/* 0x17	*/
+		&&l_op_rrb,			/* 0x18	*/
+		&&l_op_rrc,			/* 0x19	*/
+		&&l_op_rrd,			/* 0x1a	*/
+		&&l_op_rre,			/* 0x1b	*/
+		&&l_op_rrh,			/* 0x1c	*/
+		&&l_op_rrl,			/* 0x1d	*/
+		&&l_op_rrhl,			/* 0x1e	*/
+		&&l_op_rrra,			/* 0x1f	*/
+		&&l_op_slab,			/* 0x20	*/
+		&&l_op_slac,			/* 0x21	*/
+		&&l_op_slad,			/* 0x22	*/
+		&&l_op_slae,			/* 0x23	*/
+		&&l_op_slah,			/* 0x24	*/
+		&&l_op_slal,			/* 0x25	*/
+		&&l_op_slahl,			/* 0x26	*/
+		&&l_op_slaa,			/* 0x27	*/
+		&&l_op_srab,			/* 0x28	*/
+		&&l_op_srac,			/* 0x29	*/
+		&&l_op_srad,			/* 0x2a	*/
+		&&l_op_srae,			/* 0x2b	*/
+		&&l_op_srah,			/* 0x2c	*/
+		&&l_op_sral,			/* 0x2d	*/
+		&&l_op_srahl,			/* 0x2e	*/
+		&&l_op_sraa,			/* 0x2f	*/
+		&&l_trap_cb,			/* 0x30	*/
+		&&l_trap_cb,			/* 0x31	*/
+		&&l_trap_cb,			/* 0x32	*/
+		&&l_trap_cb,			/* 0x33	*/
+		&&l_trap_cb,			/* 0x34	*/
+		&&l_trap_cb,			/* 0x35	*/
+		&&l_trap_cb,			/* 0x36	*/
+		&&l_trap_cb,			/* 0x37	*/
+		&&l_op_srlb,			/* 0x38	*/
+		&&l_op_srlc,			/* 0x39	*/
+		&&l_op_srld,			/* 0x3a	*/
+		&&l_op_srle,			/* 0x3b	*/
+		&&l_op_srlh,			/* 0x3c	*/
+		&&l_op_srll,			/* 0x3d	*/
+		&&l_op_srlhl,			/* 0x3e	*/
+		&&l_op_srla,			/* 0x3f	*/
+		&&l_op_tb0b,			/* 0x40	*/
+		&&l_op_tb0c,			/* 0x41	*/
+		&&l_op_tb0d,			/* 0x42	*/
+		&&l_op_tb0e,			/* 0x43	*/
+		&&l_op_tb0h,			/* 0x44	*/
+		&&l_op_tb0l,			/* 0x45	*/
+		&&l_op_tb0hl,			/* 0x46	*/
+		&&l_op_tb0a,			/* 0x47	*/
+		&&l_op_tb1b,			/* 0x48	*/
+		&&l_op_tb1c,			/* 0x49	*/
+		&&l_op_tb1d,			/* 0x4a	*/
+		&&l_op_tb1e,			/* 0x4b	*/
+		&&l_op_tb1h,			/* 0x4c	*/
+		&&l_op_tb1l,			/* 0x4d	*/
+		&&l_op_tb1hl,			/* 0x4e	*/
+		&&l_op_tb1a,			/* 0x4f	*/
+		&&l_op_tb2b,			/* 0x50	*/
+		&&l_op_tb2c,			/* 0x51	*/
+		&&l_op_tb2d,			/* 0x52	*/
+		&&l_op_tb2e,			/* 0x53	*/
+		&&l_op_tb2h,			/* 0x54	*/
+		&&l_op_tb2l,			/* 0x55	*/
+		&&l_op_tb2hl,			/* 0x56	*/
+		&&l_op_tb2a,			/* 0x57	*/
+		&&l_op_tb3b,			/* 0x58	*/
+		&&l_op_tb3c,			/* 0x59	*/
+		&&l_op_tb3d,			/* 0x5a	*/
+		&&l_op_tb3e,			/* 0x5b	*/
+		&&l_op_tb3h,			/* 0x5c	*/
+		&&l_op_tb3l,			/* 0x5d	*/
+		&&l_op_tb3hl,			/* 0x5e	*/
+		&&l_op_tb3a,			/* 0x5f	*/
+		&&l_op_tb4b,			/* 0x60	*/
+		&&l_op_tb4c,			/* 0x61	*/
+		&&l_op_tb4d,			/* 0x62	*/
+		&&l_op_tb4e,			/* 0x63	*/
+		&&l_op_tb4h,			/* 0x64	*/
+		&&l_op_tb4l,			/* 0x65	*/
+		&&l_op_tb4hl,			/* 0x66	*/
+		&&l_op_tb4a,			/* 0x67	*/
+		&&l_op_tb5b,			/* 0x68	*/
+		&&l_op_tb5c,			/* 0x69	*/
+		&&l_op_tb5d,			/* 0x6a	*/
+		&&l_op_tb5e,			/* 0x6b	*/
+		&&l_op_tb5h,			/* 0x6c	*/
+		&&l_op_tb5l,			/* 0x6d	*/
+		&&l_op_tb5hl,			/* 0x6e	*/
+		&&l_op_tb5a,			/* 0x6f	*/
+		&&l_op_tb6b,			/* 0x70	*/
+		&&l_op_tb6c,			/* 0x71	*/
+		&&l_op_tb6d,			/* 0x72	*/
+		&&l_op_tb6e,			/* 0x73	*/
+		&&l_op_tb6h,			/* 0x74	*/
+		&&l_op_tb6l,			/* 0x75	*/
+		&&l_op_tb6hl,			/* 0x76	*/
+		&&l_op_tb6a,			/* 0x77	*/
+		&&l_op_tb7b,			/* 0x78	*/
+		&&l_op_tb7c,			/* 0x79	*/
+		&&l_op_tb7d,			/* 0x7a	*/
+		&&l_op_tb7e,			/* 0x7b	*/
+		&&l_op_tb7h,			/* 0x7c	*/
+		&&l_op_tb7l,			/* 0x7d	*/
+		&&l_op_tb7hl,			/* 0x7e	*/
+		&&l_op_tb7a,			/* 0x7f	*/
+		&&l_op_rb0b,			/* 0x80	*/
+		&&l_op_rb0c,			/* 0x81	*/
+		&&l_op_rb0d,			/* 0x82	*/
+		&&l_op_rb0e,			/* 0x83	*/
+		&&l_op_rb0h,			/* 0x84	*/
+		&&l_op_rb0l,			/* 0x85	*/
+		&&l_op_rb0hl,			/* 0x86	*/
+		&&l_op_rb0a,			/* 0x87	*/
+		&&l_op_rb1b,			/* 0x88	*/
+		&&l_op_rb1c,			/* 0x89	*/
+		&&l_op_rb1d,			/* 0x8a	*/
+		&&l_op_rb1e,			/* 0x8b	*/
+		&&l_op_rb1h,			/* 0x8c	*/
+		&&l_op_rb1l,			/* 0x8d	*/
+		&&l_op_rb1hl,			/* 0x8e	*/
+		&&l_op_rb1a,			/* 0x8f	*/
+		&&l_op_rb2b,			/* 0x90	*/
+		&&l_op_rb2c,			/* 0x91	*/
+		&&l_op_rb2d,			/* 0x92	*/
+		&&l_op_rb2e,			/* 0x93	*/
+		&&l_op_rb2h,			/* 0x94	*/
+		&&l_op_rb2l,			/* 0x95	*/
+		&&l_op_rb2hl,			/* 0x96	*/
+		&&l_op_rb2a,			/* 0x97	*/
+		&&l_op_rb3b,			/* 0x98	*/
+		&&l_op_rb3c,			/* 0x99	*/
+		&&l_op_rb3d,			/* 0x9a	*/
+		&&l_op_rb3e,			/* 0x9b	*/
+		&&l_op_rb3h,			/* 0x9c	*/
+		&&l_op_rb3l,			/* 0x9d	*/
+		&&l_op_rb3hl,			/* 0x9e	*/
+		&&l_op_rb3a,			/* 0x9f	*/
+		&&l_op_rb4b,			/* 0xa0	*/
+		&&l_op_rb4c,			/* 0xa1	*/
+		&&l_op_rb4d,			/* 0xa2	*/
+		&&l_op_rb4e,			/* 0xa3	*/
+		&&l_op_rb4h,			/* 0xa4	*/
+		&&l_op_rb4l,			/* 0xa5	*/
+		&&l_op_rb4hl,			/* 0xa6	*/
+		&&l_op_rb4a,			/* 0xa7	*/
+		&&l_op_rb5b,			/* 0xa8	*/
+		&&l_op_rb5c,			/* 0xa9	*/
+		&&l_op_rb5d,			/* 0xaa	*/
+		&&l_op_rb5e,			/* 0xab	*/
+		&&l_op_rb5h,			/* 0xac	*/
+		&&l_op_rb5l,			/* 0xad	*/
+		&&l_op_rb5hl,			/* 0xae	*/
+		&&l_op_rb5a,			/* 0xaf	*/
+		&&l_op_rb6b,			/* 0xb0	*/
+		&&l_op_rb6c,			/* 0xb1	*/
+		&&l_op_rb6d,			/* 0xb2	*/
+		&&l_op_rb6e,			/* 0xb3	*/
+		&&l_op_rb6h,			/* 0xb4	*/
+		&&l_op_rb6l,			/* 0xb5	*/
+		&&l_op_rb6hl,			/* 0xb6	*/
+		&&l_op_rb6a,			/* 0xb7	*/
+		&&l_op_rb7b,			/* 0xb8	*/
+		&&l_op_rb7c,			/* 0xb9	*/
+		&&l_op_rb7d,			/* 0xba	*/
+		&&l_op_rb7e,			/* 0xbb	*/
+		&&l_op_rb7h,			/* 0xbc	*/
+		&&l_op_rb7l,			/* 0xbd	*/
+		&&l_op_rb7hl,			/* 0xbe	*/
+		&&l_op_rb7a,			/* 0xbf	*/
+		&&l_op_sb0b,			/* 0xc0	*/
+		&&l_op_sb0c,			/* 0xc1	*/
+		&&l_op_sb0d,			/* 0xc2	*/
+		&&l_op_sb0e,			/* 0xc3	*/
+		&&l_op_sb0h,			/* 0xc4	*/
+		&&l_op_sb0l,			/* 0xc5	*/
+		&&l_op_sb0hl,			/* 0xc6	*/
+		&&l_op_sb0a,			/* 0xc7	*/
+		&&l_op_sb1b,			/* 0xc8	*/
+		&&l_op_sb1c,			/* 0xc9	*/
+		&&l_op_sb1d,			/* 0xca	*/
+		&&l_op_sb1e,			/* 0xcb	*/
+		&&l_op_sb1h,			/* 0xcc	*/
+		&&l_op_sb1l,			/* 0xcd	*/
+		&&l_op_sb1hl,			/* 0xce	*/
+		&&l_op_sb1a,			/* 0xcf	*/
+		&&l_op_sb2b,			/* 0xd0	*/
+		&&l_op_sb2c,			/* 0xd1	*/
+		&&l_op_sb2d,			/* 0xd2	*/
+		&&l_op_sb2e,			/* 0xd3	*/
+		&&l_op_sb2h,			/* 0xd4	*/
+		&&l_op_sb2l,			/* 0xd5	*/
+		&&l_op_sb2hl,			/* 0xd6	*/
+		&&l_op_sb2a,			/* 0xd7	*/
+		&&l_op_sb3b,			/* 0xd8	*/
+		&&l_op_sb3c,			/* 0xd9	*/
+		&&l_op_sb3d,			/* 0xda	*/
+		&&l_op_sb3e,			/* 0xdb	*/
+		&&l_op_sb3h,			/* 0xdc	*/
+		&&l_op_sb3l,			/* 0xdd	*/
+		&&l_op_sb3hl,			/* 0xde	*/
+		&&l_op_sb3a,			/* 0xdf	*/
+		&&l_op_sb4b,			/* 0xe0	*/
+		&&l_op_sb4c,			/* 0xe1	*/
+		&&l_op_sb4d,			/* 0xe2	*/
+		&&l_op_sb4e,			/* 0xe3	*/
+		&&l_op_sb4h,			/* 0xe4	*/
+		&&l_op_sb4l,			/* 0xe5	*/
+		&&l_op_sb4hl,			/* 0xe6	*/
+		&&l_op_sb4a,			/* 0xe7	*/
+		&&l_op_sb5b,			/* 0xe8	*/
+		&&l_op_sb5c,			/* 0xe9	*/
+		&&l_op_sb5d,			/* 0xea	*/
+		&&l_op_sb5e,			/* 0xeb	*/
+		&&l_op_sb5h,			/* 0xec	*/
+		&&l_op_sb5l,			/* 0xed	*/
+		&&l_op_sb5hl,			/* 0xee	*/
+		&&l_op_sb5a,			/* 0xef	*/
+		&&l_op_sb6b,			/* 0xf0	*/
+		&&l_op_sb6c,			/* 0xf1	*/
+		&&l_op_sb6d,			/* 0xf2	*/
+		&&l_op_sb6e,			/* 0xf3	*/
+		&&l_op_sb6h,			/* 0xf4	*/
+		&&l_op_sb6l,			/* 0xf5	*/
+		&&l_op_sb6hl,			/* 0xf6	*/
+		&&l_op_sb6a,			/* 0xf7	*/
+		&&l_op_sb7b,			/* 0xf8	*/
+		&&l_op_sb7c,			/* 0xf9	*/
+		&&l_op_sb7d,			/* 0xfa	*/
+		&&l_op_sb7e,			/* 0xfb	*/
+		&&l_op_sb7h,			/* 0xfc	*/
+		&&l_op_sb7l,			/* 0xfd	*/
+		&&l_op_sb7hl,			/* 0xfe	*/
+		&&l_op_sb7a			/* 0xff	*/
 	};
+#endif
 
-#ifdef WANT_TIM
-	t = (*op_cb[*PC++]) ();		/* execute next opcode */
+	LF_EVAL();			/* opcodes with prefix use F */
+
+#ifdef WANT_THREADED
+	goto *op_cb_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(op_rlcb);
+	OP_THR(op_rlcc);
+	OP_THR(op_rlcd);
+	OP_THR(op_rlce);
+	OP_THR(op_rlch);
+	OP_THR(op_rlcl);
+	OP_THR(op_rlchl);
+	OP_THR(op_rlcra);
+	OP_THR(op_rrcb);
+	OP_THR(op_rrcc);
+	OP_THR(op_rrcd);
+	OP_THR(op_rrce);
+	OP_THR(op_rrch);
+	OP_THR(op_rrcl);
+	OP_THR(op_rrchl);
+	OP_THR(op_rrcra);
+	OP_THR(op_rlb);
+	OP_THR(op_rlc);
+	OP_THR(op_rld);
+	OP_THR(op_rle);
+	OP_THR(op_rlh);
+	OP_THR(op_rll);
+	OP_THR(op_rlhl);
+	OP_THR(op_rlra);
+	OP_THR(op_rrb);
+	OP_THR(op_rrc);
+	OP_THR(op_rrd);
+	OP_THR(op_rre);
+	OP_THR(op_rrh);
+	OP_THR(op_rrl);
+	OP_THR(op_rrhl);
+	OP_THR(op_rrra);
+	OP_THR(op_slab);
+	OP_THR(op_slac);
+	OP_THR(op_slad);
+	OP_THR(op_slae);
+	OP_THR(op_slah);
+	OP_THR(op_slal);
+	OP_THR(op_slahl);
+	OP_THR(op_slaa);
+	OP_THR(op_srab);
+	OP_THR(op_srac);
+	OP_THR(op_srad);
+	OP_THR(op_srae);
+	OP_THR(op_srah);
+	OP_THR(op_sral);
+	OP_THR(op_srahl);
+	OP_THR(op_sraa);
+	OP_THR(trap_cb);
+	OP_THR(op_srlb);
+	OP_THR(op_srlc);
+	OP_THR(op_srld);
+	OP_THR(op_srle);
+	OP_THR(op_srlh);
+	OP_THR(op_srll);
+	OP_THR(op_srlhl);
+	OP_THR(op_srla);
+	OP_THR(op_tb0b);
+	OP_THR(op_tb0c);
+	OP_THR(op_tb0d);
+	OP_THR(op_tb0e);
+	OP_THR(op_tb0h);
+	OP_THR(op_tb0l);
+	OP_THR(op_tb0hl);
+	OP_THR(op_tb0a);
+	OP_THR(op_tb1b);
+	OP_THR(op_tb1c);
+	OP_THR(op_tb1d);
+	OP_THR(op_tb1e);
+	OP_THR(op_tb1h);
+	OP_THR(op_tb1l);
+	OP_THR(op_tb1hl);
+	OP_THR(op_tb1a);
+	OP_THR(op_tb2b);
+	OP_THR(op_tb2c);
+	OP_THR(op_tb2d);
+	OP_THR(op_tb2e);
+	OP_THR(op_tb2h);
+	OP_THR(op_tb2l);
+	OP_THR(op_tb2hl);
+	OP_THR(op_tb2a);
+	OP_THR(op_tb3b);
+	OP_THR(op_tb3c);
+	OP_THR(op_tb3d);
+	OP_THR(op_tb3e);
+	OP_THR(op_tb3h);
+	OP_THR(op_tb3l);
+	OP_THR(op_tb3hl);
+	OP_THR(op_tb3a);
+	OP_THR(op_tb4b);
+	OP_THR(op_tb4c);
+	OP_THR(op_tb4d);
+	OP_THR(op_tb4e);
+	OP_THR(op_tb4h);
+	OP_THR(op_tb4l);
+	OP_THR(op_tb4hl);
+	OP_THR(op_tb4a);
+	OP_THR(op_tb5b);
+	OP_THR(op_tb5c);
+	OP_THR(op_tb5d);
+	OP_THR(op_tb5e);
+	OP_THR(op_tb5h);
+	OP_THR(op_tb5l);
+	OP_THR(op_tb5hl);
+	OP_THR(op_tb5a);
+	OP_THR(op_tb6b);
+	OP_THR(op_tb6c);
+	OP_THR(op_tb6d);
+	OP_THR(op_tb6e);
+	OP_THR(op_tb6h);
+	OP_THR(op_tb6l);
+	OP_THR(op_tb6hl);
+	OP_THR(op_tb6a);
+	OP_THR(op_tb7b);
+	OP_THR(op_tb7c);
+	OP_THR(op_tb7d);
+	OP_THR(op_tb7e);
+	OP_THR(op_tb7h);
+	OP_THR(op_tb7l);
+	OP_THR(op_tb7hl);
+	OP_THR(op_tb7a);
+	OP_THR(op_rb0b);
+	OP_THR(op_rb0c);
+	OP_THR(op_rb0d);
+	OP_THR(op_rb0e);
+	OP_THR(op_rb0h);
+	OP_THR(op_rb0l);
+	OP_THR(op_rb0hl);
+	OP_THR(op_rb0a);
+	OP_THR(op_rb1b);
+	OP_THR(op_rb1c);
+	OP_THR(op_rb1d);
+	OP_THR(op_rb1e);
+	OP_THR(op_rb1h);
+	OP_THR(op_rb1l);
+	OP_THR(op_rb1hl);
+	OP_THR(op_rb1a);
+	OP_THR(op_rb2b);
+	OP_THR(op_rb2c);
+	OP_THR(op_rb2d);
+	OP_THR(op_rb2e);
+	OP_THR(op_rb2h);
+	OP_THR(op_rb2l);
+	OP_THR(op_rb2hl);
+	OP_THR(op_rb2a);
+	OP_THR(op_rb3b);
+	OP_THR(op_rb3c);
+	OP_THR(op_rb3d);
+	OP_THR(op_rb3e);
+	OP_THR(op_rb3h);
+	OP_THR(op_rb3l);
+	OP_THR(op_rb3hl);
+	OP_THR(op_rb3a);
+	OP_THR(op_rb4b);
+	OP_THR(op_rb4c);
+	OP_THR(op_rb4d);
+	OP_THR(op_rb4e);
+	OP_THR(op_rb4h);
+	OP_THR(op_rb4l);
+	OP_THR(op_rb4hl);
+	OP_THR(op_rb4a);
+	OP_THR(op_rb5b);
+	OP_THR(op_rb5c);
+	OP_THR(op_rb5d);
+	OP_THR(op_rb5e);
+	OP_THR(op_rb5h);
+	OP_THR(op_rb5l);
+	OP_THR(op_rb5hl);
+	OP_THR(op_rb5a);
+	OP_THR(op_rb6b);
+	OP_THR(op_rb6c);
+	OP_THR(op_rb6d);
+	OP_THR(op_rb6e);
+	OP_THR(op_rb6h);
+	OP_THR(op_rb6l);
+	OP_THR(op_rb6hl);
+	OP_THR(op_rb6a);
+	OP_THR(op_rb7b);
+	OP_THR(op_rb7c);
+	OP_THR(op_rb7d);
+	OP_THR(op_rb7e);
+	OP_THR(op_rb7h);
+	OP_THR(op_rb7l);
+	OP_THR(op_rb7hl);
+	OP_THR(op_rb7a);
+	OP_THR(op_sb0b);
+	OP_THR(op_sb0c);
+	OP_THR(op_sb0d);
+	OP_THR(op_sb0e);
+	OP_THR(op_sb0h);
+	OP_THR(op_sb0l);
+	OP_THR(op_sb0hl);
+	OP_THR(op_sb0a);
+	OP_THR(op_sb1b);
+	OP_THR(op_sb1c);
+	OP_THR(op_sb1d);
+	OP_THR(op_sb1e);
+	OP_THR(op_sb1h);
+	OP_THR(op_sb1l);
+	OP_THR(op_sb1hl);
+	OP_THR(op_sb1a);
+	OP_THR(op_sb2b);
+	OP_THR(op_sb2c);
+	OP_THR(op_sb2d);
+	OP_THR(op_sb2e);
+	OP_THR(op_sb2h);
+	OP_THR(op_sb2l);
+	OP_THR(op_sb2hl);
+	OP_THR(op_sb2a);
+	OP_THR(op_sb3b);
+	OP_THR(op_sb3c);
+	OP_THR(op_sb3d);
+	OP_THR(op_sb3e);
+	OP_THR(op_sb3h);
+	OP_THR(op_sb3l);
+	OP_THR(op_sb3hl);
+	OP_THR(op_sb3a);
+	OP_THR(op_sb4b);
+	OP_THR(op_sb4c);
+	OP_THR(op_sb4d);
+	OP_THR(op_sb4e);
+	OP_THR(op_sb4h);
+	OP_THR(op_sb4l);
+	OP_THR(op_sb4hl);
+	OP_THR(op_sb4a);
+	OP_THR(op_sb5b);
+	OP_THR(op_sb5c);
+	OP_THR(op_sb5d);
+	OP_THR(op_sb5e);
+	OP_THR(op_sb5h);
+	OP_THR(op_sb5l);
+	OP_THR(op_sb5hl);
+	OP_THR(op_sb5a);
+	OP_THR(op_sb6b);
+	OP_THR(op_sb6c);
+	OP_THR(op_sb6d);
+	OP_THR(op_sb6e);
+	OP_THR(op_sb6h);
+	OP_THR(op_sb6l);
+	OP_THR(op_sb6hl);
+	OP_THR(op_sb6a);
+	OP_THR(op_sb7b);
+	OP_THR(op_sb7c);
+	OP_THR(op_sb7d);
+	OP_THR(op_sb7e);
+	OP_THR(op_sb7h);
+	OP_THR(op_sb7l);
+	OP_THR(op_sb7hl);
+	OP_THR(op_sb7a);
+
+done:
 #else
-	(*op_cb[*PC++]) ();
+	t = (*op_cb[*PC++]) ();		/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -475,7 +1005,8 @@ static int op_srll(void)		/* SRL L */
 
 static int op_srlhl(void)		/* SRL (HL) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -483,13 +1014,15 @@ static int op_srlhl(void)		/* SRL (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -578,7 +1111,8 @@ static int op_slal(void)		/* SLA L */
 
 static int op_slahl(void)		/* SLA (HL) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -586,13 +1120,15 @@ static int op_slahl(void)		/* SLA (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -710,7 +1246,8 @@ static int op_rll(void)			/* RL L */
 static int op_rlhl(void)		/* RL (HL) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -718,15 +1255,17 @@ static int op_rlhl(void)		/* RL (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
 	old_c_flag = F & C_FLAG;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
-	if (old_c_flag)	*p |= 1;
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	if (old_c_flag)	val |= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -844,7 +1383,8 @@ static int op_rrl(void)			/* RR L */
 static int op_rrhl(void)		/* RR (HL) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -853,14 +1393,16 @@ static int op_rrhl(void)		/* RR (HL) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	old_c_flag = F & C_FLAG;
-	p = ram	+ (H <<	8) + L;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	if (old_c_flag)	*p |= 128;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	if (old_c_flag)	val |= 128;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -978,7 +1520,8 @@ static int op_rrcl(void)		/* RRC L */
 static int op_rrchl(void)		/* RRC (HL) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -986,15 +1529,17 @@ static int op_rrchl(void)		/* RRC (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	i = *p & 1;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	i = val & 1;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p >>= 1;
-	if (i) *p |= 128;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val >>= 1;
+	if (i) val |= 128;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1112,7 +1657,8 @@ static int op_rlcl(void)		/* RLC L */
 static int op_rlchl(void)		/* RLC (HL) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -1120,15 +1666,17 @@ static int op_rlchl(void)		/* RLC (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	i = *p & 128;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	i = val & 128;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p <<= 1;
-	if (i) *p |= 1;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val <<= 1;
+	if (i) val |= 1;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1246,7 +1794,8 @@ static int op_sral(void)		/* SRA L */
 static int op_srahl(void)		/* SRA (HL) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -1254,15 +1803,17 @@ static int op_srahl(void)		/* SRA (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ (H <<	8) + L;
-	i = *p & 128;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	*p |= i;
+	addr = (H << 8) + L;
+	val = memrdr(addr);
+	i = val & 128;
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	val |= i;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1616,7 +2167,7 @@ static int op_sb0hl(void)		/* SET 0,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 1;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 1);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1634,7 +2185,7 @@ static int op_sb1hl(void)		/* SET 1,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 2;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1652,7 +2203,7 @@ static int op_sb2hl(void)		/* SET 2,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 4;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1670,7 +2221,7 @@ static int op_sb3hl(void)		/* SET 3,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 8;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1688,7 +2239,7 @@ static int op_sb4hl(void)		/* SET 4,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 16;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1706,7 +2257,7 @@ static int op_sb5hl(void)		/* SET 5,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 32;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1724,7 +2275,7 @@ static int op_sb6hl(void)		/* SET 6,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 64;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1742,7 +2293,7 @@ static int op_sb7hl(void)		/* SET 7,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) |= 128;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) | 128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2096,7 +2647,7 @@ static int op_rb0hl(void)		/* RES 0,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~1;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~1);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2114,7 +2665,7 @@ static int op_rb1hl(void)		/* RES 1,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~2;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2132,7 +2683,7 @@ static int op_rb2hl(void)		/* RES 2,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~4;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2150,7 +2701,7 @@ static int op_rb3hl(void)		/* RES 3,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~8;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2168,7 +2719,7 @@ static int op_rb4hl(void)		/* RES 4,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~16;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2186,7 +2737,7 @@ static int op_rb5hl(void)		/* RES 5,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~32;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2204,7 +2755,7 @@ static int op_rb6hl(void)		/* RES 6,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~64;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2222,7 +2773,7 @@ static int op_rb7hl(void)		/* RES 7,(HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) &= ~128;
+	memwrt((H << 8) + L, memrdr((H << 8) + L) & ~128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -2732,7 +3283,7 @@ static int op_tb0hl(void)		/* BIT 0,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
 				    : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2747,7 +3298,7 @@ static int op_tb1hl(void)		/* BIT 1,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
 				    : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2762,7 +3313,7 @@ static int op_tb2hl(void)		/* BIT 2,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
 				    : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2777,7 +3328,7 @@ static int op_tb3hl(void)		/* BIT 3,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
 				    : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2792,7 +3343,7 @@ static int op_tb4hl(void)		/* BIT 4,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
 				     : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2807,7 +3358,7 @@ static int op_tb5hl(void)		/* BIT 5,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
 				     : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2822,7 +3373,7 @@ static int op_tb6hl(void)		/* BIT 6,(HL) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + (H << 8) + L) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr((H << 8) + L) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
 				     : (F |= (Z_FLAG | P_FLAG));
 	return(12);
 }
@@ -2837,7 +3388,7 @@ static int op_tb7hl(void)		/* BIT 7,(HL) */
 #endif
 	F &= ~N_FLAG;
 	F |= H_FLAG;
-	if (*(ram + (H << 8) + L) & 128) {
+	if (memrdr((H << 8) + L) & 128) {
 		F &= ~(Z_FLAG | P_FLAG);
 		F |= S_FLAG;
 	} else {
@@ -32,6 +32,7 @@
 
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
@@ -61,282 +62,617 @@ static int op_undoc_ldixl(void);
 static int op_undoc_cpixl(void);
 #endif
 
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xdd.
+ */
+static int (*op_dd[256]) (void) = {
+	trap_dd,			/* 0x00	*/
+	trap_dd,			/* 0x01	*/
+	trap_dd,			/* 0x02	*/
+	trap_dd,			/* 0x03	*/
+	trap_dd,			/* 0x04	*/
+	trap_dd,			/* 0x05	*/
+	trap_dd,			/* 0x06	*/
+	trap_dd,			/* 0x07	*/
+	trap_dd,			/* 0x08	*/
+	op_addxb,			/* 0x09	*/
+	trap_dd,			/* 0x0a	*/
+	trap_dd,			/* 0x0b	*/
+	trap_dd,			/* 0x0c	*/
+	trap_dd,			/* 0x0d	*/
+	trap_dd,			/* 0x0e	*/
+	trap_dd,			/* 0x0f	*/
+	trap_dd,			/* 0x10	*/
+	trap_dd,			/* 0x11	*/
+	trap_dd,			/* 0x12	*/
+	trap_dd,			/* 0x13	*/
+	trap_dd,			/* 0x14	*/
+	trap_dd,			/* 0x15	*/
+	trap_dd,			/* 0x16	*/
+	trap_dd,			/* 0x17	*/
+	trap_dd,			/* 0x18	*/
+	op_addxd,			/* 0x19	*/
+	trap_dd,			/* 0x1a	*/
+	trap_dd,			/* 0x1b	*/
+	trap_dd,			/* 0x1c	*/
+	trap_dd,			/* 0x1d	*/
+	trap_dd,			/* 0x1e	*/
+	trap_dd,			/* 0x1f	*/
+	trap_dd,			/* 0x20	*/
+	op_ldixnn,			/* 0x21	*/
+	op_ldinx,			/* 0x22	*/
+	op_incix,			/* 0x23	*/
+	trap_dd,			/* 0x24	*/
+	trap_dd,			/* 0x25	*/
+	trap_dd,			/* 0x26	*/
+	trap_dd,			/* 0x27	*/
+	trap_dd,			/* 0x28	*/
+	op_addxx,			/* 0x29	*/
+	op_ldixinn,			/* 0x2a	*/
+	op_decix,			/* 0x2b	*/
+	trap_dd,			/* 0x2c	*/
+	trap_dd,			/* 0x2d	*/
+	trap_dd,			/* 0x2e	*/
+	trap_dd,			/* 0x2f	*/
+	trap_dd,			/* 0x30	*/
+	trap_dd,			/* 0x31	*/
+	trap_dd,			/* 0x32	*/
+	trap_dd,			/* 0x33	*/
+	op_incxd,			/* 0x34	*/
+	op_decxd,			/* 0x35	*/
+	op_ldxdn,			/* 0x36	*/
+	trap_dd,			/* 0x37	*/
+	trap_dd,			/* 0x38	*/
+	op_addxs,			/* 0x39	*/
+	trap_dd,			/* 0x3a	*/
+	trap_dd,			/* 0x3b	*/
+	trap_dd,			/* 0x3c	*/
+	trap_dd,			/* 0x3d	*/
+	trap_dd,			/* 0x3e	*/
+	trap_dd,			/* 0x3f	*/
+	trap_dd,			/* 0x40	*/
+	trap_dd,			/* 0x41	*/
+	trap_dd,			/* 0x42	*/
+	trap_dd,			/* 0x43	*/
+	trap_dd,			/* 0x44	*/
+	trap_dd,			/* 0x45	*/
+	op_ldbxd,			/* 0x46	*/
+	trap_dd,			/* 0x47	*/
+	trap_dd,			/* 0x48	*/
+	trap_dd,			/* 0x49	*/
+	trap_dd,			/* 0x4a	*/
+	trap_dd,			/* 0x4b	*/
+	trap_dd,			/* 0x4c	*/
+	trap_dd,			/* 0x4d	*/
+	op_ldcxd,			/* 0x4e	*/
+	trap_dd,			/* 0x4f	*/
+	trap_dd,			/* 0x50	*/
+	trap_dd,			/* 0x51	*/
+	trap_dd,			/* 0x52	*/
+	trap_dd,			/* 0x53	*/
+	trap_dd,			/* 0x54	*/
+	trap_dd,			/* 0x55	*/
+	op_lddxd,			/* 0x56	*/
+	trap_dd,			/* 0x57	*/
+	trap_dd,			/* 0x58	*/
+	trap_dd,			/* 0x59	*/
+	trap_dd,			/* 0x5a	*/
+	trap_dd,			/* 0x5b	*/
+	trap_dd,			/* 0x5c	*/
+	trap_dd,			/* 0x5d	*/
+	op_ldexd,			/* 0x5e	*/
+	trap_dd,			/* 0x5f	*/
+	trap_dd,			/* 0x60	*/
+	trap_dd,			/* 0x61	*/
+	trap_dd,			/* 0x62	*/
+	trap_dd,			/* 0x63	*/
+	trap_dd,			/* 0x64	*/
+	trap_dd,			/* 0x65	*/
+	op_ldhxd,			/* 0x66	*/
+	trap_dd,			/* 0x67	*/
+	trap_dd,			/* 0x68	*/
+	trap_dd,			/* 0x69	*/
+	trap_dd,			/* 0x6a	*/
+	trap_dd,			/* 0x6b	*/
+	trap_dd,			/* 0x6c	*/
+	trap_dd,			/* 0x6d	*/
+	op_ldlxd,			/* 0x6e	*/
+#ifndef Z80_UNDOC
+	trap_dd,			/* 0x6f	*/
+#else
+	op_undoc_ldixl,
+#endif
+	op_ldxdb,			/* 0x70	*/
+	op_ldxdc,			/* 0x71	*/
+	op_ldxdd,			/* 0x72	*/
+	op_ldxde,			/* 0x73	*/
+	op_ldxdh,			/* 0x74	*/
+	op_ldxdl,			/* 0x75	*/
+	trap_dd,			/* 0x76	*/
+	op_ldxda,			/* 0x77	*/
+	trap_dd,			/* 0x78	*/
+	trap_dd,			/* 0x79	*/
+	trap_dd,			/* 0x7a	*/
+	trap_dd,			/* 0x7b	*/
+	trap_dd,			/* 0x7c	*/
+	trap_dd,			/* 0x7d	*/
+	op_ldaxd,			/* 0x7e	*/
+	trap_dd,			/* 0x7f	*/
+	trap_dd,			/* 0x80	*/
+	trap_dd,			/* 0x81	*/
+	trap_dd,			/* 0x82	*/
+	trap_dd,			/* 0x83	*/
+	trap_dd,			/* 0x84	*/
+	trap_dd,			/* 0x85	*/
+	op_adaxd,			/* 0x86	*/
+	trap_dd,			/* 0x87	*/
+	trap_dd,			/* 0x88	*/
+	trap_dd,			/* 0x89	*/
+	trap_dd,			/* 0x8a	*/
+	trap_dd,			/* 0x8b	*/
+	trap_dd,			/* 0x8c	*/
+	trap_dd,			/* 0x8d	*/
+	op_acaxd,			/* 0x8e	*/
+	trap_dd,			/* 0x8f	*/
+	trap_dd,			/* 0x90	*/
+	trap_dd,			/* 0x91	*/
+	trap_dd,			/* 0x92	*/
+	trap_dd,			/* 0x93	*/
+	trap_dd,			/* 0x94	*/
+	trap_dd,			/* 0x95	*/
+	op_suaxd,			/* 0x96	*/
+	trap_dd,			/* 0x97	*/
+	trap_dd,			/* 0x98	*/
+	trap_dd,			/* 0x99	*/
+	trap_dd,			/* 0x9a	*/
+	trap_dd,			/* 0x9b	*/
+	trap_dd,			/* 0x9c	*/
+	trap_dd,			/* 0x9d	*/
+	op_scaxd,			/* 0x9e	*/
+	trap_dd,			/* 0x9f	*/
+	trap_dd,			/* 0xa0	*/
+	trap_dd,			/* 0xa1	*/
+	trap_dd,			/* 0xa2	*/
+	trap_dd,			/* 0xa3	*/
+	trap_dd,			/* 0xa4	*/
+	trap_dd,			/* 0xa5	*/
+	op_andxd,			/* 0xa6	*/
+	trap_dd,			/* 0xa7	*/
+	trap_dd,			/* 0xa8	*/
+	trap_dd,			/* 0xa9	*/
+	trap_dd,			/* 0xaa	*/
+	trap_dd,			/* 0xab	*/
+	trap_dd,			/* 0xac	*/
+	trap_dd,			/* 0xad	*/
+	op_xorxd,			/* 0xae	*/
+	trap_dd,			/* 0xaf	*/
+	trap_dd,			/* 0xb0	*/
+	trap_dd,			/* 0xb1	*/
+	trap_dd,			/* 0xb2	*/
+	trap_dd,			/* 0xb3	*/
+	trap_dd,			/* 0xb4	*/
+	trap_dd,			/* 0xb5	*/
+	op_orxd,			/* 0xb6	*/
+	trap_dd,			/* 0xb7	*/
+	trap_dd,			/* 0xb8	*/
+	trap_dd,			/* 0xb9	*/
+	trap_dd,			/* 0xba	*/
+	trap_dd,			/* 0xbb	*/
+	trap_dd,			/* 0xbc	*/
+#ifndef Z80_UNDOC
+	trap_dd,			/* 0xbd	*/
+#else
+	op_undoc_cpixl,
+#endif
+	op_cpxd,			/* 0xbe	*/
+	trap_dd,			/* 0xbf	*/
+	trap_dd,			/* 0xc0	*/
+	trap_dd,			/* 0xc1	*/
+	trap_dd,			/* 0xc2	*/
+	trap_dd,			/* 0xc3	*/
+	trap_dd,			/* 0xc4	*/
+	trap_dd,			/* 0xc5	*/
+	trap_dd,			/* 0xc6	*/
+	trap_dd,			/* 0xc7	*/
+	trap_dd,			/* 0xc8	*/
+	trap_dd,			/* 0xc9	*/
+	trap_dd,			/* 0xca	*/
+	op_ddcb_handel,			/* 0xcb	*/
+	trap_dd,			/* 0xcc	*/
+	trap_dd,			/* 0xcd	*/
+	trap_dd,			/* 0xce	*/
+	trap_dd,			/* 0xcf	*/
+	trap_dd,			/* 0xd0	*/
+	trap_dd,			/* 0xd1	*/
+	trap_dd,			/* 0xd2	*/
+	trap_dd,			/* 0xd3	*/
+	trap_dd,			/* 0xd4	*/
+	trap_dd,			/* 0xd5	*/
+	trap_dd,			/* 0xd6	*/
+	trap_dd,			/* 0xd7	*/
+	trap_dd,			/* 0xd8	*/
+	trap_dd,			/* 0xd9	*/
+	trap_dd,			/* 0xda	*/
+	trap_dd,			/* 0xdb	*/
+	trap_dd,			/* 0xdc	*/
+	trap_dd,			/* 0xdd	*/
+	trap_dd,			/* 0xde	*/
+	trap_dd,			/* 0xdf	*/
+	trap_dd,			/* 0xe0	*/
+	op_popix,			/* 0xe1	*/
+	trap_dd,			/* 0xe2	*/
+	op_exspx,			/* 0xe3	*/
+	trap_dd,			/* 0xe4	*/
+	op_pusix,			/* 0xe5	*/
+	trap_dd,			/* 0xe6	*/
+	trap_dd,			/* 0xe7	*/
+	trap_dd,			/* 0xe8	*/
+	op_jpix,			/* 0xe9	*/
+	trap_dd,			/* 0xea	*/
+	trap_dd,			/* 0xeb	*/
+	trap_dd,			/* 0xec	*/
+	trap_dd,			/* 0xed	*/
+	trap_dd,			/* 0xee	*/
+	trap_dd,			/* 0xef	*/
+	trap_dd,			/* 0xf0	*/
+	trap_dd,			/* 0xf1	*/
+	trap_dd,			/* 0xf2	*/
+	trap_dd,			/* 0xf3	*/
+	trap_dd,			/* 0xf4	*/
+	trap_dd,			/* 0xf5	*/
+	trap_dd,			/* 0xf6	*/
+	trap_dd,			/* 0xf7	*/
+	trap_dd,			/* 0xf8	*/
+	op_ldspx,			/* 0xf9	*/
+	trap_dd,			/* 0xfa	*/
+	trap_dd,			/* 0xfb	*/
+	trap_dd,			/* 0xfc	*/
+	trap_dd,			/* 0xfd	*/
+	trap_dd,			/* 0xfe	*/
+	trap_dd				/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(); goto done
+#endif
+
 long op_dd_handel(void)
 {
 	register int t;
 
-	static int (*op_dd[256]) (void) = {
-		trap_dd,			/* 0x00	*/
-		trap_dd,			/* 0x01	*/
-		trap_dd,			/* 0x02	*/
-		trap_dd,			/* 0x03	*/
-		trap_dd,			/* 0x04	*/
-		trap_dd,			/* 0x05	*/
-		trap_dd,			/* 0x06	*/
-		trap_dd,			/* 0x07	*/
-		trap_dd,			/* 0x08	*/
-		op_addxb,			/* 0x09	*/
-		trap_dd,			/* 0x0a	*/
-		trap_dd,			/* 0x0b	*/
-		trap_dd,			/* 0x0c	*/
-		trap_dd,			/* 0x0d	*/
-		trap_dd,			/* 0x0e	*/
-		trap_dd,			/* 0x0f	*/
-		trap_dd,			/* 0x10	*/
-		trap_dd,			/* 0x11	*/
-		trap_dd,			/* 0x12	*/
-		trap_dd,			/* 0x13	*/
-		trap_dd,			/* 0x14	*/
-		trap_dd,			/* 0x15	*/
-		trap_dd,			/* 0x16	*/
-		trap_dd,			/* 0x17	*/
-		trap_dd,			/* 0x18	*/
-		op_addxd,			/* 0x19	*/
-		trap_dd,			/* 0x1a	*/
-		trap_dd,			/* 0x1b	*/
-		trap_dd,			/* 0x1c	*/
-		trap_dd,			/* 0x1d	*/
-		trap_dd,			/* 0x1e	*/
-		trap_dd,			/* 0x1f	*/
-		trap_dd,			/* 0x20	*/
-		op_ldixnn,			/* 0x21	*/
-		op_ldinx,			/* 0x22	*/
-		op_incix,			/* 0x23	*/
-		trap_dd,			/* 0x24	*/
-		trap_dd,			/* 0x25	*/
-		trap_dd,			/* 0x26	*/
-		trap_dd,			/* 0x27	*/
-		trap_dd,			/* 0x28	*/
-		op_addxx,			/* 0x29	*/
-		op_ldixinn,			/* 0x2a	*/
-		op_decix,			/* 0x2b	*/
-		trap_dd,			/* 0x2c	*/
-		trap_dd,			/* 0x2d	*/
-		trap_dd,			/* 0x2e	*/
-		trap_dd,			/* 0x2f	*/
-		trap_dd,			/* 0x30	*/
-		trap_dd,			/* 0x31	*/
-		trap_dd,			/* 0x32	*/
-		trap_dd,			/* 0x33	*/
-		op_incxd,			/* 0x34	*/
-		op_decxd,			/* 0x35	*/
-		op_ldxdn,			/* 0x36	*/
-		trap_dd,			/* 0x37	*/
-		trap_dd,			/* 0x38	*/
-		op_addxs,			/* 0x39	*/
-		trap_dd,			/* 0x3a	*/
-		trap_dd,			/* 0x3b	*/
-		trap_dd,			/* 0x3c	*/
-		trap_dd,			/* 0x3d	*/
-		trap_dd,			/* 0x3e	*/
-		trap_dd,			/* 0x3f	*/
-		trap_dd,			/* 0x40	*/
-		trap_dd,			/* 0x41	*/
-		trap_dd,			/* 0x42	*/
-		trap_dd,			/* 0x43	*/
-		trap_dd,			/* 0x44	*/
-		trap_dd,			/* 0x45	*/
-		op_ldbxd,			/* 0x46	*/
-		trap_dd,			/* 0x47	*/
-		trap_dd,			/* 0x48	*/
-		trap_dd,			/* 0x49	*/
-		trap_dd,			/* 0x4a	*/
-		trap_dd,			/* 0x4b	*/
-		trap_dd,			/* 0x4c	*/
-		trap_dd,			/* 0x4d	*/
-		op_ldcxd,			/* 0x4e	*/
-		trap_dd,			/* 0x4f	*/
-		trap_dd,			/* 0x50	*/
-		trap_dd,			/* 0x51	*/
-		trap_dd,			/* 0x52	*/
-		trap_dd,			/* 0x53	*/
-		trap_dd,			/* 0x54	*/
-		trap_dd,			/* 0x55	*/
-		op_lddxd,			/* 0x56	*/
-		trap_dd,			/* 0x57	*/
-		trap_dd,			/* 0x58	*/
-		trap_dd,			/* 0x59	*/
-		trap_dd,			/* 0x5a	*/
-		trap_dd,			/* 0x5b	*/
-		trap_dd,			/* 0x5c	*/
-		trap_dd,			/* 0x5d	*/
-		op_ldexd,			/* 0x5e	*/
-		trap_dd,			/* 0x5f	*/
-		trap_dd,			/* 0x60	*/
-		trap_dd,			/* 0x61	*/
-		trap_dd,			/* 0x62	*/
-		trap_dd,			/* 0x63	*/
-		trap_dd,			/* 0x64	*/
-		trap_dd,			/* 0x65	*/
-		op_ldhxd,			/* 0x66	*/
-		trap_dd,			/* 0x67	*/
-		trap_dd,			/* 0x68	*/
-		trap_dd,			/* 0x69	*/
-		trap_dd,			/* 0x6a	*/
-		trap_dd,			/* 0x6b	*/
-		trap_dd,			/* 0x6c	*/
-		trap_dd,			/* 0x6d	*/
-		op_ldlxd,			/* 0x6e	*/
+#ifdef WANT_THREADED
+	static void *op_dd_thr[256] = {
+		&&l_trap_dd,			/* 0x00	*/
+		&&l_trap_dd,			/* 0x01	*/
+		&&l_trap_dd,			/* 0x02	*/
+		&&l_trap_dd,			/* 0x03	*/
+		&&l_trap_dd,			/* 0x04	*/
+		&&l_trap_dd,			/* 0x05	*/
+		&&l_trap_dd,			/* 0x06	*/
+		&&l_trap_dd,			/* 0x07	*/
+		&&l_trap_dd,			/* 0x08	*/
+		&&l_op_addxb,			/* 0x09	*/
+		&&l_trap_dd,			/* 0x0a	*/
+		&&l_trap_dd,			/* 0x0b	*/
+		&&l_trap_dd,			/* 0x0c	*/
+		&&l_trap_dd,			/* 0x0d	*/
+		&&l_trap_dd,			/* 0x0e	*/
+		&&l_trap_dd,			/* 0x0f	*/
+		&&l_trap_dd,			/* 0x10	*/
+		&&l_trap_dd,			/* 0x11	*/
+		&&l_trap_dd,			/* 0x12	*/
+		&&l_trap_dd,			/* 0x13	*/
+		&&l_trap_dd,			/* 0x14	*/
+		&&l_trap_dd,			/* 0x15	*/
+		&&l_trap_dd,			/* 0x16	*/
+		&&l_trap_dd,			/* 0x17	*/
+		&&l_trap_dd,			/* 0x18	*/
+		&&l_op_addxd,			/* 0x19	*/
+		&&l_trap_dd,			/* 0x1a	*/
+		&&l_trap_dd,			/* 0x1b	*/
+		&&l_trap_dd,			/* 0x1c	*/
+		&&l_trap_dd,			/* 0x1d	*/
+		&&l_trap_dd,			/* 0x1e	*/
+		&&l_trap_dd,			/* 0x1f	*/
+		&&l_trap_dd,			/* 0x20	*/
+		&&l_op_ldixnn,			/* 0x21	*/
+		&&l_op_ldinx,			/* 0x22	*/
+		&&l_op_incix,			/* 0x23	*/
+		&&l_trap_dd,			/* 0x24	*/
+		&&l_trap_dd,			/* 0x25	*/
+		&&l_trap_dd,			/* 0x26	*/
+		&&l_trap_dd,			/* 0x27	*/
+		&&l_trap_dd,			/* 0x28	*/
+		&&l_op_addxx,			/* 0x29	*/
+		&&l_op_ldixinn,			/* 0x2a	*/
+		&&l_op_decix,			/* 0x2b	*/
+		&&l_trap_dd,			/* 0x2c	*/
+		&&l_trap_dd,			/* 0x2d	*/
+		&&l_trap_dd,			/* 0x2e	*/
+		&&l_trap_dd,			/* 0x2f	*/
+		&&l_trap_dd,			/* 0x30	*/
+		&&l_trap_dd,			/* 0x31	*/
+		&&l_trap_dd,			/* 0x32	*/
+		&&l_trap_dd,			/* 0x33	*/
+		&&l_op_incxd,			/* 0x34	*/
+		&&l_op_decxd,			/* 0x35	*/
+		&&l_op_ldxdn,			/* 0x36	*/
+		&&l_trap_dd,			/* 0x37	*/
+		&&l_trap_dd,			/* 0x38	*/
+		&&l_op_addxs,			/* 0x39	*/
+		&&l_trap_dd,			/* 0x3a	*/
+		&&l_trap_dd,			/* 0x3b	*/
+		&&l_trap_dd,			/* 0x3c	*/
+		&&l_trap_dd,			/* 0x3d	*/
+		&&l_trap_dd,			/* 0x3e	*/
+		&&l_trap_dd,			/* 0x3f	*/
+		&&l_trap_dd,			/* 0x40	*/
+		&&l_trap_dd,			/* 0x41	*/
+		&&l_trap_dd,			/* 0x42	*/
+		&&l_trap_dd,			/* 0x43	*/
+		&&l_trap_dd,			/* 0x44	*/
+		&&l_trap_dd,			/* 0x45	*/
+		&&l_op_ldbxd,			/* 0x46	*/
+		&&l_trap_dd,			/* 0x47	*/
+		&&l_trap_dd,			/* 0x48	*/
+		&&l_trap_dd,			/* 0x49	*/
+		&&l_trap_dd,			/* 0x4a	*/
+		&&l_trap_dd,			/* 0x4b	*/
+		&&l_trap_dd,			/* 0x4c	*/
+		&&l_trap_dd,			/* 0x4d	*/
+		&&l_op_ldcxd,			/* 0x4e	*/
+		&&l_trap_dd,			/* 0x4f	*/
+		&&l_trap_dd,			/* 0x50	*/
+		&&l_trap_dd,			/* 0x51	*/
+		&&l_trap_dd,			/* 0x52	*/
+		&&l_trap_dd,			/* 0x53	*/
+		&&l_trap_dd,			/* 0x54	*/
+		&&l_trap_dd,			/* 0x55	*/
+		&&l_op_lddxd,			/* 0x56	*/
+		&&l_trap_dd,			/* 0x57	*/
+		&&l_trap_dd,			/* 0x58	*/
+		&&l_trap_dd,			/* 0x59	*/
+		&&l_trap_dd,			/* 0x5a	*/
+		&&l_trap_dd,			/* 0x5b	*/
+		&&l_trap_dd,			/* 0x5c	*/
+		&&l_trap_dd,			/* 0x5d	*/
+		&&l_op_ldexd,			/* 0x5e	*/
+		&&l_trap_dd,			/* 0x5f	*/
+		&&l_trap_dd,			/* 0x60	*/
+		&&l_trap_dd,			/* 0x61	*/
+		&&l_trap_dd,			/* 0x62	*/
+		&&l_trap_dd,			/* 0x63	*/
+		&&l_trap_dd,			/* 0x64	*/
+		&&l_trap_dd,			/* 0x65	*/
+		&&l_op_ldhxd,			/* 0x66	*/
+		&&l_trap_dd,			/* 0x67	*/
+		&&l_trap_dd,			/* 0x68	*/
+		&&l_trap_dd,			/* 0x69	*/
+		&&l_trap_dd,			/* 0x6a	*/
+		&&l_trap_dd,			/* 0x6b	*/
+		&&l_trap_dd,			/* 0x6c	*/
+		&&l_trap_dd,			/* 0x6d	*/
+		&&l_op_ldlxd,			/* 0x6e	*/
 #ifndef Z80_UNDOC
-		trap_dd,			/* 0x6f	*/
+		&&l_trap_dd,			/* 0x6f	*/
 #else
-		op_undoc_ldixl,
-#endif
-		op_ldxdb,			/* 0x70	*/
-		op_ldxdc,			/* 0x71	*/
-		op_ldxdd,			/* 0x72	*/
-		op_ldxde,			/* 0x73	*/
-		op_ldxdh,			/* 0x74	*/
-		op_ldxdl,			/* 0x75	*/
-		trap_dd,			/* 0x76	*/
-		op_ldxda,			/* 0x77	*/
-		trap_dd,			/* 0x78	*/
-		trap_dd,			/* 0x79	*/
-		trap_dd,			/* 0x7a	*/
-		trap_dd,			/* 0x7b	*/
-		trap_dd,			/* 0x7c	*/
-		trap_dd,			/* 0x7d	*/
-		op_ldaxd,			/* 0x7e	*/
-		trap_dd,			/* 0x7f	*/
-		trap_dd,			/* 0x80	*/
-		trap_dd,			/* 0x81	*/
-		trap_dd,			/* 0x82	*/
-		trap_dd,			/* 0x83	*/
-		trap_dd,			/* 0x84	*/
-		trap_dd,			/* 0x85	*/
-		op_adaxd,			/* 0x86	*/
-		trap_dd,			/* 0x87	*/
-		trap_dd,			/* 0x88	*/
-		trap_dd,			/* 0x89	*/
-		trap_dd,			/* 0x8a	*/
-		trap_dd,			/* 0x8b	*/
-		trap_dd,			/* 0x8c	*/
-		trap_dd,			/* 0x8d	*/
-		op_acaxd,			/* 0x8e	*/
-		trap_dd,			/* 0x8f	*/
-		trap_dd,			/* 0x90	*/
-		trap_dd,			/* 0x91	*/
-		trap_dd,			/* 0x92	*/
-		trap_dd,			/* 0x93	*/
-		trap_dd,			/* 0x94	*/
-		trap_dd,			/* 0x95	*/
-		op_suaxd,			/* 0x96	*/
-		trap_dd,			/* 0x97	*/
-		trap_dd,			/* 0x98	*/
-		trap_dd,			/* 0x99	*/
-		trap_dd,			/* 0x9a	*/
-		trap_dd,			/* 0x9b	*/
-		trap_dd,			/* 0x9c	*/
-		trap_dd,			/* 0x9d	*/
-		op_scaxd,			/* 0x9e	*/
-		trap_dd,			/* 0x9f	*/
-		trap_dd,			/* 0xa0	*/
-		trap_dd,			/* 0xa1	*/
-		trap_dd,			/* 0xa2	*/
-		trap_dd,			/* 0xa3	*/
-		trap_dd,			/* 0xa4	*/
-		trap_dd,			/* 0xa5	*/
-		op_andxd,			/* 0xa6	*/
-		trap_dd,			/* 0xa7	*/
-		trap_dd,			/* 0xa8	*/
-		trap_dd,			/* 0xa9	*/
-		trap_dd,			/* 0xaa	*/
-		trap_dd,			/* 0xab	*/
-		trap_dd,			/* 0xac	*/
-		trap_dd,			/* 0xad	*/
-		op_xorxd,			/* 0xae	*/
-		trap_dd,			/* 0xaf	*/
-		trap_dd,			/* 0xb0	*/
-		trap_dd,			/* 0xb1	*/
-		trap_dd,			/* 0xb2	*/
-		trap_dd,			/* 0xb3	*/
-		trap_dd,			/* 0xb4	*/
-		trap_dd,			/* 0xb5	*/
-		op_orxd,			/* 0xb6	*/
-		trap_dd,			/* 0xb7	*/
-		trap_dd,			/* 0xb8	*/
-		trap_dd,			/* 0xb9	*/
-		trap_dd,			/* 0xba	*/
-		trap_dd,			/* 0xbb	*/
-		trap_dd,			/* 0xbc	*/
+		&&l_op_undoc_ldixl,
+#endif
+		&&l_op_ldxdb,			/* 0x70	*/
+		&&l_op_ldxdc,			/* 0x71	*/
+		&&l_op_ldxdd,			/* 0x72	*/
+		&&l_op_ldxde,			/* 0x73	*/
+		&&l_op_ldxdh,			/* 0x74	*/
+		&&l_op_ldxdl,			/* 0x75	*/
+		&&l_trap_dd,			/* 0x76	*/
+		&&l_op_ldxda,			/* 0x77	*/
+		&&l_trap_dd,			/* 0x78	*/
+		&&l_trap_dd,			/* 0x79	*/
+		&&l_trap_dd,			/* 0x7a	*/
+		&&l_trap_dd,			/* 0x7b	*/
+		&&l_trap_dd,			/* 0x7c	*/
+		&&l_trap_dd,			/* 0x7d	*/
+		&&l_op_ldaxd,			/* 0x7e	*/
+		&&l_trap_dd,			/* 0x7f	*/
+		&&l_trap_dd,			/* 0x80	*/
+		&&l_trap_dd,			/* 0x81	*/
+		&&l_trap_dd,			/* 0x82	*/
+		&&l_trap_dd,			/* 0x83	*/
+		&&l_trap_dd,			/* 0x84	*/
+		&&l_trap_dd,			/* 0x85	*/
+		&&l_op_adaxd,			/* 0x86	*/
+		&&l_trap_dd,			/* 0x87	*/
+		&&l_trap_dd,			/* 0x88	*/
+		&&l_trap_dd,			/* 0x89	*/
+		&&l_trap_dd,			/* 0x8a	*/
+		&&l_trap_dd,			/* 0x8b	*/
+		&&l_trap_dd,			/* 0x8c	*/
+		&&l_trap_dd,			/* 0x8d	*/
+		&&l_op_acaxd,			/* 0x8e	*/
+		&&l_trap_dd,			/* 0x8f	*/
+		&&l_trap_dd,			/* 0x90	*/
+		&&l_trap_dd,			/* 0x91	*/
+		&&l_trap_dd,			/* 0x92	*/
+		&&l_trap_dd,			/* 0x93	*/
+		&&l_trap_dd,			/* 0x94	*/
+		&&l_trap_dd,			/* 0x95	*/
+		&&l_op_suaxd,			/* 0x96	*/
+		&&l_trap_dd,			/* 0x97	*/
+		&&l_trap_dd,			/* 0x98	*/
+		&&l_trap_dd,			/* 0x99	*/
+		&&l_trap_dd,			/* 0x9a	*/
+		&&l_trap_dd,			/* 0x9b	*/
+		&&l_trap_dd,			/* 0x9c	*/
+		&&l_trap_dd,			/* 0x9d	*/
+		&&l_op_scaxd,			/* 0x9e	*/
+		&&l_trap_dd,			/* 0x9f	*/
+		&&l_trap_dd,			/* 0xa0	*/
+		&&l_trap_dd,			/* 0xa1	*/
+		&&l_trap_dd,			/* 0xa2	*/
+		&&l_trap_dd,			/* 0xa3	*/
+		&&l_trap_dd,			/* 0xa4	*/
+		&&l_trap_dd,			/* 0xa5	*/
+		&&l_op_andxd,			/* 0xa6	*/
+		&&l_trap_dd,			/* 0xa7	*/
+		&&l_trap_dd,			/* 0xa8	*/
+		&&l_trap_dd,			/* 0xa9	*/
+		&&l_trap_dd,			/* 0xaa	*/
+		&&l_trap_dd,			/* 0xab	*/
+		&&l_trap_dd,			/* 0xac	*/
+		&&l_trap_dd,			/* 0xad	*/
+		&&l_op_xorxd,			/* 0xae	*/
+		&&l_trap_dd,			/* 0xaf	*/
+		&&l_trap_dd,			/* 0xb0	*/
+		&&l_trap_dd,			/* 0xb1	*/
+		&&l_trap_dd,			/* 0xb2	*/
+		&&l_trap_dd,			/* 0xb3	*/
+		&&l_trap_dd,			/* 0xb4	*/
+		&&l_trap_dd,			/* 0xb5	*/
+		&&l_op_orxd,			/* 0xb6	*/
+		&&l_trap_dd,			/* 0xb7	*/
+		&&l_trap_dd,			/* 0xb8	*/
+		&&l_trap_dd,			/* 0xb9	*/
+		&&l_trap_dd,			/* 0xba	*/
+		&&l_trap_dd,			/* 0xbb	*/
+		&&l_trap_dd,			/* 0xbc	*/
 #ifndef Z80_UNDOC
-		trap_dd,			/* 0xbd	*/
+		&&l_trap_dd,			/* 0xbd	*/
 #else
-		op_undoc_cpixl,
-#endif
-		op_cpxd,			/* 0xbe	*/
-		trap_dd,			/* 0xbf	*/
-		trap_dd,			/* 0xc0	*/
-		trap_dd,			/* 0xc1	*/
-		trap_dd,			/* 0xc2	*/
-		trap_dd,			/* 0xc3	*/
-		trap_dd,			/* 0xc4	*/
-		trap_dd,			/* 0xc5	*/
-		trap_dd,			/* 0xc6	*/
-		trap_dd,			/* 0xc7	*/
-		trap_dd,			/* 0xc8	*/
-		trap_dd,			/* 0xc9	*/
-		trap_dd,			/* 0xca	*/
-		op_ddcb_handel,			/* 0xcb	*/
-		trap_dd,			/* 0xcc	*/
-		trap_dd,			/* 0xcd	*/
-		trap_dd,			/* 0xce	*/
-		trap_dd,			/* 0xcf	*/
-		trap_dd,			/* 0xd0	*/
-		trap_dd,			/* 0xd1	*/
-		trap_dd,			/* 0xd2	*/
-		trap_dd,			/* 0xd3	*/
-		trap_dd,			/* 0xd4	*/
-		trap_dd,			/* 0xd5	*/
-		trap_dd,			/* 0xd6	*/
-		trap_dd,			/* 0xd7	*/
-		trap_dd,			/* 0xd8	*/
-		trap_dd,			/* 0xd9	*/
-		trap_dd,			/* 0xda	*/
-		trap_dd,			/* 0xdb	*/
-		trap_dd,			/* 0xdc	*/
-		trap_dd,			/* 0xdd	*/
-		trap_dd,			/* 0xde	*/
-		trap_dd,			/* 0xdf	*/
-		trap_dd,			/* 0xe0	*/
-		op_popix,			/* 0xe1	*/
-		trap_dd,			/* 0xe2	*/
-		op_exspx,			/* 0xe3	*/
-		trap_dd,			/* 0xe4	*/
-		op_pusix,			/* 0xe5	*/
-		trap_dd,			/* 0xe6	*/
-		trap_dd,			/* 0xe7	*/
-		trap_dd,			/* 0xe8	*/
-		op_jpix,			/* 0xe9	*/
-		trap_dd,			/* 0xea	*/
-		trap_dd,			/* 0xeb	*/
-		trap_dd,			/* 0xec	*/
-		trap_dd,			/* 0xed	*/
-		trap_dd,			/* 0xee	*/
-		trap_dd,			/* 0xef	*/
-		trap_dd,			/* 0xf0	*/
-		trap_dd,			/* 0xf1	*/
-		trap_dd,			/* 0xf2	*/
-		trap_dd,			/* 0xf3	*/
-		trap_dd,			/* 0xf4	*/
-		trap_dd,			/* 0xf5	*/
-		trap_dd,			/* 0xf6	*/
-		trap_dd,			/* 0xf7	*/
-		trap_dd,			/* 0xf8	*/
-		op_ldspx,			/* 0xf9	*/
-		trap_dd,			/* 0xfa	*/
-		trap_dd,			/* 0xfb	*/
-		trap_dd,			/* 0xfc	*/
-		trap_dd,			/* 0xfd	*/
-		trap_dd,			/* 0xfe	*/
-		trap_dd				/* 0xff	*/
+		&&l_op_undoc_cpixl,
+#endif
+		&&l_op_cpxd,			/* 0xbe	*/
+		&&l_trap_dd,			/* 0xbf	*/
+		&&l_trap_dd,			/* 0xc0	*/
+		&&l_trap_dd,			/* 0xc1	*/
+		&&l_trap_dd,			/* 0xc2	*/
+		&&l_trap_dd,			/* 0xc3	*/
+		&&l_trap_dd,			/* 0xc4	*/
+		&&l_trap_dd,			/* 0xc5	*/
+		&&l_trap_dd,			/* 0xc6	*/
+		&&l_trap_dd,			/* 0xc7	*/
+		&&l_trap_dd,			/* 0xc8	*/
+		&&l_trap_dd,			/* 0xc9	*/
+		&&l_trap_dd,			/* 0xca	*/
+		&&l_op_ddcb_handel,		/* 0xcb	*/
+		&&l_trap_dd,			/* 0xcc	*/
+		&&l_trap_dd,			/* 0xcd	*/
+		&&l_trap_dd,			/* 0xce	*/
+		&&l_trap_dd,			/* 0xcf	*/
+		&&l_trap_dd,			/* 0xd0	*/
+		&&l_trap_dd,			/* 0xd1	*/
+		&&l_trap_dd,			/* 0xd2	*/
+		&&l_trap_dd,			/* 0xd3	*/
+		&&l_trap_dd,			/* 0xd4	*/
+		&&l_trap_dd,			/* 0xd5	*/
+		&&l_trap_dd,			/* 0xd6	*/
+		&&l_trap_dd,			/* 0xd7	*/
+		&&l_trap_dd,			/* 0xd8	*/
+		&&l_trap_dd,			/* 0xd9	*/
+		&&l_trap_dd,			/* 0xda	*/
+		&&l_trap_dd,			/* 0xdb	*/
+		&&l_trap_dd,			/* 0xdc	*/
+		&&l_trap_dd,			/* 0xdd	*/
+		&&l_trap_dd,			/* 0xde	*/
+		&&l_trap_dd,			/* 0xdf	*/
+		&&l_trap_dd,			/* 0xe0	*/
+		&&l_op_popix,			/* 0xe1	*/
+		&&l_trap_dd,			/* 0xe2	*/
+		&&l_op_exspx,			/* 0xe3	*/
+		&&l_trap_dd,			/* 0xe4	*/
+		&&l_op_pusix,			/* 0xe5	*/
+		&&l_trap_dd,			/* 0xe6	*/
+		&&l_trap_dd,			/* 0xe7	*/
+		&&l_trap_dd,			/* 0xe8	*/
+		&&l_op_jpix,			/* 0xe9	*/
+		&&l_trap_dd,			/* 0xea	*/
+		&&l_trap_dd,			/* 0xeb	*/
+		&&l_trap_dd,			/* 0xec	*/
+		&&l_trap_dd,			/* 0xed	*/
+		&&l_trap_dd,			/* 0xee	*/
+		&&l_trap_dd,			/* 0xef	*/
+		&&l_trap_dd,			/* 0xf0	*/
+		&&l_trap_dd,			/* 0xf1	*/
+		&&l_trap_dd,			/* 0xf2	*/
+		&&l_trap_dd,			/* 0xf3	*/
+		&&l_trap_dd,			/* 0xf4	*/
+		&&l_trap_dd,			/* 0xf5	*/
+		&&l_trap_dd,			/* 0xf6	*/
+		&&l_trap_dd,			/* 0xf7	*/
+		&&l_trap_dd,			/* 0xf8	*/
+		&&l_op_ldspx,			/* 0xf9	*/
+		&&l_trap_dd,			/* 0xfa	*/
+		&&l_trap_dd,			/* 0xfb	*/
+		&&l_trap_dd,			/* 0xfc	*/
+		&&l_trap_dd,			/* 0xfd	*/
+		&&l_trap_dd,			/* 0xfe	*/
+		&&l_trap_dd			/* 0xff	*/
 	};
+#endif
 
 
-#ifdef WANT_TIM
-	t = (*op_dd[*PC++]) ();		/* execute next opcode */
+	LF_EVAL();			/* opcodes with prefix use F */
+
+#ifdef WANT_THREADED
+	goto *op_dd_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(trap_dd);
+	OP_THR(op_addxb);
+	OP_THR(op_addxd);
+	OP_THR(op_ldixnn);
+	OP_THR(op_ldinx);
+	OP_THR(op_incix);
+	OP_THR(op_addxx);
+	OP_THR(op_ldixinn);
+	OP_THR(op_decix);
+	OP_THR(op_incxd);
+	OP_THR(op_decxd);
+	OP_THR(op_ldxdn);
+	OP_THR(op_addxs);
+	OP_THR(op_ldbxd);
+	OP_THR(op_ldcxd);
+	OP_THR(op_lddxd);
+	OP_THR(op_ldexd);
+	OP_THR(op_ldhxd);
+	OP_THR(op_ldlxd);
+#ifdef Z80_UNDOC
+	OP_THR(op_undoc_ldixl);
+#endif
+	OP_THR(op_ldxdb);
+	OP_THR(op_ldxdc);
+	OP_THR(op_ldxdd);
+	OP_THR(op_ldxde);
+	OP_THR(op_ldxdh);
+	OP_THR(op_ldxdl);
+	OP_THR(op_ldxda);
+	OP_THR(op_ldaxd);
+	OP_THR(op_adaxd);
+	OP_THR(op_acaxd);
+	OP_THR(op_suaxd);
+	OP_THR(op_scaxd);
+	OP_THR(op_andxd);
+	OP_THR(op_xorxd);
+	OP_THR(op_orxd);
+#ifdef Z80_UNDOC
+	OP_THR(op_undoc_cpixl);
+#endif
+	OP_THR(op_cpxd);
+	OP_THR(op_ddcb_handel);
+	OP_THR(op_popix);
+	OP_THR(op_exspx);
+	OP_THR(op_pusix);
+	OP_THR(op_jpix);
+	OP_THR(op_ldspx);
+
+done:
 #else
-	(*op_dd[*PC++]) ();
+	t = (*op_dd[*PC++]) ();		/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -370,12 +706,12 @@ static int op_popix(void)		/* POP IX */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	IX = *STACK++;
+	IX = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	IX += *STACK++ << 8;
+	IX += memrdr(STACK++ - ram) << 8;
 	return(14);
 }
 
@@ -391,12 +727,12 @@ static int op_pusix(void)		/* PUSH IX */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = IX >> 8;
+	memwrt(--STACK - ram, IX >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = IX;
+	memwrt(--STACK - ram, IX);
 	return(15);
 }
 
@@ -416,9 +752,9 @@ static int op_exspx(void)		/* EX (SP),IX */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK + (*(STACK +	1) << 8);
-	*STACK = IX;
-	*(STACK	+ 1) = IX >> 8;
+	i = memrdr(STACK - ram) + (memrdr(STACK + 1 - ram) << 8);
+	memwrt(STACK - ram, IX);
+	memwrt(STACK - ram + 1, IX >> 8);
 	IX = i;
 #ifdef BUS_8080
 	cpu_bus = CPU_STACK;
@@ -477,14 +813,13 @@ static int op_ldinx(void)		/* LD (nn),IX */
 #endif
 	p = ram	+ *PC++;
 	p += *PC++ << 8;
-	*p++ = IX;
-	*p = IX	>> 8;
+	memwrt(p++ - ram, IX);
+	memwrt(p - ram, IX	>> 8);
 	return(20);
 }
 
 static int op_adaxd(void)		/* ADD A,(IX+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -493,20 +828,15 @@ static int op_adaxd(void)		/* ADD A,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IX + (signed char)	*PC++);
-	((A & 0xf) + (P	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr(IX + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][P];
+	A += P;
 	return(19);
 }
 
 static int op_acaxd(void)		/* ADC A,(IX+d) */
 {
-	register int i,	carry;
+	register int carry;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -515,21 +845,15 @@ static int op_acaxd(void)		/* ADC A,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	carry =	(F & C_FLAG) ? 1 : 0;
-	P = *(ram + IX + (signed char)	*PC++);
-	((A & 0xf) + (P	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr(IX + (signed char)	*PC++);
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][P];
+	A += P + carry;
 	return(19);
 }
 
 static int op_suaxd(void)		/* SUB A,(IX+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -538,20 +862,15 @@ static int op_suaxd(void)		/* SUB A,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IX + (signed char)	*PC++);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IX + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+	A -= P;
 	return(19);
 }
 
 static int op_scaxd(void)		/* SBC A,(IX+d) */
 {
-	register int i,	carry;
+	register int carry;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -560,15 +879,10 @@ static int op_scaxd(void)		/* SBC A,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	carry =	(F & C_FLAG) ? 1 : 0;
-	P = *(ram + IX + (signed char)	*PC++);
-	((P & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IX + (signed char)	*PC++);
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][P];
+	A -= P + carry;
 	return(19);
 }
 
@@ -580,12 +894,8 @@ static int op_andxd(void)		/* AND (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A &= *(ram + IX	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	A &= memrdr(IX	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
 	return(19);
 }
 
@@ -597,11 +907,8 @@ static int op_xorxd(void)		/* XOR (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A ^= *(ram + IX	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	A ^= memrdr(IX	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
 	return(19);
 }
 
@@ -613,17 +920,13 @@ static int op_orxd(void)		/* OR (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A |= *(ram + IX	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	A |= memrdr(IX	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
 	return(19);
 }
 
 static int op_cpxd(void)		/* CP (IX+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -632,20 +935,15 @@ static int op_cpxd(void)		/* CP (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IX + (signed char)	*PC++);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IX + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
 	return(19);
 }
 
 static int op_incxd(void)		/* INC (IX+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -653,13 +951,10 @@ static int op_incxd(void)		/* INC (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + (signed char) *PC++;
-	((*p & 0xf) + 1	> 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	(*p)++;
-	(*p == 128) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F &= ~N_FLAG;
+	addr = IX + (signed char) *PC++;
+	val = memrdr(addr);
+	memwrt(addr, ++val);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[val];
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -671,7 +966,8 @@ static int op_incxd(void)		/* INC (IX+d) */
 
 static int op_decxd(void)		/* DEC (IX+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -679,13 +975,10 @@ static int op_decxd(void)		/* DEC (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + (signed char) *PC++;
-	(((*p - 1) & 0xf)	== 0xf)	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(*p)--;
-	(*p == 127) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F |= N_FLAG;
+	addr = IX + (signed char) *PC++;
+	val = memrdr(addr);
+	memwrt(addr, --val);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[val];
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -865,7 +1158,7 @@ static int op_ldxda(void)		/* LD (IX+d),A */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = A;
+	memwrt(IX + (signed char) *PC++, A);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -883,7 +1176,7 @@ static int op_ldxdb(void)		/* LD (IX+d),B */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = B;
+	memwrt(IX + (signed char) *PC++, B);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -901,7 +1194,7 @@ static int op_ldxdc(void)		/* LD (IX+d),C */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = C;
+	memwrt(IX + (signed char) *PC++, C);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -919,7 +1212,7 @@ static int op_ldxdd(void)		/* LD (IX+d),D */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = D;
+	memwrt(IX + (signed char) *PC++, D);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -937,7 +1230,7 @@ static int op_ldxde(void)		/* LD (IX+d),E */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = E;
+	memwrt(IX + (signed char) *PC++, E);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -955,7 +1248,7 @@ static int op_ldxdh(void)		/* LD (IX+d),H */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = H;
+	memwrt(IX + (signed char) *PC++, H);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -973,7 +1266,7 @@ static int op_ldxdl(void)		/* LD (IX+d),L */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IX + (signed char) *PC++ + ram) = L;
+	memwrt(IX + (signed char) *PC++, L);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -994,7 +1287,7 @@ static int op_ldxdn(void)		/* LD (IX+d),n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	d = (signed char) *PC++;
-	*(IX + d + ram)	= *PC++;
+	memwrt(IX + d, *PC++);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1023,20 +1316,13 @@ static int op_undoc_ldixl(void)		/* LD IXL,A */
 
 static int op_undoc_cpixl(void)		/* CP IXL */
 {
-	register int i;
 	register BYTE P;
 
 	if (z_flag)
 		trap_dd();
 
 	P = IX & 0xff;
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
 	return(9);
 }
 
@@ -30,13 +30,22 @@
  *	starting with 0xed
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* memrchr() */
+#endif
+
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
 #endif
 
+#if !defined(BUS_8080) && !defined(FRONTPANEL)
+#define BLK_BULK	/* block instructions without bus cycles */
+#endif			/* are done in bulk with memmove() etc. */
+
 static int trap_ed(void);
 static int op_im0(void), op_im1(void), op_im2(void);
 static int op_reti(void), op_retn(void);
@@ -58,273 +67,662 @@ static int op_ldi(void), op_ldir(void), op_ldd(void), op_lddr(void);
 static int op_cpi(void), op_cpir(void), op_cpdop(void), op_cpdr(void);
 static int op_oprld(void), op_oprrd(void);
 
+extern int io_blk_in(BYTE, BYTE *, int), io_blk_out(BYTE, BYTE *, int);
+
+/*
+ *	Number of iterations of a block instruction with n bytes
+ *	to transfer and t T-states per iteration, which can be done
+ *	until the next event is due, at least one. If the instruction
+ *	isn't finished after them, it sets back PC and is executed
+ *	again after the events and interrupts were handled, like the
+ *	Z80 does it after every iteration.
+ */
+static inline unsigned blk_cnt(unsigned n, int t)
+{
+	register long long left = ev_next;
+
+#ifdef WANT_INT
+	/* an interrupt, which can't be accepted yet, doesn't matter */
+	if (int_type == INT_INT && IFF != 3)
+		left = cpu_ctx->ev_n ? cpu_ctx->ev_q[0].time : EV_NEVER;
+#endif
+	left -= ev_clock;
+	if (left <= t)
+		return(1);
+	if (left < (long long) t * n)
+		return((left + t - 1) / t);
+	return(n);
+}
+
+/*
+ *	Set back PC to the prefix of a repeated block instruction
+ */
+static inline void blk_rep(void)
+{
+	PC = ram + ((PC - ram - 2) & 0xffff);
+}
+
+#ifdef BLK_BULK
+/*
+ *	Search byte c backwards in the n bytes ending at p
+ */
+static inline BYTE *blk_rchr(BYTE *p, BYTE c, unsigned n)
+{
+#ifdef __GLIBC__
+	return(memrchr(p - n + 1, c, n));
+#else
+	for (; n > 0; n--, p--)
+		if (*p == c)
+			return(p);
+	return(NULL);
+#endif
+}
+#endif
+
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xed.
+ */
+static int (*op_ed[256]) (void) = {
+	trap_ed,			/* 0x00	*/
+	trap_ed,			/* 0x01	*/
+	trap_ed,			/* 0x02	*/
+	trap_ed,			/* 0x03	*/
+	trap_ed,			/* 0x04	*/
+	trap_ed,			/* 0x05	*/
+	trap_ed,			/* 0x06	*/
+	trap_ed,			/* 0x07	*/
+	trap_ed,			/* 0x08	*/
+	trap_ed,			/* 0x09	*/
+	trap_ed,			/* 0x0a	*/
+	trap_ed,			/* 0x0b	*/
+	trap_ed,			/* 0x0c	*/
+	trap_ed,			/* 0x0d	*/
+	trap_ed,			/* 0x0e	*/
+	trap_ed,			/* 0x0f	*/
+	trap_ed,			/* 0x10	*/
+	trap_ed,			/* 0x11	*/
+	trap_ed,			/* 0x12	*/
+	trap_ed,			/* 0x13	*/
+	trap_ed,			/* 0x14	*/
+	trap_ed,			/* 0x15	*/
+	trap_ed,			/* 0x16	*/
+	trap_ed,			/* 0x17	*/
+	trap_ed,			/* 0x18	*/
+	trap_ed,			/* 0x19	*/
+	trap_ed,			/* 0x1a	*/
+	trap_ed,			/* 0x1b	*/
+	trap_ed,			/* 0x1c	*/
+	trap_ed,			/* 0x1d	*/
+	trap_ed,			/* 0x1e	*/
+	trap_ed,			/* 0x1f	*/
+	trap_ed,			/* 0x20	*/
+	trap_ed,			/* 0x21	*/
+	trap_ed,			/* 0x22	*/
+	trap_ed,			/* 0x23	*/
+	trap_ed,			/* 0x24	*/
+	trap_ed,			/* 0x25	*/
+	trap_ed,			/* 0x26	*/
+	trap_ed,			/* 0x27	*/
+	trap_ed,			/* 0x28	*/
+	trap_ed,			/* 0x29	*/
+	trap_ed,			/* 0x2a	*/
+	trap_ed,			/* 0x2b	*/
+	trap_ed,			/* 0x2c	*/
+	trap_ed,			/* 0x2d	*/
+	trap_ed,			/* 0x2e	*/
+	trap_ed,			/* 0x2f	*/
+	trap_ed,			/* 0x30	*/
+	trap_ed,			/* 0x31	*/
+	trap_ed,			/* 0x32	*/
+	trap_ed,			/* 0x33	*/
+	trap_ed,			/* 0x34	*/
+	trap_ed,			/* 0x35	*/
+	trap_ed,			/* 0x36	*/
+	trap_ed,			/* 0x37	*/
+	trap_ed,			/* 0x38	*/
+	trap_ed,			/* 0x39	*/
+	trap_ed,			/* 0x3a	*/
+	trap_ed,			/* 0x3b	*/
+	trap_ed,			/* 0x3c	*/
+	trap_ed,			/* 0x3d	*/
+	trap_ed,			/* 0x3e	*/
+	trap_ed,			/* 0x3f	*/
+	op_inbic,			/* 0x40	*/
+	op_outcb,			/* 0x41	*/
+	op_sbchb,			/* 0x42	*/
+	op_ldinbc,			/* 0x43	*/
+	op_neg,				/* 0x44	*/
+	op_retn,			/* 0x45	*/
+	op_im0,				/* 0x46	*/
+	op_ldia,			/* 0x47	*/
+	op_incic,			/* 0x48	*/
+	op_outcc,			/* 0x49	*/
+	op_adchb,			/* 0x4a	*/
+	op_ldbcinn,			/* 0x4b	*/
+	trap_ed,			/* 0x4c	*/
+	op_reti,			/* 0x4d	*/
+	trap_ed,			/* 0x4e	*/
+	op_ldra,			/* 0x4f	*/
+	op_indic,			/* 0x50	*/
+	op_outcd,			/* 0x51	*/
+	op_sbchd,			/* 0x52	*/
+	op_ldinde,			/* 0x53	*/
+	trap_ed,			/* 0x54	*/
+	trap_ed,			/* 0x55	*/
+	op_im1,				/* 0x56	*/
+	op_ldai,			/* 0x57	*/
+	op_ineic,			/* 0x58	*/
+	op_outce,			/* 0x59	*/
+	op_adchd,			/* 0x5a	*/
+	op_lddeinn,			/* 0x5b	*/
+	trap_ed,			/* 0x5c	*/
+	trap_ed,			/* 0x5d	*/
+	op_im2,				/* 0x5e	*/
+	op_ldar,			/* 0x5f	*/
+	op_inhic,			/* 0x60	*/
+	op_outch,			/* 0x61	*/
+	op_sbchh,			/* 0x62	*/
+	trap_ed,			/* 0x63	*/
+	trap_ed,			/* 0x64	*/
+	trap_ed,			/* 0x65	*/
+	trap_ed,			/* 0x66	*/
+	op_oprrd,			/* 0x67	*/
+	op_inlic,			/* 0x68	*/
+	op_outcl,			/* 0x69	*/
+	op_adchh,			/* 0x6a	*/
+	trap_ed,			/* 0x6b	*/
+	trap_ed,			/* 0x6c	*/
+	trap_ed,			/* 0x6d	*/
+	trap_ed,			/* 0x6e	*/
+	op_oprld,			/* 0x6f	*/
+	trap_ed,			/* 0x70	*/
+	trap_ed,			/* 0x71	*/
+	op_sbchs,			/* 0x72	*/
+	op_ldinsp,			/* 0x73	*/
+	trap_ed,			/* 0x74	*/
+	trap_ed,			/* 0x75	*/
+	trap_ed,			/* 0x76	*/
+	trap_ed,			/* 0x77	*/
+	op_inaic,			/* 0x78	*/
+	op_outca,			/* 0x79	*/
+	op_adchs,			/* 0x7a	*/
+	op_ldspinn,			/* 0x7b	*/
+	trap_ed,			/* 0x7c	*/
+	trap_ed,			/* 0x7d	*/
+	trap_ed,			/* 0x7e	*/
+	trap_ed,			/* 0x7f	*/
+	trap_ed,			/* 0x80	*/
+	trap_ed,			/* 0x81	*/
+	trap_ed,			/* 0x82	*/
+	trap_ed,			/* 0x83	*/
+	trap_ed,			/* 0x84	*/
+	trap_ed,			/* 0x85	*/
+	trap_ed,			/* 0x86	*/
+	trap_ed,			/* 0x87	*/
+	trap_ed,			/* 0x88	*/
+	trap_ed,			/* 0x89	*/
+	trap_ed,			/* 0x8a	*/
+	trap_ed,			/* 0x8b	*/
+	trap_ed,			/* 0x8c	*/
+	trap_ed,			/* 0x8d	*/
+	trap_ed,			/* 0x8e	*/
+	trap_ed,			/* 0x8f	*/
+	trap_ed,			/* 0x90	*/
+	trap_ed,			/* 0x91	*/
+	trap_ed,			/* 0x92	*/
+	trap_ed,			/* 0x93	*/
+	trap_ed,			/* 0x94	*/
+	trap_ed,			/* 0x95	*/
+	trap_ed,			/* 0x96	*/
+	trap_ed,			/* 0x97	*/
+	trap_ed,			/* 0x98	*/
+	trap_ed,			/* 0x99	*/
+	trap_ed,			/* 0x9a	*/
+	trap_ed,			/* 0x9b	*/
+	trap_ed,			/* 0x9c	*/
+	trap_ed,			/* 0x9d	*/
+	trap_ed,			/* 0x9e	*/
+	trap_ed,			/* 0x9f	*/
+	op_ldi,				/* 0xa0	*/
+	op_cpi,				/* 0xa1	*/
+	op_ini,				/* 0xa2	*/
+	op_outi,			/* 0xa3	*/
+	trap_ed,			/* 0xa4	*/
+	trap_ed,			/* 0xa5	*/
+	trap_ed,			/* 0xa6	*/
+	trap_ed,			/* 0xa7	*/
+	op_ldd,				/* 0xa8	*/
+	op_cpdop,			/* 0xa9	*/
+	op_ind,				/* 0xaa	*/
+	op_outd,			/* 0xab	*/
+	trap_ed,			/* 0xac	*/
+	trap_ed,			/* 0xad	*/
+	trap_ed,			/* 0xae	*/
+	trap_ed,			/* 0xaf	*/
+	op_ldir,			/* 0xb0	*/
+	op_cpir,			/* 0xb1	*/
+	op_inir,			/* 0xb2	*/
+	op_otir,			/* 0xb3	*/
+	trap_ed,			/* 0xb4	*/
+	trap_ed,			/* 0xb5	*/
+	trap_ed,			/* 0xb6	*/
+	trap_ed,			/* 0xb7	*/
+	op_lddr,			/* 0xb8	*/
+	op_cpdr,			/* 0xb9	*/
+	op_indr,			/* 0xba	*/
+	op_otdr,			/* 0xbb	*/
+	trap_ed,			/* 0xbc	*/
+	trap_ed,			/* 0xbd	*/
+	trap_ed,			/* 0xbe	*/
+	trap_ed,			/* 0xbf	*/
+	trap_ed,			/* 0xc0	*/
+	trap_ed,			/* 0xc1	*/
+	trap_ed,			/* 0xc2	*/
+	trap_ed,			/* 0xc3	*/
+	trap_ed,			/* 0xc4	*/
+	trap_ed,			/* 0xc5	*/
+	trap_ed,			/* 0xc6	*/
+	trap_ed,			/* 0xc7	*/
+	trap_ed,			/* 0xc8	*/
+	trap_ed,			/* 0xc9	*/
+	trap_ed,			/* 0xca	*/
+	trap_ed,			/* 0xcb	*/
+	trap_ed,			/* 0xcc	*/
+	trap_ed,			/* 0xcd	*/
+	trap_ed,			/* 0xce	*/
+	trap_ed,			/* 0xcf	*/
+	trap_ed,			/* 0xd0	*/
+	trap_ed,			/* 0xd1	*/
+	trap_ed,			/* 0xd2	*/
+	trap_ed,			/* 0xd3	*/
+	trap_ed,			/* 0xd4	*/
+	trap_ed,			/* 0xd5	*/
+	trap_ed,			/* 0xd6	*/
+	trap_ed,			/* 0xd7	*/
+	trap_ed,			/* 0xd8	*/
+	trap_ed,			/* 0xd9	*/
+	trap_ed,			/* 0xda	*/
+	trap_ed,			/* 0xdb	*/
+	trap_ed,			/* 0xdc	*/
+	trap_ed,			/* 0xdd	*/
+	trap_ed,			/* 0xde	*/
+	trap_ed,			/* 0xdf	*/
+	trap_ed,			/* 0xe0	*/
+	trap_ed,			/* 0xe1	*/
+	trap_ed,			/* 0xe2	*/
+	trap_ed,			/* 0xe3	*/
+	trap_ed,			/* 0xe4	*/
+	trap_ed,			/* 0xe5	*/
+	trap_ed,			/* 0xe6	*/
+	trap_ed,			/* 0xe7	*/
+	trap_ed,			/* 0xe8	*/
+	trap_ed,			/* 0xe9	*/
+	trap_ed,			/* 0xea	*/
+	trap_ed,			/* 0xeb	*/
+	trap_ed,			/* 0xec	*/
+	trap_ed,			/* 0xed	*/
+	trap_ed,			/* 0xee	*/
+	trap_ed,			/* 0xef	*/
+	trap_ed,			/* 0xf0	*/
+	trap_ed,			/* 0xf1	*/
+	trap_ed,			/* 0xf2	*/
+	trap_ed,			/* 0xf3	*/
+	trap_ed,			/* 0xf4	*/
+	trap_ed,			/* 0xf5	*/
+	trap_ed,			/* 0xf6	*/
+	trap_ed,			/* 0xf7	*/
+	trap_ed,			/* 0xf8	*/
+	trap_ed,			/* 0xf9	*/
+	trap_ed,			/* 0xfa	*/
+	trap_ed,			/* 0xfb	*/
+	trap_ed,			/* 0xfc	*/
+	trap_ed,			/* 0xfd	*/
+	trap_ed,			/* 0xfe	*/
+	trap_ed				/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(); goto done
+#endif
+
 int op_ed_handel(void)
 {
 	register int t;
 
-	static int (*op_ed[256]) (void) = {
-		trap_ed,			/* 0x00	*/
-		trap_ed,			/* 0x01	*/
-		trap_ed,			/* 0x02	*/
-		trap_ed,			/* 0x03	*/
-		trap_ed,			/* 0x04	*/
-		trap_ed,			/* 0x05	*/
-		trap_ed,			/* 0x06	*/
-		trap_ed,			/* 0x07	*/
-		trap_ed,			/* 0x08	*/
-		trap_ed,			/* 0x09	*/
-		trap_ed,			/* 0x0a	*/
-		trap_ed,			/* 0x0b	*/
-		trap_ed,			/* 0x0c	*/
-		trap_ed,			/* 0x0d	*/
-		trap_ed,			/* 0x0e	*/
-		trap_ed,			/* 0x0f	*/
-		trap_ed,			/* 0x10	*/
-		trap_ed,			/* 0x11	*/
-		trap_ed,			/* 0x12	*/
-		trap_ed,			/* 0x13	*/
-		trap_ed,			/* 0x14	*/
-		trap_ed,			/* 0x15	*/
-		trap_ed,			/* 0x16	*/
-		trap_ed,			/* 0x17	*/
-		trap_ed,			/* 0x18	*/
-		trap_ed,			/* 0x19	*/
-		trap_ed,			/* 0x1a	*/
-		trap_ed,			/* 0x1b	*/
-		trap_ed,			/* 0x1c	*/
-		trap_ed,			/* 0x1d	*/
-		trap_ed,			/* 0x1e	*/
-		trap_ed,			/* 0x1f	*/
-		trap_ed,			/* 0x20	*/
-		trap_ed,			/* 0x21	*/
-		trap_ed,			/* 0x22	*/
-		trap_ed,			/* 0x23	*/
-		trap_ed,			/* 0x24	*/
-		trap_ed,			/* 0x25	*/
-		trap_ed,			/* 0x26	*/
-		trap_ed,			/* 0x27	*/
-		trap_ed,			/* 0x28	*/
-		trap_ed,			/* 0x29	*/
-		trap_ed,			/* 0x2a	*/
-		trap_ed,			/* 0x2b	*/
-		trap_ed,			/* 0x2c	*/
-		trap_ed,			/* 0x2d	*/
-		trap_ed,			/* 0x2e	*/
-		trap_ed,			/* 0x2f	*/
-		trap_ed,			/* 0x30	*/
-		trap_ed,			/* 0x31	*/
-		trap_ed,			/* 0x32	*/
-		trap_ed,			/* 0x33	*/
-		trap_ed,			/* 0x34	*/
-		trap_ed,			/* 0x35	*/
-		trap_ed,			/* 0x36	*/
-		trap_ed,			/* 0x37	*/
-		trap_ed,			/* 0x38	*/
-		trap_ed,			/* 0x39	*/
-		trap_ed,			/* 0x3a	*/
-		trap_ed,			/* 0x3b	*/
-		trap_ed,			/* 0x3c	*/
-		trap_ed,			/* 0x3d	*/
-		trap_ed,			/* 0x3e	*/
-		trap_ed,			/* 0x3f	*/
-		op_inbic,			/* 0x40	*/
-		op_outcb,			/* 0x41	*/
-		op_sbchb,			/* 0x42	*/
-		op_ldinbc,			/* 0x43	*/
-		op_neg,				/* 0x44	*/
-		op_retn,			/* 0x45	*/
-		op_im0,				/* 0x46	*/
-		op_ldia,			/* 0x47	*/
-		op_incic,			/* 0x48	*/
-		op_outcc,			/* 0x49	*/
-		op_adchb,			/* 0x4a	*/
-		op_ldbcinn,			/* 0x4b	*/
-		trap_ed,			/* 0x4c	*/
-		op_reti,			/* 0x4d	*/
-		trap_ed,			/* 0x4e	*/
-		op_ldra,			/* 0x4f	*/
-		op_indic,			/* 0x50	*/
-		op_outcd,			/* 0x51	*/
-		op_sbchd,			/* 0x52	*/
-		op_ldinde,			/* 0x53	*/
-		trap_ed,			/* 0x54	*/
-		trap_ed,			/* 0x55	*/
-		op_im1,				/* 0x56	*/
-		op_ldai,			/* 0x57	*/
-		op_ineic,			/* 0x58	*/
-		op_outce,			/* 0x59	*/
-		op_adchd,			/* 0x5a	*/
-		op_lddeinn,			/* 0x5b	*/
-		trap_ed,			/* 0x5c	*/
-		trap_ed,			/* 0x5d	*/
-		op_im2,				/* 0x5e	*/
-		op_ldar,			/* 0x5f	*/
-		op_inhic,			/* 0x60	*/
-		op_outch,			/* 0x61	*/
-		op_sbchh,			/* 0x62	*/
-		trap_ed,			/* 0x63	*/
-		trap_ed,			/* 0x64	*/
-		trap_ed,			/* 0x65	*/
-		trap_ed,			/* 0x66	*/
-		op_oprrd,			/* 0x67	*/
-		op_inlic,			/* 0x68	*/
-		op_outcl,			/* 0x69	*/
-		op_adchh,			/* 0x6a	*/
-		trap_ed,			/* 0x6b	*/
-		trap_ed,			/* 0x6c	*/
-		trap_ed,			/* 0x6d	*/
-		trap_ed,			/* 0x6e	*/
-		op_oprld,			/* 0x6f	*/
-		trap_ed,			/* 0x70	*/
-		trap_ed,			/* 0x71	*/
-		op_sbchs,			/* 0x72	*/
-		op_ldinsp,			/* 0x73	*/
-		trap_ed,			/* 0x74	*/
-		trap_ed,			/* 0x75	*/
-		trap_ed,			/* 0x76	*/
-		trap_ed,			/* 0x77	*/
-		op_inaic,			/* 0x78	*/
-		op_outca,			/* 0x79	*/
-		op_adchs,			/* 0x7a	*/
-		op_ldspinn,			/* 0x7b	*/
-		trap_ed,			/* 0x7c	*/
-		trap_ed,			/* 0x7d	*/
-		trap_ed,			/* 0x7e	*/
-		trap_ed,			/* 0x7f	*/
-		trap_ed,			/* 0x80	*/
-		trap_ed,			/* 0x81	*/
-		trap_ed,			/* 0x82	*/
-		trap_ed,			/* 0x83	*/
-		trap_ed,			/* 0x84	*/
-		trap_ed,			/* 0x85	*/
-		trap_ed,			/* 0x86	*/
-		trap_ed,			/* 0x87	*/
-		trap_ed,			/* 0x88	*/
-		trap_ed,			/* 0x89	*/
-		trap_ed,			/* 0x8a	*/
-		trap_ed,			/* 0x8b	*/
-		trap_ed,			/* 0x8c	*/
-		trap_ed,			/* 0x8d	*/
-		trap_ed,			/* 0x8e	*/
-		trap_ed,			/* 0x8f	*/
-		trap_ed,			/* 0x90	*/
-		trap_ed,			/* 0x91	*/
-		trap_ed,			/* 0x92	*/
-		trap_ed,			/* 0x93	*/
-		trap_ed,			/* 0x94	*/
-		trap_ed,			/* 0x95	*/
-		trap_ed,			/* 0x96	*/
-		trap_ed,			/* 0x97	*/
-		trap_ed,			/* 0x98	*/
-		trap_ed,			/* 0x99	*/
-		trap_ed,			/* 0x9a	*/
-		trap_ed,			/* 0x9b	*/
-		trap_ed,			/* 0x9c	*/
-		trap_ed,			/* 0x9d	*/
-		trap_ed,			/* 0x9e	*/
-		trap_ed,			/* 0x9f	*/
-		op_ldi,				/* 0xa0	*/
-		op_cpi,				/* 0xa1	*/
-		op_ini,				/* 0xa2	*/
-		op_outi,			/* 0xa3	*/
-		trap_ed,			/* 0xa4	*/
-		trap_ed,			/* 0xa5	*/
-		trap_ed,			/* 0xa6	*/
-		trap_ed,			/* 0xa7	*/
-		op_ldd,				/* 0xa8	*/
-		op_cpdop,			/* 0xa9	*/
-		op_ind,				/* 0xaa	*/
-		op_outd,			/* 0xab	*/
-		trap_ed,			/* 0xac	*/
-		trap_ed,			/* 0xad	*/
-		trap_ed,			/* 0xae	*/
-		trap_ed,			/* 0xaf	*/
-		op_ldir,			/* 0xb0	*/
-		op_cpir,			/* 0xb1	*/
-		op_inir,			/* 0xb2	*/
-		op_otir,			/* 0xb3	*/
-		trap_ed,			/* 0xb4	*/
-		trap_ed,			/* 0xb5	*/
-		trap_ed,			/* 0xb6	*/
-		trap_ed,			/* 0xb7	*/
-		op_lddr,			/* 0xb8	*/
-		op_cpdr,			/* 0xb9	*/
-		op_indr,			/* 0xba	*/
-		op_otdr,			/* 0xbb	*/
-		trap_ed,			/* 0xbc	*/
-		trap_ed,			/* 0xbd	*/
-		trap_ed,			/* 0xbe	*/
-		trap_ed,			/* 0xbf	*/
-		trap_ed,			/* 0xc0	*/
-		trap_ed,			/* 0xc1	*/
-		trap_ed,			/* 0xc2	*/
-		trap_ed,			/* 0xc3	*/
-		trap_ed,			/* 0xc4	*/
-		trap_ed,			/* 0xc5	*/
-		trap_ed,			/* 0xc6	*/
-		trap_ed,			/* 0xc7	*/
-		trap_ed,			/* 0xc8	*/
-		trap_ed,			/* 0xc9	*/
-		trap_ed,			/* 0xca	*/
-		trap_ed,			/* 0xcb	*/
-		trap_ed,			/* 0xcc	*/
-		trap_ed,			/* 0xcd	*/
-		trap_ed,			/* 0xce	*/
-		trap_ed,			/* 0xcf	*/
-		trap_ed,			/* 0xd0	*/
-		trap_ed,			/* 0xd1	*/
-		trap_ed,			/* 0xd2	*/
-		trap_ed,			/* 0xd3	*/
-		trap_ed,			/* 0xd4	*/
-		trap_ed,			/* 0xd5	*/
-		trap_ed,			/* 0xd6	*/
-		trap_ed,			/* 0xd7	*/
-		trap_ed,			/* 0xd8	*/
-		trap_ed,			/* 0xd9	*/
-		trap_ed,			/* 0xda	*/
-		trap_ed,			/* 0xdb	*/
-		trap_ed,			/* 0xdc	*/
-		trap_ed,			/* 0xdd	*/
-		trap_ed,			/* 0xde	*/
-		trap_ed,			/* 0xdf	*/
-		trap_ed,			/* 0xe0	*/
-		trap_ed,			/* 0xe1	*/
-		trap_ed,			/* 0xe2	*/
-		trap_ed,			/* 0xe3	*/
-		trap_ed,			/* 0xe4	*/
-		trap_ed,			/* 0xe5	*/
-		trap_ed,			/* 0xe6	*/
-		trap_ed,			/* 0xe7	*/
-		trap_ed,			/* 0xe8	*/
-		trap_ed,			/* 0xe9	*/
-		trap_ed,			/* 0xea	*/
-		trap_ed,			/* 0xeb	*/
-		trap_ed,			/* 0xec	*/
-		trap_ed,			/* 0xed	*/
-		trap_ed,			/* 0xee	*/
-		trap_ed,			/* 0xef	*/
-		trap_ed,			/* 0xf0	*/
-		trap_ed,			/* 0xf1	*/
-		trap_ed,			/* 0xf2	*/
-		trap_ed,			/* 0xf3	*/
-		trap_ed,			/* 0xf4	*/
-		trap_ed,			/* 0xf5	*/
-		trap_ed,			/* 0xf6	*/
-		trap_ed,			/* 0xf7	*/
-		trap_ed,			/* 0xf8	*/
-		trap_ed,			/* 0xf9	*/
-		trap_ed,			/* 0xfa	*/
-		trap_ed,			/* 0xfb	*/
-		trap_ed,			/* 0xfc	*/
-		trap_ed,			/* 0xfd	*/
-		trap_ed,			/* 0xfe	*/
-		trap_ed				/* 0xff	*/
+#ifdef WANT_THREADED
+	static void *op_ed_thr[256] = {
+		&&l_trap_ed,			/* 0x00	*/
+		&&l_trap_ed,			/* 0x01	*/
+		&&l_trap_ed,			/* 0x02	*/
+		&&l_trap_ed,			/* 0x03	*/
+		&&l_trap_ed,			/* 0x04	*/
+		&&l_trap_ed,			/* 0x05	*/
+		&&l_trap_ed,			/* 0x06	*/
+		&&l_trap_ed,			/* 0x07	*/
+		&&l_trap_ed,			/* 0x08	*/
+		&&l_trap_ed,			/* 0x09	*/
+		&&l_trap_ed,			/* 0x0a	*/
+		&&l_trap_ed,			/* 0x0b	*/
+		&&l_trap_ed,			/* 0x0c	*/
+		&&l_trap_ed,			/* 0x0d	*/
+		&&l_trap_ed,			/* 0x0e	*/
+		&&l_trap_ed,			/* 0x0f	*/
+		&&l_trap_ed,			/* 0x10	*/
+		&&l_trap_ed,			/* 0x11	*/
+		&&l_trap_ed,			/* 0x12	*/
+		&&l_trap_ed,			/* 0x13	*/
+		&&l_trap_ed,			/* 0x14	*/
+		&&l_trap_ed,			/* 0x15	*/
+		&&l_trap_ed,			/* 0x16	*/
+		&&l_trap_ed,			/* 0x17	*/
+		&&l_trap_ed,			/* 0x18	*/
+		&&l_trap_ed,			/* 0x19	*/
+		&&l_trap_ed,			/* 0x1a	*/
+		&&l_trap_ed,			/* 0x1b	*/
+		&&l_trap_ed,			/* 0x1c	*/
+		&&l_trap_ed,			/* 0x1d	*/
+		&&l_trap_ed,			/* 0x1e	*/
+		&&l_trap_ed,			/* 0x1f	*/
+		&&l_trap_ed,			/* 0x20	*/
+		&&l_trap_ed,			/* 0x21	*/
+		&&l_trap_ed,			/* 0x22	*/
+		&&l_trap_ed,			/* 0x23	*/
+		&&l_trap_ed,			/* 0x24	*/
+		&&l_trap_ed,			/* 0x25	*/
+		&&l_trap_ed,			/* 0x26	*/
+		&&l_trap_ed,			/* 0x27	*/
+		&&l_trap_ed,			/* 0x28	*/
+		&&l_trap_ed,			/* 0x29	*/
+		&&l_trap_ed,			/* 0x2a	*/
+		&&l_trap_ed,			/* 0x2b	*/
+		&&l_trap_ed,			/* 0x2c	*/
+		&&l_trap_ed,			/* 0x2d	*/
+		&&l_trap_ed,			/* 0x2e	*/
+		&&l_trap_ed,			/* 0x2f	*/
+		&&l_trap_ed,			/* 0x30	*/
+		&&l_trap_ed,			/* 0x31	*/
+		&&l_trap_ed,			/* 0x32	*/
+		&&l_trap_ed,			/* 0x33	*/
+		&&l_trap_ed,			/* 0x34	*/
+		&&l_trap_ed,			/* 0x35	*/
+		&&l_trap_ed,			/* 0x36	*/
+		&&l_trap_ed,			/* 0x37	*/
+		&&l_trap_ed,			/* 0x38	*/
+		&&l_trap_ed,			/* 0x39	*/
+		&&l_trap_ed,			/* 0x3a	*/
+		&&l_trap_ed,			/* 0x3b	*/
+		&&l_trap_ed,			/* 0x3c	*/
+		&&l_trap_ed,			/* 0x3d	*/
+		&&l_trap_ed,			/* 0x3e	*/
+		&&l_trap_ed,			/* 0x3f	*/
+		&&l_op_inbic,			/* 0x40	*/
+		&&l_op_outcb,			/* 0x41	*/
+		&&l_op_sbchb,			/* 0x42	*/
+		&&l_op_ldinbc,			/* 0x43	*/
+		&&l_op_neg,			/* 0x44	*/
+		&&l_op_retn,			/* 0x45	*/
+		&&l_op_im0,			/* 0x46	*/
+		&&l_op_ldia,			/* 0x47	*/
+		&&l_op_incic,			/* 0x48	*/
+		&&l_op_outcc,			/* 0x49	*/
+		&&l_op_adchb,			/* 0x4a	*/
+		&&l_op_ldbcinn,			/* 0x4b	*/
+		&&l_trap_ed,			/* 0x4c	*/
+		&&l_op_reti,			/* 0x4d	*/
+		&&l_trap_ed,			/* 0x4e	*/
+		&&l_op_ldra,			/* 0x4f	*/
+		&&l_op_indic,			/* 0x50	*/
+		&&l_op_outcd,			/* 0x51	*/
+		&&l_op_sbchd,			/* 0x52	*/
+		&&l_op_ldinde,			/* 0x53	*/
+		&&l_trap_ed,			/* 0x54	*/
+		&&l_trap_ed,			/* 0x55	*/
+		&&l_op_im1,			/* 0x56	*/
+		&&l_op_ldai,			/* 0x57	*/
+		&&l_op_ineic,			/* 0x58	*/
+		&&l_op_outce,			/* 0x59	*/
+		&&l_op_adchd,			/* 0x5a	*/
+		&&l_op_lddeinn,			/* 0x5b	*/
+		&&l_trap_ed,			/* 0x5c	*/
+		&&l_trap_ed,			/* 0x5d	*/
+		&&l_op_im2,			/* 0x5e	*/
+		&&l_op_ldar,			/* 0x5f	*/
+		&&l_op_inhic,			/* 0x60	*/
+		&&l_op_outch,			/* 0x61	*/
+		&&l_op_sbchh,			/* 0x62	*/
+		&&l_trap_ed,			/* 0x63	*/
+		&&l_trap_ed,			/* 0x64	*/
+		&&l_trap_ed,			/* 0x65	*/
+		&&l_trap_ed,			/* 0x66	*/
+		&&l_op_oprrd,			/* 0x67	*/
+		&&l_op_inlic,			/* 0x68	*/
+		&&l_op_outcl,			/* 0x69	*/
+		&&l_op_adchh,			/* 0x6a	*/
+		&&l_trap_ed,			/* 0x6b	*/
+		&&l_trap_ed,			/* 0x6c	*/
+		&&l_trap_ed,			/* 0x6d	*/
+		&&l_trap_ed,			/* 0x6e	*/
+		&&l_op_oprld,			/* 0x6f	*/
+		&&l_trap_ed,			/* 0x70	*/
+		&&l_trap_ed,			/* 0x71	*/
+		&&l_op_sbchs,			/* 0x72	*/
+		&&l_op_ldinsp,			/* 0x73	*/
+		&&l_trap_ed,			/* 0x74	*/
+		&&l_trap_ed,			/* 0x75	*/
+		&&l_trap_ed,			/* 0x76	*/
+		&&l_trap_ed,			/* 0x77	*/
+		&&l_op_inaic,			/* 0x78	*/
+		&&l_op_outca,			/* 0x79	*/
+		&&l_op_adchs,			/* 0x7a	*/
+		&&l_op_ldspinn,			/* 0x7b	*/
+		&&l_trap_ed,			/* 0x7c	*/
+		&&l_trap_ed,			/* 0x7d	*/
+		&&l_trap_ed,			/* 0x7e	*/
+		&&l_trap_ed,			/* 0x7f	*/
+		&&l_trap_ed,			/* 0x80	*/
+		&&l_trap_ed,			/* 0x81	*/
+		&&l_trap_ed,			/* 0x82	*/
+		&&l_trap_ed,			/* 0x83	*/
+		&&l_trap_ed,			/* 0x84	*/
+		&&l_trap_ed,			/* 0x85	*/
+		&&l_trap_ed,			/* 0x86	*/
+		&&l_trap_ed,			/* 0x87	*/
+		&&l_trap_ed,			/* 0x88	*/
+		&&l_trap_ed,			/* 0x89	*/
+		&&l_trap_ed,			/* 0x8a	*/
+		&&l_trap_ed,			/* 0x8b	*/
+		&&l_trap_ed,			/* 0x8c	*/
+		&&l_trap_ed,			/* 0x8d	*/
+		&&l_trap_ed,			/* 0x8e	*/
+		&&l_trap_ed,			/* 0x8f	*/
+		&&l_trap_ed,			/* 0x90	*/
+		&&l_trap_ed,			/* 0x91	*/
+		&&l_trap_ed,			/* 0x92	*/
+		&&l_trap_ed,			/* 0x93	*/
+		&&l_trap_ed,			/* 0x94	*/
+		&&l_trap_ed,			/* 0x95	*/
+		&&l_trap_ed,			/* 0x96	*/
+		&&l_trap_ed,			/* 0x97	*/
+		&&l_trap_ed,			/* 0x98	*/
+		&&l_trap_ed,			/* 0x99	*/
+		&&l_trap_ed,			/* 0x9a	*/
+		&&l_trap_ed,			/* 0x9b	*/
+		&&l_trap_ed,			/* 0x9c	*/
+		&&l_trap_ed,			/* 0x9d	*/
+		&&l_trap_ed,			/* 0x9e	*/
+		&&l_trap_ed,			/* 0x9f	*/
+		&&l_op_ldi,			/* 0xa0	*/
+		&&l_op_cpi,			/* 0xa1	*/
+		&&l_op_ini,			/* 0xa2	*/
+		&&l_op_outi,			/* 0xa3	*/
+		&&l_trap_ed,			/* 0xa4	*/
+		&&l_trap_ed,			/* 0xa5	*/
+		&&l_trap_ed,			/* 0xa6	*/
+		&&l_trap_ed,			/* 0xa7	*/
+		&&l_op_ldd,			/* 0xa8	*/
+		&&l_op_cpdop,			/* 0xa9	*/
+		&&l_op_ind,			/* 0xaa	*/
+		&&l_op_outd,			/* 0xab	*/
+		&&l_trap_ed,			/* 0xac	*/
+		&&l_trap_ed,			/* 0xad	*/
+		&&l_trap_ed,			/* 0xae	*/
+		&&l_trap_ed,			/* 0xaf	*/
+		&&l_op_ldir,			/* 0xb0	*/
+		&&l_op_cpir,			/* 0xb1	*/
+		&&l_op_inir,			/* 0xb2	*/
+		&&l_op_otir,			/* 0xb3	*/
+		&&l_trap_ed,			/* 0xb4	*/
+		&&l_trap_ed,			/* 0xb5	*/
+		&&l_trap_ed,			/* 0xb6	*/
+		&&l_trap_ed,			/* 0xb7	*/
+		&&l_op_lddr,			/* 0xb8	*/
+		&&l_op_cpdr,			/* 0xb9	*/
+		&&l_op_indr,			/* 0xba	*/
+		&&l_op_otdr,			/* 0xbb	*/
+		&&l_trap_ed,			/* 0xbc	*/
+		&&l_trap_ed,			/* 0xbd	*/
+		&&l_trap_ed,			/* 0xbe	*/
+		&&l_trap_ed,			/* 0xbf	*/
+		&&l_trap_ed,			/* 0xc0	*/
+		&&l_trap_ed,			/* 0xc1	*/
+		&&l_trap_ed,			/* 0xc2	*/
+		&&l_trap_ed,			/* 0xc3	*/
+		&&l_trap_ed,			/* 0xc4	*/
+		&&l_trap_ed,			/* 0xc5	*/
+		&&l_trap_ed,			/* 0xc6	*/
+		&&l_trap_ed,			/* 0xc7	*/
+		&&l_trap_ed,			/* 0xc8	*/
+		&&l_trap_ed,			/* 0xc9	*/
+		&&l_trap_ed,			/* 0xca	*/
+		&&l_trap_ed,			/* 0xcb	*/
+		&&l_trap_ed,			/* 0xcc	*/
+		&&l_trap_ed,			/* 0xcd	*/
+		&&l_trap_ed,			/* 0xce	*/
+		&&l_trap_ed,			/* 0xcf	*/
+		&&l_trap_ed,			/* 0xd0	*/
+		&&l_trap_ed,			/* 0xd1	*/
+		&&l_trap_ed,			/* 0xd2	*/
+		&&l_trap_ed,			/* 0xd3	*/
+		&&l_trap_ed,			/* 0xd4	*/
+		&&l_trap_ed,			/* 0xd5	*/
+		&&l_trap_ed,			/* 0xd6	*/
+		&&l_trap_ed,			/* 0xd7	*/
+		&&l_trap_ed,			/* 0xd8	*/
+		&&l_trap_ed,			/* 0xd9	*/
+		&&l_trap_ed,			/* 0xda	*/
+		&&l_trap_ed,			/* 0xdb	*/
+		&&l_trap_ed,			/* 0xdc	*/
+		&&l_trap_ed,			/* 0xdd	*/
+		&&l_trap_ed,			/* 0xde	*/
+		&&l_trap_ed,			/* 0xdf	*/
+		&&l_trap_ed,			/* 0xe0	*/
+		&&l_trap_ed,			/* 0xe1	*/
+		&&l_trap_ed,			/* 0xe2	*/
+		&&l_trap_ed,			/* 0xe3	*/
+		&&l_trap_ed,			/* 0xe4	*/
+		&&l_trap_ed,			/* 0xe5	*/
+		&&l_trap_ed,			/* 0xe6	*/
+		&&l_trap_ed,			/* 0xe7	*/
+		&&l_trap_ed,			/* 0xe8	*/
+		&&l_trap_ed,			/* 0xe9	*/
+		&&l_trap_ed,			/* 0xea	*/
+		&&l_trap_ed,			/* 0xeb	*/
+		&&l_trap_ed,			/* 0xec	*/
+		&&l_trap_ed,			/* 0xed	*/
+		&&l_trap_ed,			/* 0xee	*/
+		&&l_trap_ed,			/* 0xef	*/
+		&&l_trap_ed,			/* 0xf0	*/
+		&&l_trap_ed,			/* 0xf1	*/
+		&&l_trap_ed,			/* 0xf2	*/
+		&&l_trap_ed,			/* 0xf3	*/
+		&&l_trap_ed,			/* 0xf4	*/
+		&&l_trap_ed,			/* 0xf5	*/
+		&&l_trap_ed,			/* 0xf6	*/
+		&&l_trap_ed,			/* 0xf7	*/
+		&&l_trap_ed,			/* 0xf8	*/
+		&&l_trap_ed,			/* 0xf9	*/
+		&&l_trap_ed,			/* 0xfa	*/
+		&&l_trap_ed,			/* 0xfb	*/
+		&&l_trap_ed,			/* 0xfc	*/
+		&&l_trap_ed,			/* 0xfd	*/
+		&&l_trap_ed,			/* 0xfe	*/
+		&&l_trap_ed			/* 0xff	*/
 	};
+#endif
 
-#ifdef WANT_TIM
-	t = (*op_ed[*PC++]) ();		/* execute next opcode */
+	LF_EVAL();			/* opcodes with prefix use F */
+
+#ifdef WANT_THREADED
+	goto *op_ed_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(trap_ed);
+	OP_THR(op_inbic);
+	OP_THR(op_outcb);
+	OP_THR(op_sbchb);
+	OP_THR(op_ldinbc);
+	OP_THR(op_neg);
+	OP_THR(op_retn);
+	OP_THR(op_im0);
+	OP_THR(op_ldia);
+	OP_THR(op_incic);
+	OP_THR(op_outcc);
+	OP_THR(op_adchb);
+	OP_THR(op_ldbcinn);
+	OP_THR(op_reti);
+	OP_THR(op_ldra);
+	OP_THR(op_indic);
+	OP_THR(op_outcd);
+	OP_THR(op_sbchd);
+	OP_THR(op_ldinde);
+	OP_THR(op_im1);
+	OP_THR(op_ldai);
+	OP_THR(op_ineic);
+	OP_THR(op_outce);
+	OP_THR(op_adchd);
+	OP_THR(op_lddeinn);
+	OP_THR(op_im2);
+	OP_THR(op_ldar);
+	OP_THR(op_inhic);
+	OP_THR(op_outch);
+	OP_THR(op_sbchh);
+	OP_THR(op_oprrd);
+	OP_THR(op_inlic);
+	OP_THR(op_outcl);
+	OP_THR(op_adchh);
+	OP_THR(op_oprld);
+	OP_THR(op_sbchs);
+	OP_THR(op_ldinsp);
+	OP_THR(op_inaic);
+	OP_THR(op_outca);
+	OP_THR(op_adchs);
+	OP_THR(op_ldspinn);
+	OP_THR(op_ldi);
+	OP_THR(op_cpi);
+	OP_THR(op_ini);
+	OP_THR(op_outi);
+	OP_THR(op_ldd);
+	OP_THR(op_cpdop);
+	OP_THR(op_ind);
+	OP_THR(op_outd);
+	OP_THR(op_ldir);
+	OP_THR(op_cpir);
+	OP_THR(op_inir);
+	OP_THR(op_otir);
+	OP_THR(op_lddr);
+	OP_THR(op_cpdr);
+	OP_THR(op_indr);
+	OP_THR(op_otdr);
+
+done:
 #else
-	(*op_ed[*PC++]) ();
+	t = (*op_ed[*PC++]) ();		/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -374,17 +772,20 @@ static int op_reti(void)		/* RETI */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK++;
+	i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	i += *STACK++ << 8;
+	i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
 	PC = ram + i;
+#ifdef WANT_INT
+	int_reti();
+#endif
 	return(14);
 }
 
@@ -398,31 +799,31 @@ static int op_retn(void)		/* RETN */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK++;
+	i = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
-	i += *STACK++ << 8;
+	i += memrdr(STACK++ - ram) << 8;
 #ifdef WANT_SPC
 	if (STACK >= ram + 65536L)
 		STACK =	ram;
 #endif
 	PC = ram + i;
-	if (IFF & 2)
+	if (IFF & 2) {
 		IFF |= 1;
+#ifdef WANT_INT
+		if (int_type)
+			ev_attn();
+#endif
+	}
 	return(14);
 }
 
 static int op_neg(void)			/* NEG */
 {
-	(A) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	(A == 0x80) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(0 - ((signed char) A & 0xf) <	0) ? (F	|= H_FLAG) : (F	&= ~H_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][0][A];
 	A = 0 -	A;
-	F |= N_FLAG;
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
 	return(8);
 }
 
@@ -437,10 +838,7 @@ static int op_inaic(void)		/* IN A,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	A = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[A];
 	return(12);
 }
 
@@ -455,10 +853,7 @@ static int op_inbic(void)		/* IN B,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	B = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(B) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(B & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[B]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[B];
 	return(12);
 }
 
@@ -473,10 +868,7 @@ static int op_incic(void)		/* IN C,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	C = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(C) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(C & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[C]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[C];
 	return(12);
 }
 
@@ -491,10 +883,7 @@ static int op_indic(void)		/* IN D,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	D = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(D) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(D & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[D]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[D];
 	return(12);
 }
 
@@ -509,10 +898,7 @@ static int op_ineic(void)		/* IN E,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	E = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(E) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(E & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[E]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[E];
 	return(12);
 }
 
@@ -527,10 +913,7 @@ static int op_inhic(void)		/* IN H,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	H = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(H) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(H & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[H]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[H];
 	return(12);
 }
 
@@ -545,10 +928,7 @@ static int op_inlic(void)		/* IN L,(C) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	L = io_in(C);
-	F &= ~(N_FLAG |	H_FLAG);
-	(L) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(L & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(parrity[L]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szp_flag[L];
 	return(12);
 }
 
@@ -660,7 +1040,7 @@ static int op_ini(void)			/* INI */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	io_in(C);
+	memwrt((H << 8) + L, io_in(C));
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -678,32 +1058,47 @@ static int op_ini(void)			/* INI */
 
 static int op_inir(void)		/* INIR */
 {
-	register int t	= -21;
-	register BYTE *d;
+	register unsigned n, k;
+	register WORD d;
 	BYTE io_in();
+#ifdef BLK_BULK
+	BYTE buf[256];
+#endif
 
-	d = ram	+ (H <<	8) + L;
-	do {
+	n = blk_cnt(B ? B : 256, 21);
+	d = (H << 8) + L;
+#ifdef BLK_BULK
+	if (io_blk_in(C, buf, n))
+		for (k = 0; k < n; k++)
+			memwrt(d++, buf[k]);
+	else
+#endif
+	for (k = 0; k < n; k++) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_INP;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		*d++ = io_in(C);
+		memwrt(d++, io_in(C));
 #ifdef BUS_8080
 		cpu_bus = 0;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		B--;
-		t += 21;
-	} while	(B);
-	H = (d - ram) >> 8;
-	L = d -	ram;
-	F |= N_FLAG | Z_FLAG;
-	return(t + 16);
+	}
+	B -= n;
+	H = d >> 8;
+	L = d;
+	F |= N_FLAG;
+	if (B) {
+		F &= ~Z_FLAG;
+		blk_rep();
+		return(n * 21);
+	}
+	F |= Z_FLAG;
+	return(n * 21 - 5);
 }
 
 static int op_ind(void)			/* IND */
@@ -716,7 +1111,7 @@ static int op_ind(void)			/* IND */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(H << 8) + L) =	io_in(C);
+	memwrt((H << 8) + L, io_in(C));
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -734,32 +1129,47 @@ static int op_ind(void)			/* IND */
 
 static int op_indr(void)		/* INDR */
 {
-	register int t	= -21;
-	register BYTE *d;
+	register unsigned n, k;
+	register WORD d;
 	BYTE io_in();
+#ifdef BLK_BULK
+	BYTE buf[256];
+#endif
 
-	d = ram	+ (H <<	8) + L;
-	do {
+	n = blk_cnt(B ? B : 256, 21);
+	d = (H << 8) + L;
+#ifdef BLK_BULK
+	if (io_blk_in(C, buf, n))
+		for (k = 0; k < n; k++)
+			memwrt(d--, buf[k]);
+	else
+#endif
+	for (k = 0; k < n; k++) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_INP;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		*d-- = io_in(C);
+		memwrt(d--, io_in(C));
 #ifdef BUS_8080
 		cpu_bus = 0;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		B--;
-		t += 21;
-	} while	(B);
-	H = (d - ram) >> 8;
-	L = d -	ram;
-	F |= N_FLAG | Z_FLAG;
-	return(t + 16);
+	}
+	B -= n;
+	H = d >> 8;
+	L = d;
+	F |= N_FLAG;
+	if (B) {
+		F &= ~Z_FLAG;
+		blk_rep();
+		return(n * 21);
+	}
+	F |= Z_FLAG;
+	return(n * 21 - 5);
 }
 
 static int op_outi(void)		/* OUTI */
@@ -772,7 +1182,7 @@ static int op_outi(void)		/* OUTI */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	io_out(C, *(ram	+ (H <<	8) * L));
+	io_out(C, memrdr((H <<	8) + L));
 #ifdef BUS_8080
 	cpu_bus = CPU_OUT;
 #endif
@@ -790,32 +1200,49 @@ static int op_outi(void)		/* OUTI */
 
 static int op_otir(void)		/* OTIR */
 {
-	register int t	= -21;
-	register BYTE *d;
+	register unsigned n, k;
+	register WORD d;
 	BYTE io_out();
-
-	d = ram	+ (H <<	8) + L;
-	do {
+#ifdef BLK_BULK
+	BYTE buf[256];
+#endif
+
+	n = blk_cnt(B ? B : 256, 21);
+	d = (H << 8) + L;
+#ifdef BLK_BULK
+	for (k = 0; k < n; k++)
+		buf[k] = memrdr(d++);
+	if (!io_blk_out(C, buf, n))
+		for (k = 0; k < n; k++)
+			io_out(C, buf[k]);
+#else
+	for (k = 0; k < n; k++) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		io_out(C, *d++);
+		io_out(C, memrdr(d++));
 #ifdef BUS_8080
 		cpu_bus = CPU_OUT;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		B--;
-		t += 21;
-	} while	(B);
-	H = (d - ram) >> 8;
-	L = d -	ram;
-	F |= N_FLAG | Z_FLAG;
-	return(t + 16);
+	}
+#endif
+	B -= n;
+	H = d >> 8;
+	L = d;
+	F |= N_FLAG;
+	if (B) {
+		F &= ~Z_FLAG;
+		blk_rep();
+		return(n * 21);
+	}
+	F |= Z_FLAG;
+	return(n * 21 - 5);
 }
 
 static int op_outd(void)		/* OUTD */
@@ -828,7 +1255,7 @@ static int op_outd(void)		/* OUTD */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	io_out(C, *(ram	+ (H <<	8) * L));
+	io_out(C, memrdr((H <<	8) + L));
 #ifdef BUS_8080
 	cpu_bus = CPU_OUT;
 #endif
@@ -846,32 +1273,49 @@ static int op_outd(void)		/* OUTD */
 
 static int op_otdr(void)		/* OTDR */
 {
-	register int t	= -21;
-	register BYTE *d;
+	register unsigned n, k;
+	register WORD d;
 	BYTE io_out();
-
-	d = ram	+ (H <<	8) + L;
-	do {
+#ifdef BLK_BULK
+	BYTE buf[256];
+#endif
+
+	n = blk_cnt(B ? B : 256, 21);
+	d = (H << 8) + L;
+#ifdef BLK_BULK
+	for (k = 0; k < n; k++)
+		buf[k] = memrdr(d--);
+	if (!io_blk_out(C, buf, n))
+		for (k = 0; k < n; k++)
+			io_out(C, buf[k]);
+#else
+	for (k = 0; k < n; k++) {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		io_out(C, *d--);
+		io_out(C, memrdr(d--));
 #ifdef BUS_8080
 		cpu_bus = CPU_OUT;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		B--;
-		t += 21;
-	} while	(B);
-	H = (d - ram) >> 8;
-	L = d -	ram;
-	F |= N_FLAG | Z_FLAG;
-	return(t + 16);
+	}
+#endif
+	B -= n;
+	H = d >> 8;
+	L = d;
+	F |= N_FLAG;
+	if (B) {
+		F &= ~Z_FLAG;
+		blk_rep();
+		return(n * 21);
+	}
+	F |= Z_FLAG;
+	return(n * 21 - 5);
 }
 
 static int op_ldai(void)		/* LD A,I */
@@ -969,8 +1413,8 @@ static int op_ldinbc(void)		/* LD (nn),BC */
 #endif
 	p = ram	+ *PC++;
 	p += *PC++ << 8;
-	*p++ = C;
-	*p = B;
+	memwrt(p++ - ram, C);
+	memwrt(p - ram, B);
 	return(20);
 }
 
@@ -986,8 +1430,8 @@ static int op_ldinde(void)		/* LD (nn),DE */
 #endif
 	p = ram	+ *PC++;
 	p += *PC++ << 8;
-	*p++ = E;
-	*p = D;
+	memwrt(p++ - ram, E);
+	memwrt(p - ram, D);
 	return(20);
 }
 
@@ -1005,8 +1449,8 @@ static int op_ldinsp(void)		/* LD (nn),SP */
 	p = ram	+ *PC++;
 	p += *PC++ << 8;
 	i = STACK - ram;
-	*p++ = i;
-	*p = i >> 8;
+	memwrt(p++ - ram, i);
+	memwrt(p - ram, i >> 8);
 	return(20);
 }
 
@@ -1200,7 +1644,7 @@ static int op_ldi(void)			/* LDI */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(D << 8) + E) =	*(ram +	(H << 8) + L);
+	memwrt((D << 8) + E, memrdr((H << 8) + L));
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1223,13 +1667,38 @@ static int op_ldi(void)			/* LDI */
 
 static int op_ldir(void)		/* LDIR */
 {
-	register int t	= -21;
-	register WORD i;
-	register BYTE *s, *d;
+	register unsigned n, t;
+	register WORD i, s, d;
+#ifdef BLK_BULK
+	register unsigned k;
+	register WORD dist;
+#endif
 
 	i = (B << 8) + C;
-	d = ram	+ (D <<	8) + E;
-	s = ram	+ (H <<	8) + L;
+	n = blk_cnt(i ? i : 65536, 21);
+	t = n * 21;
+	i -= n;
+	d = (D << 8) + E;
+	s = (H << 8) + L;
+#ifdef BLK_BULK
+	do {
+		k = n;			/* stop at the end of the memory */
+		if (k > 65536 - s)
+			k = 65536 - s;
+		if (k > 65536 - d)
+			k = 65536 - d;
+		dist = d - s;
+		if (dist == 1)		/* fill with the first byte */
+			memfil(d, memrdr(s), k);
+		else {
+			if (dist && dist < k)	/* copy source before */
+				k = dist;	/* it's overwritten */
+			memmov(d, s, k);
+		}
+		s += k;
+		d += k;
+	} while (n -= k);
+#else
 	do {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -1237,22 +1706,28 @@ static int op_ldir(void)		/* LDIR */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		*d++ = *s++;
+		memwrt(d++, memrdr(s++));
 #ifdef BUS_8080
 		cpu_bus = 0;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		t += 21;
-	} while	(--i);
-	B = C =	0;
-	D = (d - ram) >> 8;
-	E = d -	ram;
-	H = (s - ram) >> 8;
-	L = s -	ram;
+	} while	(--n);
+#endif
+	B = i >> 8;
+	C = i;
+	D = d >> 8;
+	E = d;
+	H = s >> 8;
+	L = s;
 	F &= ~(N_FLAG |	P_FLAG | H_FLAG);
-	return(t + 16);
+	if (i) {
+		F |= P_FLAG;
+		blk_rep();
+		return(t);
+	}
+	return(t - 5);
 }
 
 static int op_ldd(void)			/* LDD */
@@ -1263,7 +1738,7 @@ static int op_ldd(void)			/* LDD */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	(D << 8) + E) =	*(ram +	(H << 8) + L);
+	memwrt((D << 8) + E, memrdr((H << 8) + L));
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1286,13 +1761,38 @@ static int op_ldd(void)			/* LDD */
 
 static int op_lddr(void)		/* LDDR */
 {
-	register int t	= -21;
-	register WORD i;
-	register BYTE *s, *d;
+	register unsigned n, t;
+	register WORD i, s, d;
+#ifdef BLK_BULK
+	register unsigned k;
+	register WORD dist;
+#endif
 
 	i = (B << 8) + C;
-	d = ram	+ (D <<	8) + E;
-	s = ram	+ (H <<	8) + L;
+	n = blk_cnt(i ? i : 65536, 21);
+	t = n * 21;
+	i -= n;
+	d = (D << 8) + E;
+	s = (H << 8) + L;
+#ifdef BLK_BULK
+	do {
+		k = n;			/* stop at the begin of the memory */
+		if (k > s + 1)
+			k = s + 1;
+		if (k > d + 1)
+			k = d + 1;
+		dist = s - d;
+		if (dist == 1)		/* fill with the first byte */
+			memfil(d - k + 1, memrdr(s), k);
+		else {
+			if (dist && dist < k)	/* copy source before */
+				k = dist;	/* it's overwritten */
+			memmov(d - k + 1, s - k + 1, k);
+		}
+		s -= k;
+		d -= k;
+	} while (n -= k);
+#else
 	do {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -1300,22 +1800,28 @@ static int op_lddr(void)		/* LDDR */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		*d-- = *s--;
+		memwrt(d--, memrdr(s--));
 #ifdef BUS_8080
 		cpu_bus = 0;
 #endif
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		t += 21;
-	} while	(--i);
-	B = C =	0;
-	D = (d - ram) >> 8;
-	E = d -	ram;
-	H = (s - ram) >> 8;
-	L = s -	ram;
+	} while	(--n);
+#endif
+	B = i >> 8;
+	C = i;
+	D = d >> 8;
+	E = d;
+	H = s >> 8;
+	L = s;
 	F &= ~(N_FLAG |	P_FLAG | H_FLAG);
-	return(t + 16);
+	if (i) {
+		F |= P_FLAG;
+		blk_rep();
+		return(t);
+	}
+	return(t - 5);
 }
 
 static int op_cpi(void)		/* CPI */
@@ -1328,7 +1834,7 @@ static int op_cpi(void)		/* CPI */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *(ram + ((H << 8) + L));
+	i = memrdr(((H << 8) + L));
 	((i & 0xf) > (A & 0xF)) ? (F |= H_FLAG) : (F &= ~H_FLAG);
 	i = A -	i;
 	L++;
@@ -1345,15 +1851,36 @@ static int op_cpi(void)		/* CPI */
 }
 
 static int op_cpir(void)	/* CPIR */
-				/* H Flag not set!!! */
 {
-	register int t	= -21;
-	register BYTE *s;
-	register BYTE d;
-	register WORD i;
+	register unsigned n, m;
+	register WORD i, s;
+	register BYTE b, d;
+#ifdef BLK_BULK
+	register unsigned k;
+	register BYTE *p;
+#endif
 
 	i = (B << 8) + C;
-	s = ram	+ (H <<	8) + L;
+	n = blk_cnt(i ? i : 65536, 21);
+	s = (H << 8) + L;
+	m = 0;
+#ifdef BLK_BULK
+	do {
+		k = n - m;		/* stop at the end of the memory */
+		if (k > 65536 - s)
+			k = 65536 - s;
+		if ((p = memchr(ram + s, A, k)) != NULL)
+			k = p - (ram + s) + 1;
+		s += k;
+		m += k;
+	} while (p == NULL && m < n);
+#ifdef WANT_WATCH
+	if (wp_armed)		/* the last byte is read with memrdr() */
+		wp_read(s - m, m - 1);
+#endif
+	b = memrdr((WORD) (s - 1));
+	d = A - b;
+#else
 	do {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -1361,18 +1888,25 @@ static int op_cpir(void)	/* CPIR */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		d = A -	*s++;
-		t += 21;
-	} while	(--i &&	d);
-	F |= N_FLAG;
+		b = memrdr(s++);
+		d = A - b;
+	} while	(++m < n && d);
+#endif
+	i -= m;
 	B = i >> 8;
 	C = i;
-	H = (s - ram) >> 8;
-	L = s -	ram;
+	H = s >> 8;
+	L = s;
+	F |= N_FLAG;
+	((b & 0xf) > (A & 0xf)) ? (F |= H_FLAG) : (F &= ~H_FLAG);
 	(i) ? (F |= P_FLAG) : (F &= ~P_FLAG);
 	(d) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
 	(d & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	return(t + 16);
+	if (i && d) {
+		blk_rep();
+		return(m * 21);
+	}
+	return(m * 21 - 5);
 }
 
 static int op_cpdop(void)	/* CPD */
@@ -1385,7 +1919,7 @@ static int op_cpdop(void)	/* CPD */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *(ram + ((H << 8) + L));
+	i = memrdr(((H << 8) + L));
 	((i & 0xf) > (A & 0xF)) ? (F |= H_FLAG) : (F &= ~H_FLAG);
 	i = A -	i;
 	L--;
@@ -1402,15 +1936,36 @@ static int op_cpdop(void)	/* CPD */
 }
 
 static int op_cpdr(void)	/* CPDR */
-				/* H Flag not set!!! */
 {
-	register int t	= -21;
-	register BYTE *s;
-	register BYTE d;
-	register WORD i;
+	register unsigned n, m;
+	register WORD i, s;
+	register BYTE b, d;
+#ifdef BLK_BULK
+	register unsigned k;
+	register BYTE *p;
+#endif
 
 	i = (B << 8) + C;
-	s = ram	+ (H <<	8) + L;
+	n = blk_cnt(i ? i : 65536, 21);
+	s = (H << 8) + L;
+	m = 0;
+#ifdef BLK_BULK
+	do {
+		k = n - m;		/* stop at the begin of the memory */
+		if (k > s + 1)
+			k = s + 1;
+		if ((p = blk_rchr(ram + s, A, k)) != NULL)
+			k = (ram + s) - p + 1;
+		s -= k;
+		m += k;
+	} while (p == NULL && m < n);
+#ifdef WANT_WATCH
+	if (wp_armed)		/* the last byte is read with memrdr() */
+		wp_read(s + 2, m - 1);
+#endif
+	b = memrdr((WORD) (s + 1));
+	d = A - b;
+#else
 	do {
 #ifdef BUS_8080
 		cpu_bus = CPU_WO | CPU_MEMR;
@@ -1418,18 +1973,25 @@ static int op_cpdr(void)	/* CPDR */
 #ifdef FRONTPANEL
 		fp_sampleLightGroup(0, 0);
 #endif
-		d = A -	*s--;
-		t += 21;
-	} while	(--i &&	d);
-	F |= N_FLAG;
+		b = memrdr(s--);
+		d = A - b;
+	} while	(++m < n && d);
+#endif
+	i -= m;
 	B = i >> 8;
 	C = i;
-	H = (s - ram) >> 8;
-	L = s -	ram;
+	H = s >> 8;
+	L = s;
+	F |= N_FLAG;
+	((b & 0xf) > (A & 0xf)) ? (F |= H_FLAG) : (F &= ~H_FLAG);
 	(i) ? (F |= P_FLAG) : (F &= ~P_FLAG);
 	(d) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
 	(d & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	return(t + 16);
+	if (i && d) {
+		blk_rep();
+		return(m * 21);
+	}
+	return(m * 21 - 5);
 }
 
 static int op_oprld(void)	/* RLD (HL) */
@@ -1442,11 +2004,11 @@ static int op_oprld(void)	/* RLD (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *(ram + (H << 8) + L);
+	i = memrdr((H << 8) + L);
 	j = A &	0x0f;
 	A = (A & 0xf0) | (i >> 4);
 	i = (i << 4) | j;
-	*(ram +	(H << 8) + L) =	i;
+	memwrt((H << 8) + L, i);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -1470,11 +2032,11 @@ static int op_oprrd(void)	/* RRD (HL) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *(ram + (H << 8) + L);
+	i = memrdr((H << 8) + L);
 	j = A &	0x0f;
 	A = (A & 0xf0) | (i & 0x0f);
 	i = (i >> 4) | (j << 4);
-	*(ram +	(H << 8) + L) =	i;
+	memwrt((H << 8) + L, i);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
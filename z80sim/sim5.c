@@ -32,6 +32,7 @@
 
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
@@ -58,273 +59,594 @@ static int op_ldydd(void), op_ldyde(void);
 static int op_ldydh(void), op_ldydl(void), op_ldydn(void);
 extern int op_fdcb_handel(void);
 
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xfd.
+ */
+static int (*op_fd[256]) () = {
+	trap_fd,			/* 0x00	*/
+	trap_fd,			/* 0x01	*/
+	trap_fd,			/* 0x02	*/
+	trap_fd,			/* 0x03	*/
+	trap_fd,			/* 0x04	*/
+	trap_fd,			/* 0x05	*/
+	trap_fd,			/* 0x06	*/
+	trap_fd,			/* 0x07	*/
+	trap_fd,			/* 0x08	*/
+	op_addyb,			/* 0x09	*/
+	trap_fd,			/* 0x0a	*/
+	trap_fd,			/* 0x0b	*/
+	trap_fd,			/* 0x0c	*/
+	trap_fd,			/* 0x0d	*/
+	trap_fd,			/* 0x0e	*/
+	trap_fd,			/* 0x0f	*/
+	trap_fd,			/* 0x10	*/
+	trap_fd,			/* 0x11	*/
+	trap_fd,			/* 0x12	*/
+	trap_fd,			/* 0x13	*/
+	trap_fd,			/* 0x14	*/
+	trap_fd,			/* 0x15	*/
+	trap_fd,			/* 0x16	*/
+	trap_fd,			/* 0x17	*/
+	trap_fd,			/* 0x18	*/
+	op_addyd,			/* 0x19	*/
+	trap_fd,			/* 0x1a	*/
+	trap_fd,			/* 0x1b	*/
+	trap_fd,			/* 0x1c	*/
+	trap_fd,			/* 0x1d	*/
+	trap_fd,			/* 0x1e	*/
+	trap_fd,			/* 0x1f	*/
+	trap_fd,			/* 0x20	*/
+	op_ldiynn,			/* 0x21	*/
+	op_ldiny,			/* 0x22	*/
+	op_inciy,			/* 0x23	*/
+	trap_fd,			/* 0x24	*/
+	trap_fd,			/* 0x25	*/
+	trap_fd,			/* 0x26	*/
+	trap_fd,			/* 0x27	*/
+	trap_fd,			/* 0x28	*/
+	op_addyy,			/* 0x29	*/
+	op_ldiyinn,			/* 0x2a	*/
+	op_deciy,			/* 0x2b	*/
+	trap_fd,			/* 0x2c	*/
+	trap_fd,			/* 0x2d	*/
+	trap_fd,			/* 0x2e	*/
+	trap_fd,			/* 0x2f	*/
+	trap_fd,			/* 0x30	*/
+	trap_fd,			/* 0x31	*/
+	trap_fd,			/* 0x32	*/
+	trap_fd,			/* 0x33	*/
+	op_incyd,			/* 0x34	*/
+	op_decyd,			/* 0x35	*/
+	op_ldydn,			/* 0x36	*/
+	trap_fd,			/* 0x37	*/
+	trap_fd,			/* 0x38	*/
+	op_addys,			/* 0x39	*/
+	trap_fd,			/* 0x3a	*/
+	trap_fd,			/* 0x3b	*/
+	trap_fd,			/* 0x3c	*/
+	trap_fd,			/* 0x3d	*/
+	trap_fd,			/* 0x3e	*/
+	trap_fd,			/* 0x3f	*/
+	trap_fd,			/* 0x40	*/
+	trap_fd,			/* 0x41	*/
+	trap_fd,			/* 0x42	*/
+	trap_fd,			/* 0x43	*/
+	trap_fd,			/* 0x44	*/
+	trap_fd,			/* 0x45	*/
+	op_ldbyd,			/* 0x46	*/
+	trap_fd,			/* 0x47	*/
+	trap_fd,			/* 0x48	*/
+	trap_fd,			/* 0x49	*/
+	trap_fd,			/* 0x4a	*/
+	trap_fd,			/* 0x4b	*/
+	trap_fd,			/* 0x4c	*/
+	trap_fd,			/* 0x4d	*/
+	op_ldcyd,			/* 0x4e	*/
+	trap_fd,			/* 0x4f	*/
+	trap_fd,			/* 0x50	*/
+	trap_fd,			/* 0x51	*/
+	trap_fd,			/* 0x52	*/
+	trap_fd,			/* 0x53	*/
+	trap_fd,			/* 0x54	*/
+	trap_fd,			/* 0x55	*/
+	op_lddyd,			/* 0x56	*/
+	trap_fd,			/* 0x57	*/
+	trap_fd,			/* 0x58	*/
+	trap_fd,			/* 0x59	*/
+	trap_fd,			/* 0x5a	*/
+	trap_fd,			/* 0x5b	*/
+	trap_fd,			/* 0x5c	*/
+	trap_fd,			/* 0x5d	*/
+	op_ldeyd,			/* 0x5e	*/
+	trap_fd,			/* 0x5f	*/
+	trap_fd,			/* 0x60	*/
+	trap_fd,			/* 0x61	*/
+	trap_fd,			/* 0x62	*/
+	trap_fd,			/* 0x63	*/
+	trap_fd,			/* 0x64	*/
+	trap_fd,			/* 0x65	*/
+	op_ldhyd,			/* 0x66	*/
+	trap_fd,			/* 0x67	*/
+	trap_fd,			/* 0x68	*/
+	trap_fd,			/* 0x69	*/
+	trap_fd,			/* 0x6a	*/
+	trap_fd,			/* 0x6b	*/
+	trap_fd,			/* 0x6c	*/
+	trap_fd,			/* 0x6d	*/
+	op_ldlyd,			/* 0x6e	*/
+	trap_fd,			/* 0x6f	*/
+	op_ldydb,			/* 0x70	*/
+	op_ldydc,			/* 0x71	*/
+	op_ldydd,			/* 0x72	*/
+	op_ldyde,			/* 0x73	*/
+	op_ldydh,			/* 0x74	*/
+	op_ldydl,			/* 0x75	*/
+	trap_fd,			/* 0x76	*/
+	op_ldyda,			/* 0x77	*/
+	trap_fd,			/* 0x78	*/
+	trap_fd,			/* 0x79	*/
+	trap_fd,			/* 0x7a	*/
+	trap_fd,			/* 0x7b	*/
+	trap_fd,			/* 0x7c	*/
+	trap_fd,			/* 0x7d	*/
+	op_ldayd,			/* 0x7e	*/
+	trap_fd,			/* 0x7f	*/
+	trap_fd,			/* 0x80	*/
+	trap_fd,			/* 0x81	*/
+	trap_fd,			/* 0x82	*/
+	trap_fd,			/* 0x83	*/
+	trap_fd,			/* 0x84	*/
+	trap_fd,			/* 0x85	*/
+	op_adayd,			/* 0x86	*/
+	trap_fd,			/* 0x87	*/
+	trap_fd,			/* 0x88	*/
+	trap_fd,			/* 0x89	*/
+	trap_fd,			/* 0x8a	*/
+	trap_fd,			/* 0x8b	*/
+	trap_fd,			/* 0x8c	*/
+	trap_fd,			/* 0x8d	*/
+	op_acayd,			/* 0x8e	*/
+	trap_fd,			/* 0x8f	*/
+	trap_fd,			/* 0x90	*/
+	trap_fd,			/* 0x91	*/
+	trap_fd,			/* 0x92	*/
+	trap_fd,			/* 0x93	*/
+	trap_fd,			/* 0x94	*/
+	trap_fd,			/* 0x95	*/
+	op_suayd,			/* 0x96	*/
+	trap_fd,			/* 0x97	*/
+	trap_fd,			/* 0x98	*/
+	trap_fd,			/* 0x99	*/
+	trap_fd,			/* 0x9a	*/
+	trap_fd,			/* 0x9b	*/
+	trap_fd,			/* 0x9c	*/
+	trap_fd,			/* 0x9d	*/
+	op_scayd,			/* 0x9e	*/
+	trap_fd,			/* 0x9f	*/
+	trap_fd,			/* 0xa0	*/
+	trap_fd,			/* 0xa1	*/
+	trap_fd,			/* 0xa2	*/
+	trap_fd,			/* 0xa3	*/
+	trap_fd,			/* 0xa4	*/
+	trap_fd,			/* 0xa5	*/
+	op_andyd,			/* 0xa6	*/
+	trap_fd,			/* 0xa7	*/
+	trap_fd,			/* 0xa8	*/
+	trap_fd,			/* 0xa9	*/
+	trap_fd,			/* 0xaa	*/
+	trap_fd,			/* 0xab	*/
+	trap_fd,			/* 0xac	*/
+	trap_fd,			/* 0xad	*/
+	op_xoryd,			/* 0xae	*/
+	trap_fd,			/* 0xaf	*/
+	trap_fd,			/* 0xb0	*/
+	trap_fd,			/* 0xb1	*/
+	trap_fd,			/* 0xb2	*/
+	trap_fd,			/* 0xb3	*/
+	trap_fd,			/* 0xb4	*/
+	trap_fd,			/* 0xb5	*/
+	op_oryd,			/* 0xb6	*/
+	trap_fd,			/* 0xb7	*/
+	trap_fd,			/* 0xb8	*/
+	trap_fd,			/* 0xb9	*/
+	trap_fd,			/* 0xba	*/
+	trap_fd,			/* 0xbb	*/
+	trap_fd,			/* 0xbc	*/
+	trap_fd,			/* 0xbd	*/
+	op_cpyd,			/* 0xbe	*/
+	trap_fd,			/* 0xbf	*/
+	trap_fd,			/* 0xc0	*/
+	trap_fd,			/* 0xc1	*/
+	trap_fd,			/* 0xc2	*/
+	trap_fd,			/* 0xc3	*/
+	trap_fd,			/* 0xc4	*/
+	trap_fd,			/* 0xc5	*/
+	trap_fd,			/* 0xc6	*/
+	trap_fd,			/* 0xc7	*/
+	trap_fd,			/* 0xc8	*/
+	trap_fd,			/* 0xc9	*/
+	trap_fd,			/* 0xca	*/
+	op_fdcb_handel,			/* 0xcb	*/
+	trap_fd,			/* 0xcc	*/
+	trap_fd,			/* 0xcd	*/
+	trap_fd,			/* 0xce	*/
+	trap_fd,			/* 0xcf	*/
+	trap_fd,			/* 0xd0	*/
+	trap_fd,			/* 0xd1	*/
+	trap_fd,			/* 0xd2	*/
+	trap_fd,			/* 0xd3	*/
+	trap_fd,			/* 0xd4	*/
+	trap_fd,			/* 0xd5	*/
+	trap_fd,			/* 0xd6	*/
+	trap_fd,			/* 0xd7	*/
+	trap_fd,			/* 0xd8	*/
+	trap_fd,			/* 0xd9	*/
+	trap_fd,			/* 0xda	*/
+	trap_fd,			/* 0xdb	*/
+	trap_fd,			/* 0xdc	*/
+	trap_fd,			/* 0xdd	*/
+	trap_fd,			/* 0xde	*/
+	trap_fd,			/* 0xdf	*/
+	trap_fd,			/* 0xe0	*/
+	op_popiy,			/* 0xe1	*/
+	trap_fd,			/* 0xe2	*/
+	op_exspy,			/* 0xe3	*/
+	trap_fd,			/* 0xe4	*/
+	op_pusiy,			/* 0xe5	*/
+	trap_fd,			/* 0xe6	*/
+	trap_fd,			/* 0xe7	*/
+	trap_fd,			/* 0xe8	*/
+	op_jpiy,			/* 0xe9	*/
+	trap_fd,			/* 0xea	*/
+	trap_fd,			/* 0xeb	*/
+	trap_fd,			/* 0xec	*/
+	trap_fd,			/* 0xed	*/
+	trap_fd,			/* 0xee	*/
+	trap_fd,			/* 0xef	*/
+	trap_fd,			/* 0xf0	*/
+	trap_fd,			/* 0xf1	*/
+	trap_fd,			/* 0xf2	*/
+	trap_fd,			/* 0xf3	*/
+	trap_fd,			/* 0xf4	*/
+	trap_fd,			/* 0xf5	*/
+	trap_fd,			/* 0xf6	*/
+	trap_fd,			/* 0xf7	*/
+	trap_fd,			/* 0xf8	*/
+	op_ldspy,			/* 0xf9	*/
+	trap_fd,			/* 0xfa	*/
+	trap_fd,			/* 0xfb	*/
+	trap_fd,			/* 0xfc	*/
+	trap_fd,			/* 0xfd	*/
+	trap_fd,			/* 0xfe	*/
+	trap_fd				/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(); goto done
+#endif
+
 int op_fd_handel(void)
 {
 	register int t;
 
-	static int (*op_fd[256]) () = {
-		trap_fd,			/* 0x00	*/
-		trap_fd,			/* 0x01	*/
-		trap_fd,			/* 0x02	*/
-		trap_fd,			/* 0x03	*/
-		trap_fd,			/* 0x04	*/
-		trap_fd,			/* 0x05	*/
-		trap_fd,			/* 0x06	*/
-		trap_fd,			/* 0x07	*/
-		trap_fd,			/* 0x08	*/
-		op_addyb,			/* 0x09	*/
-		trap_fd,			/* 0x0a	*/
-		trap_fd,			/* 0x0b	*/
-		trap_fd,			/* 0x0c	*/
-		trap_fd,			/* 0x0d	*/
-		trap_fd,			/* 0x0e	*/
-		trap_fd,			/* 0x0f	*/
-		trap_fd,			/* 0x10	*/
-		trap_fd,			/* 0x11	*/
-		trap_fd,			/* 0x12	*/
-		trap_fd,			/* 0x13	*/
-		trap_fd,			/* 0x14	*/
-		trap_fd,			/* 0x15	*/
-		trap_fd,			/* 0x16	*/
-		trap_fd,			/* 0x17	*/
-		trap_fd,			/* 0x18	*/
-		op_addyd,			/* 0x19	*/
-		trap_fd,			/* 0x1a	*/
-		trap_fd,			/* 0x1b	*/
-		trap_fd,			/* 0x1c	*/
-		trap_fd,			/* 0x1d	*/
-		trap_fd,			/* 0x1e	*/
-		trap_fd,			/* 0x1f	*/
-		trap_fd,			/* 0x20	*/
-		op_ldiynn,			/* 0x21	*/
-		op_ldiny,			/* 0x22	*/
-		op_inciy,			/* 0x23	*/
-		trap_fd,			/* 0x24	*/
-		trap_fd,			/* 0x25	*/
-		trap_fd,			/* 0x26	*/
-		trap_fd,			/* 0x27	*/
-		trap_fd,			/* 0x28	*/
-		op_addyy,			/* 0x29	*/
-		op_ldiyinn,			/* 0x2a	*/
-		op_deciy,			/* 0x2b	*/
-		trap_fd,			/* 0x2c	*/
-		trap_fd,			/* 0x2d	*/
-		trap_fd,			/* 0x2e	*/
-		trap_fd,			/* 0x2f	*/
-		trap_fd,			/* 0x30	*/
-		trap_fd,			/* 0x31	*/
-		trap_fd,			/* 0x32	*/
-		trap_fd,			/* 0x33	*/
-		op_incyd,			/* 0x34	*/
-		op_decyd,			/* 0x35	*/
-		op_ldydn,			/* 0x36	*/
-		trap_fd,			/* 0x37	*/
-		trap_fd,			/* 0x38	*/
-		op_addys,			/* 0x39	*/
-		trap_fd,			/* 0x3a	*/
-		trap_fd,			/* 0x3b	*/
-		trap_fd,			/* 0x3c	*/
-		trap_fd,			/* 0x3d	*/
-		trap_fd,			/* 0x3e	*/
-		trap_fd,			/* 0x3f	*/
-		trap_fd,			/* 0x40	*/
-		trap_fd,			/* 0x41	*/
-		trap_fd,			/* 0x42	*/
-		trap_fd,			/* 0x43	*/
-		trap_fd,			/* 0x44	*/
-		trap_fd,			/* 0x45	*/
-		op_ldbyd,			/* 0x46	*/
-		trap_fd,			/* 0x47	*/
-		trap_fd,			/* 0x48	*/
-		trap_fd,			/* 0x49	*/
-		trap_fd,			/* 0x4a	*/
-		trap_fd,			/* 0x4b	*/
-		trap_fd,			/* 0x4c	*/
-		trap_fd,			/* 0x4d	*/
-		op_ldcyd,			/* 0x4e	*/
-		trap_fd,			/* 0x4f	*/
-		trap_fd,			/* 0x50	*/
-		trap_fd,			/* 0x51	*/
-		trap_fd,			/* 0x52	*/
-		trap_fd,			/* 0x53	*/
-		trap_fd,			/* 0x54	*/
-		trap_fd,			/* 0x55	*/
-		op_lddyd,			/* 0x56	*/
-		trap_fd,			/* 0x57	*/
-		trap_fd,			/* 0x58	*/
-		trap_fd,			/* 0x59	*/
-		trap_fd,			/* 0x5a	*/
-		trap_fd,			/* 0x5b	*/
-		trap_fd,			/* 0x5c	*/
-		trap_fd,			/* 0x5d	*/
-		op_ldeyd,			/* 0x5e	*/
-		trap_fd,			/* 0x5f	*/
-		trap_fd,			/* 0x60	*/
-		trap_fd,			/* 0x61	*/
-		trap_fd,			/* 0x62	*/
-		trap_fd,			/* 0x63	*/
-		trap_fd,			/* 0x64	*/
-		trap_fd,			/* 0x65	*/
-		op_ldhyd,			/* 0x66	*/
-		trap_fd,			/* 0x67	*/
-		trap_fd,			/* 0x68	*/
-		trap_fd,			/* 0x69	*/
-		trap_fd,			/* 0x6a	*/
-		trap_fd,			/* 0x6b	*/
-		trap_fd,			/* 0x6c	*/
-		trap_fd,			/* 0x6d	*/
-		op_ldlyd,			/* 0x6e	*/
-		trap_fd,			/* 0x6f	*/
-		op_ldydb,			/* 0x70	*/
-		op_ldydc,			/* 0x71	*/
-		op_ldydd,			/* 0x72	*/
-		op_ldyde,			/* 0x73	*/
-		op_ldydh,			/* 0x74	*/
-		op_ldydl,			/* 0x75	*/
-		trap_fd,			/* 0x76	*/
-		op_ldyda,			/* 0x77	*/
-		trap_fd,			/* 0x78	*/
-		trap_fd,			/* 0x79	*/
-		trap_fd,			/* 0x7a	*/
-		trap_fd,			/* 0x7b	*/
-		trap_fd,			/* 0x7c	*/
-		trap_fd,			/* 0x7d	*/
-		op_ldayd,			/* 0x7e	*/
-		trap_fd,			/* 0x7f	*/
-		trap_fd,			/* 0x80	*/
-		trap_fd,			/* 0x81	*/
-		trap_fd,			/* 0x82	*/
-		trap_fd,			/* 0x83	*/
-		trap_fd,			/* 0x84	*/
-		trap_fd,			/* 0x85	*/
-		op_adayd,			/* 0x86	*/
-		trap_fd,			/* 0x87	*/
-		trap_fd,			/* 0x88	*/
-		trap_fd,			/* 0x89	*/
-		trap_fd,			/* 0x8a	*/
-		trap_fd,			/* 0x8b	*/
-		trap_fd,			/* 0x8c	*/
-		trap_fd,			/* 0x8d	*/
-		op_acayd,			/* 0x8e	*/
-		trap_fd,			/* 0x8f	*/
-		trap_fd,			/* 0x90	*/
-		trap_fd,			/* 0x91	*/
-		trap_fd,			/* 0x92	*/
-		trap_fd,			/* 0x93	*/
-		trap_fd,			/* 0x94	*/
-		trap_fd,			/* 0x95	*/
-		op_suayd,			/* 0x96	*/
-		trap_fd,			/* 0x97	*/
-		trap_fd,			/* 0x98	*/
-		trap_fd,			/* 0x99	*/
-		trap_fd,			/* 0x9a	*/
-		trap_fd,			/* 0x9b	*/
-		trap_fd,			/* 0x9c	*/
-		trap_fd,			/* 0x9d	*/
-		op_scayd,			/* 0x9e	*/
-		trap_fd,			/* 0x9f	*/
-		trap_fd,			/* 0xa0	*/
-		trap_fd,			/* 0xa1	*/
-		trap_fd,			/* 0xa2	*/
-		trap_fd,			/* 0xa3	*/
-		trap_fd,			/* 0xa4	*/
-		trap_fd,			/* 0xa5	*/
-		op_andyd,			/* 0xa6	*/
-		trap_fd,			/* 0xa7	*/
-		trap_fd,			/* 0xa8	*/
-		trap_fd,			/* 0xa9	*/
-		trap_fd,			/* 0xaa	*/
-		trap_fd,			/* 0xab	*/
-		trap_fd,			/* 0xac	*/
-		trap_fd,			/* 0xad	*/
-		op_xoryd,			/* 0xae	*/
-		trap_fd,			/* 0xaf	*/
-		trap_fd,			/* 0xb0	*/
-		trap_fd,			/* 0xb1	*/
-		trap_fd,			/* 0xb2	*/
-		trap_fd,			/* 0xb3	*/
-		trap_fd,			/* 0xb4	*/
-		trap_fd,			/* 0xb5	*/
-		op_oryd,			/* 0xb6	*/
-		trap_fd,			/* 0xb7	*/
-		trap_fd,			/* 0xb8	*/
-		trap_fd,			/* 0xb9	*/
-		trap_fd,			/* 0xba	*/
-		trap_fd,			/* 0xbb	*/
-		trap_fd,			/* 0xbc	*/
-		trap_fd,			/* 0xbd	*/
-		op_cpyd,			/* 0xbe	*/
-		trap_fd,			/* 0xbf	*/
-		trap_fd,			/* 0xc0	*/
-		trap_fd,			/* 0xc1	*/
-		trap_fd,			/* 0xc2	*/
-		trap_fd,			/* 0xc3	*/
-		trap_fd,			/* 0xc4	*/
-		trap_fd,			/* 0xc5	*/
-		trap_fd,			/* 0xc6	*/
-		trap_fd,			/* 0xc7	*/
-		trap_fd,			/* 0xc8	*/
-		trap_fd,			/* 0xc9	*/
-		trap_fd,			/* 0xca	*/
-		op_fdcb_handel,			/* 0xcb	*/
-		trap_fd,			/* 0xcc	*/
-		trap_fd,			/* 0xcd	*/
-		trap_fd,			/* 0xce	*/
-		trap_fd,			/* 0xcf	*/
-		trap_fd,			/* 0xd0	*/
-		trap_fd,			/* 0xd1	*/
-		trap_fd,			/* 0xd2	*/
-		trap_fd,			/* 0xd3	*/
-		trap_fd,			/* 0xd4	*/
-		trap_fd,			/* 0xd5	*/
-		trap_fd,			/* 0xd6	*/
-		trap_fd,			/* 0xd7	*/
-		trap_fd,			/* 0xd8	*/
-		trap_fd,			/* 0xd9	*/
-		trap_fd,			/* 0xda	*/
-		trap_fd,			/* 0xdb	*/
-		trap_fd,			/* 0xdc	*/
-		trap_fd,			/* 0xdd	*/
-		trap_fd,			/* 0xde	*/
-		trap_fd,			/* 0xdf	*/
-		trap_fd,			/* 0xe0	*/
-		op_popiy,			/* 0xe1	*/
-		trap_fd,			/* 0xe2	*/
-		op_exspy,			/* 0xe3	*/
-		trap_fd,			/* 0xe4	*/
-		op_pusiy,			/* 0xe5	*/
-		trap_fd,			/* 0xe6	*/
-		trap_fd,			/* 0xe7	*/
-		trap_fd,			/* 0xe8	*/
-		op_jpiy,			/* 0xe9	*/
-		trap_fd,			/* 0xea	*/
-		trap_fd,			/* 0xeb	*/
-		trap_fd,			/* 0xec	*/
-		trap_fd,			/* 0xed	*/
-		trap_fd,			/* 0xee	*/
-		trap_fd,			/* 0xef	*/
-		trap_fd,			/* 0xf0	*/
-		trap_fd,			/* 0xf1	*/
-		trap_fd,			/* 0xf2	*/
-		trap_fd,			/* 0xf3	*/
-		trap_fd,			/* 0xf4	*/
-		trap_fd,			/* 0xf5	*/
-		trap_fd,			/* 0xf6	*/
-		trap_fd,			/* 0xf7	*/
-		trap_fd,			/* 0xf8	*/
-		op_ldspy,			/* 0xf9	*/
-		trap_fd,			/* 0xfa	*/
-		trap_fd,			/* 0xfb	*/
-		trap_fd,			/* 0xfc	*/
-		trap_fd,			/* 0xfd	*/
-		trap_fd,			/* 0xfe	*/
-		trap_fd				/* 0xff	*/
+#ifdef WANT_THREADED
+	static void *op_fd_thr[256] = {
+		&&l_trap_fd,			/* 0x00	*/
+		&&l_trap_fd,			/* 0x01	*/
+		&&l_trap_fd,			/* 0x02	*/
+		&&l_trap_fd,			/* 0x03	*/
+		&&l_trap_fd,			/* 0x04	*/
+		&&l_trap_fd,			/* 0x05	*/
+		&&l_trap_fd,			/* 0x06	*/
+		&&l_trap_fd,			/* 0x07	*/
+		&&l_trap_fd,			/* 0x08	*/
+		&&l_op_addyb,			/* 0x09	*/
+		&&l_trap_fd,			/* 0x0a	*/
+		&&l_trap_fd,			/* 0x0b	*/
+		&&l_trap_fd,			/* 0x0c	*/
+		&&l_trap_fd,			/* 0x0d	*/
+		&&l_trap_fd,			/* 0x0e	*/
+		&&l_trap_fd,			/* 0x0f	*/
+		&&l_trap_fd,			/* 0x10	*/
+		&&l_trap_fd,			/* 0x11	*/
+		&&l_trap_fd,			/* 0x12	*/
+		&&l_trap_fd,			/* 0x13	*/
+		&&l_trap_fd,			/* 0x14	*/
+		&&l_trap_fd,			/* 0x15	*/
+		&&l_trap_fd,			/* 0x16	*/
+		&&l_trap_fd,			/* 0x17	*/
+		&&l_trap_fd,			/* 0x18	*/
+		&&l_op_addyd,			/* 0x19	*/
+		&&l_trap_fd,			/* 0x1a	*/
+		&&l_trap_fd,			/* 0x1b	*/
+		&&l_trap_fd,			/* 0x1c	*/
+		&&l_trap_fd,			/* 0x1d	*/
+		&&l_trap_fd,			/* 0x1e	*/
+		&&l_trap_fd,			/* 0x1f	*/
+		&&l_trap_fd,			/* 0x20	*/
+		&&l_op_ldiynn,			/* 0x21	*/
+		&&l_op_ldiny,			/* 0x22	*/
+		&&l_op_inciy,			/* 0x23	*/
+		&&l_trap_fd,			/* 0x24	*/
+		&&l_trap_fd,			/* 0x25	*/
+		&&l_trap_fd,			/* 0x26	*/
+		&&l_trap_fd,			/* 0x27	*/
+		&&l_trap_fd,			/* 0x28	*/
+		&&l_op_addyy,			/* 0x29	*/
+		&&l_op_ldiyinn,			/* 0x2a	*/
+		&&l_op_deciy,			/* 0x2b	*/
+		&&l_trap_fd,			/* 0x2c	*/
+		&&l_trap_fd,			/* 0x2d	*/
+		&&l_trap_fd,			/* 0x2e	*/
+		&&l_trap_fd,			/* 0x2f	*/
+		&&l_trap_fd,			/* 0x30	*/
+		&&l_trap_fd,			/* 0x31	*/
+		&&l_trap_fd,			/* 0x32	*/
+		&&l_trap_fd,			/* 0x33	*/
+		&&l_op_incyd,			/* 0x34	*/
+		&&l_op_decyd,			/* 0x35	*/
+		&&l_op_ldydn,			/* 0x36	*/
+		&&l_trap_fd,			/* 0x37	*/
+		&&l_trap_fd,			/* 0x38	*/
+		&&l_op_addys,			/* 0x39	*/
+		&&l_trap_fd,			/* 0x3a	*/
+		&&l_trap_fd,			/* 0x3b	*/
+		&&l_trap_fd,			/* 0x3c	*/
+		&&l_trap_fd,			/* 0x3d	*/
+		&&l_trap_fd,			/* 0x3e	*/
+		&&l_trap_fd,			/* 0x3f	*/
+		&&l_trap_fd,			/* 0x40	*/
+		&&l_trap_fd,			/* 0x41	*/
+		&&l_trap_fd,			/* 0x42	*/
+		&&l_trap_fd,			/* 0x43	*/
+		&&l_trap_fd,			/* 0x44	*/
+		&&l_trap_fd,			/* 0x45	*/
+		&&l_op_ldbyd,			/* 0x46	*/
+		&&l_trap_fd,			/* 0x47	*/
+		&&l_trap_fd,			/* 0x48	*/
+		&&l_trap_fd,			/* 0x49	*/
+		&&l_trap_fd,			/* 0x4a	*/
+		&&l_trap_fd,			/* 0x4b	*/
+		&&l_trap_fd,			/* 0x4c	*/
+		&&l_trap_fd,			/* 0x4d	*/
+		&&l_op_ldcyd,			/* 0x4e	*/
+		&&l_trap_fd,			/* 0x4f	*/
+		&&l_trap_fd,			/* 0x50	*/
+		&&l_trap_fd,			/* 0x51	*/
+		&&l_trap_fd,			/* 0x52	*/
+		&&l_trap_fd,			/* 0x53	*/
+		&&l_trap_fd,			/* 0x54	*/
+		&&l_trap_fd,			/* 0x55	*/
+		&&l_op_lddyd,			/* 0x56	*/
+		&&l_trap_fd,			/* 0x57	*/
+		&&l_trap_fd,			/* 0x58	*/
+		&&l_trap_fd,			/* 0x59	*/
+		&&l_trap_fd,			/* 0x5a	*/
+		&&l_trap_fd,			/* 0x5b	*/
+		&&l_trap_fd,			/* 0x5c	*/
+		&&l_trap_fd,			/* 0x5d	*/
+		&&l_op_ldeyd,			/* 0x5e	*/
+		&&l_trap_fd,			/* 0x5f	*/
+		&&l_trap_fd,			/* 0x60	*/
+		&&l_trap_fd,			/* 0x61	*/
+		&&l_trap_fd,			/* 0x62	*/
+		&&l_trap_fd,			/* 0x63	*/
+		&&l_trap_fd,			/* 0x64	*/
+		&&l_trap_fd,			/* 0x65	*/
+		&&l_op_ldhyd,			/* 0x66	*/
+		&&l_trap_fd,			/* 0x67	*/
+		&&l_trap_fd,			/* 0x68	*/
+		&&l_trap_fd,			/* 0x69	*/
+		&&l_trap_fd,			/* 0x6a	*/
+		&&l_trap_fd,			/* 0x6b	*/
+		&&l_trap_fd,			/* 0x6c	*/
+		&&l_trap_fd,			/* 0x6d	*/
+		&&l_op_ldlyd,			/* 0x6e	*/
+		&&l_trap_fd,			/* 0x6f	*/
+		&&l_op_ldydb,			/* 0x70	*/
+		&&l_op_ldydc,			/* 0x71	*/
+		&&l_op_ldydd,			/* 0x72	*/
+		&&l_op_ldyde,			/* 0x73	*/
+		&&l_op_ldydh,			/* 0x74	*/
+		&&l_op_ldydl,			/* 0x75	*/
+		&&l_trap_fd,			/* 0x76	*/
+		&&l_op_ldyda,			/* 0x77	*/
+		&&l_trap_fd,			/* 0x78	*/
+		&&l_trap_fd,			/* 0x79	*/
+		&&l_trap_fd,			/* 0x7a	*/
+		&&l_trap_fd,			/* 0x7b	*/
+		&&l_trap_fd,			/* 0x7c	*/
+		&&l_trap_fd,			/* 0x7d	*/
+		&&l_op_ldayd,			/* 0x7e	*/
+		&&l_trap_fd,			/* 0x7f	*/
+		&&l_trap_fd,			/* 0x80	*/
+		&&l_trap_fd,			/* 0x81	*/
+		&&l_trap_fd,			/* 0x82	*/
+		&&l_trap_fd,			/* 0x83	*/
+		&&l_trap_fd,			/* 0x84	*/
+		&&l_trap_fd,			/* 0x85	*/
+		&&l_op_adayd,			/* 0x86	*/
+		&&l_trap_fd,			/* 0x87	*/
+		&&l_trap_fd,			/* 0x88	*/
+		&&l_trap_fd,			/* 0x89	*/
+		&&l_trap_fd,			/* 0x8a	*/
+		&&l_trap_fd,			/* 0x8b	*/
+		&&l_trap_fd,			/* 0x8c	*/
+		&&l_trap_fd,			/* 0x8d	*/
+		&&l_op_acayd,			/* 0x8e	*/
+		&&l_trap_fd,			/* 0x8f	*/
+		&&l_trap_fd,			/* 0x90	*/
+		&&l_trap_fd,			/* 0x91	*/
+		&&l_trap_fd,			/* 0x92	*/
+		&&l_trap_fd,			/* 0x93	*/
+		&&l_trap_fd,			/* 0x94	*/
+		&&l_trap_fd,			/* 0x95	*/
+		&&l_op_suayd,			/* 0x96	*/
+		&&l_trap_fd,			/* 0x97	*/
+		&&l_trap_fd,			/* 0x98	*/
+		&&l_trap_fd,			/* 0x99	*/
+		&&l_trap_fd,			/* 0x9a	*/
+		&&l_trap_fd,			/* 0x9b	*/
+		&&l_trap_fd,			/* 0x9c	*/
+		&&l_trap_fd,			/* 0x9d	*/
+		&&l_op_scayd,			/* 0x9e	*/
+		&&l_trap_fd,			/* 0x9f	*/
+		&&l_trap_fd,			/* 0xa0	*/
+		&&l_trap_fd,			/* 0xa1	*/
+		&&l_trap_fd,			/* 0xa2	*/
+		&&l_trap_fd,			/* 0xa3	*/
+		&&l_trap_fd,			/* 0xa4	*/
+		&&l_trap_fd,			/* 0xa5	*/
+		&&l_op_andyd,			/* 0xa6	*/
+		&&l_trap_fd,			/* 0xa7	*/
+		&&l_trap_fd,			/* 0xa8	*/
+		&&l_trap_fd,			/* 0xa9	*/
+		&&l_trap_fd,			/* 0xaa	*/
+		&&l_trap_fd,			/* 0xab	*/
+		&&l_trap_fd,			/* 0xac	*/
+		&&l_trap_fd,			/* 0xad	*/
+		&&l_op_xoryd,			/* 0xae	*/
+		&&l_trap_fd,			/* 0xaf	*/
+		&&l_trap_fd,			/* 0xb0	*/
+		&&l_trap_fd,			/* 0xb1	*/
+		&&l_trap_fd,			/* 0xb2	*/
+		&&l_trap_fd,			/* 0xb3	*/
+		&&l_trap_fd,			/* 0xb4	*/
+		&&l_trap_fd,			/* 0xb5	*/
+		&&l_op_oryd,			/* 0xb6	*/
+		&&l_trap_fd,			/* 0xb7	*/
+		&&l_trap_fd,			/* 0xb8	*/
+		&&l_trap_fd,			/* 0xb9	*/
+		&&l_trap_fd,			/* 0xba	*/
+		&&l_trap_fd,			/* 0xbb	*/
+		&&l_trap_fd,			/* 0xbc	*/
+		&&l_trap_fd,			/* 0xbd	*/
+		&&l_op_cpyd,			/* 0xbe	*/
+		&&l_trap_fd,			/* 0xbf	*/
+		&&l_trap_fd,			/* 0xc0	*/
+		&&l_trap_fd,			/* 0xc1	*/
+		&&l_trap_fd,			/* 0xc2	*/
+		&&l_trap_fd,			/* 0xc3	*/
+		&&l_trap_fd,			/* 0xc4	*/
+		&&l_trap_fd,			/* 0xc5	*/
+		&&l_trap_fd,			/* 0xc6	*/
+		&&l_trap_fd,			/* 0xc7	*/
+		&&l_trap_fd,			/* 0xc8	*/
+		&&l_trap_fd,			/* 0xc9	*/
+		&&l_trap_fd,			/* 0xca	*/
+		&&l_op_fdcb_handel,		/* 0xcb	*/
+		&&l_trap_fd,			/* 0xcc	*/
+		&&l_trap_fd,			/* 0xcd	*/
+		&&l_trap_fd,			/* 0xce	*/
+		&&l_trap_fd,			/* 0xcf	*/
+		&&l_trap_fd,			/* 0xd0	*/
+		&&l_trap_fd,			/* 0xd1	*/
+		&&l_trap_fd,			/* 0xd2	*/
+		&&l_trap_fd,			/* 0xd3	*/
+		&&l_trap_fd,			/* 0xd4	*/
+		&&l_trap_fd,			/* 0xd5	*/
+		&&l_trap_fd,			/* 0xd6	*/
+		&&l_trap_fd,			/* 0xd7	*/
+		&&l_trap_fd,			/* 0xd8	*/
+		&&l_trap_fd,			/* 0xd9	*/
+		&&l_trap_fd,			/* 0xda	*/
+		&&l_trap_fd,			/* 0xdb	*/
+		&&l_trap_fd,			/* 0xdc	*/
+		&&l_trap_fd,			/* 0xdd	*/
+		&&l_trap_fd,			/* 0xde	*/
+		&&l_trap_fd,			/* 0xdf	*/
+		&&l_trap_fd,			/* 0xe0	*/
+		&&l_op_popiy,			/* 0xe1	*/
+		&&l_trap_fd,			/* 0xe2	*/
+		&&l_op_exspy,			/* 0xe3	*/
+		&&l_trap_fd,			/* 0xe4	*/
+		&&l_op_pusiy,			/* 0xe5	*/
+		&&l_trap_fd,			/* 0xe6	*/
+		&&l_trap_fd,			/* 0xe7	*/
+		&&l_trap_fd,			/* 0xe8	*/
+		&&l_op_jpiy,			/* 0xe9	*/
+		&&l_trap_fd,			/* 0xea	*/
+		&&l_trap_fd,			/* 0xeb	*/
+		&&l_trap_fd,			/* 0xec	*/
+		&&l_trap_fd,			/* 0xed	*/
+		&&l_trap_fd,			/* 0xee	*/
+		&&l_trap_fd,			/* 0xef	*/
+		&&l_trap_fd,			/* 0xf0	*/
+		&&l_trap_fd,			/* 0xf1	*/
+		&&l_trap_fd,			/* 0xf2	*/
+		&&l_trap_fd,			/* 0xf3	*/
+		&&l_trap_fd,			/* 0xf4	*/
+		&&l_trap_fd,			/* 0xf5	*/
+		&&l_trap_fd,			/* 0xf6	*/
+		&&l_trap_fd,			/* 0xf7	*/
+		&&l_trap_fd,			/* 0xf8	*/
+		&&l_op_ldspy,			/* 0xf9	*/
+		&&l_trap_fd,			/* 0xfa	*/
+		&&l_trap_fd,			/* 0xfb	*/
+		&&l_trap_fd,			/* 0xfc	*/
+		&&l_trap_fd,			/* 0xfd	*/
+		&&l_trap_fd,			/* 0xfe	*/
+		&&l_trap_fd			/* 0xff	*/
 	};
+#endif
 
-#ifdef WANT_TIM
-	t = (*op_fd[*PC++]) ();		/* execute next opcode */
+	LF_EVAL();			/* opcodes with prefix use F */
+
+#ifdef WANT_THREADED
+	goto *op_fd_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(trap_fd);
+	OP_THR(op_addyb);
+	OP_THR(op_addyd);
+	OP_THR(op_ldiynn);
+	OP_THR(op_ldiny);
+	OP_THR(op_inciy);
+	OP_THR(op_addyy);
+	OP_THR(op_ldiyinn);
+	OP_THR(op_deciy);
+	OP_THR(op_incyd);
+	OP_THR(op_decyd);
+	OP_THR(op_ldydn);
+	OP_THR(op_addys);
+	OP_THR(op_ldbyd);
+	OP_THR(op_ldcyd);
+	OP_THR(op_lddyd);
+	OP_THR(op_ldeyd);
+	OP_THR(op_ldhyd);
+	OP_THR(op_ldlyd);
+	OP_THR(op_ldydb);
+	OP_THR(op_ldydc);
+	OP_THR(op_ldydd);
+	OP_THR(op_ldyde);
+	OP_THR(op_ldydh);
+	OP_THR(op_ldydl);
+	OP_THR(op_ldyda);
+	OP_THR(op_ldayd);
+	OP_THR(op_adayd);
+	OP_THR(op_acayd);
+	OP_THR(op_suayd);
+	OP_THR(op_scayd);
+	OP_THR(op_andyd);
+	OP_THR(op_xoryd);
+	OP_THR(op_oryd);
+	OP_THR(op_cpyd);
+	OP_THR(op_fdcb_handel);
+	OP_THR(op_popiy);
+	OP_THR(op_exspy);
+	OP_THR(op_pusiy);
+	OP_THR(op_jpiy);
+	OP_THR(op_ldspy);
+
+done:
 #else
-	(*op_fd[*PC++]) ();
+	t = (*op_fd[*PC++]) ();		/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -358,12 +680,12 @@ static int op_popiy(void)		/* POP IY */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	IY = *STACK++;
+	IY = memrdr(STACK++ - ram);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	IY += *STACK++ << 8;
+	IY += memrdr(STACK++ - ram) << 8;
 	return(14);
 }
 
@@ -379,12 +701,12 @@ static int op_pusiy(void)		/* PUSH IY */
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = IY >> 8;
+	memwrt(--STACK - ram, IY >> 8);
 #ifdef WANT_SPC
 	if (STACK <= ram)
 		STACK =	ram + 65536L;
 #endif
-	*--STACK = IY;
+	memwrt(--STACK - ram, IY);
 	return(15);
 }
 
@@ -404,9 +726,9 @@ static int op_exspy(void)		/* EX (SP),IY */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	i = *STACK + (*(STACK +	1) << 8);
-	*STACK = IY;
-	*(STACK	+ 1) = IY >> 8;
+	i = memrdr(STACK - ram) + (memrdr(STACK + 1 - ram) << 8);
+	memwrt(STACK - ram, IY);
+	memwrt(STACK - ram + 1, IY >> 8);
 	IY = i;
 #ifdef BUS_8080
 	cpu_bus = CPU_STACK;
@@ -465,14 +787,13 @@ static int op_ldiny(void)		/* LD (nn),IY */
 #endif
 	p = ram	+ *PC++;
 	p += *PC++ << 8;
-	*p++ = IY;
-	*p = IY	>> 8;
+	memwrt(p++ - ram, IY);
+	memwrt(p - ram, IY	>> 8);
 	return(20);
 }
 
 static int op_adayd(void)		/* ADD A,(IY+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -481,20 +802,15 @@ static int op_adayd(void)		/* ADD A,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IY + (signed char)	*PC++);
-	((A & 0xf) + (P	& 0xf) > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr(IY + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[0][A][P];
+	A += P;
 	return(19);
 }
 
 static int op_acayd(void)		/* ADC A,(IY+d) */
 {
-	register int i,	carry;
+	register int carry;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -503,21 +819,15 @@ static int op_acayd(void)		/* ADC A,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	carry =	(F & C_FLAG) ? 1 : 0;
-	P = *(ram + IY + (signed char)	*PC++);
-	((A & 0xf) + (P	& 0xf) + carry > 0xf) ?	(F |= H_FLAG) :	(F &= ~H_FLAG);
-	(A + P + carry > 255) ?	(F |= C_FLAG) :	(F &= ~C_FLAG);
-	A = i =	(signed char) A + (signed char) P + carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F &= ~N_FLAG;
+	P = memrdr(IY + (signed char)	*PC++);
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | add_flag[carry][A][P];
+	A += P + carry;
 	return(19);
 }
 
 static int op_suayd(void)		/* SUB A,(IY+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -526,20 +836,15 @@ static int op_suayd(void)		/* SUB A,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IY + (signed char)	*PC++);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IY + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
+	A -= P;
 	return(19);
 }
 
 static int op_scayd(void)		/* SBC A,(IY+d) */
 {
-	register int i,	carry;
+	register int carry;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -548,15 +853,10 @@ static int op_scayd(void)		/* SBC A,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	carry =	(F & C_FLAG) ? 1 : 0;
-	P = *(ram + IY + (signed char)	*PC++);
-	((P & 0xf) + carry > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P + carry > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	A = i =	(signed char) A - (signed char) P - carry;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IY + (signed char)	*PC++);
+	carry = F & C_FLAG;
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[carry][A][P];
+	A -= P + carry;
 	return(19);
 }
 
@@ -568,12 +868,8 @@ static int op_andyd(void)		/* AND (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A &= *(ram + IY	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= H_FLAG;
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(N_FLAG |	C_FLAG);
+	A &= memrdr(IY	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A] | H_FLAG;
 	return(19);
 }
 
@@ -585,11 +881,8 @@ static int op_xoryd(void)		/* XOR (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A ^= *(ram + IY	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	A ^= memrdr(IY	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
 	return(19);
 }
 
@@ -601,17 +894,13 @@ static int op_oryd(void)		/* OR (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	A |= *(ram + IY	+ (signed char) *PC++);
-	(A & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(A) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	(parrity[A]) ? (F &= ~P_FLAG) :	(F |= P_FLAG);
-	F &= ~(H_FLAG |	N_FLAG | C_FLAG);
+	A |= memrdr(IY	+ (signed char) *PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | szp_flag[A];
 	return(19);
 }
 
 static int op_cpyd(void)		/* CP (IY+d) */
 {
-	register int i;
 	register BYTE P;
 
 #ifdef BUS_8080
@@ -620,20 +909,15 @@ static int op_cpyd(void)		/* CP (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	P = *(ram + IY + (signed char)	*PC++);
-	((P & 0xf) > (A	& 0xf))	? (F |=	H_FLAG)	: (F &=	~H_FLAG);
-	(P > A)	? (F |=	C_FLAG)	: (F &=	~C_FLAG);
-	i = (signed char) A - (signed char) P;
-	(i < -128 || i > 127) ?	(F |= P_FLAG) :	(F &= ~P_FLAG);
-	(i & 128) ? (F |= S_FLAG) : (F &= ~S_FLAG);
-	(i) ? (F &= ~Z_FLAG) : (F |= Z_FLAG);
-	F |= N_FLAG;
+	P = memrdr(IY + (signed char)	*PC++);
+	F = (F & (N2_FLAG | N1_FLAG)) | sub_flag[0][A][P];
 	return(19);
 }
 
 static int op_incyd(void)		/* INC (IY+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -641,13 +925,10 @@ static int op_incyd(void)		/* INC (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + (signed char) *PC++;
-	((*p & 0xf) + 1	> 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	(*p)++;
-	(*p == 128) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F &= ~N_FLAG;
+	addr = IY + (signed char) *PC++;
+	val = memrdr(addr);
+	memwrt(addr, ++val);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_inc[val];
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -659,7 +940,8 @@ static int op_incyd(void)		/* INC (IY+d) */
 
 static int op_decyd(void)		/* DEC (IY+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -667,13 +949,10 @@ static int op_decyd(void)		/* DEC (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + (signed char) *PC++;
-	(((*p - 1) & 0xf) == 0xf) ? (F |= H_FLAG) : (F &= ~H_FLAG);
-	(*p)--;
-	(*p == 127) ? (F |= P_FLAG) : (F &= ~P_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	F |= N_FLAG;
+	addr = IY + (signed char) *PC++;
+	val = memrdr(addr);
+	memwrt(addr, --val);
+	F = (F & (N2_FLAG | N1_FLAG | C_FLAG)) | szhv_dec[val];
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -853,7 +1132,7 @@ static int op_ldyda(void)		/* LD (IY+d),A */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = A;
+	memwrt(IY + (signed char) *PC++, A);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -871,7 +1150,7 @@ static int op_ldydb(void)		/* LD (IY+d),B */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = B;
+	memwrt(IY + (signed char) *PC++, B);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -889,7 +1168,7 @@ static int op_ldydc(void)		/* LD (IY+d),C */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = C;
+	memwrt(IY + (signed char) *PC++, C);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -907,7 +1186,7 @@ static int op_ldydd(void)		/* LD (IY+d),D */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = D;
+	memwrt(IY + (signed char) *PC++, D);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -925,7 +1204,7 @@ static int op_ldyde(void)		/* LD (IY+d),E */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = E;
+	memwrt(IY + (signed char) *PC++, E);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -943,7 +1222,7 @@ static int op_ldydh(void)		/* LD (IY+d),H */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = H;
+	memwrt(IY + (signed char) *PC++, H);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -961,7 +1240,7 @@ static int op_ldydl(void)		/* LD (IY+d),L */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(IY + (signed char) *PC++ + ram) = L;
+	memwrt(IY + (signed char) *PC++, L);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -982,7 +1261,7 @@ static int op_ldydn(void)		/* LD (IY+d),n */
 	fp_sampleLightGroup(0, 0);
 #endif
 	d = (signed char) *PC++;
-	*(IY + d + ram)	= *PC++;
+	memwrt(IY + d, *PC++);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -32,12 +32,13 @@
 
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
 #endif
 
-static int trap_ddcb(void);
+static int trap_ddcb(int);
 static int op_tb0ixd(int), op_tb1ixd(int), op_tb2ixd(int), op_tb3ixd(int);
 static int op_tb4ixd(int), op_tb5ixd(int), op_tb6ixd(int), op_tb7ixd(int);
 static int op_rb0ixd(int), op_rb1ixd(int), op_rb2ixd(int), op_rb3ixd(int);
@@ -47,266 +48,541 @@ static int op_sb4ixd(int), op_sb5ixd(int), op_sb6ixd(int), op_sb7ixd(int);
 static int op_rlcixd(int), op_rrcixd(int), op_rlixd(int), op_rrixd(int);
 static int op_slaixd(int), op_sraixd(int), op_srlixd(int);
 
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xdd 0xcb.
+ */
+static int (*op_ddcb[256]) () = {
+	trap_ddcb,			/* 0x00	*/
+	trap_ddcb,			/* 0x01	*/
+	trap_ddcb,			/* 0x02	*/
+	trap_ddcb,			/* 0x03	*/
+	trap_ddcb,			/* 0x04	*/
+	trap_ddcb,			/* 0x05	*/
+	op_rlcixd,			/* 0x06	*/
+	trap_ddcb,			/* 0x07	*/
+	trap_ddcb,			/* 0x08	*/
+	trap_ddcb,			/* 0x09	*/
+	trap_ddcb,			/* 0x0a	*/
+	trap_ddcb,			/* 0x0b	*/
+	trap_ddcb,			/* 0x0c	*/
+	trap_ddcb,			/* 0x0d	*/
+	op_rrcixd,			/* 0x0e	*/
+	trap_ddcb,			/* 0x0f	*/
+	trap_ddcb,			/* 0x10	*/
+	trap_ddcb,			/* 0x11	*/
+	trap_ddcb,			/* 0x12	*/
+	trap_ddcb,			/* 0x13	*/
+	trap_ddcb,			/* 0x14	*/
+	trap_ddcb,			/* 0x15	*/
+	op_rlixd,			/* 0x16	*/
+	trap_ddcb,			/* 0x17	*/
+	trap_ddcb,			/* 0x18	*/
+	trap_ddcb,			/* 0x19	*/
+	trap_ddcb,			/* 0x1a	*/
+	trap_ddcb,			/* 0x1b	*/
+	trap_ddcb,			/* 0x1c	*/
+	trap_ddcb,			/* 0x1d	*/
+	op_rrixd,			/* 0x1e	*/
+	trap_ddcb,			/* 0x1f	*/
+	trap_ddcb,			/* 0x20	*/
+	trap_ddcb,			/* 0x21	*/
+	trap_ddcb,			/* 0x22	*/
+	trap_ddcb,			/* 0x23	*/
+	trap_ddcb,			/* 0x24	*/
+	trap_ddcb,			/* 0x25	*/
+	op_slaixd,			/* 0x26	*/
+	trap_ddcb,			/* 0x27	*/
+	trap_ddcb,			/* 0x28	*/
+	trap_ddcb,			/* 0x29	*/
+	trap_ddcb,			/* 0x2a	*/
+	trap_ddcb,			/* 0x2b	*/
+	trap_ddcb,			/* 0x2c	*/
+	trap_ddcb,			/* 0x2d	*/
+	op_sraixd,			/* 0x2e	*/
+	trap_ddcb,			/* 0x2f	*/
+	trap_ddcb,			/* 0x30	*/
+	trap_ddcb,			/* 0x31	*/
+	trap_ddcb,			/* 0x32	*/
+	trap_ddcb,			/* 0x33	*/
+	trap_ddcb,			/* 0x34	*/
+	trap_ddcb,			/* 0x35	*/
+	trap_ddcb,			/* 0x36	*/
+	trap_ddcb,			/* 0x37	*/
+	trap_ddcb,			/* 0x38	*/
+	trap_ddcb,			/* 0x39	*/
+	trap_ddcb,			/* 0x3a	*/
+	trap_ddcb,			/* 0x3b	*/
+	trap_ddcb,			/* 0x3c	*/
+	trap_ddcb,			/* 0x3d	*/
+	op_srlixd,			/* 0x3e	*/
+	trap_ddcb,			/* 0x3f	*/
+	trap_ddcb,			/* 0x40	*/
+	trap_ddcb,			/* 0x41	*/
+	trap_ddcb,			/* 0x42	*/
+	trap_ddcb,			/* 0x43	*/
+	trap_ddcb,			/* 0x44	*/
+	trap_ddcb,			/* 0x45	*/
+	op_tb0ixd,			/* 0x46	*/
+	trap_ddcb,			/* 0x47	*/
+	trap_ddcb,			/* 0x48	*/
+	trap_ddcb,			/* 0x49	*/
+	trap_ddcb,			/* 0x4a	*/
+	trap_ddcb,			/* 0x4b	*/
+	trap_ddcb,			/* 0x4c	*/
+	trap_ddcb,			/* 0x4d	*/
+	op_tb1ixd,			/* 0x4e	*/
+	trap_ddcb,			/* 0x4f	*/
+	trap_ddcb,			/* 0x50	*/
+	trap_ddcb,			/* 0x51	*/
+	trap_ddcb,			/* 0x52	*/
+	trap_ddcb,			/* 0x53	*/
+	trap_ddcb,			/* 0x54	*/
+	trap_ddcb,			/* 0x55	*/
+	op_tb2ixd,			/* 0x56	*/
+	trap_ddcb,			/* 0x57	*/
+	trap_ddcb,			/* 0x58	*/
+	trap_ddcb,			/* 0x59	*/
+	trap_ddcb,			/* 0x5a	*/
+	trap_ddcb,			/* 0x5b	*/
+	trap_ddcb,			/* 0x5c	*/
+	trap_ddcb,			/* 0x5d	*/
+	op_tb3ixd,			/* 0x5e	*/
+	trap_ddcb,			/* 0x5f	*/
+	trap_ddcb,			/* 0x60	*/
+	trap_ddcb,			/* 0x61	*/
+	trap_ddcb,			/* 0x62	*/
+	trap_ddcb,			/* 0x63	*/
+	trap_ddcb,			/* 0x64	*/
+	trap_ddcb,			/* 0x65	*/
+	op_tb4ixd,			/* 0x66	*/
+	trap_ddcb,			/* 0x67	*/
+	trap_ddcb,			/* 0x68	*/
+	trap_ddcb,			/* 0x69	*/
+	trap_ddcb,			/* 0x6a	*/
+	trap_ddcb,			/* 0x6b	*/
+	trap_ddcb,			/* 0x6c	*/
+	trap_ddcb,			/* 0x6d	*/
+	op_tb5ixd,			/* 0x6e	*/
+	trap_ddcb,			/* 0x6f	*/
+	trap_ddcb,			/* 0x70	*/
+	trap_ddcb,			/* 0x71	*/
+	trap_ddcb,			/* 0x72	*/
+	trap_ddcb,			/* 0x73	*/
+	trap_ddcb,			/* 0x74	*/
+	trap_ddcb,			/* 0x75	*/
+	op_tb6ixd,			/* 0x76	*/
+	trap_ddcb,			/* 0x77	*/
+	trap_ddcb,			/* 0x78	*/
+	trap_ddcb,			/* 0x79	*/
+	trap_ddcb,			/* 0x7a	*/
+	trap_ddcb,			/* 0x7b	*/
+	trap_ddcb,			/* 0x7c	*/
+	trap_ddcb,			/* 0x7d	*/
+	op_tb7ixd,			/* 0x7e	*/
+	trap_ddcb,			/* 0x7f	*/
+	trap_ddcb,			/* 0x80	*/
+	trap_ddcb,			/* 0x81	*/
+	trap_ddcb,			/* 0x82	*/
+	trap_ddcb,			/* 0x83	*/
+	trap_ddcb,			/* 0x84	*/
+	trap_ddcb,			/* 0x85	*/
+	op_rb0ixd,			/* 0x86	*/
+	trap_ddcb,			/* 0x87	*/
+	trap_ddcb,			/* 0x88	*/
+	trap_ddcb,			/* 0x89	*/
+	trap_ddcb,			/* 0x8a	*/
+	trap_ddcb,			/* 0x8b	*/
+	trap_ddcb,			/* 0x8c	*/
+	trap_ddcb,			/* 0x8d	*/
+	op_rb1ixd,			/* 0x8e	*/
+	trap_ddcb,			/* 0x8f	*/
+	trap_ddcb,			/* 0x90	*/
+	trap_ddcb,			/* 0x91	*/
+	trap_ddcb,			/* 0x92	*/
+	trap_ddcb,			/* 0x93	*/
+	trap_ddcb,			/* 0x94	*/
+	trap_ddcb,			/* 0x95	*/
+	op_rb2ixd,			/* 0x96	*/
+	trap_ddcb,			/* 0x97	*/
+	trap_ddcb,			/* 0x98	*/
+	trap_ddcb,			/* 0x99	*/
+	trap_ddcb,			/* 0x9a	*/
+	trap_ddcb,			/* 0x9b	*/
+	trap_ddcb,			/* 0x9c	*/
+	trap_ddcb,			/* 0x9d	*/
+	op_rb3ixd,			/* 0x9e	*/
+	trap_ddcb,			/* 0x9f	*/
+	trap_ddcb,			/* 0xa0	*/
+	trap_ddcb,			/* 0xa1	*/
+	trap_ddcb,			/* 0xa2	*/
+	trap_ddcb,			/* 0xa3	*/
+	trap_ddcb,			/* 0xa4	*/
+	trap_ddcb,			/* 0xa5	*/
+	op_rb4ixd,			/* 0xa6	*/
+	trap_ddcb,			/* 0xa7	*/
+	trap_ddcb,			/* 0xa8	*/
+	trap_ddcb,			/* 0xa9	*/
+	trap_ddcb,			/* 0xaa	*/
+	trap_ddcb,			/* 0xab	*/
+	trap_ddcb,			/* 0xac	*/
+	trap_ddcb,			/* 0xad	*/
+	op_rb5ixd,			/* 0xae	*/
+	trap_ddcb,			/* 0xaf	*/
+	trap_ddcb,			/* 0xb0	*/
+	trap_ddcb,			/* 0xb1	*/
+	trap_ddcb,			/* 0xb2	*/
+	trap_ddcb,			/* 0xb3	*/
+	trap_ddcb,			/* 0xb4	*/
+	trap_ddcb,			/* 0xb5	*/
+	op_rb6ixd,			/* 0xb6	*/
+	trap_ddcb,			/* 0xb7	*/
+	trap_ddcb,			/* 0xb8	*/
+	trap_ddcb,			/* 0xb9	*/
+	trap_ddcb,			/* 0xba	*/
+	trap_ddcb,			/* 0xbb	*/
+	trap_ddcb,			/* 0xbc	*/
+	trap_ddcb,			/* 0xbd	*/
+	op_rb7ixd,			/* 0xbe	*/
+	trap_ddcb,			/* 0xbf	*/
+	trap_ddcb,			/* 0xc0	*/
+	trap_ddcb,			/* 0xc1	*/
+	trap_ddcb,			/* 0xc2	*/
+	trap_ddcb,			/* 0xc3	*/
+	trap_ddcb,			/* 0xc4	*/
+	trap_ddcb,			/* 0xc5	*/
+	op_sb0ixd,			/* 0xc6	*/
+	trap_ddcb,			/* 0xc7	*/
+	trap_ddcb,			/* 0xc8	*/
+	trap_ddcb,			/* 0xc9	*/
+	trap_ddcb,			/* 0xca	*/
+	trap_ddcb,			/* 0xcb	*/
+	trap_ddcb,			/* 0xcc	*/
+	trap_ddcb,			/* 0xcd	*/
+	op_sb1ixd,			/* 0xce	*/
+	trap_ddcb,			/* 0xcf	*/
+	trap_ddcb,			/* 0xd0	*/
+	trap_ddcb,			/* 0xd1	*/
+	trap_ddcb,			/* 0xd2	*/
+	trap_ddcb,			/* 0xd3	*/
+	trap_ddcb,			/* 0xd4	*/
+	trap_ddcb,			/* 0xd5	*/
+	op_sb2ixd,			/* 0xd6	*/
+	trap_ddcb,			/* 0xd7	*/
+	trap_ddcb,			/* 0xd8	*/
+	trap_ddcb,			/* 0xd9	*/
+	trap_ddcb,			/* 0xda	*/
+	trap_ddcb,			/* 0xdb	*/
+	trap_ddcb,			/* 0xdc	*/
+	trap_ddcb,			/* 0xdd	*/
+	op_sb3ixd,			/* 0xde	*/
+	trap_ddcb,			/* 0xdf	*/
+	trap_ddcb,			/* 0xe0	*/
+	trap_ddcb,			/* 0xe1	*/
+	trap_ddcb,			/* 0xe2	*/
+	trap_ddcb,			/* 0xe3	*/
+	trap_ddcb,			/* 0xe4	*/
+	trap_ddcb,			/* 0xe5	*/
+	op_sb4ixd,			/* 0xe6	*/
+	trap_ddcb,			/* 0xe7	*/
+	trap_ddcb,			/* 0xe8	*/
+	trap_ddcb,			/* 0xe9	*/
+	trap_ddcb,			/* 0xea	*/
+	trap_ddcb,			/* 0xeb	*/
+	trap_ddcb,			/* 0xec	*/
+	trap_ddcb,			/* 0xed	*/
+	op_sb5ixd,			/* 0xee	*/
+	trap_ddcb,			/* 0xef	*/
+	trap_ddcb,			/* 0xf0	*/
+	trap_ddcb,			/* 0xf1	*/
+	trap_ddcb,			/* 0xf2	*/
+	trap_ddcb,			/* 0xf3	*/
+	trap_ddcb,			/* 0xf4	*/
+	trap_ddcb,			/* 0xf5	*/
+	op_sb6ixd,			/* 0xf6	*/
+	trap_ddcb,			/* 0xf7	*/
+	trap_ddcb,			/* 0xf8	*/
+	trap_ddcb,			/* 0xf9	*/
+	trap_ddcb,			/* 0xfa	*/
+	trap_ddcb,			/* 0xfb	*/
+	trap_ddcb,			/* 0xfc	*/
+	trap_ddcb,			/* 0xfd	*/
+	op_sb7ixd,			/* 0xfe	*/
+	trap_ddcb			/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(d); goto done
+#endif
+
 int op_ddcb_handel(void)
 {
-	static int (*op_ddcb[256]) () = {
-		trap_ddcb,			/* 0x00	*/
-		trap_ddcb,			/* 0x01	*/
-		trap_ddcb,			/* 0x02	*/
-		trap_ddcb,			/* 0x03	*/
-		trap_ddcb,			/* 0x04	*/
-		trap_ddcb,			/* 0x05	*/
-		op_rlcixd,			/* 0x06	*/
-		trap_ddcb,			/* 0x07	*/
-		trap_ddcb,			/* 0x08	*/
-		trap_ddcb,			/* 0x09	*/
-		trap_ddcb,			/* 0x0a	*/
-		trap_ddcb,			/* 0x0b	*/
-		trap_ddcb,			/* 0x0c	*/
-		trap_ddcb,			/* 0x0d	*/
-		op_rrcixd,			/* 0x0e	*/
-		trap_ddcb,			/* 0x0f	*/
-		trap_ddcb,			/* 0x10	*/
-		trap_ddcb,			/* 0x11	*/
-		trap_ddcb,			/* 0x12	*/
-		trap_ddcb,			/* 0x13	*/
-		trap_ddcb,			/* 0x14	*/
-		trap_ddcb,			/* 0x15	*/
-		op_rlixd,			/* 0x16	*/
-		trap_ddcb,			/* 0x17	*/
-		trap_ddcb,			/* 0x18	*/
-		trap_ddcb,			/* 0x19	*/
-		trap_ddcb,			/* 0x1a	*/
-		trap_ddcb,			/* 0x1b	*/
-		trap_ddcb,			/* 0x1c	*/
-		trap_ddcb,			/* 0x1d	*/
-		op_rrixd,			/* 0x1e	*/
-		trap_ddcb,			/* 0x1f	*/
-		trap_ddcb,			/* 0x20	*/
-		trap_ddcb,			/* 0x21	*/
-		trap_ddcb,			/* 0x22	*/
-		trap_ddcb,			/* 0x23	*/
-		trap_ddcb,			/* 0x24	*/
-		trap_ddcb,			/* 0x25	*/
-		op_slaixd,			/* 0x26	*/
-		trap_ddcb,			/* 0x27	*/
-		trap_ddcb,			/* 0x28	*/
-		trap_ddcb,			/* 0x29	*/
-		trap_ddcb,			/* 0x2a	*/
-		trap_ddcb,			/* 0x2b	*/
-		trap_ddcb,			/* 0x2c	*/
-		trap_ddcb,			/* 0x2d	*/
-		op_sraixd,			/* 0x2e	*/
-		trap_ddcb,			/* 0x2f	*/
-		trap_ddcb,			/* 0x30	*/
-		trap_ddcb,			/* 0x31	*/
-		trap_ddcb,			/* 0x32	*/
-		trap_ddcb,			/* 0x33	*/
-		trap_ddcb,			/* 0x34	*/
-		trap_ddcb,			/* 0x35	*/
-		trap_ddcb,			/* 0x36	*/
-		trap_ddcb,			/* 0x37	*/
-		trap_ddcb,			/* 0x38	*/
-		trap_ddcb,			/* 0x39	*/
-		trap_ddcb,			/* 0x3a	*/
-		trap_ddcb,			/* 0x3b	*/
-		trap_ddcb,			/* 0x3c	*/
-		trap_ddcb,			/* 0x3d	*/
-		op_srlixd,			/* 0x3e	*/
-		trap_ddcb,			/* 0x3f	*/
-		trap_ddcb,			/* 0x40	*/
-		trap_ddcb,			/* 0x41	*/
-		trap_ddcb,			/* 0x42	*/
-		trap_ddcb,			/* 0x43	*/
-		trap_ddcb,			/* 0x44	*/
-		trap_ddcb,			/* 0x45	*/
-		op_tb0ixd,			/* 0x46	*/
-		trap_ddcb,			/* 0x47	*/
-		trap_ddcb,			/* 0x48	*/
-		trap_ddcb,			/* 0x49	*/
-		trap_ddcb,			/* 0x4a	*/
-		trap_ddcb,			/* 0x4b	*/
-		trap_ddcb,			/* 0x4c	*/
-		trap_ddcb,			/* 0x4d	*/
-		op_tb1ixd,			/* 0x4e	*/
-		trap_ddcb,			/* 0x4f	*/
-		trap_ddcb,			/* 0x50	*/
-		trap_ddcb,			/* 0x51	*/
-		trap_ddcb,			/* 0x52	*/
-		trap_ddcb,			/* 0x53	*/
-		trap_ddcb,			/* 0x54	*/
-		trap_ddcb,			/* 0x55	*/
-		op_tb2ixd,			/* 0x56	*/
-		trap_ddcb,			/* 0x57	*/
-		trap_ddcb,			/* 0x58	*/
-		trap_ddcb,			/* 0x59	*/
-		trap_ddcb,			/* 0x5a	*/
-		trap_ddcb,			/* 0x5b	*/
-		trap_ddcb,			/* 0x5c	*/
-		trap_ddcb,			/* 0x5d	*/
-		op_tb3ixd,			/* 0x5e	*/
-		trap_ddcb,			/* 0x5f	*/
-		trap_ddcb,			/* 0x60	*/
-		trap_ddcb,			/* 0x61	*/
-		trap_ddcb,			/* 0x62	*/
-		trap_ddcb,			/* 0x63	*/
-		trap_ddcb,			/* 0x64	*/
-		trap_ddcb,			/* 0x65	*/
-		op_tb4ixd,			/* 0x66	*/
-		trap_ddcb,			/* 0x67	*/
-		trap_ddcb,			/* 0x68	*/
-		trap_ddcb,			/* 0x69	*/
-		trap_ddcb,			/* 0x6a	*/
-		trap_ddcb,			/* 0x6b	*/
-		trap_ddcb,			/* 0x6c	*/
-		trap_ddcb,			/* 0x6d	*/
-		op_tb5ixd,			/* 0x6e	*/
-		trap_ddcb,			/* 0x6f	*/
-		trap_ddcb,			/* 0x70	*/
-		trap_ddcb,			/* 0x71	*/
-		trap_ddcb,			/* 0x72	*/
-		trap_ddcb,			/* 0x73	*/
-		trap_ddcb,			/* 0x74	*/
-		trap_ddcb,			/* 0x75	*/
-		op_tb6ixd,			/* 0x76	*/
-		trap_ddcb,			/* 0x77	*/
-		trap_ddcb,			/* 0x78	*/
-		trap_ddcb,			/* 0x79	*/
-		trap_ddcb,			/* 0x7a	*/
-		trap_ddcb,			/* 0x7b	*/
-		trap_ddcb,			/* 0x7c	*/
-		trap_ddcb,			/* 0x7d	*/
-		op_tb7ixd,			/* 0x7e	*/
-		trap_ddcb,			/* 0x7f	*/
-		trap_ddcb,			/* 0x80	*/
-		trap_ddcb,			/* 0x81	*/
-		trap_ddcb,			/* 0x82	*/
-		trap_ddcb,			/* 0x83	*/
-		trap_ddcb,			/* 0x84	*/
-		trap_ddcb,			/* 0x85	*/
-		op_rb0ixd,			/* 0x86	*/
-		trap_ddcb,			/* 0x87	*/
-		trap_ddcb,			/* 0x88	*/
-		trap_ddcb,			/* 0x89	*/
-		trap_ddcb,			/* 0x8a	*/
-		trap_ddcb,			/* 0x8b	*/
-		trap_ddcb,			/* 0x8c	*/
-		trap_ddcb,			/* 0x8d	*/
-		op_rb1ixd,			/* 0x8e	*/
-		trap_ddcb,			/* 0x8f	*/
-		trap_ddcb,			/* 0x90	*/
-		trap_ddcb,			/* 0x91	*/
-		trap_ddcb,			/* 0x92	*/
-		trap_ddcb,			/* 0x93	*/
-		trap_ddcb,			/* 0x94	*/
-		trap_ddcb,			/* 0x95	*/
-		op_rb2ixd,			/* 0x96	*/
-		trap_ddcb,			/* 0x97	*/
-		trap_ddcb,			/* 0x98	*/
-		trap_ddcb,			/* 0x99	*/
-		trap_ddcb,			/* 0x9a	*/
-		trap_ddcb,			/* 0x9b	*/
-		trap_ddcb,			/* 0x9c	*/
-		trap_ddcb,			/* 0x9d	*/
-		op_rb3ixd,			/* 0x9e	*/
-		trap_ddcb,			/* 0x9f	*/
-		trap_ddcb,			/* 0xa0	*/
-		trap_ddcb,			/* 0xa1	*/
-		trap_ddcb,			/* 0xa2	*/
-		trap_ddcb,			/* 0xa3	*/
-		trap_ddcb,			/* 0xa4	*/
-		trap_ddcb,			/* 0xa5	*/
-		op_rb4ixd,			/* 0xa6	*/
-		trap_ddcb,			/* 0xa7	*/
-		trap_ddcb,			/* 0xa8	*/
-		trap_ddcb,			/* 0xa9	*/
-		trap_ddcb,			/* 0xaa	*/
-		trap_ddcb,			/* 0xab	*/
-		trap_ddcb,			/* 0xac	*/
-		trap_ddcb,			/* 0xad	*/
-		op_rb5ixd,			/* 0xae	*/
-		trap_ddcb,			/* 0xaf	*/
-		trap_ddcb,			/* 0xb0	*/
-		trap_ddcb,			/* 0xb1	*/
-		trap_ddcb,			/* 0xb2	*/
-		trap_ddcb,			/* 0xb3	*/
-		trap_ddcb,			/* 0xb4	*/
-		trap_ddcb,			/* 0xb5	*/
-		op_rb6ixd,			/* 0xb6	*/
-		trap_ddcb,			/* 0xb7	*/
-		trap_ddcb,			/* 0xb8	*/
-		trap_ddcb,			/* 0xb9	*/
-		trap_ddcb,			/* 0xba	*/
-		trap_ddcb,			/* 0xbb	*/
-		trap_ddcb,			/* 0xbc	*/
-		trap_ddcb,			/* 0xbd	*/
-		op_rb7ixd,			/* 0xbe	*/
-		trap_ddcb,			/* 0xbf	*/
-		trap_ddcb,			/* 0xc0	*/
-		trap_ddcb,			/* 0xc1	*/
-		trap_ddcb,			/* 0xc2	*/
-		trap_ddcb,			/* 0xc3	*/
-		trap_ddcb,			/* 0xc4	*/
-		trap_ddcb,			/* 0xc5	*/
-		op_sb0ixd,			/* 0xc6	*/
-		trap_ddcb,			/* 0xc7	*/
-		trap_ddcb,			/* 0xc8	*/
-		trap_ddcb,			/* 0xc9	*/
-		trap_ddcb,			/* 0xca	*/
-		trap_ddcb,			/* 0xcb	*/
-		trap_ddcb,			/* 0xcc	*/
-		trap_ddcb,			/* 0xcd	*/
-		op_sb1ixd,			/* 0xce	*/
-		trap_ddcb,			/* 0xcf	*/
-		trap_ddcb,			/* 0xd0	*/
-		trap_ddcb,			/* 0xd1	*/
-		trap_ddcb,			/* 0xd2	*/
-		trap_ddcb,			/* 0xd3	*/
-		trap_ddcb,			/* 0xd4	*/
-		trap_ddcb,			/* 0xd5	*/
-		op_sb2ixd,			/* 0xd6	*/
-		trap_ddcb,			/* 0xd7	*/
-		trap_ddcb,			/* 0xd8	*/
-		trap_ddcb,			/* 0xd9	*/
-		trap_ddcb,			/* 0xda	*/
-		trap_ddcb,			/* 0xdb	*/
-		trap_ddcb,			/* 0xdc	*/
-		trap_ddcb,			/* 0xdd	*/
-		op_sb3ixd,			/* 0xde	*/
-		trap_ddcb,			/* 0xdf	*/
-		trap_ddcb,			/* 0xe0	*/
-		trap_ddcb,			/* 0xe1	*/
-		trap_ddcb,			/* 0xe2	*/
-		trap_ddcb,			/* 0xe3	*/
-		trap_ddcb,			/* 0xe4	*/
-		trap_ddcb,			/* 0xe5	*/
-		op_sb4ixd,			/* 0xe6	*/
-		trap_ddcb,			/* 0xe7	*/
-		trap_ddcb,			/* 0xe8	*/
-		trap_ddcb,			/* 0xe9	*/
-		trap_ddcb,			/* 0xea	*/
-		trap_ddcb,			/* 0xeb	*/
-		trap_ddcb,			/* 0xec	*/
-		trap_ddcb,			/* 0xed	*/
-		op_sb5ixd,			/* 0xee	*/
-		trap_ddcb,			/* 0xef	*/
-		trap_ddcb,			/* 0xf0	*/
-		trap_ddcb,			/* 0xf1	*/
-		trap_ddcb,			/* 0xf2	*/
-		trap_ddcb,			/* 0xf3	*/
-		trap_ddcb,			/* 0xf4	*/
-		trap_ddcb,			/* 0xf5	*/
-		op_sb6ixd,			/* 0xf6	*/
-		trap_ddcb,			/* 0xf7	*/
-		trap_ddcb,			/* 0xf8	*/
-		trap_ddcb,			/* 0xf9	*/
-		trap_ddcb,			/* 0xfa	*/
-		trap_ddcb,			/* 0xfb	*/
-		trap_ddcb,			/* 0xfc	*/
-		trap_ddcb,			/* 0xfd	*/
-		op_sb7ixd,			/* 0xfe	*/
-		trap_ddcb			/* 0xff	*/
+#ifdef WANT_THREADED
+	static void *op_ddcb_thr[256] = {
+		&&l_trap_ddcb,			/* 0x00	*/
+		&&l_trap_ddcb,			/* 0x01	*/
+		&&l_trap_ddcb,			/* 0x02	*/
+		&&l_trap_ddcb,			/* 0x03	*/
+		&&l_trap_ddcb,			/* 0x04	*/
+		&&l_trap_ddcb,			/* 0x05	*/
+		&&l_op_rlcixd,			/* 0x06	*/
+		&&l_trap_ddcb,			/* 0x07	*/
+		&&l_trap_ddcb,			/* 0x08	*/
+		&&l_trap_ddcb,			/* 0x09	*/
+		&&l_trap_ddcb,			/* 0x0a	*/
+		&&l_trap_ddcb,			/* 0x0b	*/
+		&&l_trap_ddcb,			/* 0x0c	*/
+		&&l_trap_ddcb,			/* 0x0d	*/
+		&&l_op_rrcixd,			/* 0x0e	*/
+		&&l_trap_ddcb,			/* 0x0f	*/
+		&&l_trap_ddcb,			/* 0x10	*/
+		&&l_trap_ddcb,			/* 0x11	*/
+		&&l_trap_ddcb,			/* 0x12	*/
+		&&l_trap_ddcb,			/* 0x13	*/
+		&&l_trap_ddcb,			/* 0x14	*/
+		&&l_trap_ddcb,			/* 0x15	*/
+		&&l_op_rlixd,			/* 0x16	*/
+		&&l_trap_ddcb,			/* 0x17	*/
+		&&l_trap_ddcb,			/* 0x18	*/
+		&&l_trap_ddcb,			/* 0x19	*/
+		&&l_trap_ddcb,			/* 0x1a	*/
+		&&l_trap_ddcb,			/* 0x1b	*/
+		&&l_trap_ddcb,			/* 0x1c	*/
+		&&l_trap_ddcb,			/* 0x1d	*/
+		&&l_op_rrixd,			/* 0x1e	*/
+		&&l_trap_ddcb,			/* 0x1f	*/
+		&&l_trap_ddcb,			/* 0x20	*/
+		&&l_trap_ddcb,			/* 0x21	*/
+		&&l_trap_ddcb,			/* 0x22	*/
+		&&l_trap_ddcb,			/* 0x23	*/
+		&&l_trap_ddcb,			/* 0x24	*/
+		&&l_trap_ddcb,			/* 0x25	*/
+		&&l_op_slaixd,			/* 0x26	*/
+		&&l_trap_ddcb,			/* 0x27	*/
+		&&l_trap_ddcb,			/* 0x28	*/
+		&&l_trap_ddcb,			/* 0x29	*/
+		&&l_trap_ddcb,			/* 0x2a	*/
+		&&l_trap_ddcb,			/* 0x2b	*/
+		&&l_trap_ddcb,			/* 0x2c	*/
+		&&l_trap_ddcb,			/* 0x2d	*/
+		&&l_op_sraixd,			/* 0x2e	*/
+		&&l_trap_ddcb,			/* 0x2f	*/
+		&&l_trap_ddcb,			/* 0x30	*/
+		&&l_trap_ddcb,			/* 0x31	*/
+		&&l_trap_ddcb,			/* 0x32	*/
+		&&l_trap_ddcb,			/* 0x33	*/
+		&&l_trap_ddcb,			/* 0x34	*/
+		&&l_trap_ddcb,			/* 0x35	*/
+		&&l_trap_ddcb,			/* 0x36	*/
+		&&l_trap_ddcb,			/* 0x37	*/
+		&&l_trap_ddcb,			/* 0x38	*/
+		&&l_trap_ddcb,			/* 0x39	*/
+		&&l_trap_ddcb,			/* 0x3a	*/
+		&&l_trap_ddcb,			/* 0x3b	*/
+		&&l_trap_ddcb,			/* 0x3c	*/
+		&&l_trap_ddcb,			/* 0x3d	*/
+		&&l_op_srlixd,			/* 0x3e	*/
+		&&l_trap_ddcb,			/* 0x3f	*/
+		&&l_trap_ddcb,			/* 0x40	*/
+		&&l_trap_ddcb,			/* 0x41	*/
+		&&l_trap_ddcb,			/* 0x42	*/
+		&&l_trap_ddcb,			/* 0x43	*/
+		&&l_trap_ddcb,			/* 0x44	*/
+		&&l_trap_ddcb,			/* 0x45	*/
+		&&l_op_tb0ixd,			/* 0x46	*/
+		&&l_trap_ddcb,			/* 0x47	*/
+		&&l_trap_ddcb,			/* 0x48	*/
+		&&l_trap_ddcb,			/* 0x49	*/
+		&&l_trap_ddcb,			/* 0x4a	*/
+		&&l_trap_ddcb,			/* 0x4b	*/
+		&&l_trap_ddcb,			/* 0x4c	*/
+		&&l_trap_ddcb,			/* 0x4d	*/
+		&&l_op_tb1ixd,			/* 0x4e	*/
+		&&l_trap_ddcb,			/* 0x4f	*/
+		&&l_trap_ddcb,			/* 0x50	*/
+		&&l_trap_ddcb,			/* 0x51	*/
+		&&l_trap_ddcb,			/* 0x52	*/
+		&&l_trap_ddcb,			/* 0x53	*/
+		&&l_trap_ddcb,			/* 0x54	*/
+		&&l_trap_ddcb,			/* 0x55	*/
+		&&l_op_tb2ixd,			/* 0x56	*/
+		&&l_trap_ddcb,			/* 0x57	*/
+		&&l_trap_ddcb,			/* 0x58	*/
+		&&l_trap_ddcb,			/* 0x59	*/
+		&&l_trap_ddcb,			/* 0x5a	*/
+		&&l_trap_ddcb,			/* 0x5b	*/
+		&&l_trap_ddcb,			/* 0x5c	*/
+		&&l_trap_ddcb,			/* 0x5d	*/
+		&&l_op_tb3ixd,			/* 0x5e	*/
+		&&l_trap_ddcb,			/* 0x5f	*/
+		&&l_trap_ddcb,			/* 0x60	*/
+		&&l_trap_ddcb,			/* 0x61	*/
+		&&l_trap_ddcb,			/* 0x62	*/
+		&&l_trap_ddcb,			/* 0x63	*/
+		&&l_trap_ddcb,			/* 0x64	*/
+		&&l_trap_ddcb,			/* 0x65	*/
+		&&l_op_tb4ixd,			/* 0x66	*/
+		&&l_trap_ddcb,			/* 0x67	*/
+		&&l_trap_ddcb,			/* 0x68	*/
+		&&l_trap_ddcb,			/* 0x69	*/
+		&&l_trap_ddcb,			/* 0x6a	*/
+		&&l_trap_ddcb,			/* 0x6b	*/
+		&&l_trap_ddcb,			/* 0x6c	*/
+		&&l_trap_ddcb,			/* 0x6d	*/
+		&&l_op_tb5ixd,			/* 0x6e	*/
+		&&l_trap_ddcb,			/* 0x6f	*/
+		&&l_trap_ddcb,			/* 0x70	*/
+		&&l_trap_ddcb,			/* 0x71	*/
+		&&l_trap_ddcb,			/* 0x72	*/
+		&&l_trap_ddcb,			/* 0x73	*/
+		&&l_trap_ddcb,			/* 0x74	*/
+		&&l_trap_ddcb,			/* 0x75	*/
+		&&l_op_tb6ixd,			/* 0x76	*/
+		&&l_trap_ddcb,			/* 0x77	*/
+		&&l_trap_ddcb,			/* 0x78	*/
+		&&l_trap_ddcb,			/* 0x79	*/
+		&&l_trap_ddcb,			/* 0x7a	*/
+		&&l_trap_ddcb,			/* 0x7b	*/
+		&&l_trap_ddcb,			/* 0x7c	*/
+		&&l_trap_ddcb,			/* 0x7d	*/
+		&&l_op_tb7ixd,			/* 0x7e	*/
+		&&l_trap_ddcb,			/* 0x7f	*/
+		&&l_trap_ddcb,			/* 0x80	*/
+		&&l_trap_ddcb,			/* 0x81	*/
+		&&l_trap_ddcb,			/* 0x82	*/
+		&&l_trap_ddcb,			/* 0x83	*/
+		&&l_trap_ddcb,			/* 0x84	*/
+		&&l_trap_ddcb,			/* 0x85	*/
+		&&l_op_rb0ixd,			/* 0x86	*/
+		&&l_trap_ddcb,			/* 0x87	*/
+		&&l_trap_ddcb,			/* 0x88	*/
+		&&l_trap_ddcb,			/* 0x89	*/
+		&&l_trap_ddcb,			/* 0x8a	*/
+		&&l_trap_ddcb,			/* 0x8b	*/
+		&&l_trap_ddcb,			/* 0x8c	*/
+		&&l_trap_ddcb,			/* 0x8d	*/
+		&&l_op_rb1ixd,			/* 0x8e	*/
+		&&l_trap_ddcb,			/* 0x8f	*/
+		&&l_trap_ddcb,			/* 0x90	*/
+		&&l_trap_ddcb,			/* 0x91	*/
+		&&l_trap_ddcb,			/* 0x92	*/
+		&&l_trap_ddcb,			/* 0x93	*/
+		&&l_trap_ddcb,			/* 0x94	*/
+		&&l_trap_ddcb,			/* 0x95	*/
+		&&l_op_rb2ixd,			/* 0x96	*/
+		&&l_trap_ddcb,			/* 0x97	*/
+		&&l_trap_ddcb,			/* 0x98	*/
+		&&l_trap_ddcb,			/* 0x99	*/
+		&&l_trap_ddcb,			/* 0x9a	*/
+		&&l_trap_ddcb,			/* 0x9b	*/
+		&&l_trap_ddcb,			/* 0x9c	*/
+		&&l_trap_ddcb,			/* 0x9d	*/
+		&&l_op_rb3ixd,			/* 0x9e	*/
+		&&l_trap_ddcb,			/* 0x9f	*/
+		&&l_trap_ddcb,			/* 0xa0	*/
+		&&l_trap_ddcb,			/* 0xa1	*/
+		&&l_trap_ddcb,			/* 0xa2	*/
+		&&l_trap_ddcb,			/* 0xa3	*/
+		&&l_trap_ddcb,			/* 0xa4	*/
+		&&l_trap_ddcb,			/* 0xa5	*/
+		&&l_op_rb4ixd,			/* 0xa6	*/
+		&&l_trap_ddcb,			/* 0xa7	*/
+		&&l_trap_ddcb,			/* 0xa8	*/
+		&&l_trap_ddcb,			/* 0xa9	*/
+		&&l_trap_ddcb,			/* 0xaa	*/
+		&&l_trap_ddcb,			/* 0xab	*/
+		&&l_trap_ddcb,			/* 0xac	*/
+		&&l_trap_ddcb,			/* 0xad	*/
+		&&l_op_rb5ixd,			/* 0xae	*/
+		&&l_trap_ddcb,			/* 0xaf	*/
+		&&l_trap_ddcb,			/* 0xb0	*/
+		&&l_trap_ddcb,			/* 0xb1	*/
+		&&l_trap_ddcb,			/* 0xb2	*/
+		&&l_trap_ddcb,			/* 0xb3	*/
+		&&l_trap_ddcb,			/* 0xb4	*/
+		&&l_trap_ddcb,			/* 0xb5	*/
+		&&l_op_rb6ixd,			/* 0xb6	*/
+		&&l_trap_ddcb,			/* 0xb7	*/
+		&&l_trap_ddcb,			/* 0xb8	*/
+		&&l_trap_ddcb,			/* 0xb9	*/
+		&&l_trap_ddcb,			/* 0xba	*/
+		&&l_trap_ddcb,			/* 0xbb	*/
+		&&l_trap_ddcb,			/* 0xbc	*/
+		&&l_trap_ddcb,			/* 0xbd	*/
+		&&l_op_rb7ixd,			/* 0xbe	*/
+		&&l_trap_ddcb,			/* 0xbf	*/
+		&&l_trap_ddcb,			/* 0xc0	*/
+		&&l_trap_ddcb,			/* 0xc1	*/
+		&&l_trap_ddcb,			/* 0xc2	*/
+		&&l_trap_ddcb,			/* 0xc3	*/
+		&&l_trap_ddcb,			/* 0xc4	*/
+		&&l_trap_ddcb,			/* 0xc5	*/
+		&&l_op_sb0ixd,			/* 0xc6	*/
+		&&l_trap_ddcb,			/* 0xc7	*/
+		&&l_trap_ddcb,			/* 0xc8	*/
+		&&l_trap_ddcb,			/* 0xc9	*/
+		&&l_trap_ddcb,			/* 0xca	*/
+		&&l_trap_ddcb,			/* 0xcb	*/
+		&&l_trap_ddcb,			/* 0xcc	*/
+		&&l_trap_ddcb,			/* 0xcd	*/
+		&&l_op_sb1ixd,			/* 0xce	*/
+		&&l_trap_ddcb,			/* 0xcf	*/
+		&&l_trap_ddcb,			/* 0xd0	*/
+		&&l_trap_ddcb,			/* 0xd1	*/
+		&&l_trap_ddcb,			/* 0xd2	*/
+		&&l_trap_ddcb,			/* 0xd3	*/
+		&&l_trap_ddcb,			/* 0xd4	*/
+		&&l_trap_ddcb,			/* 0xd5	*/
+		&&l_op_sb2ixd,			/* 0xd6	*/
+		&&l_trap_ddcb,			/* 0xd7	*/
+		&&l_trap_ddcb,			/* 0xd8	*/
+		&&l_trap_ddcb,			/* 0xd9	*/
+		&&l_trap_ddcb,			/* 0xda	*/
+		&&l_trap_ddcb,			/* 0xdb	*/
+		&&l_trap_ddcb,			/* 0xdc	*/
+		&&l_trap_ddcb,			/* 0xdd	*/
+		&&l_op_sb3ixd,			/* 0xde	*/
+		&&l_trap_ddcb,			/* 0xdf	*/
+		&&l_trap_ddcb,			/* 0xe0	*/
+		&&l_trap_ddcb,			/* 0xe1	*/
+		&&l_trap_ddcb,			/* 0xe2	*/
+		&&l_trap_ddcb,			/* 0xe3	*/
+		&&l_trap_ddcb,			/* 0xe4	*/
+		&&l_trap_ddcb,			/* 0xe5	*/
+		&&l_op_sb4ixd,			/* 0xe6	*/
+		&&l_trap_ddcb,			/* 0xe7	*/
+		&&l_trap_ddcb,			/* 0xe8	*/
+		&&l_trap_ddcb,			/* 0xe9	*/
+		&&l_trap_ddcb,			/* 0xea	*/
+		&&l_trap_ddcb,			/* 0xeb	*/
+		&&l_trap_ddcb,			/* 0xec	*/
+		&&l_trap_ddcb,			/* 0xed	*/
+		&&l_op_sb5ixd,			/* 0xee	*/
+		&&l_trap_ddcb,			/* 0xef	*/
+		&&l_trap_ddcb,			/* 0xf0	*/
+		&&l_trap_ddcb,			/* 0xf1	*/
+		&&l_trap_ddcb,			/* 0xf2	*/
+		&&l_trap_ddcb,			/* 0xf3	*/
+		&&l_trap_ddcb,			/* 0xf4	*/
+		&&l_trap_ddcb,			/* 0xf5	*/
+		&&l_op_sb6ixd,			/* 0xf6	*/
+		&&l_trap_ddcb,			/* 0xf7	*/
+		&&l_trap_ddcb,			/* 0xf8	*/
+		&&l_trap_ddcb,			/* 0xf9	*/
+		&&l_trap_ddcb,			/* 0xfa	*/
+		&&l_trap_ddcb,			/* 0xfb	*/
+		&&l_trap_ddcb,			/* 0xfc	*/
+		&&l_trap_ddcb,			/* 0xfd	*/
+		&&l_op_sb7ixd,			/* 0xfe	*/
+		&&l_trap_ddcb			/* 0xff	*/
 	};
+#endif
 
 	register int d;
 	register int t;
@@ -318,10 +594,45 @@ int op_ddcb_handel(void)
 			PC = ram;
 #endif
 
-#ifdef WANT_TIM
-	t = (*op_ddcb[*PC++]) (d);	/* execute next opcode */
+#ifdef WANT_THREADED
+	goto *op_ddcb_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(trap_ddcb);
+	OP_THR(op_rlcixd);
+	OP_THR(op_rrcixd);
+	OP_THR(op_rlixd);
+	OP_THR(op_rrixd);
+	OP_THR(op_slaixd);
+	OP_THR(op_sraixd);
+	OP_THR(op_srlixd);
+	OP_THR(op_tb0ixd);
+	OP_THR(op_tb1ixd);
+	OP_THR(op_tb2ixd);
+	OP_THR(op_tb3ixd);
+	OP_THR(op_tb4ixd);
+	OP_THR(op_tb5ixd);
+	OP_THR(op_tb6ixd);
+	OP_THR(op_tb7ixd);
+	OP_THR(op_rb0ixd);
+	OP_THR(op_rb1ixd);
+	OP_THR(op_rb2ixd);
+	OP_THR(op_rb3ixd);
+	OP_THR(op_rb4ixd);
+	OP_THR(op_rb5ixd);
+	OP_THR(op_rb6ixd);
+	OP_THR(op_rb7ixd);
+	OP_THR(op_sb0ixd);
+	OP_THR(op_sb1ixd);
+	OP_THR(op_sb2ixd);
+	OP_THR(op_sb3ixd);
+	OP_THR(op_sb4ixd);
+	OP_THR(op_sb5ixd);
+	OP_THR(op_sb6ixd);
+	OP_THR(op_sb7ixd);
+
+done:
 #else
-	(*op_ddcb[*PC++]) (d);
+	t = (*op_ddcb[*PC++]) (d);	/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -336,7 +647,7 @@ int op_ddcb_handel(void)
  *	This function traps all illegal opcodes following the
  *	initial 0xdd 0xcb of a 4 byte opcode.
  */
-static int trap_ddcb(void)
+static int trap_ddcb(int data)
 {
 	cpu_error = OPTRAP4;
 	cpu_state = STOPPED;
@@ -353,7 +664,7 @@ static int op_tb0ixd(int data)		/* BIT 0,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -368,7 +679,7 @@ static int op_tb1ixd(int data)		/* BIT 1,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -383,7 +694,7 @@ static int op_tb2ixd(int data)		/* BIT 2,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -398,7 +709,7 @@ static int op_tb3ixd(int data)		/* BIT 3,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -413,7 +724,7 @@ static int op_tb4ixd(int data)		/* BIT 4,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -428,7 +739,7 @@ static int op_tb5ixd(int data)		/* BIT 5,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -443,7 +754,7 @@ static int op_tb6ixd(int data)		/* BIT 6,(IX+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IX + data) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IX + data) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -458,7 +769,7 @@ static int op_tb7ixd(int data)		/* BIT 7,(IX+d) */
 #endif
 	F &= ~N_FLAG;
 	F |= H_FLAG;
-	if (*(ram + IX + data) & 128) {
+	if (memrdr(IX + data) & 128) {
 		F &= ~(Z_FLAG | P_FLAG);
 		F |= S_FLAG;
 	} else {
@@ -476,7 +787,7 @@ static int op_rb0ixd(int data)		/* RES 0,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~1;
+	memwrt(IX + data, memrdr(IX + data) & ~1);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -494,7 +805,7 @@ static int op_rb1ixd(int data)		/* RES 1,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~2;
+	memwrt(IX + data, memrdr(IX + data) & ~2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -512,7 +823,7 @@ static int op_rb2ixd(int data)		/* RES 2,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~4;
+	memwrt(IX + data, memrdr(IX + data) & ~4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -530,7 +841,7 @@ static int op_rb3ixd(int data)		/* RES 3,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~8;
+	memwrt(IX + data, memrdr(IX + data) & ~8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -548,7 +859,7 @@ static int op_rb4ixd(int data)		/* RES 4,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~16;
+	memwrt(IX + data, memrdr(IX + data) & ~16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -566,7 +877,7 @@ static int op_rb5ixd(int data)		/* RES 5,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~32;
+	memwrt(IX + data, memrdr(IX + data) & ~32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -584,7 +895,7 @@ static int op_rb6ixd(int data)		/* RES 6,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~64;
+	memwrt(IX + data, memrdr(IX + data) & ~64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -602,7 +913,7 @@ static int op_rb7ixd(int data)		/* RES 7,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) &= ~128;
+	memwrt(IX + data, memrdr(IX + data) & ~128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -620,7 +931,7 @@ static int op_sb0ixd(int data)		/* SET 0,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 1;
+	memwrt(IX + data, memrdr(IX + data) | 1);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -638,7 +949,7 @@ static int op_sb1ixd(int data)		/* SET 1,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 2;
+	memwrt(IX + data, memrdr(IX + data) | 2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -656,7 +967,7 @@ static int op_sb2ixd(int data)		/* SET 2,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 4;
+	memwrt(IX + data, memrdr(IX + data) | 4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -674,7 +985,7 @@ static int op_sb3ixd(int data)		/* SET 3,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 8;
+	memwrt(IX + data, memrdr(IX + data) | 8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -692,7 +1003,7 @@ static int op_sb4ixd(int data)		/* SET 4,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 16;
+	memwrt(IX + data, memrdr(IX + data) | 16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -710,7 +1021,7 @@ static int op_sb5ixd(int data)		/* SET 5,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 32;
+	memwrt(IX + data, memrdr(IX + data) | 32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -728,7 +1039,7 @@ static int op_sb6ixd(int data)		/* SET 6,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 64;
+	memwrt(IX + data, memrdr(IX + data) | 64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -746,7 +1057,7 @@ static int op_sb7ixd(int data)		/* SET 7,(IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IX + data) |= 128;
+	memwrt(IX + data, memrdr(IX + data) | 128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -759,7 +1070,8 @@ static int op_sb7ixd(int data)		/* SET 7,(IX+d) */
 static int op_rlcixd(int data)		/* RLC (IX+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -767,15 +1079,17 @@ static int op_rlcixd(int data)		/* RLC (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
-	i = *p & 128;
+	addr = IX + data;
+	val = memrdr(addr);
+	i = val & 128;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p <<= 1;
-	if (i) *p |= 1;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val <<= 1;
+	if (i) val |= 1;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -788,7 +1102,8 @@ static int op_rlcixd(int data)		/* RLC (IX+d) */
 static int op_rrcixd(int data)		/* RRC (IX+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -796,15 +1111,17 @@ static int op_rrcixd(int data)		/* RRC (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
-	i = *p & 1;
+	addr = IX + data;
+	val = memrdr(addr);
+	i = val & 1;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p >>= 1;
-	if (i) *p |= 128;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val >>= 1;
+	if (i) val |= 128;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -817,7 +1134,8 @@ static int op_rrcixd(int data)		/* RRC (IX+d) */
 static int op_rlixd(int data)		/* RL (IX+d) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -825,15 +1143,17 @@ static int op_rlixd(int data)		/* RL (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
+	addr = IX + data;
+	val = memrdr(addr);
 	old_c_flag = F & C_FLAG;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
-	if (old_c_flag)	*p |= 1;
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	if (old_c_flag)	val |= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -846,7 +1166,8 @@ static int op_rlixd(int data)		/* RL (IX+d) */
 static int op_rrixd(int data)		/* RR (IX+d) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -855,14 +1176,16 @@ static int op_rrixd(int data)		/* RR (IX+d) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	old_c_flag = F & C_FLAG;
-	p = ram	+ IX + data;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	if (old_c_flag)	*p |= 128;
+	addr = IX + data;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	if (old_c_flag)	val |= 128;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -874,7 +1197,8 @@ static int op_rrixd(int data)		/* RR (IX+d) */
 
 static int op_slaixd(int data)		/* SLA (IX+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -882,13 +1206,15 @@ static int op_slaixd(int data)		/* SLA (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
+	addr = IX + data;
+	val = memrdr(addr);
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -901,7 +1227,8 @@ static int op_slaixd(int data)		/* SLA (IX+d) */
 static int op_sraixd(int data)		/* SRA (IX+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -909,15 +1236,17 @@ static int op_sraixd(int data)		/* SRA (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
-	i = *p & 128;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	*p |= i;
+	addr = IX + data;
+	val = memrdr(addr);
+	i = val & 128;
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	val |= i;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -929,7 +1258,8 @@ static int op_sraixd(int data)		/* SRA (IX+d) */
 
 static int op_srlixd(int data)		/* SRL (IX+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -937,13 +1267,15 @@ static int op_srlixd(int data)		/* SRL (IX+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IX + data;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
+	addr = IX + data;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
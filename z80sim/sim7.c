@@ -32,12 +32,13 @@
 
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 #ifdef FRONTPANEL
 #include "../../frontpanel/frontpanel.h"
 #endif
 
-static int trap_fdcb(void);
+static int trap_fdcb(int);
 static int op_tb0iyd(int), op_tb1iyd(int), op_tb2iyd(int), op_tb3iyd(int);
 static int op_tb4iyd(int), op_tb5iyd(int), op_tb6iyd(int), op_tb7iyd(int);
 static int op_rb0iyd(int), op_rb1iyd(int), op_rb2iyd(int), op_rb3iyd(int);
@@ -47,266 +48,541 @@ static int op_sb4iyd(int), op_sb5iyd(int), op_sb6iyd(int), op_sb7iyd(int);
 static int op_rlciyd(int), op_rrciyd(int), op_rliyd(int), op_rriyd(int);
 static int op_slaiyd(int), op_sraiyd(int), op_srliyd(int);
 
+#ifndef WANT_THREADED
+/*
+ *	This array contains the function pointers for all
+ *	opcodes following 0xfd 0xcb.
+ */
+static int (*op_fdcb[256]) () = {
+	trap_fdcb,			/* 0x00	*/
+	trap_fdcb,			/* 0x01	*/
+	trap_fdcb,			/* 0x02	*/
+	trap_fdcb,			/* 0x03	*/
+	trap_fdcb,			/* 0x04	*/
+	trap_fdcb,			/* 0x05	*/
+	op_rlciyd,			/* 0x06	*/
+	trap_fdcb,			/* 0x07	*/
+	trap_fdcb,			/* 0x08	*/
+	trap_fdcb,			/* 0x09	*/
+	trap_fdcb,			/* 0x0a	*/
+	trap_fdcb,			/* 0x0b	*/
+	trap_fdcb,			/* 0x0c	*/
+	trap_fdcb,			/* 0x0d	*/
+	op_rrciyd,			/* 0x0e	*/
+	trap_fdcb,			/* 0x0f	*/
+	trap_fdcb,			/* 0x10	*/
+	trap_fdcb,			/* 0x11	*/
+	trap_fdcb,			/* 0x12	*/
+	trap_fdcb,			/* 0x13	*/
+	trap_fdcb,			/* 0x14	*/
+	trap_fdcb,			/* 0x15	*/
+	op_rliyd,			/* 0x16	*/
+	trap_fdcb,			/* 0x17	*/
+	trap_fdcb,			/* 0x18	*/
+	trap_fdcb,			/* 0x19	*/
+	trap_fdcb,			/* 0x1a	*/
+	trap_fdcb,			/* 0x1b	*/
+	trap_fdcb,			/* 0x1c	*/
+	trap_fdcb,			/* 0x1d	*/
+	op_rriyd,			/* 0x1e	*/
+	trap_fdcb,			/* 0x1f	*/
+	trap_fdcb,			/* 0x20	*/
+	trap_fdcb,			/* 0x21	*/
+	trap_fdcb,			/* 0x22	*/
+	trap_fdcb,			/* 0x23	*/
+	trap_fdcb,			/* 0x24	*/
+	trap_fdcb,			/* 0x25	*/
+	op_slaiyd,			/* 0x26	*/
+	trap_fdcb,			/* 0x27	*/
+	trap_fdcb,			/* 0x28	*/
+	trap_fdcb,			/* 0x29	*/
+	trap_fdcb,			/* 0x2a	*/
+	trap_fdcb,			/* 0x2b	*/
+	trap_fdcb,			/* 0x2c	*/
+	trap_fdcb,			/* 0x2d	*/
+	op_sraiyd,			/* 0x2e	*/
+	trap_fdcb,			/* 0x2f	*/
+	trap_fdcb,			/* 0x30	*/
+	trap_fdcb,			/* 0x31	*/
+	trap_fdcb,			/* 0x32	*/
+	trap_fdcb,			/* 0x33	*/
+	trap_fdcb,			/* 0x34	*/
+	trap_fdcb,			/* 0x35	*/
+	trap_fdcb,			/* 0x36	*/
+	trap_fdcb,			/* 0x37	*/
+	trap_fdcb,			/* 0x38	*/
+	trap_fdcb,			/* 0x39	*/
+	trap_fdcb,			/* 0x3a	*/
+	trap_fdcb,			/* 0x3b	*/
+	trap_fdcb,			/* 0x3c	*/
+	trap_fdcb,			/* 0x3d	*/
+	op_srliyd,			/* 0x3e	*/
+	trap_fdcb,			/* 0x3f	*/
+	trap_fdcb,			/* 0x40	*/
+	trap_fdcb,			/* 0x41	*/
+	trap_fdcb,			/* 0x42	*/
+	trap_fdcb,			/* 0x43	*/
+	trap_fdcb,			/* 0x44	*/
+	trap_fdcb,			/* 0x45	*/
+	op_tb0iyd,			/* 0x46	*/
+	trap_fdcb,			/* 0x47	*/
+	trap_fdcb,			/* 0x48	*/
+	trap_fdcb,			/* 0x49	*/
+	trap_fdcb,			/* 0x4a	*/
+	trap_fdcb,			/* 0x4b	*/
+	trap_fdcb,			/* 0x4c	*/
+	trap_fdcb,			/* 0x4d	*/
+	op_tb1iyd,			/* 0x4e	*/
+	trap_fdcb,			/* 0x4f	*/
+	trap_fdcb,			/* 0x50	*/
+	trap_fdcb,			/* 0x51	*/
+	trap_fdcb,			/* 0x52	*/
+	trap_fdcb,			/* 0x53	*/
+	trap_fdcb,			/* 0x54	*/
+	trap_fdcb,			/* 0x55	*/
+	op_tb2iyd,			/* 0x56	*/
+	trap_fdcb,			/* 0x57	*/
+	trap_fdcb,			/* 0x58	*/
+	trap_fdcb,			/* 0x59	*/
+	trap_fdcb,			/* 0x5a	*/
+	trap_fdcb,			/* 0x5b	*/
+	trap_fdcb,			/* 0x5c	*/
+	trap_fdcb,			/* 0x5d	*/
+	op_tb3iyd,			/* 0x5e	*/
+	trap_fdcb,			/* 0x5f	*/
+	trap_fdcb,			/* 0x60	*/
+	trap_fdcb,			/* 0x61	*/
+	trap_fdcb,			/* 0x62	*/
+	trap_fdcb,			/* 0x63	*/
+	trap_fdcb,			/* 0x64	*/
+	trap_fdcb,			/* 0x65	*/
+	op_tb4iyd,			/* 0x66	*/
+	trap_fdcb,			/* 0x67	*/
+	trap_fdcb,			/* 0x68	*/
+	trap_fdcb,			/* 0x69	*/
+	trap_fdcb,			/* 0x6a	*/
+	trap_fdcb,			/* 0x6b	*/
+	trap_fdcb,			/* 0x6c	*/
+	trap_fdcb,			/* 0x6d	*/
+	op_tb5iyd,			/* 0x6e	*/
+	trap_fdcb,			/* 0x6f	*/
+	trap_fdcb,			/* 0x70	*/
+	trap_fdcb,			/* 0x71	*/
+	trap_fdcb,			/* 0x72	*/
+	trap_fdcb,			/* 0x73	*/
+	trap_fdcb,			/* 0x74	*/
+	trap_fdcb,			/* 0x75	*/
+	op_tb6iyd,			/* 0x76	*/
+	trap_fdcb,			/* 0x77	*/
+	trap_fdcb,			/* 0x78	*/
+	trap_fdcb,			/* 0x79	*/
+	trap_fdcb,			/* 0x7a	*/
+	trap_fdcb,			/* 0x7b	*/
+	trap_fdcb,			/* 0x7c	*/
+	trap_fdcb,			/* 0x7d	*/
+	op_tb7iyd,			/* 0x7e	*/
+	trap_fdcb,			/* 0x7f	*/
+	trap_fdcb,			/* 0x80	*/
+	trap_fdcb,			/* 0x81	*/
+	trap_fdcb,			/* 0x82	*/
+	trap_fdcb,			/* 0x83	*/
+	trap_fdcb,			/* 0x84	*/
+	trap_fdcb,			/* 0x85	*/
+	op_rb0iyd,			/* 0x86	*/
+	trap_fdcb,			/* 0x87	*/
+	trap_fdcb,			/* 0x88	*/
+	trap_fdcb,			/* 0x89	*/
+	trap_fdcb,			/* 0x8a	*/
+	trap_fdcb,			/* 0x8b	*/
+	trap_fdcb,			/* 0x8c	*/
+	trap_fdcb,			/* 0x8d	*/
+	op_rb1iyd,			/* 0x8e	*/
+	trap_fdcb,			/* 0x8f	*/
+	trap_fdcb,			/* 0x90	*/
+	trap_fdcb,			/* 0x91	*/
+	trap_fdcb,			/* 0x92	*/
+	trap_fdcb,			/* 0x93	*/
+	trap_fdcb,			/* 0x94	*/
+	trap_fdcb,			/* 0x95	*/
+	op_rb2iyd,			/* 0x96	*/
+	trap_fdcb,			/* 0x97	*/
+	trap_fdcb,			/* 0x98	*/
+	trap_fdcb,			/* 0x99	*/
+	trap_fdcb,			/* 0x9a	*/
+	trap_fdcb,			/* 0x9b	*/
+	trap_fdcb,			/* 0x9c	*/
+	trap_fdcb,			/* 0x9d	*/
+	op_rb3iyd,			/* 0x9e	*/
+	trap_fdcb,			/* 0x9f	*/
+	trap_fdcb,			/* 0xa0	*/
+	trap_fdcb,			/* 0xa1	*/
+	trap_fdcb,			/* 0xa2	*/
+	trap_fdcb,			/* 0xa3	*/
+	trap_fdcb,			/* 0xa4	*/
+	trap_fdcb,			/* 0xa5	*/
+	op_rb4iyd,			/* 0xa6	*/
+	trap_fdcb,			/* 0xa7	*/
+	trap_fdcb,			/* 0xa8	*/
+	trap_fdcb,			/* 0xa9	*/
+	trap_fdcb,			/* 0xaa	*/
+	trap_fdcb,			/* 0xab	*/
+	trap_fdcb,			/* 0xac	*/
+	trap_fdcb,			/* 0xad	*/
+	op_rb5iyd,			/* 0xae	*/
+	trap_fdcb,			/* 0xaf	*/
+	trap_fdcb,			/* 0xb0	*/
+	trap_fdcb,			/* 0xb1	*/
+	trap_fdcb,			/* 0xb2	*/
+	trap_fdcb,			/* 0xb3	*/
+	trap_fdcb,			/* 0xb4	*/
+	trap_fdcb,			/* 0xb5	*/
+	op_rb6iyd,			/* 0xb6	*/
+	trap_fdcb,			/* 0xb7	*/
+	trap_fdcb,			/* 0xb8	*/
+	trap_fdcb,			/* 0xb9	*/
+	trap_fdcb,			/* 0xba	*/
+	trap_fdcb,			/* 0xbb	*/
+	trap_fdcb,			/* 0xbc	*/
+	trap_fdcb,			/* 0xbd	*/
+	op_rb7iyd,			/* 0xbe	*/
+	trap_fdcb,			/* 0xbf	*/
+	trap_fdcb,			/* 0xc0	*/
+	trap_fdcb,			/* 0xc1	*/
+	trap_fdcb,			/* 0xc2	*/
+	trap_fdcb,			/* 0xc3	*/
+	trap_fdcb,			/* 0xc4	*/
+	trap_fdcb,			/* 0xc5	*/
+	op_sb0iyd,			/* 0xc6	*/
+	trap_fdcb,			/* 0xc7	*/
+	trap_fdcb,			/* 0xc8	*/
+	trap_fdcb,			/* 0xc9	*/
+	trap_fdcb,			/* 0xca	*/
+	trap_fdcb,			/* 0xcb	*/
+	trap_fdcb,			/* 0xcc	*/
+	trap_fdcb,			/* 0xcd	*/
+	op_sb1iyd,			/* 0xce	*/
+	trap_fdcb,			/* 0xcf	*/
+	trap_fdcb,			/* 0xd0	*/
+	trap_fdcb,			/* 0xd1	*/
+	trap_fdcb,			/* 0xd2	*/
+	trap_fdcb,			/* 0xd3	*/
+	trap_fdcb,			/* 0xd4	*/
+	trap_fdcb,			/* 0xd5	*/
+	op_sb2iyd,			/* 0xd6	*/
+	trap_fdcb,			/* 0xd7	*/
+	trap_fdcb,			/* 0xd8	*/
+	trap_fdcb,			/* 0xd9	*/
+	trap_fdcb,			/* 0xda	*/
+	trap_fdcb,			/* 0xdb	*/
+	trap_fdcb,			/* 0xdc	*/
+	trap_fdcb,			/* 0xdd	*/
+	op_sb3iyd,			/* 0xde	*/
+	trap_fdcb,			/* 0xdf	*/
+	trap_fdcb,			/* 0xe0	*/
+	trap_fdcb,			/* 0xe1	*/
+	trap_fdcb,			/* 0xe2	*/
+	trap_fdcb,			/* 0xe3	*/
+	trap_fdcb,			/* 0xe4	*/
+	trap_fdcb,			/* 0xe5	*/
+	op_sb4iyd,			/* 0xe6	*/
+	trap_fdcb,			/* 0xe7	*/
+	trap_fdcb,			/* 0xe8	*/
+	trap_fdcb,			/* 0xe9	*/
+	trap_fdcb,			/* 0xea	*/
+	trap_fdcb,			/* 0xeb	*/
+	trap_fdcb,			/* 0xec	*/
+	trap_fdcb,			/* 0xed	*/
+	op_sb5iyd,			/* 0xee	*/
+	trap_fdcb,			/* 0xef	*/
+	trap_fdcb,			/* 0xf0	*/
+	trap_fdcb,			/* 0xf1	*/
+	trap_fdcb,			/* 0xf2	*/
+	trap_fdcb,			/* 0xf3	*/
+	trap_fdcb,			/* 0xf4	*/
+	trap_fdcb,			/* 0xf5	*/
+	op_sb6iyd,			/* 0xf6	*/
+	trap_fdcb,			/* 0xf7	*/
+	trap_fdcb,			/* 0xf8	*/
+	trap_fdcb,			/* 0xf9	*/
+	trap_fdcb,			/* 0xfa	*/
+	trap_fdcb,			/* 0xfb	*/
+	trap_fdcb,			/* 0xfc	*/
+	trap_fdcb,			/* 0xfd	*/
+	op_sb7iyd,			/* 0xfe	*/
+	trap_fdcb			/* 0xff	*/
+};
+#endif
+
+#ifdef WANT_THREADED
+/*
+ *	Opcode labels for the threaded code dispatch, the handlers
+ *	are called direct, so that the compiler can inline them
+ */
+#define OP_THR(f)	l_##f: t = f(d); goto done
+#endif
+
 int op_fdcb_handel(void)
 {
-	static int (*op_fdcb[256]) () = {
-		trap_fdcb,			/* 0x00	*/
-		trap_fdcb,			/* 0x01	*/
-		trap_fdcb,			/* 0x02	*/
-		trap_fdcb,			/* 0x03	*/
-		trap_fdcb,			/* 0x04	*/
-		trap_fdcb,			/* 0x05	*/
-		op_rlciyd,			/* 0x06	*/
-		trap_fdcb,			/* 0x07	*/
-		trap_fdcb,			/* 0x08	*/
-		trap_fdcb,			/* 0x09	*/
-		trap_fdcb,			/* 0x0a	*/
-		trap_fdcb,			/* 0x0b	*/
-		trap_fdcb,			/* 0x0c	*/
-		trap_fdcb,			/* 0x0d	*/
-		op_rrciyd,			/* 0x0e	*/
-		trap_fdcb,			/* 0x0f	*/
-		trap_fdcb,			/* 0x10	*/
-		trap_fdcb,			/* 0x11	*/
-		trap_fdcb,			/* 0x12	*/
-		trap_fdcb,			/* 0x13	*/
-		trap_fdcb,			/* 0x14	*/
-		trap_fdcb,			/* 0x15	*/
-		op_rliyd,			/* 0x16	*/
-		trap_fdcb,			/* 0x17	*/
-		trap_fdcb,			/* 0x18	*/
-		trap_fdcb,			/* 0x19	*/
-		trap_fdcb,			/* 0x1a	*/
-		trap_fdcb,			/* 0x1b	*/
-		trap_fdcb,			/* 0x1c	*/
-		trap_fdcb,			/* 0x1d	*/
-		op_rriyd,			/* 0x1e	*/
-		trap_fdcb,			/* 0x1f	*/
-		trap_fdcb,			/* 0x20	*/
-		trap_fdcb,			/* 0x21	*/
-		trap_fdcb,			/* 0x22	*/
-		trap_fdcb,			/* 0x23	*/
-		trap_fdcb,			/* 0x24	*/
-		trap_fdcb,			/* 0x25	*/
-		op_slaiyd,			/* 0x26	*/
-		trap_fdcb,			/* 0x27	*/
-		trap_fdcb,			/* 0x28	*/
-		trap_fdcb,			/* 0x29	*/
-		trap_fdcb,			/* 0x2a	*/
-		trap_fdcb,			/* 0x2b	*/
-		trap_fdcb,			/* 0x2c	*/
-		trap_fdcb,			/* 0x2d	*/
-		op_sraiyd,			/* 0x2e	*/
-		trap_fdcb,			/* 0x2f	*/
-		trap_fdcb,			/* 0x30	*/
-		trap_fdcb,			/* 0x31	*/
-		trap_fdcb,			/* 0x32	*/
-		trap_fdcb,			/* 0x33	*/
-		trap_fdcb,			/* 0x34	*/
-		trap_fdcb,			/* 0x35	*/
-		trap_fdcb,			/* 0x36	*/
-		trap_fdcb,			/* 0x37	*/
-		trap_fdcb,			/* 0x38	*/
-		trap_fdcb,			/* 0x39	*/
-		trap_fdcb,			/* 0x3a	*/
-		trap_fdcb,			/* 0x3b	*/
-		trap_fdcb,			/* 0x3c	*/
-		trap_fdcb,			/* 0x3d	*/
-		op_srliyd,			/* 0x3e	*/
-		trap_fdcb,			/* 0x3f	*/
-		trap_fdcb,			/* 0x40	*/
-		trap_fdcb,			/* 0x41	*/
-		trap_fdcb,			/* 0x42	*/
-		trap_fdcb,			/* 0x43	*/
-		trap_fdcb,			/* 0x44	*/
-		trap_fdcb,			/* 0x45	*/
-		op_tb0iyd,			/* 0x46	*/
-		trap_fdcb,			/* 0x47	*/
-		trap_fdcb,			/* 0x48	*/
-		trap_fdcb,			/* 0x49	*/
-		trap_fdcb,			/* 0x4a	*/
-		trap_fdcb,			/* 0x4b	*/
-		trap_fdcb,			/* 0x4c	*/
-		trap_fdcb,			/* 0x4d	*/
-		op_tb1iyd,			/* 0x4e	*/
-		trap_fdcb,			/* 0x4f	*/
-		trap_fdcb,			/* 0x50	*/
-		trap_fdcb,			/* 0x51	*/
-		trap_fdcb,			/* 0x52	*/
-		trap_fdcb,			/* 0x53	*/
-		trap_fdcb,			/* 0x54	*/
-		trap_fdcb,			/* 0x55	*/
-		op_tb2iyd,			/* 0x56	*/
-		trap_fdcb,			/* 0x57	*/
-		trap_fdcb,			/* 0x58	*/
-		trap_fdcb,			/* 0x59	*/
-		trap_fdcb,			/* 0x5a	*/
-		trap_fdcb,			/* 0x5b	*/
-		trap_fdcb,			/* 0x5c	*/
-		trap_fdcb,			/* 0x5d	*/
-		op_tb3iyd,			/* 0x5e	*/
-		trap_fdcb,			/* 0x5f	*/
-		trap_fdcb,			/* 0x60	*/
-		trap_fdcb,			/* 0x61	*/
-		trap_fdcb,			/* 0x62	*/
-		trap_fdcb,			/* 0x63	*/
-		trap_fdcb,			/* 0x64	*/
-		trap_fdcb,			/* 0x65	*/
-		op_tb4iyd,			/* 0x66	*/
-		trap_fdcb,			/* 0x67	*/
-		trap_fdcb,			/* 0x68	*/
-		trap_fdcb,			/* 0x69	*/
-		trap_fdcb,			/* 0x6a	*/
-		trap_fdcb,			/* 0x6b	*/
-		trap_fdcb,			/* 0x6c	*/
-		trap_fdcb,			/* 0x6d	*/
-		op_tb5iyd,			/* 0x6e	*/
-		trap_fdcb,			/* 0x6f	*/
-		trap_fdcb,			/* 0x70	*/
-		trap_fdcb,			/* 0x71	*/
-		trap_fdcb,			/* 0x72	*/
-		trap_fdcb,			/* 0x73	*/
-		trap_fdcb,			/* 0x74	*/
-		trap_fdcb,			/* 0x75	*/
-		op_tb6iyd,			/* 0x76	*/
-		trap_fdcb,			/* 0x77	*/
-		trap_fdcb,			/* 0x78	*/
-		trap_fdcb,			/* 0x79	*/
-		trap_fdcb,			/* 0x7a	*/
-		trap_fdcb,			/* 0x7b	*/
-		trap_fdcb,			/* 0x7c	*/
-		trap_fdcb,			/* 0x7d	*/
-		op_tb7iyd,			/* 0x7e	*/
-		trap_fdcb,			/* 0x7f	*/
-		trap_fdcb,			/* 0x80	*/
-		trap_fdcb,			/* 0x81	*/
-		trap_fdcb,			/* 0x82	*/
-		trap_fdcb,			/* 0x83	*/
-		trap_fdcb,			/* 0x84	*/
-		trap_fdcb,			/* 0x85	*/
-		op_rb0iyd,			/* 0x86	*/
-		trap_fdcb,			/* 0x87	*/
-		trap_fdcb,			/* 0x88	*/
-		trap_fdcb,			/* 0x89	*/
-		trap_fdcb,			/* 0x8a	*/
-		trap_fdcb,			/* 0x8b	*/
-		trap_fdcb,			/* 0x8c	*/
-		trap_fdcb,			/* 0x8d	*/
-		op_rb1iyd,			/* 0x8e	*/
-		trap_fdcb,			/* 0x8f	*/
-		trap_fdcb,			/* 0x90	*/
-		trap_fdcb,			/* 0x91	*/
-		trap_fdcb,			/* 0x92	*/
-		trap_fdcb,			/* 0x93	*/
-		trap_fdcb,			/* 0x94	*/
-		trap_fdcb,			/* 0x95	*/
-		op_rb2iyd,			/* 0x96	*/
-		trap_fdcb,			/* 0x97	*/
-		trap_fdcb,			/* 0x98	*/
-		trap_fdcb,			/* 0x99	*/
-		trap_fdcb,			/* 0x9a	*/
-		trap_fdcb,			/* 0x9b	*/
-		trap_fdcb,			/* 0x9c	*/
-		trap_fdcb,			/* 0x9d	*/
-		op_rb3iyd,			/* 0x9e	*/
-		trap_fdcb,			/* 0x9f	*/
-		trap_fdcb,			/* 0xa0	*/
-		trap_fdcb,			/* 0xa1	*/
-		trap_fdcb,			/* 0xa2	*/
-		trap_fdcb,			/* 0xa3	*/
-		trap_fdcb,			/* 0xa4	*/
-		trap_fdcb,			/* 0xa5	*/
-		op_rb4iyd,			/* 0xa6	*/
-		trap_fdcb,			/* 0xa7	*/
-		trap_fdcb,			/* 0xa8	*/
-		trap_fdcb,			/* 0xa9	*/
-		trap_fdcb,			/* 0xaa	*/
-		trap_fdcb,			/* 0xab	*/
-		trap_fdcb,			/* 0xac	*/
-		trap_fdcb,			/* 0xad	*/
-		op_rb5iyd,			/* 0xae	*/
-		trap_fdcb,			/* 0xaf	*/
-		trap_fdcb,			/* 0xb0	*/
-		trap_fdcb,			/* 0xb1	*/
-		trap_fdcb,			/* 0xb2	*/
-		trap_fdcb,			/* 0xb3	*/
-		trap_fdcb,			/* 0xb4	*/
-		trap_fdcb,			/* 0xb5	*/
-		op_rb6iyd,			/* 0xb6	*/
-		trap_fdcb,			/* 0xb7	*/
-		trap_fdcb,			/* 0xb8	*/
-		trap_fdcb,			/* 0xb9	*/
-		trap_fdcb,			/* 0xba	*/
-		trap_fdcb,			/* 0xbb	*/
-		trap_fdcb,			/* 0xbc	*/
-		trap_fdcb,			/* 0xbd	*/
-		op_rb7iyd,			/* 0xbe	*/
-		trap_fdcb,			/* 0xbf	*/
-		trap_fdcb,			/* 0xc0	*/
-		trap_fdcb,			/* 0xc1	*/
-		trap_fdcb,			/* 0xc2	*/
-		trap_fdcb,			/* 0xc3	*/
-		trap_fdcb,			/* 0xc4	*/
-		trap_fdcb,			/* 0xc5	*/
-		op_sb0iyd,			/* 0xc6	*/
-		trap_fdcb,			/* 0xc7	*/
-		trap_fdcb,			/* 0xc8	*/
-		trap_fdcb,			/* 0xc9	*/
-		trap_fdcb,			/* 0xca	*/
-		trap_fdcb,			/* 0xcb	*/
-		trap_fdcb,			/* 0xcc	*/
-		trap_fdcb,			/* 0xcd	*/
-		op_sb1iyd,			/* 0xce	*/
-		trap_fdcb,			/* 0xcf	*/
-		trap_fdcb,			/* 0xd0	*/
-		trap_fdcb,			/* 0xd1	*/
-		trap_fdcb,			/* 0xd2	*/
-		trap_fdcb,			/* 0xd3	*/
-		trap_fdcb,			/* 0xd4	*/
-		trap_fdcb,			/* 0xd5	*/
-		op_sb2iyd,			/* 0xd6	*/
-		trap_fdcb,			/* 0xd7	*/
-		trap_fdcb,			/* 0xd8	*/
-		trap_fdcb,			/* 0xd9	*/
-		trap_fdcb,			/* 0xda	*/
-		trap_fdcb,			/* 0xdb	*/
-		trap_fdcb,			/* 0xdc	*/
-		trap_fdcb,			/* 0xdd	*/
-		op_sb3iyd,			/* 0xde	*/
-		trap_fdcb,			/* 0xdf	*/
-		trap_fdcb,			/* 0xe0	*/
-		trap_fdcb,			/* 0xe1	*/
-		trap_fdcb,			/* 0xe2	*/
-		trap_fdcb,			/* 0xe3	*/
-		trap_fdcb,			/* 0xe4	*/
-		trap_fdcb,			/* 0xe5	*/
-		op_sb4iyd,			/* 0xe6	*/
-		trap_fdcb,			/* 0xe7	*/
-		trap_fdcb,			/* 0xe8	*/
-		trap_fdcb,			/* 0xe9	*/
-		trap_fdcb,			/* 0xea	*/
-		trap_fdcb,			/* 0xeb	*/
-		trap_fdcb,			/* 0xec	*/
-		trap_fdcb,			/* 0xed	*/
-		op_sb5iyd,			/* 0xee	*/
-		trap_fdcb,			/* 0xef	*/
-		trap_fdcb,			/* 0xf0	*/
-		trap_fdcb,			/* 0xf1	*/
-		trap_fdcb,			/* 0xf2	*/
-		trap_fdcb,			/* 0xf3	*/
-		trap_fdcb,			/* 0xf4	*/
-		trap_fdcb,			/* 0xf5	*/
-		op_sb6iyd,			/* 0xf6	*/
-		trap_fdcb,			/* 0xf7	*/
-		trap_fdcb,			/* 0xf8	*/
-		trap_fdcb,			/* 0xf9	*/
-		trap_fdcb,			/* 0xfa	*/
-		trap_fdcb,			/* 0xfb	*/
-		trap_fdcb,			/* 0xfc	*/
-		trap_fdcb,			/* 0xfd	*/
-		op_sb7iyd,			/* 0xfe	*/
-		trap_fdcb			/* 0xff	*/
+#ifdef WANT_THREADED
+	static void *op_fdcb_thr[256] = {
+		&&l_trap_fdcb,			/* 0x00	*/
+		&&l_trap_fdcb,			/* 0x01	*/
+		&&l_trap_fdcb,			/* 0x02	*/
+		&&l_trap_fdcb,			/* 0x03	*/
+		&&l_trap_fdcb,			/* 0x04	*/
+		&&l_trap_fdcb,			/* 0x05	*/
+		&&l_op_rlciyd,			/* 0x06	*/
+		&&l_trap_fdcb,			/* 0x07	*/
+		&&l_trap_fdcb,			/* 0x08	*/
+		&&l_trap_fdcb,			/* 0x09	*/
+		&&l_trap_fdcb,			/* 0x0a	*/
+		&&l_trap_fdcb,			/* 0x0b	*/
+		&&l_trap_fdcb,			/* 0x0c	*/
+		&&l_trap_fdcb,			/* 0x0d	*/
+		&&l_op_rrciyd,			/* 0x0e	*/
+		&&l_trap_fdcb,			/* 0x0f	*/
+		&&l_trap_fdcb,			/* 0x10	*/
+		&&l_trap_fdcb,			/* 0x11	*/
+		&&l_trap_fdcb,			/* 0x12	*/
+		&&l_trap_fdcb,			/* 0x13	*/
+		&&l_trap_fdcb,			/* 0x14	*/
+		&&l_trap_fdcb,			/* 0x15	*/
+		&&l_op_rliyd,			/* 0x16	*/
+		&&l_trap_fdcb,			/* 0x17	*/
+		&&l_trap_fdcb,			/* 0x18	*/
+		&&l_trap_fdcb,			/* 0x19	*/
+		&&l_trap_fdcb,			/* 0x1a	*/
+		&&l_trap_fdcb,			/* 0x1b	*/
+		&&l_trap_fdcb,			/* 0x1c	*/
+		&&l_trap_fdcb,			/* 0x1d	*/
+		&&l_op_rriyd,			/* 0x1e	*/
+		&&l_trap_fdcb,			/* 0x1f	*/
+		&&l_trap_fdcb,			/* 0x20	*/
+		&&l_trap_fdcb,			/* 0x21	*/
+		&&l_trap_fdcb,			/* 0x22	*/
+		&&l_trap_fdcb,			/* 0x23	*/
+		&&l_trap_fdcb,			/* 0x24	*/
+		&&l_trap_fdcb,			/* 0x25	*/
+		&&l_op_slaiyd,			/* 0x26	*/
+		&&l_trap_fdcb,			/* 0x27	*/
+		&&l_trap_fdcb,			/* 0x28	*/
+		&&l_trap_fdcb,			/* 0x29	*/
+		&&l_trap_fdcb,			/* 0x2a	*/
+		&&l_trap_fdcb,			/* 0x2b	*/
+		&&l_trap_fdcb,			/* 0x2c	*/
+		&&l_trap_fdcb,			/* 0x2d	*/
+		&&l_op_sraiyd,			/* 0x2e	*/
+		&&l_trap_fdcb,			/* 0x2f	*/
+		&&l_trap_fdcb,			/* 0x30	*/
+		&&l_trap_fdcb,			/* 0x31	*/
+		&&l_trap_fdcb,			/* 0x32	*/
+		&&l_trap_fdcb,			/* 0x33	*/
+		&&l_trap_fdcb,			/* 0x34	*/
+		&&l_trap_fdcb,			/* 0x35	*/
+		&&l_trap_fdcb,			/* 0x36	*/
+		&&l_trap_fdcb,			/* 0x37	*/
+		&&l_trap_fdcb,			/* 0x38	*/
+		&&l_trap_fdcb,			/* 0x39	*/
+		&&l_trap_fdcb,			/* 0x3a	*/
+		&&l_trap_fdcb,			/* 0x3b	*/
+		&&l_trap_fdcb,			/* 0x3c	*/
+		&&l_trap_fdcb,			/* 0x3d	*/
+		&&l_op_srliyd,			/* 0x3e	*/
+		&&l_trap_fdcb,			/* 0x3f	*/
+		&&l_trap_fdcb,			/* 0x40	*/
+		&&l_trap_fdcb,			/* 0x41	*/
+		&&l_trap_fdcb,			/* 0x42	*/
+		&&l_trap_fdcb,			/* 0x43	*/
+		&&l_trap_fdcb,			/* 0x44	*/
+		&&l_trap_fdcb,			/* 0x45	*/
+		&&l_op_tb0iyd,			/* 0x46	*/
+		&&l_trap_fdcb,			/* 0x47	*/
+		&&l_trap_fdcb,			/* 0x48	*/
+		&&l_trap_fdcb,			/* 0x49	*/
+		&&l_trap_fdcb,			/* 0x4a	*/
+		&&l_trap_fdcb,			/* 0x4b	*/
+		&&l_trap_fdcb,			/* 0x4c	*/
+		&&l_trap_fdcb,			/* 0x4d	*/
+		&&l_op_tb1iyd,			/* 0x4e	*/
+		&&l_trap_fdcb,			/* 0x4f	*/
+		&&l_trap_fdcb,			/* 0x50	*/
+		&&l_trap_fdcb,			/* 0x51	*/
+		&&l_trap_fdcb,			/* 0x52	*/
+		&&l_trap_fdcb,			/* 0x53	*/
+		&&l_trap_fdcb,			/* 0x54	*/
+		&&l_trap_fdcb,			/* 0x55	*/
+		&&l_op_tb2iyd,			/* 0x56	*/
+		&&l_trap_fdcb,			/* 0x57	*/
+		&&l_trap_fdcb,			/* 0x58	*/
+		&&l_trap_fdcb,			/* 0x59	*/
+		&&l_trap_fdcb,			/* 0x5a	*/
+		&&l_trap_fdcb,			/* 0x5b	*/
+		&&l_trap_fdcb,			/* 0x5c	*/
+		&&l_trap_fdcb,			/* 0x5d	*/
+		&&l_op_tb3iyd,			/* 0x5e	*/
+		&&l_trap_fdcb,			/* 0x5f	*/
+		&&l_trap_fdcb,			/* 0x60	*/
+		&&l_trap_fdcb,			/* 0x61	*/
+		&&l_trap_fdcb,			/* 0x62	*/
+		&&l_trap_fdcb,			/* 0x63	*/
+		&&l_trap_fdcb,			/* 0x64	*/
+		&&l_trap_fdcb,			/* 0x65	*/
+		&&l_op_tb4iyd,			/* 0x66	*/
+		&&l_trap_fdcb,			/* 0x67	*/
+		&&l_trap_fdcb,			/* 0x68	*/
+		&&l_trap_fdcb,			/* 0x69	*/
+		&&l_trap_fdcb,			/* 0x6a	*/
+		&&l_trap_fdcb,			/* 0x6b	*/
+		&&l_trap_fdcb,			/* 0x6c	*/
+		&&l_trap_fdcb,			/* 0x6d	*/
+		&&l_op_tb5iyd,			/* 0x6e	*/
+		&&l_trap_fdcb,			/* 0x6f	*/
+		&&l_trap_fdcb,			/* 0x70	*/
+		&&l_trap_fdcb,			/* 0x71	*/
+		&&l_trap_fdcb,			/* 0x72	*/
+		&&l_trap_fdcb,			/* 0x73	*/
+		&&l_trap_fdcb,			/* 0x74	*/
+		&&l_trap_fdcb,			/* 0x75	*/
+		&&l_op_tb6iyd,			/* 0x76	*/
+		&&l_trap_fdcb,			/* 0x77	*/
+		&&l_trap_fdcb,			/* 0x78	*/
+		&&l_trap_fdcb,			/* 0x79	*/
+		&&l_trap_fdcb,			/* 0x7a	*/
+		&&l_trap_fdcb,			/* 0x7b	*/
+		&&l_trap_fdcb,			/* 0x7c	*/
+		&&l_trap_fdcb,			/* 0x7d	*/
+		&&l_op_tb7iyd,			/* 0x7e	*/
+		&&l_trap_fdcb,			/* 0x7f	*/
+		&&l_trap_fdcb,			/* 0x80	*/
+		&&l_trap_fdcb,			/* 0x81	*/
+		&&l_trap_fdcb,			/* 0x82	*/
+		&&l_trap_fdcb,			/* 0x83	*/
+		&&l_trap_fdcb,			/* 0x84	*/
+		&&l_trap_fdcb,			/* 0x85	*/
+		&&l_op_rb0iyd,			/* 0x86	*/
+		&&l_trap_fdcb,			/* 0x87	*/
+		&&l_trap_fdcb,			/* 0x88	*/
+		&&l_trap_fdcb,			/* 0x89	*/
+		&&l_trap_fdcb,			/* 0x8a	*/
+		&&l_trap_fdcb,			/* 0x8b	*/
+		&&l_trap_fdcb,			/* 0x8c	*/
+		&&l_trap_fdcb,			/* 0x8d	*/
+		&&l_op_rb1iyd,			/* 0x8e	*/
+		&&l_trap_fdcb,			/* 0x8f	*/
+		&&l_trap_fdcb,			/* 0x90	*/
+		&&l_trap_fdcb,			/* 0x91	*/
+		&&l_trap_fdcb,			/* 0x92	*/
+		&&l_trap_fdcb,			/* 0x93	*/
+		&&l_trap_fdcb,			/* 0x94	*/
+		&&l_trap_fdcb,			/* 0x95	*/
+		&&l_op_rb2iyd,			/* 0x96	*/
+		&&l_trap_fdcb,			/* 0x97	*/
+		&&l_trap_fdcb,			/* 0x98	*/
+		&&l_trap_fdcb,			/* 0x99	*/
+		&&l_trap_fdcb,			/* 0x9a	*/
+		&&l_trap_fdcb,			/* 0x9b	*/
+		&&l_trap_fdcb,			/* 0x9c	*/
+		&&l_trap_fdcb,			/* 0x9d	*/
+		&&l_op_rb3iyd,			/* 0x9e	*/
+		&&l_trap_fdcb,			/* 0x9f	*/
+		&&l_trap_fdcb,			/* 0xa0	*/
+		&&l_trap_fdcb,			/* 0xa1	*/
+		&&l_trap_fdcb,			/* 0xa2	*/
+		&&l_trap_fdcb,			/* 0xa3	*/
+		&&l_trap_fdcb,			/* 0xa4	*/
+		&&l_trap_fdcb,			/* 0xa5	*/
+		&&l_op_rb4iyd,			/* 0xa6	*/
+		&&l_trap_fdcb,			/* 0xa7	*/
+		&&l_trap_fdcb,			/* 0xa8	*/
+		&&l_trap_fdcb,			/* 0xa9	*/
+		&&l_trap_fdcb,			/* 0xaa	*/
+		&&l_trap_fdcb,			/* 0xab	*/
+		&&l_trap_fdcb,			/* 0xac	*/
+		&&l_trap_fdcb,			/* 0xad	*/
+		&&l_op_rb5iyd,			/* 0xae	*/
+		&&l_trap_fdcb,			/* 0xaf	*/
+		&&l_trap_fdcb,			/* 0xb0	*/
+		&&l_trap_fdcb,			/* 0xb1	*/
+		&&l_trap_fdcb,			/* 0xb2	*/
+		&&l_trap_fdcb,			/* 0xb3	*/
+		&&l_trap_fdcb,			/* 0xb4	*/
+		&&l_trap_fdcb,			/* 0xb5	*/
+		&&l_op_rb6iyd,			/* 0xb6	*/
+		&&l_trap_fdcb,			/* 0xb7	*/
+		&&l_trap_fdcb,			/* 0xb8	*/
+		&&l_trap_fdcb,			/* 0xb9	*/
+		&&l_trap_fdcb,			/* 0xba	*/
+		&&l_trap_fdcb,			/* 0xbb	*/
+		&&l_trap_fdcb,			/* 0xbc	*/
+		&&l_trap_fdcb,			/* 0xbd	*/
+		&&l_op_rb7iyd,			/* 0xbe	*/
+		&&l_trap_fdcb,			/* 0xbf	*/
+		&&l_trap_fdcb,			/* 0xc0	*/
+		&&l_trap_fdcb,			/* 0xc1	*/
+		&&l_trap_fdcb,			/* 0xc2	*/
+		&&l_trap_fdcb,			/* 0xc3	*/
+		&&l_trap_fdcb,			/* 0xc4	*/
+		&&l_trap_fdcb,			/* 0xc5	*/
+		&&l_op_sb0iyd,			/* 0xc6	*/
+		&&l_trap_fdcb,			/* 0xc7	*/
+		&&l_trap_fdcb,			/* 0xc8	*/
+		&&l_trap_fdcb,			/* 0xc9	*/
+		&&l_trap_fdcb,			/* 0xca	*/
+		&&l_trap_fdcb,			/* 0xcb	*/
+		&&l_trap_fdcb,			/* 0xcc	*/
+		&&l_trap_fdcb,			/* 0xcd	*/
+		&&l_op_sb1iyd,			/* 0xce	*/
+		&&l_trap_fdcb,			/* 0xcf	*/
+		&&l_trap_fdcb,			/* 0xd0	*/
+		&&l_trap_fdcb,			/* 0xd1	*/
+		&&l_trap_fdcb,			/* 0xd2	*/
+		&&l_trap_fdcb,			/* 0xd3	*/
+		&&l_trap_fdcb,			/* 0xd4	*/
+		&&l_trap_fdcb,			/* 0xd5	*/
+		&&l_op_sb2iyd,			/* 0xd6	*/
+		&&l_trap_fdcb,			/* 0xd7	*/
+		&&l_trap_fdcb,			/* 0xd8	*/
+		&&l_trap_fdcb,			/* 0xd9	*/
+		&&l_trap_fdcb,			/* 0xda	*/
+		&&l_trap_fdcb,			/* 0xdb	*/
+		&&l_trap_fdcb,			/* 0xdc	*/
+		&&l_trap_fdcb,			/* 0xdd	*/
+		&&l_op_sb3iyd,			/* 0xde	*/
+		&&l_trap_fdcb,			/* 0xdf	*/
+		&&l_trap_fdcb,			/* 0xe0	*/
+		&&l_trap_fdcb,			/* 0xe1	*/
+		&&l_trap_fdcb,			/* 0xe2	*/
+		&&l_trap_fdcb,			/* 0xe3	*/
+		&&l_trap_fdcb,			/* 0xe4	*/
+		&&l_trap_fdcb,			/* 0xe5	*/
+		&&l_op_sb4iyd,			/* 0xe6	*/
+		&&l_trap_fdcb,			/* 0xe7	*/
+		&&l_trap_fdcb,			/* 0xe8	*/
+		&&l_trap_fdcb,			/* 0xe9	*/
+		&&l_trap_fdcb,			/* 0xea	*/
+		&&l_trap_fdcb,			/* 0xeb	*/
+		&&l_trap_fdcb,			/* 0xec	*/
+		&&l_trap_fdcb,			/* 0xed	*/
+		&&l_op_sb5iyd,			/* 0xee	*/
+		&&l_trap_fdcb,			/* 0xef	*/
+		&&l_trap_fdcb,			/* 0xf0	*/
+		&&l_trap_fdcb,			/* 0xf1	*/
+		&&l_trap_fdcb,			/* 0xf2	*/
+		&&l_trap_fdcb,			/* 0xf3	*/
+		&&l_trap_fdcb,			/* 0xf4	*/
+		&&l_trap_fdcb,			/* 0xf5	*/
+		&&l_op_sb6iyd,			/* 0xf6	*/
+		&&l_trap_fdcb,			/* 0xf7	*/
+		&&l_trap_fdcb,			/* 0xf8	*/
+		&&l_trap_fdcb,			/* 0xf9	*/
+		&&l_trap_fdcb,			/* 0xfa	*/
+		&&l_trap_fdcb,			/* 0xfb	*/
+		&&l_trap_fdcb,			/* 0xfc	*/
+		&&l_trap_fdcb,			/* 0xfd	*/
+		&&l_op_sb7iyd,			/* 0xfe	*/
+		&&l_trap_fdcb			/* 0xff	*/
 	};
+#endif
 
 	register int d;
 	register int t;
@@ -318,10 +594,45 @@ int op_fdcb_handel(void)
 			PC = ram;
 #endif
 
-#ifdef WANT_TIM
-	t = (*op_fdcb[*PC++]) (d);	/* execute next opcode */
+#ifdef WANT_THREADED
+	goto *op_fdcb_thr[*PC++];		/* execute next opcode */
+
+	OP_THR(trap_fdcb);
+	OP_THR(op_rlciyd);
+	OP_THR(op_rrciyd);
+	OP_THR(op_rliyd);
+	OP_THR(op_rriyd);
+	OP_THR(op_slaiyd);
+	OP_THR(op_sraiyd);
+	OP_THR(op_srliyd);
+	OP_THR(op_tb0iyd);
+	OP_THR(op_tb1iyd);
+	OP_THR(op_tb2iyd);
+	OP_THR(op_tb3iyd);
+	OP_THR(op_tb4iyd);
+	OP_THR(op_tb5iyd);
+	OP_THR(op_tb6iyd);
+	OP_THR(op_tb7iyd);
+	OP_THR(op_rb0iyd);
+	OP_THR(op_rb1iyd);
+	OP_THR(op_rb2iyd);
+	OP_THR(op_rb3iyd);
+	OP_THR(op_rb4iyd);
+	OP_THR(op_rb5iyd);
+	OP_THR(op_rb6iyd);
+	OP_THR(op_rb7iyd);
+	OP_THR(op_sb0iyd);
+	OP_THR(op_sb1iyd);
+	OP_THR(op_sb2iyd);
+	OP_THR(op_sb3iyd);
+	OP_THR(op_sb4iyd);
+	OP_THR(op_sb5iyd);
+	OP_THR(op_sb6iyd);
+	OP_THR(op_sb7iyd);
+
+done:
 #else
-	(*op_fdcb[*PC++]) (d);
+	t = (*op_fdcb[*PC++]) (d);	/* execute next opcode */
 #endif
 
 #ifdef WANT_PCC
@@ -336,7 +647,7 @@ int op_fdcb_handel(void)
  *	This function traps all illegal opcodes following the
  *	initial 0xfd 0xcb of a 4 byte opcode.
  */
-static int trap_fdcb(void)
+static int trap_fdcb(int data)
 {
 	cpu_error = OPTRAP4;
 	cpu_state = STOPPED;
@@ -353,7 +664,7 @@ static int op_tb0iyd(int data)		/* BIT 0,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 1) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -368,7 +679,7 @@ static int op_tb1iyd(int data)		/* BIT 1,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 2) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -383,7 +694,7 @@ static int op_tb2iyd(int data)		/* BIT 2,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 4) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -398,7 +709,7 @@ static int op_tb3iyd(int data)		/* BIT 3,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 8) ? (F &= ~(Z_FLAG | P_FLAG))
 				 : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -413,7 +724,7 @@ static int op_tb4iyd(int data)		/* BIT 4,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 16) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -428,7 +739,7 @@ static int op_tb5iyd(int data)		/* BIT 5,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 32) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -443,7 +754,7 @@ static int op_tb6iyd(int data)		/* BIT 6,(IY+d) */
 #endif
 	F &= ~(N_FLAG | S_FLAG);
 	F |= H_FLAG;
-	(*(ram + IY + data) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
+	(memrdr(IY + data) & 64) ? (F &= ~(Z_FLAG | P_FLAG))
 				  : (F |= (Z_FLAG | P_FLAG));
 	return(20);
 }
@@ -458,7 +769,7 @@ static int op_tb7iyd(int data)		/* BIT 7,(IY+d) */
 #endif
 	F &= ~N_FLAG;
 	F |= H_FLAG;
-	if (*(ram + IY + data) & 128) {
+	if (memrdr(IY + data) & 128) {
 		F &= ~(Z_FLAG | P_FLAG);
 		F |= S_FLAG;
 	} else {
@@ -470,7 +781,7 @@ static int op_tb7iyd(int data)		/* BIT 7,(IY+d) */
 
 static int op_rb0iyd(int data)		/* RES 0,(IY+d) */
 {
-	*(ram +	IY + data) &= ~1;
+	memwrt(IY + data, memrdr(IY + data) & ~1);
 	return(23);
 }
 
@@ -482,7 +793,7 @@ static int op_rb1iyd(int data)		/* RES 1,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~2;
+	memwrt(IY + data, memrdr(IY + data) & ~2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -500,7 +811,7 @@ static int op_rb2iyd(int data)		/* RES 2,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~4;
+	memwrt(IY + data, memrdr(IY + data) & ~4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -518,7 +829,7 @@ static int op_rb3iyd(int data)		/* RES 3,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~8;
+	memwrt(IY + data, memrdr(IY + data) & ~8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -536,7 +847,7 @@ static int op_rb4iyd(int data)		/* RES 4,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~16;
+	memwrt(IY + data, memrdr(IY + data) & ~16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -554,7 +865,7 @@ static int op_rb5iyd(int data)		/* RES 5,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~32;
+	memwrt(IY + data, memrdr(IY + data) & ~32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -572,7 +883,7 @@ static int op_rb6iyd(int data)		/* RES 6,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~64;
+	memwrt(IY + data, memrdr(IY + data) & ~64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -590,7 +901,7 @@ static int op_rb7iyd(int data)		/* RES 7,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) &= ~128;
+	memwrt(IY + data, memrdr(IY + data) & ~128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -608,7 +919,7 @@ static int op_sb0iyd(int data)		/* SET 0,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 1;
+	memwrt(IY + data, memrdr(IY + data) | 1);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -626,7 +937,7 @@ static int op_sb1iyd(int data)		/* SET 1,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 2;
+	memwrt(IY + data, memrdr(IY + data) | 2);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -644,7 +955,7 @@ static int op_sb2iyd(int data)		/* SET 2,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 4;
+	memwrt(IY + data, memrdr(IY + data) | 4);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -662,7 +973,7 @@ static int op_sb3iyd(int data)		/* SET 3,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 8;
+	memwrt(IY + data, memrdr(IY + data) | 8);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -680,7 +991,7 @@ static int op_sb4iyd(int data)		/* SET 4,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 16;
+	memwrt(IY + data, memrdr(IY + data) | 16);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -698,7 +1009,7 @@ static int op_sb5iyd(int data)		/* SET 5,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 32;
+	memwrt(IY + data, memrdr(IY + data) | 32);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -716,7 +1027,7 @@ static int op_sb6iyd(int data)		/* SET 6,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 64;
+	memwrt(IY + data, memrdr(IY + data) | 64);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -734,7 +1045,7 @@ static int op_sb7iyd(int data)		/* SET 7,(IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	*(ram +	IY + data) |= 128;
+	memwrt(IY + data, memrdr(IY + data) | 128);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -747,7 +1058,8 @@ static int op_sb7iyd(int data)		/* SET 7,(IY+d) */
 static int op_rlciyd(int data)		/* RLC (IY+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -755,15 +1067,17 @@ static int op_rlciyd(int data)		/* RLC (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
-	i = *p & 128;
+	addr = IY + data;
+	val = memrdr(addr);
+	i = val & 128;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p <<= 1;
-	if (i) *p |= 1;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val <<= 1;
+	if (i) val |= 1;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -776,7 +1090,8 @@ static int op_rlciyd(int data)		/* RLC (IY+d) */
 static int op_rrciyd(int data)		/* RRC (IY+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -784,15 +1099,17 @@ static int op_rrciyd(int data)		/* RRC (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
-	i = *p & 1;
+	addr = IY + data;
+	val = memrdr(addr);
+	i = val & 1;
 	(i) ? (F |= C_FLAG) : (F &= ~C_FLAG);
 	F &= ~(H_FLAG |	N_FLAG);
-	*p >>= 1;
-	if (i) *p |= 128;
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	val >>= 1;
+	if (i) val |= 128;
+	memwrt(addr, val);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -805,7 +1122,8 @@ static int op_rrciyd(int data)		/* RRC (IY+d) */
 static int op_rliyd(int data)		/* RL (IY+d) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -813,15 +1131,17 @@ static int op_rliyd(int data)		/* RL (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
+	addr = IY + data;
+	val = memrdr(addr);
 	old_c_flag = F & C_FLAG;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
-	if (old_c_flag)	*p |= 1;
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	if (old_c_flag)	val |= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -834,7 +1154,8 @@ static int op_rliyd(int data)		/* RL (IY+d) */
 static int op_rriyd(int data)		/* RR (IY+d) */
 {
 	register int old_c_flag;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -843,14 +1164,16 @@ static int op_rriyd(int data)		/* RR (IY+d) */
 	fp_sampleLightGroup(0, 0);
 #endif
 	old_c_flag = F & C_FLAG;
-	p = ram	+ IY + data;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	if (old_c_flag)	*p |= 128;
+	addr = IY + data;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	if (old_c_flag)	val |= 128;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -862,7 +1185,8 @@ static int op_rriyd(int data)		/* RR (IY+d) */
 
 static int op_slaiyd(int data)		/* SLA (IY+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -870,13 +1194,15 @@ static int op_slaiyd(int data)		/* SLA (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
-	(*p & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
-	*p <<= 1;
+	addr = IY + data;
+	val = memrdr(addr);
+	(val & 128) ? (F	|= C_FLAG) : (F	&= ~C_FLAG);
+	val <<= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -889,7 +1215,8 @@ static int op_slaiyd(int data)		/* SLA (IY+d) */
 static int op_sraiyd(int data)		/* SRA (IY+d) */
 {
 	register int i;
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -897,15 +1224,17 @@ static int op_sraiyd(int data)		/* SRA (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
-	i = *p & 128;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
-	*p |= i;
+	addr = IY + data;
+	val = memrdr(addr);
+	i = val & 128;
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	val |= i;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -917,7 +1246,8 @@ static int op_sraiyd(int data)		/* SRA (IY+d) */
 
 static int op_srliyd(int data)		/* SRL (IY+d) */
 {
-	register BYTE *p;
+	register WORD addr;
+	register BYTE val;
 
 #ifdef BUS_8080
 	cpu_bus = CPU_WO | CPU_MEMR;
@@ -925,13 +1255,15 @@ static int op_srliyd(int data)		/* SRL (IY+d) */
 #ifdef FRONTPANEL
 	fp_sampleLightGroup(0, 0);
 #endif
-	p = ram	+ IY + data;
-	(*p & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
-	*p >>= 1;
+	addr = IY + data;
+	val = memrdr(addr);
+	(val & 1) ? (F |= C_FLAG) : (F &= ~C_FLAG);
+	val >>= 1;
+	memwrt(addr, val);
 	F &= ~(H_FLAG |	N_FLAG);
-	(*p) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
-	(*p & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
-	(parrity[*p]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
+	(val) ? (F &= ~Z_FLAG) :	(F |= Z_FLAG);
+	(val & 128) ? (F	|= S_FLAG) : (F	&= ~S_FLAG);
+	(parrity[val]) ?	(F &= ~P_FLAG) : (F |= P_FLAG);
 #ifdef BUS_8080
 	cpu_bus = 0;
 #endif
@@ -44,6 +44,7 @@
 #include <signal.h>
 #include "sim.h"
 #include "simglb.h"
+#include "simmem.h"
 
 extern void cpu(void);
 extern void disass(unsigned char **, int);
@@ -55,7 +56,6 @@ extern int load_file(char *);
 static void do_step(void);
 static void do_trace(char *);
 static void do_go(char *);
-static int handel_break(void);
 static void do_dump(char *);
 static void do_list(char *);
 static void do_modify(char *);
@@ -66,14 +66,17 @@ static void do_reg(char *);
 static void print_head(void);
 static void print_reg(void);
 static void do_break(char *);
+static void do_watch(char *);
 static void do_hist(char *);
 static void do_count(char *);
-static void do_clock(void);
+static void do_prof(char *);
+static void do_clock(char *);
+static void do_speed(char *);
 static void timeout(int);
 static void do_show(void);
 static void do_unix(char *);
 static void do_help(void);
-static void cpu_err_msg(void);
+void cpu_err_msg(void);
 
 struct termios old_term;
 
@@ -134,14 +137,20 @@ void mon(void)
 		case 'b':
 			do_break(cmd + 1);
 			break;
+		case 'w':
+			do_watch(cmd + 1);
+			break;
 		case 'h':
 			do_hist(cmd + 1);
 			break;
 		case 'z':
 			do_count(cmd + 1);
 			break;
+		case 'u':
+			do_prof(cmd + 1);
+			break;
 		case 'c':
-			do_clock();
+			do_clock(cmd + 1);
 			break;
 		case 's':
 			do_show();
@@ -175,8 +184,6 @@ static void do_step(void)
 	cpu_state = SINGLE_STEP;
 	cpu_error = NONE;
 	cpu();
-	if (cpu_error == OPHALT)
-		handel_break();
 	cpu_err_msg();
 	print_head();
 	print_reg();
@@ -193,6 +200,24 @@ static void do_trace(char *s)
 
 	while (isspace((int)*s))
 		s++;
+#ifdef WANT_TRACE
+	if (*s == 'f') {	/* execution trace into a file */
+		s++;
+		while (isspace((int)*s))
+			s++;
+		if (*s == '\0') {
+			if (tr_on)
+				tr_close();
+			else
+				puts("no trace file open");
+		} else {
+			s[strcspn(s, " \t\n")] = '\0';
+			if (!tr_open(s))
+				printf("can't create trace file %s\n", s);
+		}
+		return;
+	}
+#endif
 	if (*s == '\0')
 		count =	20;
 	else
@@ -204,14 +229,8 @@ static void do_trace(char *s)
 	for (i = 0; i <	count; i++) {
 		cpu();
 		print_reg();
-		if (cpu_error) {
-			if (cpu_error == OPHALT) {
-				if (!handel_break()) {
-					break;
-				}
-			} else
-				break;
-		}
+		if (cpu_error)
+			break;
 	}
 	cpu_err_msg();
 }
@@ -225,59 +244,14 @@ static void do_go(char *s)
 		s++;
 	if (isxdigit((int)*s))
 		PC = ram + exatoi(s);
-	cont:
 	cpu_state = CONTIN_RUN;
 	cpu_error = NONE;
 	cpu();
-	if (cpu_error == OPHALT)
-		if (handel_break())
-			if (!cpu_error)
-				goto cont;
 	cpu_err_msg();
 	print_head();
 	print_reg();
 }
 
-/*
- *	Handling of software breakpoints (HALT opcode):
- *
- *	Output:	0 breakpoint or other HALT opcode reached (stop)
- *		1 breakpoint reached, passcounter not reached (continue)
- */
-static int handel_break(void)
-{
-#ifdef SBSIZE
-	register int i;
-	int break_address;
-
-	for (i = 0; i <	SBSIZE;	i++)	/* search for breakpoint */
-		if (soft[i].sb_adr == PC - ram - 1)
-			goto was_softbreak;
-	return(0);
-	was_softbreak:
-#ifdef HISIZE
-	h_next--;			/* correct history */
-	if (h_next < 0)
-		h_next = 0;
-#endif
-	break_address =	PC - ram - 1;	/* store adr of breakpoint */
-	cpu_error = NONE;		/* HALT	was a breakpoint */
-	PC--;				/* substitute HALT opcode by */
-	*PC = soft[i].sb_oldopc;	/* original opcode */
-	cpu_state = SINGLE_STEP;	/* and execute it */
-	cpu();
-	*(ram +	soft[i].sb_adr)	= 0x76;	/* restore HALT	opcode again */
-	soft[i].sb_passcount++;		/* increment passcounter */
-	if (soft[i].sb_passcount != soft[i].sb_pass)
-		return(1);		/* pass	not reached, continue */
-	printf("Software breakpoint %d reached at %04x\n", i, break_address);
-	soft[i].sb_passcount = 0;	/* reset passcounter */
-	return(0);			/* pass	reached, stop */
-#else
-	return(0);
-#endif
-}
-
 /*
  *	Memory dump
  */
@@ -352,7 +326,7 @@ static void do_modify(char *s)
 		}
 		if (!isxdigit((int)nv[0]))
 			break;
-		*wrk_ram++ = exatoi(nv);
+		memwrt(wrk_ram++ - ram, exatoi(nv));
 		if (wrk_ram > ram + 65535)
 			wrk_ram	= ram;
 	}
@@ -387,7 +361,7 @@ static void do_fill(char *s)
 		return;
 	}
 	while (i--) {
-		*p++ = val;
+		memwrt(p++ - ram, val);
 		if (p >	ram + 65535)
 			p = ram;
 	}
@@ -422,7 +396,7 @@ static void do_move(char *s)
 		return;
 	}
 	while (count--)	{
-		*p2++ =	*p1++;
+		memwrt(p2++ - ram, *p1++);
 		if (p1 > ram + 65535)
 			p1 = ram;
 		if (p2 > ram + 65535)
@@ -634,8 +608,122 @@ static void print_reg(void)
 		 (unsigned int)(STACK - ram));
 }
 
+#if defined(HISIZE) || defined(SBSIZE)
+static char *reg_names[] = { "af", "bc", "de", "hl", "ix", "iy", "sp" };
+
+/*
+ *	Check for a register test reg{=<>}value in a history search
+ *	or the condition of a breakpoint
+ *
+ *	Output:	number of the register, like in a history entry
+ *		-1 no register test
+ */
+static int reg_test(char *s)
+{
+	register int i;
+
+	if (!*s || !*(s + 1)
+	    || (*(s + 2) != '=' && *(s + 2) != '<' && *(s + 2) != '>'))
+		return(-1);
+	for (i = 0; i < 7; i++)
+		if (tolower((int)*s) == reg_names[i][0]
+		    && tolower((int)*(s + 1)) == reg_names[i][1])
+			return(i);
+	return(-1);
+}
+#endif
+
+#ifdef SBSIZE
+/*
+ *	Contents of the register number r of reg_test()
+ */
+static WORD reg_value(int r)
+{
+	LF_EVAL();
+	switch (r) {
+	case 0:
+		return((A << 8) + F);
+	case 1:
+		return((B << 8) + C);
+	case 2:
+		return((D << 8) + E);
+	case 3:
+		return((H << 8) + L);
+	case 4:
+		return(IX);
+	case 5:
+		return(IY);
+	default:
+		return(STACK - ram);
+	}
+}
+
+/*
+ *	Set or clear the bit of address adr in the bitmap of the
+ *	breakpoints, depending on the breakpoints left at adr
+ */
+static void sb_mark(WORD adr)
+{
+	register int i;
+
+	sb_map[adr >> 6] &= ~(1ULL << (adr & 63));
+	for (i = 0; i < sb_max; i++)
+		if (soft[i].sb_pass && soft[i].sb_adr == adr)
+			sb_map[adr >> 6] |= 1ULL << (adr & 63);
+}
+
+/*
+ *	Remove breakpoint i
+ */
+static void sb_clear(int i)
+{
+	if (!soft[i].sb_pass)
+		return;
+	soft[i].sb_pass = 0;
+	sb_armed--;
+	sb_mark(soft[i].sb_adr);
+}
+
+/*
+ *	Called by the CPU before the opcode at an address with a bit
+ *	in the bitmap is executed: test the conditions of the
+ *	breakpoints at this address and count their passes
+ *
+ *	Output:	1 breakpoint reached (stop), its number in sb_last
+ *		0 continue
+ */
+int sb_hit(void)
+{
+	register int i;
+	register WORD adr = PC - ram, v;
+	register struct softbreak *b;
+
+	for (i = 0, b = soft; i < sb_max; i++, b++) {
+		if (!b->sb_pass || b->sb_adr != adr)
+			continue;
+		if (b->sb_reg >= 0) {
+			v = reg_value(b->sb_reg);
+			if ((b->sb_op == '=' && v != b->sb_val)
+			    || (b->sb_op == '<' && v >= b->sb_val)
+			    || (b->sb_op == '>' && v <= b->sb_val))
+				continue;
+		}
+		if (++b->sb_passcount < b->sb_pass)
+			continue;
+		b->sb_passcount = 0;	/* reset passcounter */
+		sb_last = i;
+		return(1);
+	}
+	return(0);
+}
+#endif
+
 /*
- *	Software breakpoints
+ *	Software breakpoints, any number of them. They are kept in a
+ *	table, which grows as needed, and a bitmap of the addresses,
+ *	which the CPU checks before every opcode, the memory isn't
+ *	modified. Pass counts and conditions are checked by sb_hit(),
+ *	so that the CPU only stops if a breakpoint is reached.
  */
 static void do_break(char *s)
 {
@@ -643,50 +731,131 @@ static void do_break(char *s)
 	puts("Sorry, no breakpoints available");
 	puts("Please recompile with SBSIZE defined in sim.h");
 #else
-	register int i;
+	register int i, n;
+	register struct softbreak *b;
 
 	if (*s == '\n')	{
-		puts("No Addr Pass  Counter");
-		for (i = 0; i <	SBSIZE;	i++)
-			if (soft[i].sb_pass)
-				printf("%02d %04x %05d %05d\n",	i,
-				       soft[i].sb_adr,soft[i].sb_pass,
-				       soft[i].sb_passcount);
+		puts("No   Addr Pass  Counter Condition");
+		for (i = 0; i <	sb_max; i++) {
+			b = &soft[i];
+			if (!b->sb_pass)
+				continue;
+			printf("%04d %04x %05d %05d", i, b->sb_adr,
+			       b->sb_pass, b->sb_passcount);
+			if (b->sb_reg >= 0)
+				printf("   %s%c%04x", reg_names[b->sb_reg],
+				       b->sb_op, b->sb_val);
+			putchar('\n');
+		}
+		return;
+	}
+	if (isdigit((int)*s)) {
+		i = atoi(s);
+		while (isdigit((int)*s))
+			s++;
+	} else			/* first free entry */
+		for (i = 0; i < sb_max && soft[i].sb_pass; i++)
+			;
+	if (i > 65535) {
+		printf("breakpoint %d not available\n",	i);
 		return;
 	}
-	if (isxdigit((int)*s)) {
-		i = atoi(s++);
-		if (i >= SBSIZE) {
-			printf("breakpoint %d not available\n",	i);
+	if (i >= sb_max) {	/* grow the table */
+		n = (i < 2 * sb_max) ? 2 * sb_max : i + SBSIZE;
+		if ((b = realloc(soft, n * sizeof(struct softbreak))) == NULL) {
+			puts("no memory for breakpoint");
 			return;
 		}
-	} else {
-		i = sb_next++;
-		if (sb_next == SBSIZE)
-			sb_next	= 0;
+		memset((char *) &b[sb_max], 0,
+		       (n - sb_max) * sizeof(struct softbreak));
+		soft = b;
+		sb_max = n;
 	}
 	while (isspace((int)*s))
 		s++;
-	if (*s == 'c') {
-		*(ram +	soft[i].sb_adr)	= soft[i].sb_oldopc;
-		memset((char *)	&soft[i], 0, sizeof(struct softbreak));
+	sb_clear(i);
+	if (*s == 'c')
 		return;
-	}
-	if (soft[i].sb_pass)
-		*(ram +	soft[i].sb_adr)	= soft[i].sb_oldopc;
-	soft[i].sb_adr = exatoi(s);
-	soft[i].sb_oldopc = *(ram + soft[i].sb_adr);
-	*(ram +	soft[i].sb_adr)	= 0x76;
-	while (!iscntrl((int)*s) && !ispunct((int)*s))
+	b = &soft[i];
+	b->sb_adr = exatoi(s);
+	while (isxdigit((int)*s))
 		s++;
 	if (*s != ',')
-		soft[i].sb_pass	= 1;
-	else
-		soft[i].sb_pass	= exatoi(++s);
-	soft[i].sb_passcount = 0;
+		b->sb_pass = 1;
+	else {
+		b->sb_pass = exatoi(++s);
+		while (isxdigit((int)*s))
+			s++;
+	}
+	if (b->sb_pass <= 0)
+		b->sb_pass = 1;
+	while (isspace((int)*s))
+		s++;
+	b->sb_reg = -1;
+	if (*s) {
+		if ((b->sb_reg = reg_test(s)) < 0) {
+			b->sb_pass = 0;
+			puts("what??");
+			return;
+		}
+		b->sb_op = *(s + 2);
+		b->sb_val = exatoi(s + 3);
+	}
+	b->sb_passcount = 0;
+	sb_armed++;
+	sb_mark(b->sb_adr);
 #endif
 }
 
+/*
+ *	Memory watchpoints
+ */
+static void do_watch(char *s)
+{
+#ifndef	WANT_WATCH
+	puts("Sorry, no watchpoints available");
+	puts("Please recompile with WANT_WATCH defined in sim.h");
+#else
+	register int i;
+	register struct watch *w;
+
+	if (*s == '\n')	{
+		puts("No   From To   Access Value");
+		for (i = 0; i < wp_max; i++) {
+			w = &watch[i];
+			if (!w->wp_kind)
+				continue;
+			printf("%04d %04x %04x %c%c", i, w->wp_lo, w->wp_hi,
+			       (w->wp_kind & WP_READ) ? 'r' : ' ',
+			       (w->wp_kind & WP_WRITE) ? 'w' : ' ');
+			if (w->wp_val >= 0)
+				printf("     %02x", w->wp_val);
+			putchar('\n');
+		}
+		return;
+	}
+	if (isdigit((int)*s)) {
+		i = atoi(s);
+		while (isdigit((int)*s))
+			s++;
+	} else
+		i = -1;
+	while (isspace((int)*s))
+		s++;
+	if (*s == 'c' && (*(s + 1) == '\0' || isspace((int)*(s + 1)))) {
+		if (i >= 0)
+			wp_clear(i);
+		else
+			puts("what??");
+		return;
+	}
+	if (i >= 0)
+		wp_clear(i);
+	wp_set(i, s);
+#endif
+}
+
+
 /*
  *	History
  */
@@ -696,54 +865,82 @@ static void do_hist(char *s)
 	puts("Sorry, no history available");
 	puts("Please recompile with HISIZE defined in sim.h");
 #else
-	int i,	l, b, e, c, sa;
+	struct hfind f;
+	int l, c, sa, srch = 0;
 
 	while (isspace((int)*s))
 		s++;
-	switch (*s) {
-	case 'c':
-		memset((char *)	his, 0,	sizeof(struct history) * HISIZE);
-		h_next = 0;
-		h_flag = 0;
-		break;
-	default:
-		if ((h_next == 0) && (h_flag ==	0)) {
-			puts("History memory is empty");
-			break;
+	if (!strncmp(s, "on", 2)) {
+		h_on = 1;
+		return;
+	}
+	if (!strncmp(s, "off", 3)) {
+		h_on = 0;
+		return;
+	}
+	if (*s == 'c') {
+		his_clear();
+		return;
+	}
+	if (his_count() == 0) {
+		puts("History memory is empty");
+		return;
+	}
+	f.hf_lo = 0;
+	f.hf_hi = 0xffff;
+	f.hf_reg = -1;
+	sa = -1;
+	if (*s == 's') {		/* search */
+		srch = 1;
+		s++;
+		while (isspace((int)*s))
+			s++;
+		if (reg_test(s) < 0 && isxdigit((int)*s)) {
+			f.hf_lo = f.hf_hi = exatoi(s);
+			while (isxdigit((int)*s))
+				s++;
+			if (*s == ',')
+				f.hf_hi = exatoi(++s);
+			while (isxdigit((int)*s))
+				s++;
 		}
-		e = h_next;
-		b = (h_flag) ? h_next +	1 : 0;
-		l = 0;
 		while (isspace((int)*s))
 			s++;
-		if (*s)
-			sa = exatoi(s);
-		else
-			sa = -1;
-		for (i = b; i != e; i++) {
-			if (i == HISIZE)
-				i = 0;
-			if (sa != -1) {
-				if (his[i].h_adr < sa)
-					continue;
-				else
-					sa = -1;
-			}
-			printf("%04x AF=%04x BC=%04x DE=%04x HL=%04x IX=%04x IY=%04x SP=%04x\n",
-			       his[i].h_adr, his[i].h_af, his[i].h_bc,
-			       his[i].h_de, his[i].h_hl, his[i].h_ix,
-			       his[i].h_iy, his[i].h_sp);
-			l++;
-			if (l == 20) {
-				l = 0;
-				printf("q = quit, else continue: ");
-				c = getkey();
-				putchar('\n');
-				if (toupper(c) == 'Q')
-					break;
+		if (*s && *s != '\n') {
+			if ((f.hf_reg = reg_test(s)) < 0) {
+				puts("what??");
+				return;
 			}
+			f.hf_op = *(s + 2);
+			f.hf_val = exatoi(s + 3);
+		}
+	} else if (*s && *s != '\n') {	/* start at address */
+		sa = exatoi(s);
+		f.hf_lo = sa;
+	}
+	his_start(&f);
+	l = 0;
+	while (his_find(&f)) {
+		if (sa != -1) {		/* show all after the first one */
+			f.hf_lo = 0;
+			sa = -1;
+		}
+		printf("%04x AF=%04x BC=%04x DE=%04x HL=%04x IX=%04x IY=%04x SP=%04x",
+		       f.hf_e.h_adr, f.hf_e.h_reg[0], f.hf_e.h_reg[1],
+		       f.hf_e.h_reg[2], f.hf_e.h_reg[3], f.hf_e.h_reg[4],
+		       f.hf_e.h_reg[5], f.hf_e.h_reg[6]);
+		if (srch)
+			printf(" #%llu", f.hf_n);
+		putchar('\n');
+		l++;
+		if (l == 20) {
+			l = 0;
+			printf("q = quit, else continue: ");
+			c = getkey();
+			putchar('\n');
+			if (toupper(c) == 'Q')
+				break;
 		}
-		break;
 	}
 #endif
 }
@@ -777,6 +974,146 @@ static void do_count(char *s)
 #endif
 }
 
+#ifdef WANT_PROF
+#define P_GAP		4		/* max. distance of opcodes in a range */
+
+struct prange {				/* range of code executed */
+	WORD	lo, hi;			/* first and last opcode */
+	unsigned long long cnt, tim;	/* opcodes and T-states executed */
+};
+
+static WORD pf_adr[65536];		/* addresses executed */
+static struct prange p_rng[65536];	/* ranges executed */
+
+/*
+ *	Compare the T-states of two addresses for qsort(), the most first
+ */
+static int prof_acmp(const void *a, const void *b)
+{
+	register unsigned long long ta = p_tim[*(const WORD *) a];
+	register unsigned long long tb = p_tim[*(const WORD *) b];
+
+	return((ta < tb) - (ta > tb));
+}
+
+/*
+ *	Compare the T-states of two ranges for qsort(), the most first
+ */
+static int prof_rcmp(const void *a, const void *b)
+{
+	register unsigned long long ta = ((const struct prange *) a)->tim;
+	register unsigned long long tb = ((const struct prange *) b)->tim;
+
+	return((ta < tb) - (ta > tb));
+}
+
+/*
+ *	Show the n addresses and the n ranges of code, in which the
+ *	most T-states were spent. Opcodes not more than P_GAP bytes
+ *	apart belong to the same range, so that a range is a loop or
+ *	a straight piece of code.
+ */
+static void prof_show(int n)
+{
+	register int i, na, nr;
+	register unsigned long long total = 0;
+	BYTE *p;
+
+	for (i = na = nr = 0; i < 65536; i++) {
+		if (p_cnt[i] == 0)
+			continue;
+		total += p_tim[i];
+		pf_adr[na++] = i;
+		if (nr == 0 || i - p_rng[nr - 1].hi > P_GAP) {
+			p_rng[nr].lo = i;
+			p_rng[nr].cnt = p_rng[nr].tim = 0;
+			nr++;
+		}
+		p_rng[nr - 1].hi = i;
+		p_rng[nr - 1].cnt += p_cnt[i];
+		p_rng[nr - 1].tim += p_tim[i];
+	}
+	if (total == 0) {
+		puts("no profile recorded");
+		return;
+	}
+	qsort(pf_adr, na, sizeof(WORD), prof_acmp);
+	qsort(p_rng, nr, sizeof(struct prange), prof_rcmp);
+
+	printf("%llu T-states profiled\n", total);
+	puts("Adr  Executed     T-states       %");
+	for (i = 0; i < n && i < na; i++) {
+		printf("%04x %12llu %14llu %5.1f  ", pf_adr[i],
+		       p_cnt[pf_adr[i]], p_tim[pf_adr[i]],
+		       100.0 * p_tim[pf_adr[i]] / total);
+		p = ram + pf_adr[i];
+		disass(&p, pf_adr[i]);
+	}
+	puts("Range     Executed     T-states       %");
+	for (i = 0; i < n && i < nr; i++) {
+		printf("%04x-%04x %12llu %14llu %5.1f  ", p_rng[i].lo,
+		       p_rng[i].hi, p_rng[i].cnt, p_rng[i].tim,
+		       100.0 * p_rng[i].tim / total);
+		p = ram + p_rng[i].lo;
+		disass(&p, p_rng[i].lo);
+	}
+}
+
+/*
+ *	Write the profile into file fn, a line with the address,
+ *	the executions and the T-states for every address executed
+ */
+static void prof_write(char *fn)
+{
+	register FILE *fp;
+	register int i;
+
+	if ((fp = fopen(fn, "w")) == NULL) {
+		printf("can't create file %s\n", fn);
+		return;
+	}
+	for (i = 0; i < 65536; i++)
+		if (p_cnt[i])
+			fprintf(fp, "%04x %llu %llu\n", i, p_cnt[i], p_tim[i]);
+	fclose(fp);
+}
+#endif
+
+/*
+ *	Profiler: switch it on or off, clear the profile, show the
+ *	count hot spots of it (default 10) or write it into a file.
+ *	The profile counts the executions and T-states of the opcodes
+ *	by their address, prefixed opcodes at the prefix.
+ */
+static void do_prof(char *s)
+{
+#ifndef	WANT_PROF
+	puts("Sorry, no profiler available");
+	puts("Please recompile with WANT_PROF defined in sim.h");
+#else
+	while (isspace((int)*s))
+		s++;
+	if (!strncmp(s, "on", 2))
+		p_on = 1;
+	else if (!strncmp(s, "off", 3))
+		p_on = 0;
+	else if (*s == 'c') {
+		memset(p_cnt, 0, 65536 * sizeof(p_cnt[0]));
+		memset(p_tim, 0, 65536 * sizeof(p_tim[0]));
+	} else if (*s == 'w') {
+		s++;
+		while (isspace((int)*s))
+			s++;
+		s[strcspn(s, " \t\n")] = '\0';
+		if (*s == '\0')
+			puts("no filename given");
+		else
+			prof_write(s);
+	} else
+		prof_show(*s ? atoi(s) : 10);
+#endif
+}
+
 /*
  *	Calculate the clock frequency of the emulated CPU:
  *	into memory locations 0000H to 0002H the following
@@ -788,17 +1125,39 @@ static void do_count(char *s)
  *	the timer is down and stopps the emulation, the clock
  *	speed of the CPU is calculated with:
  *		f = R /	300000
+ *	With the argument a a loop of 8 bit arithmetic and
+ *	logical opcodes is stored into 0000H to 000FH instead:
+ *		LOOP: ADD A,B / SUB C / INC D / XOR E / DEC H / CP L
+ *		      ADC A,A / OR H / AND L / SBC A,E / DEC C
+ *		      JR NZ,LOOP / JP LOOP
+ *	and the number of executed opcodes per second is shown,
+ *	which is mostly determined by the flag computation.
+ *	With the argument s the CPU speed achieved by the speed
+ *	adjustment of the last run is shown, see do_speed().
  */
-static void do_clock(void)
+static void do_clock(char *s)
 {
-	static BYTE save[3];
+	static BYTE jp_loop[] = { 0xc3, 0x00, 0x00 };
+	static BYTE alu_loop[] = { 0x80, 0x91, 0x14, 0xab, 0x25, 0xbd,
+				   0x8f, 0xb4, 0xa5, 0x9b, 0x0d, 0x20,
+				   0xf3, 0xc3, 0x00, 0x00 };
+	static BYTE save[sizeof(alu_loop)];
+	register BYTE *code;
+	register int i, len, alu;
 
-	save[0]	= *(ram	+ 0x0000);	/* save memory locations */
-	save[1]	= *(ram	+ 0x0001);	/* 0000H - 0002H */
-	save[2]	= *(ram	+ 0x0002);
-	*(ram +	0x0000)	= 0xc3;		/* store opcode JP 0000H at address */
-	*(ram +	0x0001)	= 0x00;		/* 0000H */
-	*(ram +	0x0002)	= 0x00;
+	while (isspace((int)*s))
+		s++;
+	if (*s == 's') {
+		do_speed(s + 1);
+		return;
+	}
+	alu = (*s == 'a');
+	code = alu ? alu_loop : jp_loop;
+	len = alu ? sizeof(alu_loop) : sizeof(jp_loop);
+	for (i = 0; i < len; i++) {
+		save[i] = *(ram + i);	/* save memory locations */
+		memwrt(i, code[i]);	/* store the loop at 0000H */
+	}
 	PC = ram + 0x0000;		/* set PC to this code */
 	R = 0L;				/* clear refresh register */
 	cpu_state = CONTIN_RUN;		/* initialize CPU */
@@ -806,13 +1165,41 @@ static void do_clock(void)
 	signal(SIGALRM,	timeout);	/* initialize timer interrupt handler */
 	alarm(3);			/* start 3 secound timer */
 	cpu();				/* start CPU */
-	*(ram +	0x0000)	= save[0];	/* restore memory locations */
-	*(ram +	0x0001)	= save[1];	/* 0000H - 0002H */
-	*(ram +	0x0002)	= save[2];
-	if (cpu_error == NONE)
+	for (i = 0; i < len; i++)
+		memwrt(i, save[i]);	/* restore memory locations */
+	if (cpu_error != NONE)
+		puts("Interrupted by user");
+	else if (alu)
+		printf("ALU opcodes = %5.2f Mips\n", ((float) R) / 3000000.0);
+	else
 		printf("clock frequency = %5.2f Mhz\n",	((float) R) / 300000.0);
+}
+
+/*
+ *	Show the CPU speed and the time lost by the speed adjustment
+ *	during the last run, or set its time slice and the max. time
+ *	the CPU may run behind the clock to catch up:
+ *		c s [slice[,catchup]]	(in ms, decimal)
+ */
+static void do_speed(char *s)
+{
+	while (isspace((int)*s))
+		s++;
+	if (isdigit((int)*s)) {
+		if (atoi(s) > 0)
+			f_slice = atoi(s);
+		while (isdigit((int)*s))
+			s++;
+		if (*s == ',')
+			f_catchup = atoi(s + 1);
+	}
+	if (f_flag)
+		printf("CPU speed %d MHz, achieved %ld.%03ld MHz, slip %ld ms\n",
+		       f_flag, ev_khz() / 1000, ev_khz() % 1000, ev_slip());
 	else
-		puts("Interrupted by user");
+		puts("CPU speed is unlimited");
+	printf("time slice %d ms, catch up limit %d ms\n", f_slice,
+	       f_catchup);
 }
 
 /*
@@ -833,17 +1220,25 @@ static void do_show(void)
 
 	printf("Release: %s\n",	RELEASE);
 #ifdef HISIZE
-	i = HISIZE;
-#else
-	i = 0;
+	printf("History %s, %llu entrys recorded\n", h_on ? "on" : "off",
+	       his_count());
+#endif
+#ifdef WANT_TRACE
+	printf("Execution trace %s, %llu records\n", tr_on ? "on" : "off",
+	       tr_head);
+#endif
+#ifdef WANT_PROF
+	printf("Profiler %s\n", p_on ? "on" : "off");
 #endif
-	printf("No. of entrys in history memory: %d\n",	i);
 #ifdef SBSIZE
-	i = SBSIZE;
+	i = sb_armed;
 #else
 	i = 0;
 #endif
-	printf("No. of software breakpoints: %d\n", i);
+	printf("No. of software breakpoints set: %d\n", i);
+#ifdef WANT_WATCH
+	printf("No. of watchpoints set: %d\n", wp_armed);
+#endif
 #ifdef Z80_UNDOC
 	i = z_flag;
 #else
@@ -906,17 +1301,31 @@ static void do_help(void)
 	puts("p address                 show/modify port");
 	puts("g [address]               run program");
 	puts("t [count]                 trace program");
+#ifdef WANT_TRACE
+	puts("t f [filename]            start/stop trace into file");
+#endif
 	puts("return                    single step program");
 	puts("x [register]              show/modify register");
 	puts("x f<flag>                 modify flag");
-	puts("b[no] address[,pass]      set soft breakpoint");
+	puts("b[no] address[,pass] [reg{=<>}value] set soft breakpoint");
 	puts("b                         show soft breakpoints");
 	puts("b[no] c                   clear soft breakpoint");
+	puts("w[no] address[,to] [r][w] [=value] set watchpoint");
+	puts("w                         show watchpoints");
+	puts("w[no] c                   clear watchpoint");
 	puts("h [address]               show history");
 	puts("h c                       clear history");
+	puts("h s [from[,to]] [reg{=<>}value] search history");
+	puts("h on|off                  switch history on/off");
 	puts("z start,stop              set trigger adr for t-state count");
 	puts("z                         show t-state count");
+	puts("u on|off                  switch profiler on/off");
+	puts("u [count]                 show hot spots of the profile");
+	puts("u c                       clear profile");
+	puts("u w filename              write profile into file");
 	puts("c                         measure clock frequency");
+	puts("c a                       measure speed of ALU opcodes");
+	puts("c s [slice[,catchup]]     show/set CPU speed adjustment");
 	puts("s                         show settings");
 	puts("! command                 execute UNIX command");
 	puts("q                         quit");
@@ -925,7 +1334,7 @@ static void do_help(void)
 /*
  *	Error handler after CPU is stopped
  */
-static void cpu_err_msg(void)
+void cpu_err_msg(void)
 {
 	switch (cpu_error) {
 	case NONE:
@@ -957,6 +1366,23 @@ static void cpu_err_msg(void)
 	case USERINT:
 		puts("User Interrupt");
 		break;
+	case INTERROR:
+		printf("Interrupt op-code not implemented at %04x\n",
+		       (unsigned int)(PC - ram));
+		break;
+#ifdef SBSIZE
+	case BRKPOINT:
+		printf("Software breakpoint %d reached at %04x\n", sb_last,
+		       (unsigned int)(PC - ram));
+		break;
+#endif
+#ifdef WANT_WATCH
+	case WATCHPT:
+		printf("Watchpoint %d hit at %04x, %s %04x=%02x\n", wp_last,
+		       (unsigned int)(PC - ram),
+		       (wp_how == WP_READ) ? "read" : "write", wp_adr, wp_data);
+		break;
+#endif
 	case POWEROFF:
 		break;
 	default:
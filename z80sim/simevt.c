@@ -0,0 +1,361 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * History:
+ * 28-SEP-87 Development on TARGON/35 with AT&T Unix System V.3
+ * 11-JAN-89 Release 1.1
+ * 08-FEB-89 Release 1.2
+ * 13-MAR-89 Release 1.3
+ * 09-FEB-90 Release 1.4  Ported to TARGON/31 M10/30
+ * 20-DEC-90 Release 1.5  Ported to COHERENT 3.0
+ * 10-JUN-92 Release 1.6  long casting problem solved with COHERENT 3.2
+ *			  and some optimization
+ * 25-JUN-92 Release 1.7  comments in english and ported to COHERENT 4.0
+ * 02-OCT-06 Release 1.8  modified to compile on modern POSIX OS's
+ * 18-NOV-06 Release 1.9  modified to work with CP/M sources
+ * 08-DEC-06 Release 1.10 modified MMU for working with CP/NET
+ * 17-DEC-06 Release 1.11 TCP/IP sockets for CP/NET
+ * 25-DEC-06 Release 1.12 CPU speed option
+ * 19-FEB-07 Release 1.13 various improvements
+ * 06-OCT-07 Release 1.14 bug fixes and improvements
+ * 06-AUG-08 Release 1.15 many improvements and Windows support via Cygwin
+ * 25-AUG-08 Release 1.16 console status I/O loop detection and line discipline
+ * 20-OCT-08 Release 1.17 frontpanel integrated and Altair/IMSAI emulations
+ */
+
+/*
+ *	This modul contains the event scheduler of the CPU emulation:
+ *
+ *	ev_add()	: call a function after n T-states
+ *	ev_cancel()	: remove all scheduled calls of a function
+ *	ev_attn()	: let the CPU look at int_type as soon as possible
+ *	ev_run()	: called by the CPU, when the next event is due
+ *	ev_init()	: schedule the events needed by the CPU itself
+ *	ev_idle()	: wait for an interrupt while the CPU is halted
+ *	ev_khz()	: CPU speed achieved by the speed adjustment
+ *	ev_slip()	: time lost by the speed adjustment
+ *
+ *	The CPU counts the executed T-states in ev_clock and compares
+ *	it with ev_next before every opcode only, so that devices don't
+ *	need to be polled. The events are kept in a heap in the context
+ *	of the CPU, ordered by their time. Functions called by signal
+ *	handlers must only use ev_attn().
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/select.h>
+#include "sim.h"
+#include "simglb.h"
+
+static void ev_speed(void);
+
+#ifdef WANT_MIRROR
+#define EV_MIRROR	100000		/* T-states between the moves of PC, SP */
+static void ev_mirror(void);
+#endif
+
+/*
+ *	Schedule a call of function func in n T-states
+ */
+void ev_add(long long n, void (*func)(void))
+{
+	register int i, p;
+	register struct event *q = cpu_ctx->ev_q;
+
+	if (cpu_ctx->ev_n == EV_MAX) {
+		puts("too many scheduled events");
+		return;
+	}
+	if (n < 1)		/* not before the next opcode */
+		n = 1;
+	/* sift the new event up from the end of the heap */
+	for (i = cpu_ctx->ev_n++; i > 0; i = p) {
+		p = (i - 1) / 2;
+		if (q[p].time <= ev_clock + n)
+			break;
+		q[i] = q[p];
+	}
+	q[i].time = ev_clock + n;
+	q[i].func = func;
+	if (q[0].time < ev_next)
+		ev_next = q[0].time;
+}
+
+/*
+ *	Remove the event at index i from the heap
+ */
+static void ev_del(int i)
+{
+	register int c;
+	register struct event *q = cpu_ctx->ev_q;
+	struct event last;
+
+	last = q[--cpu_ctx->ev_n];
+	if (i == cpu_ctx->ev_n)
+		return;
+	/* sift the last event down from i */
+	while ((c = 2 * i + 1) < cpu_ctx->ev_n) {
+		if (c + 1 < cpu_ctx->ev_n && q[c + 1].time < q[c].time)
+			c++;
+		if (last.time <= q[c].time)
+			break;
+		q[i] = q[c];
+		i = c;
+	}
+	q[i] = last;
+	/* or up, if it's earlier than its new parent */
+	while (i > 0 && q[(i - 1) / 2].time > q[i].time) {
+		last = q[i];
+		q[i] = q[(i - 1) / 2];
+		q[(i - 1) / 2] = last;
+		i = (i - 1) / 2;
+	}
+}
+
+/*
+ *	Remove all scheduled calls of function func
+ */
+void ev_cancel(void (*func)(void))
+{
+	register int i;
+
+	for (i = cpu_ctx->ev_n - 1; i >= 0; i--)
+		if (cpu_ctx->ev_q[i].func == func)
+			ev_del(i);
+}
+
+/*
+ *	Let the CPU call ev_run() before the next opcode,
+ *	e.g. after an interrupt request was set in int_type
+ */
+void ev_attn(void)
+{
+	ev_next = 0;
+}
+
+/*
+ *	Call the functions of all events which are due
+ *	and compute the time of the next event
+ */
+void ev_run(void)
+{
+	void (*func)(void);
+
+	while (cpu_ctx->ev_n > 0 && cpu_ctx->ev_q[0].time <= ev_clock) {
+		func = cpu_ctx->ev_q[0].func;
+		ev_del(0);
+		(*func)();
+	}
+	ev_next = (cpu_ctx->ev_n > 0) ? cpu_ctx->ev_q[0].time : EV_NEVER;
+#ifdef WANT_INT
+	/* an interrupt requested by a signal handler must not get lost, */
+	/* a maskable one waits until EI or RETN enable the interrupts */
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	if (int_type == INT_NMI || (int_type == INT_INT && IFF == 3))
+		ev_next = 0;
+#endif
+}
+
+/*
+ *	Wall clock time in ns
+ */
+static long long ev_time(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return(t.tv_sec * 1000000000LL + t.tv_nsec);
+}
+
+/*
+ *	Schedule the events used by the CPU emulation itself,
+ *	called when the CPU is started and if f_flag was modified
+ */
+void ev_init(void)
+{
+	ev_cancel(ev_speed);
+	cpu_ctx->sp_clock = ev_clock;
+	cpu_ctx->sp_start = ev_time();
+	cpu_ctx->sp_slip = 0;
+	cpu_ctx->sp_khz = f_flag * 1000L;
+	if (f_flag) {
+		tmax = f_flag * 1000 * f_slice;
+		ev_add(tmax, ev_speed);
+	}
+#ifdef WANT_SNAP
+	ev_cancel(sn_poll);		/* periodic snapshots, monitor only */
+	if (sn_period && cpu_ctx == &cpu0)
+		ev_add(1, sn_poll);
+#endif
+#ifdef WANT_MIRROR
+	ev_cancel(ev_mirror);
+	ev_add(EV_MIRROR, ev_mirror);
+#endif
+}
+
+#ifdef WANT_MIRROR
+/*
+ *	Move PC and SP out of the mirrors of the memory every
+ *	EV_MIRROR T-states. No opcode moves PC by more than
+ *	one byte per 3 T-states or SP by more than one byte per
+ *	5 T-states, so they can't run off the mirrors.
+ */
+static void ev_mirror(void)
+{
+	mem_wrap();
+	ev_add(EV_MIRROR, ev_mirror);
+}
+#endif
+
+/*
+ *	Adjust CPU speed, called every tmax T-states (f_slice ms).
+ *	The T-states executed since the CPU was started are converted
+ *	into the wall clock time, at which they should be done, and
+ *	the CPU sleeps until then. So the time needed for the sleep
+ *	itself and the emulation doesn't add up, the emulated clock
+ *	doesn't drift. If the CPU is behind the clock, it runs without
+ *	sleeping to catch up, but not more than f_catchup ms. Time
+ *	beyond that is lost and counted as slip.
+ */
+static void ev_speed(void)
+{
+	register long long now, due, late;
+	struct timespec t;
+
+	if (!f_flag)
+		return;
+	due = cpu_ctx->sp_start + cpu_ctx->sp_slip
+	      + (ev_clock - cpu_ctx->sp_clock) * 1000 / f_flag;
+	now = ev_time();
+	if (now < due) {
+		t.tv_sec = due / 1000000000LL;
+		t.tv_nsec = due % 1000000000LL;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t,
+				       NULL) == EINTR)
+			;
+		now = due;
+	} else if ((late = now - due) > f_catchup * 1000000LL)
+		cpu_ctx->sp_slip += late - f_catchup * 1000000LL;
+	if (now > cpu_ctx->sp_start)
+		cpu_ctx->sp_khz = (ev_clock - cpu_ctx->sp_clock) * 1000000LL
+				  / (now - cpu_ctx->sp_start);
+	ev_add(tmax, ev_speed);
+}
+
+/*
+ *	Let the time pass until T-state time t, the refresh register
+ *	counts on as the CPU would execute NOPs
+ */
+static void ev_pass(long long t)
+{
+	if (t > ev_clock) {
+		R += (t - ev_clock) / 4;
+		ev_clock = t;
+	}
+}
+
+/*
+ *	Wait for an interrupt while the CPU is halted.
+ *	All interrupt sources (timer, sockets) and the user interrupt
+ *	are signal handlers, so the CPU sleeps in pselect() until a
+ *	signal arrives. The signals are blocked while int_type and
+ *	cpu_state are tested, and unblocked by pselect() atomically,
+ *	so that no wake up can get lost between the test and the sleep.
+ *	If the CPU speed is limited, the emulated clock follows the
+ *	wall clock while sleeping and the sleep ends when the next
+ *	event is due, else the time passes until the next event at once.
+ */
+void ev_idle(void)
+{
+	sigset_t all, old;
+	struct timespec t, *tp;
+	long long now, due;
+
+#ifdef WANT_MIRROR
+	ev_cancel(ev_mirror);		/* PC and SP don't move while halted */
+#endif
+#ifdef WANT_SNAP
+	ev_cancel(sn_poll);		/* T-states would pass in a busy loop */
+#endif
+	sigfillset(&all);
+	for (;;) {
+		sigprocmask(SIG_BLOCK, &all, &old);
+#ifdef WANT_INT
+		if ((int_type && int_ready())
+		    || __atomic_load_n(&cpu_state, __ATOMIC_RELAXED) != CONTIN_RUN) {
+#else
+		if (__atomic_load_n(&cpu_state, __ATOMIC_RELAXED) != CONTIN_RUN) {
+#endif
+			sigprocmask(SIG_SETMASK, &old, NULL);
+			break;
+		}
+		if (ev_next <= ev_clock) {
+			sigprocmask(SIG_SETMASK, &old, NULL);
+			ev_run();
+			continue;
+		}
+		tp = NULL;
+		if (ev_next != EV_NEVER) {
+			if (!f_flag) {
+				sigprocmask(SIG_SETMASK, &old, NULL);
+				ev_pass(ev_next);
+				continue;
+			}
+			due = cpu_ctx->sp_start + cpu_ctx->sp_slip
+			      + (ev_next - cpu_ctx->sp_clock) * 1000 / f_flag;
+			if ((now = ev_time()) >= due) {
+				sigprocmask(SIG_SETMASK, &old, NULL);
+				ev_pass(ev_next);
+				continue;
+			}
+			t.tv_sec = (due - now) / 1000000000LL;
+			t.tv_nsec = (due - now) % 1000000000LL;
+			tp = &t;
+		}
+#ifdef WANT_HOST
+		/* machines of the host are stopped without a signal */
+		if (cpu_ctx != &cpu0 && (tp == NULL || t.tv_sec > 0
+					 || t.tv_nsec > 1000000L)) {
+			t.tv_sec = 0;
+			t.tv_nsec = 1000000L;
+			tp = &t;
+		}
+#endif
+		pselect(0, NULL, NULL, NULL, tp, &old);
+		sigprocmask(SIG_SETMASK, &old, NULL);
+		if (f_flag) {
+			now = cpu_ctx->sp_clock + (ev_time() - cpu_ctx->sp_start
+				- cpu_ctx->sp_slip) * f_flag / 1000;
+			ev_pass((now < ev_next) ? now : ev_next);
+		}
+	}
+#ifdef WANT_MIRROR
+	ev_add(EV_MIRROR, ev_mirror);
+#endif
+#ifdef WANT_SNAP
+	if (sn_period && cpu_ctx == &cpu0)
+		ev_add(1, sn_poll);
+#endif
+}
+
+/*
+ *	CPU speed achieved by the speed adjustment in kHz,
+ *	0 if the speed isn't limited
+ */
+long ev_khz(void)
+{
+	return(f_flag ? cpu_ctx->sp_khz : 0L);
+}
+
+/*
+ *	ms lost by the speed adjustment since the CPU was started
+ */
+long ev_slip(void)
+{
+	return(cpu_ctx->sp_slip / 1000000LL);
+}
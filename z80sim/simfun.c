@@ -29,11 +29,17 @@
  *	This modul contains some commonly used functions
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE	/* memfd_create() */
+#endif
+
 #include <unistd.h>
 #include <stdio.h>
 #include <ctype.h>
 #include <termios.h>
+#include <sys/mman.h>
 #include "sim.h"
+#include "simglb.h"
 
 /*
  *	atoi for hexadecimal numbers
@@ -70,3 +76,60 @@ int getkey(void)
 	tcsetattr(0, TCSADRAIN, &old_term);
 	return(c);
 }
+
+#ifdef WANT_MIRROR
+/*
+ *	Map the 64KB memory of a CPU three times back to back and
+ *	return the address of the mapping in the middle, NULL on
+ *	error. The mappings before and behind it are mirrors of
+ *	the same memory, so that PC and SP wrap around at FFFF
+ *	without any checks: opcodes and operands read behind FFFF
+ *	come from 0000 and a push below 0000 writes to FFFF.
+ */
+BYTE *mem_map(void)
+{
+	register BYTE *p;
+	register int i, fd;
+
+	if ((fd = memfd_create("z80sim", 0)) == -1)
+		return(NULL);
+	if (ftruncate(fd, 65536) == -1) {
+		close(fd);
+		return(NULL);
+	}
+	p = mmap(NULL, 3 * 65536, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS,
+		 -1, 0);
+	if (p == MAP_FAILED) {
+		close(fd);
+		return(NULL);
+	}
+	for (i = 0; i < 3; i++)
+		if (mmap(p + i * 65536, 65536, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+			munmap(p, 3 * 65536);
+			close(fd);
+			return(NULL);
+		}
+	close(fd);			/* the mappings keep the memory */
+	return(p + 65536);
+}
+
+/*
+ *	Unmap the memory mapped by mem_map()
+ */
+void mem_unmap(BYTE *p)
+{
+	munmap(p - 65536, 3 * 65536);
+}
+
+/*
+ *	Move PC and SP out of the mirrors into the memory, they
+ *	must not run off the mirrors and the monitor expects them
+ *	in the memory
+ */
+void mem_wrap(void)
+{
+	PC = ram + (WORD) (PC - ram);
+	STACK = ram + (WORD) (STACK - ram);
+}
+#endif
@@ -30,25 +30,19 @@
  */
 
 #include "sim.h"
+#include "simglb.h"
 
 #define MAXCHAN	5	/* max number of channel for I/O busy detect */
 
 /*
- *	CPU Registers
+ *	CPU registers and memory of the emulated machine,
+ *	the CPU emulation uses the context cpu_ctx points to
  */
-BYTE A,B,C,D,E,H,L;		/* Z80 primary registers */
-int  F;				/* normaly 8-Bit, but int is faster */
-WORD IX, IY;
-BYTE A_,B_,C_,D_,E_,H_,L_;	/* Z80 alternate registers */
-int  F_;
-BYTE *PC;			/* Z80 programm counter */
-BYTE *STACK;			/* Z80 stackpointer */
-BYTE I;				/* Z80 interrupt register */
-BYTE IFF;			/* Z80 interrupt flags */
-long R;				/* Z80 refresh register */
-				/* is normaly a 8 bit register	*/
-				/* the 32 bits are used to measure the */
-				/* clock frequency */
+struct cpu_context cpu0;
+TLOCAL struct cpu_context *cpu_ctx = &cpu0;
+#ifdef WANT_MIRROR
+TLOCAL BYTE *mem_base;		/* memory of cpu_ctx */
+#endif
 
 #ifdef BUS_8080			/* CPU bus status, for frontpanels */
 BYTE cpu_bus;
@@ -59,34 +53,49 @@ BYTE mem_wp;			/* memory write-protect flag */
 /*
  *	Variables for memory of the emulated CPU
  */
-BYTE ram[65536];		/* 64KB RAM */
 BYTE *wrk_ram;			/* workpointer into memory for dump etc. */
 
 /*
  *	Variables for history memory
  */
 #ifdef HISIZE
-struct history his[HISIZE];	/* memory to hold trace informations */
-int h_next;			/* index into trace memory */
-int h_flag;			/* flag for trace memory overrun */
+int h_on = 1;			/* history switched on */
+long h_size = HISIZE;		/* number of entries, option -h */
+#endif
+
+/*
+ *	Variables for the profiler
+ */
+#ifdef WANT_PROF
+int p_on;			/* profiler switched on */
+unsigned long long p_cnt[65536]; /* executions of the opcode at address */
+unsigned long long p_tim[65536]; /* T-states of the opcode at address */
 #endif
 
 /*
  *	Variables for breakpoint memory
  */
 #ifdef SBSIZE
-struct softbreak soft[SBSIZE];	/* memory to hold breakpoint informations */
-int sb_next;			/* index into breakpoint memory */
+struct softbreak *soft;		/* memory to hold breakpoint informations */
+int sb_max;			/* size of breakpoint memory */
+int sb_armed;			/* number of breakpoints set */
+int sb_last;			/* number of the breakpoint reached */
+unsigned long long sb_map[1024]; /* bitmap of the addresses with breakpoints */
 #endif
 
 /*
  *	Variables for runtime measurement
  */
 #ifdef WANT_TIM
-long t_states;			/* number of counted T states */
-int t_flag;			/* flag, 1 = on, 0 = off */
-BYTE *t_start =	ram + 65535;	/* start address for measurement */
-BYTE *t_end = ram + 65535;	/* end address for measurement */
+TLOCAL long t_states;		/* number of counted T states */
+TLOCAL int t_flag;		/* flag, 1 = on, 0 = off */
+#ifndef WANT_MIRROR
+BYTE *t_start =	cpu0.mem + 65535; /* start address for measurement */
+BYTE *t_end = cpu0.mem + 65535;	/* end address for measurement */
+#else
+BYTE *t_start;			/* set when the memory is mapped */
+BYTE *t_end;
+#endif
 #endif
 
 /*
@@ -107,15 +116,14 @@ int m_flag;			/* flag	for -m option */
 int x_flag;			/* flag	for -x option */
 int i_flag;			/* flag for -i option */
 int f_flag;			/* flag for -f option */
+int b_flag;			/* flag for -b option */
 #ifdef Z80_UNDOC
 int z_flag;			/* flag for -z option */
 #endif
 char xfn[LENCMD];		/* buffer for filename (option -x) */
-BYTE cpu_state;			/* status of CPU emulation */
-int cpu_error;			/* error status of CPU emulation */
-int int_type;			/* type	of interrupt */
-int tmax;			/* max t-stats to execute in 10ms */
-int int_mode;			/* CPU interrupt mode (IM 0, IM 1, IM 2) */
+int tmax;			/* max t-stats to execute in a time slice */
+int f_slice = 10;		/* time slice of CPU speed adjustment in ms */
+int f_catchup = 100;		/* max. ms the CPU may be behind the clock */
 int cntl_c;			/* flag	for cntl-c entered */
 int cntl_bs;			/* flag	for cntl-\ entered */
 
@@ -215,3 +223,14 @@ int parrity[256] = {
 		1 /* 11111011 */, 0 /* 11111100	*/, 1 /* 11111101 */,
 		1 /* 11111110 */, 0 /* 11111111	*/
 };
+
+/*
+ *	Tables with the precomputed flags of the 8 bit arithmetic
+ *	and logical opcodes, initialized by init_alu() at startup
+ */
+BYTE sz_flag[256];		/* S and Z flags of a result */
+BYTE szp_flag[256];		/* S, Z and P flags of a result */
+BYTE szhv_inc[256];		/* flags of INC for the incremented value */
+BYTE szhv_dec[256];		/* flags of DEC for the decremented value */
+BYTE add_flag[2][256][256];	/* flags of ADD/ADC [carry][A][operand] */
+BYTE sub_flag[2][256][256];	/* flags of SUB/SBC/CP [carry][A][operand] */
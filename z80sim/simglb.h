@@ -25,48 +25,256 @@
  * 20-OCT-08 Release 1.17 frontpanel integrated and Altair/IMSAI emulations
  */
 
+#ifndef MEM_ALIGN
+#define MEM_ALIGN	64		/* alignment of the memory of a CPU */
+#endif
+
+/*
+ *	Event scheduled at a T-state time, see simevt.c
+ */
+#define EV_MAX		16		/* max. number of scheduled events */
+#define EV_NEVER	0x7fffffffffffffffLL /* time if nothing scheduled */
+
+struct event {
+	long long time;			/* T-state time of the event */
+	void (*func)(void);		/* function called at that time */
+};
+
+/*
+ *	Devices requesting maskable interrupts, see int_request()
+ */
+#define INT_DEV		32		/* max. number of devices in the chain */
+
+/*
+ *	Context of an emulated CPU with its memory. The registers
+ *	used by nearly all opcodes are packed into the first cache
+ *	line, the rarely used state follows behind them. The state
+ *	of the debugger (history, breakpoints, runtime measurement)
+ *	isn't part of the context. The CPU emulation works on the
+ *	context cpu_ctx points to, so that more than one machine
+ *	can be emulated by switching cpu_ctx while cpu() isn't running.
+ *	With WANT_HOST cpu_ctx and the debugger state are thread local,
+ *	so that the machines can run in parallel, see simhost.c.
+ */
+struct cpu_context {
+	/* hot registers, first cache line */
+	BYTE	*pc;			/* programm counter */
+	BYTE	*sp;			/* stackpointer */
+	long	r;			/* refresh register, normaly 8 bit, */
+					/* the 32 bits are used to measure */
+					/* the clock frequency */
+	int	f;			/* flags */
+	BYTE	a, b, c, d, e, h, l;	/* primary registers */
+	BYTE	i;			/* interrupt register */
+	BYTE	iff;			/* interrupt flags */
+	WORD	ix, iy;			/* index registers */
+#ifdef WANT_LAZYF
+	int	lf_op, lf_c;		/* pending flags, see lf_flags() */
+	BYTE	lf_a, lf_b;
+#endif
+	long long ev_clock;		/* T-states executed */
+	long long ev_next;		/* T-state time of the next event */
+#ifdef WANT_HOST
+	unsigned long long ops;		/* instructions executed */
+#endif
+	/* cold state */
+	int	f_;			/* alternate registers */
+	BYTE	a_, b_, c_, d_, e_, h_, l_;
+	BYTE	state;			/* status of CPU emulation */
+	int	error;			/* error status of CPU emulation */
+	int	int_type;		/* type of interrupt */
+	int	int_mode;		/* CPU interrupt mode */
+	int	int_ei;			/* EI executed, see cpu_int() */
+	void	*io;			/* state of the machines I/O devices */
+	int	ev_n;			/* number of scheduled events */
+	struct event ev_q[EV_MAX];	/* heap of the scheduled events */
+	unsigned int_req;		/* devices requesting an interrupt */
+	unsigned int_ack;		/* devices with interrupt in service */
+	BYTE	int_vec[INT_DEV];	/* interrupt vectors of the devices */
+	WORD	int_adr[INT_DEV];	/* and the address of an IM 0 CALL */
+	long long sp_clock;		/* ev_clock when the CPU was started */
+	long long sp_start;		/* and the wall clock time in ns */
+	long long sp_slip;		/* ns lost by the CPU speed adjustment */
+	long	sp_khz;			/* achieved CPU speed in kHz */
+#ifdef WANT_MMIO
+	BYTE	*mm_rdp[256];		/* memory of the pages read */
+	BYTE	*mm_wrp[256];		/* and written, see simmio.c */
+	BYTE	mm_trap[256];		/* pages with a handler */
+	BYTE	mm_sink[256];		/* writes into ROM are lost here */
+#endif
+#ifdef WANT_MIRROR
+	BYTE	*mem;			/* 64KB RAM, see mem_map() */
+#else
+	BYTE	mem[65536] __attribute__ ((aligned (MEM_ALIGN))); /* 64KB RAM */
+#endif
+} __attribute__ ((aligned (64)));
+
+#ifdef WANT_HOST
+/* one instance per thread, the variables are all in the executable */
+#define TLOCAL		__thread __attribute__ ((tls_model ("local-exec")))
+#else
+#define TLOCAL
+#endif
+
+extern struct cpu_context cpu0;
+extern TLOCAL struct cpu_context *cpu_ctx;
+
+#define A		(cpu_ctx->a)
+#define B		(cpu_ctx->b)
+#define C		(cpu_ctx->c)
+#define D		(cpu_ctx->d)
+#define E		(cpu_ctx->e)
+#define H		(cpu_ctx->h)
+#define L		(cpu_ctx->l)
+#define F		(cpu_ctx->f)
+#define A_		(cpu_ctx->a_)
+#define B_		(cpu_ctx->b_)
+#define C_		(cpu_ctx->c_)
+#define D_		(cpu_ctx->d_)
+#define E_		(cpu_ctx->e_)
+#define H_		(cpu_ctx->h_)
+#define L_		(cpu_ctx->l_)
+#define F_		(cpu_ctx->f_)
+#define IX		(cpu_ctx->ix)
+#define IY		(cpu_ctx->iy)
+#define PC		(cpu_ctx->pc)
+#define STACK		(cpu_ctx->sp)
+#define I		(cpu_ctx->i)
+#define IFF		(cpu_ctx->iff)
+#define R		(cpu_ctx->r)
+#ifdef WANT_MIRROR
+#define ram		mem_base	/* cpu_ctx->mem, one load less */
+#else
+#define ram		(cpu_ctx->mem)
+#endif
+#define cpu_state	(cpu_ctx->state)
+#define cpu_error	(cpu_ctx->error)
+#define int_type	(cpu_ctx->int_type)
+#define int_mode	(cpu_ctx->int_mode)
+#define ev_clock	(cpu_ctx->ev_clock)
+#define ev_next		(cpu_ctx->ev_next)
+
 /*
  *	Declaration of variables in simglb.c
  */
 
-extern BYTE	A, B, C, D, E, H, L, A_, B_, C_, D_, E_, H_, L_,
-		*PC, *STACK, I, IFF;
-extern WORD	IX, IY;
-extern int	F, F_;
-extern long	R;
 extern BYTE	mem_wp;
 
 #ifdef BUS_8080
 extern BYTE	cpu_bus;
 #endif
 
-extern BYTE	ram[],*wrk_ram, cpu_state;
+extern BYTE	*wrk_ram;
+
+extern void	ev_add(long long, void (*)(void)), ev_cancel(void (*)(void));
+extern void	ev_attn(void), ev_run(void), ev_init(void), ev_idle(void);
+extern long	ev_khz(void), ev_slip(void);
+
+#ifdef WANT_MIRROR
+extern TLOCAL BYTE *mem_base;
+extern BYTE	*mem_map(void);
+extern void	mem_unmap(BYTE *);
+extern void	mem_wrap(void);
+#endif
+
+extern void	int_request(int, BYTE), int_cancel(int), int_reset(void);
+extern void	int_request_call(int, WORD);
+extern void	int_reti(void);
+extern int	int_ready(void);
+
+#ifdef WANT_LAZYF
+#define lf_op		(cpu_ctx->lf_op)
+#define lf_c		(cpu_ctx->lf_c)
+#define lf_a		(cpu_ctx->lf_a)
+#define lf_b		(cpu_ctx->lf_b)
+extern void	lf_flags(void);
+#define LF_EVAL()	if (lf_op) lf_flags()	/* compute pending flags */
+#else
+#define LF_EVAL()
+#endif
 
 extern int	s_flag, l_flag, m_flag, x_flag, break_flag, i_flag, f_flag,
-		cpu_error, int_type, int_mode, cntl_c, cntl_bs,
-		parrity[], sb_next;
+		b_flag,
+		cntl_c, cntl_bs,
+		parrity[];
+
+extern BYTE	sz_flag[], szp_flag[], szhv_inc[], szhv_dec[],
+		add_flag[2][256][256], sub_flag[2][256][256];
 
 #ifdef Z80_UNDOC
 extern int	z_flag;
 #endif
 
-extern int	tmax;
+extern int	tmax, f_slice, f_catchup;
 extern int	busy_loop_cnt[];
 
 extern char	xfn[];
 
 #ifdef HISIZE
-extern struct	history	his[];
-extern int	h_next,	h_flag;
+extern int	h_on, h_nraw;
+extern long	h_size;
+extern struct history h_raw[];
+extern int	his_init(void), his_find(struct hfind *);
+extern void	his_clear(void), his_flush(void);
+extern void	his_start(struct hfind *);
+extern unsigned long long his_count(void);
+#endif
+
+#ifdef WANT_TRACE
+extern TLOCAL struct trace *tr_cur;
+extern struct trace tr_ring[];
+extern unsigned long long tr_head;
+extern int	tr_on;
+extern int	tr_open(char *);
+extern void	tr_close(void), tr_next(void), tr_sync(void);
+extern void	tr_io(int, BYTE, BYTE, unsigned);
+#endif
+
+#ifdef WANT_PROF
+extern int	p_on;
+extern unsigned long long p_cnt[], p_tim[];
 #endif
 
 #ifdef SBSIZE
-extern struct	softbreak soft[];
+extern struct	softbreak *soft;
+extern int	sb_max, sb_armed, sb_last;
+extern unsigned long long sb_map[];
+extern int	sb_hit(void);
+#endif
+
+#ifdef WANT_WATCH
+extern struct	watch *watch;
+extern int	wp_max, wp_armed, wp_last, wp_how;
+extern WORD	wp_adr;
+extern BYTE	wp_data, wp_page[];
+extern TLOCAL int wp_run;
+extern int	wp_set(int, char *);
+extern void	wp_clear(int), wp_check(WORD, BYTE, int);
+extern void	wp_read(WORD, unsigned);
+extern void	wp_move(WORD, WORD, unsigned), wp_fill(WORD, BYTE, unsigned);
+#endif
+
+#ifdef WANT_SNAP
+extern BYTE	sn_dirty[];
+extern int	sn_period;
+extern int	sn_save(char *), sn_load(char *), sn_close(void);
+extern int	sn_test(char *);
+extern void	sn_bank(int, int, int, int), sn_all(void), sn_poll(void);
+#endif
+
+#ifdef WANT_MMIO
+extern BYTE	mm_page[];
+extern int	mm_used;
+extern void	mm_ram(WORD, unsigned), mm_rom(WORD, unsigned);
+extern void	mm_io(WORD, unsigned, BYTE (*)(WORD), int (*)(WORD, BYTE));
+extern BYTE	mm_read(WORD);
+extern int	mm_write(WORD, BYTE);
+extern void	mm_init(struct cpu_context *);
 #endif
 
 #ifdef WANT_TIM
-extern long	t_states;
-extern int	t_flag;
+extern TLOCAL long t_states;
+extern TLOCAL int t_flag;
 extern BYTE	*t_start, *t_end;
 #endif
 
@@ -0,0 +1,394 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * History:
+ * 28-SEP-87 Development on TARGON/35 with AT&T Unix System V.3
+ * 11-JAN-89 Release 1.1
+ * 08-FEB-89 Release 1.2
+ * 13-MAR-89 Release 1.3
+ * 09-FEB-90 Release 1.4  Ported to TARGON/31 M10/30
+ * 20-DEC-90 Release 1.5  Ported to COHERENT 3.0
+ * 10-JUN-92 Release 1.6  long casting problem solved with COHERENT 3.2
+ *			  and some optimization
+ * 25-JUN-92 Release 1.7  comments in english and ported to COHERENT 4.0
+ * 02-OCT-06 Release 1.8  modified to compile on modern POSIX OS's
+ * 18-NOV-06 Release 1.9  modified to work with CP/M sources
+ * 08-DEC-06 Release 1.10 modified MMU for working with CP/NET
+ * 17-DEC-06 Release 1.11 TCP/IP sockets for CP/NET
+ * 25-DEC-06 Release 1.12 CPU speed option
+ * 19-FEB-07 Release 1.13 various improvements
+ * 06-OCT-07 Release 1.14 bug fixes and improvements
+ * 06-AUG-08 Release 1.15 many improvements and Windows support via Cygwin
+ * 25-AUG-08 Release 1.16 console status I/O loop detection and line discipline
+ * 20-OCT-08 Release 1.17 frontpanel integrated and Altair/IMSAI emulations
+ */
+/*
+ *	This modul contains the history memory of the CPU emulation:
+ *
+ *	his_init()	: allocate the history memory
+ *	his_clear()	: clear the history
+ *	his_flush()	: store the entries written by the CPU
+ *	his_count()	: number of entries in the history
+ *	his_start()	: start a search in the history
+ *	his_find()	: find the next entry matching the search
+ *
+ *	The CPU writes the entries uncompressed into h_raw[] before
+ *	every opcode and calls his_flush(), if it is full. The history
+ *	itself is a ring of blocks with H_BLOCK bytes, mapped on demand,
+ *	so that it can hold millions of entries. Every entry is stored
+ *	as difference to the one before it: a byte with a bit for every
+ *	register changed, the distance to the last address of execution
+ *	in one byte, if it fits, followed by the registers changed. The
+ *	first entry of a block holds everything, so that a block can be
+ *	decoded alone. For every block the 256 byte pages executed and
+ *	the range of the register contents are kept, so that a search
+ *	only decodes the blocks which can contain matching entries.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef HISIZE
+
+#define H_ALL		((1 << H_REGS) - 1) /* all registers stored */
+#define H_ABS		128		/* address stored in two bytes */
+#define H_MAXENT	(3 + 2 * H_REGS) /* max. size of an entry */
+
+struct hblock {				/* summary of a history block */
+	unsigned long long hb_first;	/* number of the first entry */
+	int	hb_len;			/* bytes used */
+	WORD	hb_min[H_REGS + 1];	/* range of the address and */
+	WORD	hb_max[H_REGS + 1];	/* the registers, like history */
+	BYTE	hb_page[32];		/* 256 byte pages executed */
+};
+
+struct history h_raw[H_RAW];		/* entries written by the CPU */
+int h_nraw;				/* number of entries in h_raw[] */
+
+static BYTE *h_buf;			/* memory for the blocks */
+static int h_nblk;			/* number of blocks */
+static struct hblock *h_blk;		/* summaries of the blocks */
+static int h_cur;			/* block written */
+static int h_wrap;			/* ring wrapped around */
+static unsigned long long h_cnt;	/* number of entries stored */
+static struct history h_prev;		/* last entry stored */
+
+static void his_next(void);
+
+/*
+ *	Allocate the memory for h_size entries of the history with
+ *	4 bytes per entry, the blocks are mapped by the OS when they
+ *	are written first
+ *
+ *	Output:	1 history available
+ *		0 no memory for the history
+ */
+int his_init(void)
+{
+	if (h_buf != NULL)
+		return(1);
+	h_nblk = (h_size * 4L + H_BLOCK - 1) / H_BLOCK + 1;
+	h_buf = mmap(NULL, (size_t) h_nblk * H_BLOCK, PROT_READ | PROT_WRITE,
+		     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (h_buf == MAP_FAILED) {
+		h_buf = NULL;
+		perror("history memory");
+		return(0);
+	}
+	if ((h_blk = calloc(h_nblk, sizeof(struct hblock))) == NULL) {
+		munmap(h_buf, (size_t) h_nblk * H_BLOCK);
+		h_buf = NULL;
+		puts("can't allocate memory for the history");
+		return(0);
+	}
+	h_cur = -1;
+	his_next();
+	return(1);
+}
+
+/*
+ *	Clear the history and give the memory used back to the OS
+ */
+void his_clear(void)
+{
+	h_nraw = 0;
+	if (h_buf == NULL)
+		return;
+	madvise(h_buf, (size_t) h_nblk * H_BLOCK, MADV_DONTNEED);
+	h_cur = -1;
+	h_wrap = 0;
+	h_cnt = 0;
+	his_next();
+}
+
+/*
+ *	Store register i of entry e at p, p is moved behind it,
+ *	if the register is marked as changed in m
+ */
+#define H_PUT(i)	(memcpy(p, &e->h_reg[i], 2), p += (m >> (i)) & 1 ? 2 : 0)
+
+/*
+ *	Store the entries in h_raw[] into the history. Which registers
+ *	changed can't be predicted by the host CPU, so an entry is
+ *	stored without branches: all registers are written and the
+ *	pointer is only moved behind the ones needed. With SSE2 the
+ *	registers changed and the range of the contents are computed
+ *	for the whole entry at once, the contents are compared as
+ *	signed numbers with the sign bit flipped.
+ */
+void his_flush(void)
+{
+	register BYTE *p, *b;
+	register struct history *e, *end;
+	register struct hblock *s;
+	register int m, d;
+#ifndef __SSE2__
+	register int i;
+#endif
+	WORD w;
+#ifdef __SSE2__
+	const __m128i bias = _mm_set1_epi16(-0x8000);
+	__m128i vn, vo, vmn, vmx;
+#else
+	struct history o;
+	WORD mn[H_REGS + 1], mx[H_REGS + 1];
+#endif
+
+	if (h_nraw == 0)
+		return;
+	s = &h_blk[h_cur];
+	b = h_buf + (long) h_cur * H_BLOCK;
+	p = b + s->hb_len;
+	end = h_raw + h_nraw;
+#ifdef __SSE2__
+	vo = _mm_loadu_si128((__m128i *) &h_prev);
+	vmn = _mm_xor_si128(_mm_loadu_si128((__m128i *) s->hb_min), bias);
+	vmx = _mm_xor_si128(_mm_loadu_si128((__m128i *) s->hb_max), bias);
+#else
+	o = h_prev;
+	memcpy(mn, s->hb_min, sizeof(mn));
+	memcpy(mx, s->hb_max, sizeof(mx));
+#endif
+	for (e = h_raw; e < end; e++) {
+		if (p > b + H_BLOCK - H_MAXENT) {	/* block full */
+			s->hb_len = p - b;
+#ifdef __SSE2__
+			_mm_storeu_si128((__m128i *) s->hb_min,
+					 _mm_xor_si128(vmn, bias));
+			_mm_storeu_si128((__m128i *) s->hb_max,
+					 _mm_xor_si128(vmx, bias));
+#else
+			memcpy(s->hb_min, mn, sizeof(mn));
+			memcpy(s->hb_max, mx, sizeof(mx));
+#endif
+			his_next();
+			s = &h_blk[h_cur];
+#ifdef __SSE2__
+			vmn = _mm_set1_epi16(0x7fff);
+			vmx = bias;
+#else
+			memcpy(mn, s->hb_min, sizeof(mn));
+			memcpy(mx, s->hb_max, sizeof(mx));
+#endif
+			b = p = h_buf + (long) h_cur * H_BLOCK;
+		}
+#ifdef __SSE2__
+		vn = _mm_loadu_si128((__m128i *) e);
+		m = (~_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpeq_epi16(vn, vo),
+			_mm_setzero_si128())) >> 1) & H_ALL;
+		d = (WORD) (e->h_adr - _mm_extract_epi16(vo, 0));
+		vmn = _mm_min_epi16(vmn, _mm_xor_si128(vn, bias));
+		vmx = _mm_max_epi16(vmx, _mm_xor_si128(vn, bias));
+		vo = vn;
+#else
+		d = (WORD) (e->h_adr - o.h_adr);
+		m = 0;
+		for (i = 0; i < H_REGS; i++) {
+			m |= (e->h_reg[i] != o.h_reg[i]) << i;
+			mn[i + 1] = (e->h_reg[i] < mn[i + 1]) ?
+				    e->h_reg[i] : mn[i + 1];
+			mx[i + 1] = (e->h_reg[i] > mx[i + 1]) ?
+				    e->h_reg[i] : mx[i + 1];
+		}
+		o = *e;
+#endif
+		if (d >= 0x8000)
+			d -= 0x10000;
+		m |= (d < -128 || d > 127) ? H_ABS : 0;
+		if (p == b)	/* first entry of a block holds all */
+			m = H_ALL | H_ABS;
+		w = (m & H_ABS) ? e->h_adr : (BYTE) d;
+		*p = m;
+		memcpy(p + 1, &w, 2);
+		p += (m & H_ABS) ? 3 : 2;
+		H_PUT(0); H_PUT(1); H_PUT(2); H_PUT(3);
+		H_PUT(4); H_PUT(5); H_PUT(6);
+		s->hb_page[e->h_adr >> 11] |= 1 << ((e->h_adr >> 8) & 7);
+	}
+	s->hb_len = p - b;
+#ifdef __SSE2__
+	_mm_storeu_si128((__m128i *) s->hb_min,
+			 _mm_xor_si128(vmn, bias));
+	_mm_storeu_si128((__m128i *) s->hb_max,
+			 _mm_xor_si128(vmx, bias));
+#else
+	memcpy(s->hb_min, mn, sizeof(mn));
+	memcpy(s->hb_max, mx, sizeof(mx));
+#endif
+	h_prev = h_raw[h_nraw - 1];
+	h_cnt += h_nraw;
+	h_nraw = 0;
+}
+
+/*
+ *	Number of entries in the history
+ */
+unsigned long long his_count(void)
+{
+	if (h_buf == NULL)
+		return(0);
+	his_flush();
+	return(h_cnt - h_blk[h_wrap ? (h_cur + 1) % h_nblk : 0].hb_first);
+}
+
+/*
+ *	Continue with the next block, which replaces the oldest one,
+ *	if the ring is wrapped around
+ */
+static void his_next(void)
+{
+	register struct hblock *s;
+	register int i;
+
+	if (++h_cur == h_nblk) {
+		h_cur = 0;
+		h_wrap = 1;
+	}
+	s = &h_blk[h_cur];
+	memset(s, 0, sizeof(struct hblock));
+	for (i = 0; i <= H_REGS; i++)
+		s->hb_min[i] = 0xffff;
+	s->hb_first = h_cnt;
+}
+
+/*
+ *	Decode the entry at position *pos of block b into e,
+ *	which must hold the entry before it
+ *
+ *	Output:	1 entry decoded, *pos is moved behind it
+ *		0 end of the block
+ */
+static int his_dec(int b, int *pos, struct history *e)
+{
+	register BYTE *p;
+	register int i, m;
+
+	if (*pos >= h_blk[b].hb_len)
+		return(0);
+	p = h_buf + (long) b * H_BLOCK + *pos;
+	m = *p++;
+	if (m & H_ABS) {
+		e->h_adr = *p + (*(p + 1) << 8);
+		p += 2;
+	} else
+		e->h_adr += (signed char) *p++;
+	for (i = 0; i < H_REGS; i++)
+		if (m & (1 << i)) {
+			e->h_reg[i] = *p + (*(p + 1) << 8);
+			p += 2;
+		}
+	*pos = p - (h_buf + (long) b * H_BLOCK);
+	return(1);
+}
+
+/*
+ *	Check if block b can contain entries matching the search f
+ */
+static int his_match(int b, struct hfind *f)
+{
+	register struct hblock *s = &h_blk[b];
+	register int i;
+
+	for (i = f->hf_lo >> 8; i <= f->hf_hi >> 8; i++)
+		if (s->hb_page[i >> 3] & (1 << (i & 7)))
+			break;
+	if (i > f->hf_hi >> 8)
+		return(0);
+	if (f->hf_reg < 0)
+		return(1);
+	switch (f->hf_op) {
+	case '<':
+		return(s->hb_min[f->hf_reg + 1] < f->hf_val);
+	case '>':
+		return(s->hb_max[f->hf_reg + 1] > f->hf_val);
+	default:
+		return(s->hb_min[f->hf_reg + 1] <= f->hf_val
+		       && s->hb_max[f->hf_reg + 1] >= f->hf_val);
+	}
+}
+
+/*
+ *	Start the search f at the oldest entry of the history,
+ *	the range of addresses and the register to test must
+ *	be set by the caller, they can be modified between the
+ *	calls of his_find()
+ */
+void his_start(struct hfind *f)
+{
+	his_flush();
+	f->hf_blk = -1;
+	f->hf_pos = 0;
+	f->hf_n = 0;
+}
+
+/*
+ *	Find the next entry matching the search f
+ *
+ *	Output:	1 entry found, stored in f->hf_e, its number
+ *		  in the history in f->hf_n
+ *		0 no more entries
+ */
+int his_find(struct hfind *f)
+{
+	register int r;
+
+	if (h_buf == NULL)
+		return(0);
+	for (;;) {
+		if (f->hf_blk < 0 || !his_dec(f->hf_blk, &f->hf_pos, &f->hf_e)) {
+			/* continue with the next block, which can match */
+			do {
+				if (f->hf_blk < 0)
+					f->hf_blk = h_wrap ? h_cur : -1;
+				else if (f->hf_blk == h_cur)
+					return(0);
+				f->hf_blk = (f->hf_blk + 1) % h_nblk;
+			} while (!his_match(f->hf_blk, f));
+			f->hf_pos = 0;
+			f->hf_n = h_blk[f->hf_blk].hb_first - h_blk[h_wrap ?
+				  (h_cur + 1) % h_nblk : 0].hb_first - 1;
+			continue;
+		}
+		f->hf_n++;
+		if (f->hf_e.h_adr < f->hf_lo || f->hf_e.h_adr > f->hf_hi)
+			continue;
+		if (f->hf_reg < 0)
+			return(1);
+		r = f->hf_e.h_reg[f->hf_reg];
+		if ((f->hf_op == '<' && r < f->hf_val)
+		    || (f->hf_op == '>' && r > f->hf_val)
+		    || (f->hf_op == '=' && r == f->hf_val))
+			return(1);
+	}
+}
+
+#endif
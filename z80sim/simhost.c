@@ -0,0 +1,310 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This modul contains the host mode of the simulator, which
+ * runs many independent machines in one process. Every machine
+ * has its own CPU context with registers, memory, console and
+ * time base. The machines are run in time slices by a pool of
+ * worker threads. Every worker has a deque of runnable machines,
+ * it runs the machines from the top of its own deque in turn,
+ * puts them back at the bottom after their time slice and
+ * steals from the bottom of the deques of the other workers,
+ * if its own deque is empty. The main thread ends the time slices
+ * of the running machines by stopping their CPU, the same way
+ * as cntl-c does it, so that the CPU emulation isn't slowed down.
+ * The run loops read the state with atomic loads for this.
+ * Host mode is available in z80sim only. Its machines get their
+ * console from host_io() in iosim.c. The I/O devices of cpmsim,
+ * imsaisim and altairsim (disks, consoles, sockets, MMU and the
+ * frontpanel) are still global variables of their iosim.c, they
+ * would have to move into cpu_ctx->io with a host_io() and
+ * host_io_close() of their own first, so their sim.h undefines
+ * WANT_HOST.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef WANT_HOST
+
+#define HOST_SLICE	10000000L	/* time slice of the machines in ns */
+
+struct worker {
+	pthread_t thread;
+	pthread_mutex_t lock;		/* lock for the deque */
+	struct cpu_context **q;		/* deque of runnable machines */
+	long top;			/* the worker takes at the top */
+	long bot;			/* and puts back at the bottom */
+	struct cpu_context *run;	/* machine running now */
+};
+
+static struct cpu_context **mach;	/* the machines */
+static struct worker *work;		/* the workers */
+static int nmach, nwork;
+static int ndone;			/* number of stopped machines */
+static int host_stop;			/* stop all machines */
+
+extern void cpu(void), cpu_err_msg(void);
+extern void *host_io(int);
+extern void host_io_close(void *);
+
+/*
+ *	Put machine m at the bottom of the deque of worker w
+ */
+static void push(struct worker *w, struct cpu_context *m)
+{
+	pthread_mutex_lock(&w->lock);
+	w->q[w->bot++ % nmach] = m;
+	pthread_mutex_unlock(&w->lock);
+}
+
+/*
+ *	Take the machine waiting longest from the top
+ *	of the deque of worker w
+ */
+static struct cpu_context *pop(struct worker *w)
+{
+	register struct cpu_context *m = NULL;
+
+	pthread_mutex_lock(&w->lock);
+	if (w->bot > w->top)
+		m = w->q[w->top++ % nmach];
+	pthread_mutex_unlock(&w->lock);
+	return(m);
+}
+
+/*
+ *	Steal a machine from the bottom of the deque of another worker
+ */
+static struct cpu_context *steal(struct worker *w)
+{
+	register struct worker *v;
+	register struct cpu_context *m = NULL;
+	register int i;
+
+	for (i = 1; i < nwork && m == NULL; i++) {
+		v = &work[(w - work + i) % nwork];
+		pthread_mutex_lock(&v->lock);
+		if (v->bot > v->top)
+			m = v->q[--v->bot % nmach];
+		pthread_mutex_unlock(&v->lock);
+	}
+	return(m);
+}
+
+/*
+ *	Worker thread, runs time slices of the machines
+ *	until all machines are stopped
+ */
+static void *worker(void *arg)
+{
+	register struct worker *w = arg;
+	register struct cpu_context *m;
+	struct timespec timer;
+
+	while (__atomic_load_n(&ndone, __ATOMIC_ACQUIRE) < nmach) {
+		if ((m = pop(w)) == NULL && (m = steal(w)) == NULL) {
+			timer.tv_sec = 0;
+			timer.tv_nsec = 1000000L;
+			nanosleep(&timer, NULL);
+			continue;
+		}
+		cpu_ctx = m;
+#ifdef WANT_MIRROR
+		mem_base = m->mem;
+#endif
+		if (!__atomic_load_n(&host_stop, __ATOMIC_ACQUIRE)) {
+			cpu_state = CONTIN_RUN;
+			__atomic_store_n(&w->run, m, __ATOMIC_RELEASE);
+			cpu();
+			__atomic_store_n(&w->run, NULL, __ATOMIC_RELEASE);
+			if (cpu_error == NONE
+			    && !__atomic_load_n(&host_stop, __ATOMIC_ACQUIRE)) {
+				push(w, m);	/* end of time slice */
+				continue;
+			}
+		}
+		if (cpu_error == NONE)
+			cpu_error = USERINT;
+		__atomic_add_fetch(&ndone, 1, __ATOMIC_ACQ_REL);
+	}
+	return(NULL);
+}
+
+/*
+ *	Free the machines and the workers,
+ *	also the partly created ones after an error
+ */
+static void host_free(void)
+{
+	register int i;
+
+	if (mach != NULL) {
+		for (i = 0; i < nmach; i++) {
+			if (mach[i] == NULL)
+				continue;
+			if (mach[i]->io != NULL)
+				host_io_close(mach[i]->io);
+#ifdef WANT_MIRROR
+			if (mach[i]->mem != NULL)
+				mem_unmap(mach[i]->mem);
+#endif
+			free(mach[i]);
+		}
+		free(mach);
+		mach = NULL;
+	}
+	if (work != NULL) {
+		for (i = 0; i < nwork; i++)
+			if (work[i].q != NULL) {
+				pthread_mutex_destroy(&work[i].lock);
+				free(work[i].q);
+			}
+		free(work);
+		work = NULL;
+	}
+}
+
+/*
+ *	Run n machines with the program loaded into cpu0
+ *	on a pool of w worker threads
+ */
+int host_run(int n, int w)
+{
+	register int i, nthr;
+	struct timespec timer, t1, t2;
+	sigset_t set, oset;
+	struct cpu_context *m;
+	double secs;
+	long long insts = 0;
+
+	nmach = n;
+	nwork = (w > 0) ? w : sysconf(_SC_NPROCESSORS_ONLN);
+	if (nwork < 1)
+		nwork = 1;
+	if (nwork > nmach)
+		nwork = nmach;
+	mach = calloc(nmach, sizeof(struct cpu_context *));
+	work = calloc(nwork, sizeof(struct worker));
+	if (mach == NULL || work == NULL) {
+		puts("can't allocate memory for the machines");
+		host_free();
+		return(1);
+	}
+	for (i = 0; i < nwork; i++) {
+		if ((work[i].q = calloc(nmach, sizeof(struct cpu_context *)))
+		    == NULL) {
+			puts("can't allocate memory for the workers");
+			host_free();
+			return(1);
+		}
+		pthread_mutex_init(&work[i].lock, NULL);
+	}
+
+	/* all machines start as a copy of cpu0 */
+	for (i = 0; i < nmach; i++) {
+		if (posix_memalign((void **) &m, MEM_ALIGN,
+				   sizeof(struct cpu_context)) != 0) {
+			printf("can't allocate memory for machine %d\n", i);
+			host_free();
+			return(1);
+		}
+		memcpy(m, &cpu0, sizeof(struct cpu_context));
+		m->io = NULL;
+		mach[i] = m;
+#ifdef WANT_MIRROR
+		if ((m->mem = mem_map()) == NULL) {
+			printf("can't map memory for machine %d\n", i);
+			host_free();
+			return(1);
+		}
+		memcpy(m->mem, cpu0.mem, 65536);
+#endif
+#ifdef WANT_MMIO
+		mm_init(m);
+#endif
+		m->pc = m->mem + (cpu0.pc - cpu0.mem);
+		m->sp = m->mem + (cpu0.sp - cpu0.mem);
+		m->state = CONTIN_RUN;
+		m->error = NONE;
+		m->r = 0L;
+		m->ops = 0;
+		if ((m->io = host_io(i)) == NULL) {
+			host_free();
+			return(1);
+		}
+	}
+	for (i = 0; i < nmach; i++)
+		push(&work[i % nwork], mach[i]);
+
+	printf("running %d machines on %d threads\n", nmach, nwork);
+	fflush(stdout);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	/* signals are handled by this thread only */
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGQUIT);
+	pthread_sigmask(SIG_BLOCK, &set, &oset);
+	for (nthr = 0; nthr < nwork; nthr++)
+		if (pthread_create(&work[nthr].thread, NULL, worker,
+				   &work[nthr])) {
+			/* the others steal the machines of the missing ones */
+			puts("can't create worker thread");
+			__atomic_store_n(&host_stop, 1, __ATOMIC_RELEASE);
+			break;
+		}
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+	if (nthr == 0) {
+		host_free();
+		return(1);
+	}
+
+	/* end the time slices of the running machines */
+	timer.tv_sec = 0;
+	timer.tv_nsec = HOST_SLICE;
+	while (__atomic_load_n(&ndone, __ATOMIC_ACQUIRE) < nmach) {
+		nanosleep(&timer, NULL);
+		if (cntl_c || cntl_bs || cpu0.error == USERINT)
+			__atomic_store_n(&host_stop, 1, __ATOMIC_RELEASE);
+		for (i = 0; i < nwork; i++)
+			if ((m = __atomic_load_n(&work[i].run,
+						 __ATOMIC_ACQUIRE)) != NULL)
+				__atomic_store_n(&m->state, STOPPED,
+						 __ATOMIC_RELAXED);
+	}
+	for (i = 0; i < nthr; i++)
+		pthread_join(work[i].thread, NULL);
+	clock_gettime(CLOCK_MONOTONIC, &t2);
+
+	/* report the state of the machines */
+	for (i = 0; i < nmach; i++) {
+		cpu_ctx = mach[i];
+#ifdef WANT_MIRROR
+		mem_base = cpu_ctx->mem;
+#endif
+		printf("machine %d: %llu instructions, ", i, cpu_ctx->ops);
+		cpu_err_msg();
+		insts += cpu_ctx->ops;
+	}
+	cpu_ctx = &cpu0;
+#ifdef WANT_MIRROR
+	mem_base = cpu0.mem;
+#endif
+	host_free();
+	secs = (t2.tv_sec - t1.tv_sec) + (t2.tv_nsec - t1.tv_nsec) / 1e9;
+	printf("%lld instructions in %.2f s = %.2f Mips\n", insts, secs,
+	       insts / secs / 1000000.0);
+	return(nthr < nwork);
+}
+
+#endif
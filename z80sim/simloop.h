@@ -0,0 +1,568 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * History:
+ * 28-SEP-87 Development on TARGON/35 with AT&T Unix System V.3
+ * 11-JAN-89 Release 1.1
+ * 08-FEB-89 Release 1.2
+ * 13-MAR-89 Release 1.3
+ * 09-FEB-90 Release 1.4  Ported to TARGON/31 M10/30
+ * 20-DEC-90 Release 1.5  Ported to COHERENT 3.0
+ * 10-JUN-92 Release 1.6  long casting problem solved with COHERENT 3.2
+ *			  and some optimization
+ * 25-JUN-92 Release 1.7  comments in english and ported to COHERENT 4.0
+ * 02-OCT-06 Release 1.8  modified to compile on modern POSIX OS's
+ * 18-NOV-06 Release 1.9  modified to work with CP/M sources
+ * 08-DEC-06 Release 1.10 modified MMU for working with CP/NET
+ * 17-DEC-06 Release 1.11 TCP/IP sockets for CP/NET
+ * 25-DEC-06 Release 1.12 CPU speed option
+ * 19-FEB-07 Release 1.13 various improvements
+ * 06-OCT-07 Release 1.14 bug fixes and improvements
+ * 06-AUG-08 Release 1.15 many improvements and Windows support via Cygwin
+ * 25-AUG-08 Release 1.16 console status I/O loop detection and line discipline
+ * 20-OCT-08 Release 1.17 frontpanel integrated and Altair/IMSAI emulations
+ */
+
+/*
+ *	Run loop of the CPU, this file is included into sim1.c
+ *	once for every combination of the debugging features, which
+ *	can be switched on and off at runtime. CPU_LOOP is the name
+ *	of the function to build and CPU_FEAT the features it
+ *	supports, all features not in CPU_FEAT cost nothing in it.
+ */
+static void CPU_LOOP(void)
+{
+#ifndef WANT_THREADED
+	do {
+		pre_op_f(CPU_FEAT);
+		post_op_f(CPU_FEAT, (*op_sim[*PC++]) ()); /* execute next opcode */
+	} while	(__atomic_load_n(&cpu_state, __ATOMIC_RELAXED) == CONTIN_RUN);
+#else
+	static void *op_sim_thr[256] = {
+		&&l_op_nop,			/* 0x00	*/
+		&&l_op_ldbcnn,			/* 0x01	*/
+		&&l_op_ldbca,			/* 0x02	*/
+		&&l_op_incbc,			/* 0x03	*/
+		&&l_op_incb,			/* 0x04	*/
+		&&l_op_decb,			/* 0x05	*/
+		&&l_op_ldbn,			/* 0x06	*/
+		&&l_op_rlca,			/* 0x07	*/
+		&&l_op_exafaf,			/* 0x08	*/
+		&&l_op_adhlbc,			/* 0x09	*/
+		&&l_op_ldabc,			/* 0x0a	*/
+		&&l_op_decbc,			/* 0x0b	*/
+		&&l_op_incc,			/* 0x0c	*/
+		&&l_op_decc,			/* 0x0d	*/
+		&&l_op_ldcn,			/* 0x0e	*/
+		&&l_op_rrca,			/* 0x0f	*/
+		&&l_op_djnz,			/* 0x10	*/
+		&&l_op_lddenn,			/* 0x11	*/
+		&&l_op_lddea,			/* 0x12	*/
+		&&l_op_incde,			/* 0x13	*/
+		&&l_op_incd,			/* 0x14	*/
+		&&l_op_decd,			/* 0x15	*/
+		&&l_op_lddn,			/* 0x16	*/
+		&&l_op_rla,			/* 0x17	*/
+		&&l_op_jr,			/* 0x18	*/
+		&&l_op_adhlde,			/* 0x19	*/
+		&&l_op_ldade,			/* 0x1a	*/
+		&&l_op_decde,			/* 0x1b	*/
+		&&l_op_ince,			/* 0x1c	*/
+		&&l_op_dece,			/* 0x1d	*/
+		&&l_op_lden,			/* 0x1e	*/
+		&&l_op_rra,			/* 0x1f	*/
+		&&l_op_jrnz,			/* 0x20	*/
+		&&l_op_ldhlnn,			/* 0x21	*/
+		&&l_op_ldinhl,			/* 0x22	*/
+		&&l_op_inchl,			/* 0x23	*/
+		&&l_op_inch,			/* 0x24	*/
+		&&l_op_dech,			/* 0x25	*/
+		&&l_op_ldhn,			/* 0x26	*/
+		&&l_op_daa,			/* 0x27	*/
+		&&l_op_jrz,			/* 0x28	*/
+		&&l_op_adhlhl,			/* 0x29	*/
+		&&l_op_ldhlin,			/* 0x2a	*/
+		&&l_op_dechl,			/* 0x2b	*/
+		&&l_op_incl,			/* 0x2c	*/
+		&&l_op_decl,			/* 0x2d	*/
+		&&l_op_ldln,			/* 0x2e	*/
+		&&l_op_cpl,			/* 0x2f	*/
+		&&l_op_jrnc,			/* 0x30	*/
+		&&l_op_ldspnn,			/* 0x31	*/
+		&&l_op_ldnna,			/* 0x32	*/
+		&&l_op_incsp,			/* 0x33	*/
+		&&l_op_incihl,			/* 0x34	*/
+		&&l_op_decihl,			/* 0x35	*/
+		&&l_op_ldhl1,			/* 0x36	*/
+		&&l_op_scf,			/* 0x37	*/
+		&&l_op_jrc,			/* 0x38	*/
+		&&l_op_adhlsp,			/* 0x39	*/
+		&&l_op_ldann,			/* 0x3a	*/
+		&&l_op_decsp,			/* 0x3b	*/
+		&&l_op_inca,			/* 0x3c	*/
+		&&l_op_deca,			/* 0x3d	*/
+		&&l_op_ldan,			/* 0x3e	*/
+		&&l_op_ccf,			/* 0x3f	*/
+		&&l_op_ldbb,			/* 0x40	*/
+		&&l_op_ldbc,			/* 0x41	*/
+		&&l_op_ldbd,			/* 0x42	*/
+		&&l_op_ldbe,			/* 0x43	*/
+		&&l_op_ldbh,			/* 0x44	*/
+		&&l_op_ldbl,			/* 0x45	*/
+		&&l_op_ldbhl,			/* 0x46	*/
+		&&l_op_ldba,			/* 0x47	*/
+		&&l_op_ldcb,			/* 0x48	*/
+		&&l_op_ldcc,			/* 0x49	*/
+		&&l_op_ldcd,			/* 0x4a	*/
+		&&l_op_ldce,			/* 0x4b	*/
+		&&l_op_ldch,			/* 0x4c	*/
+		&&l_op_ldcl,			/* 0x4d	*/
+		&&l_op_ldchl,			/* 0x4e	*/
+		&&l_op_ldca,			/* 0x4f	*/
+		&&l_op_lddb,			/* 0x50	*/
+		&&l_op_lddc,			/* 0x51	*/
+		&&l_op_lddd,			/* 0x52	*/
+		&&l_op_ldde,			/* 0x53	*/
+		&&l_op_lddh,			/* 0x54	*/
+		&&l_op_lddl,			/* 0x55	*/
+		&&l_op_lddhl,			/* 0x56	*/
+		&&l_op_ldda,			/* 0x57	*/
+		&&l_op_ldeb,			/* 0x58	*/
+		&&l_op_ldec,			/* 0x59	*/
+		&&l_op_lded,			/* 0x5a	*/
+		&&l_op_ldee,			/* 0x5b	*/
+		&&l_op_ldeh,			/* 0x5c	*/
+		&&l_op_ldel,			/* 0x5d	*/
+		&&l_op_ldehl,			/* 0x5e	*/
+		&&l_op_ldea,			/* 0x5f	*/
+		&&l_op_ldhb,			/* 0x60	*/
+		&&l_op_ldhc,			/* 0x61	*/
+		&&l_op_ldhd,			/* 0x62	*/
+		&&l_op_ldhe,			/* 0x63	*/
+		&&l_op_ldhh,			/* 0x64	*/
+		&&l_op_ldhl,			/* 0x65	*/
+		&&l_op_ldhhl,			/* 0x66	*/
+		&&l_op_ldha,			/* 0x67	*/
+		&&l_op_ldlb,			/* 0x68	*/
+		&&l_op_ldlc,			/* 0x69	*/
+		&&l_op_ldld,			/* 0x6a	*/
+		&&l_op_ldle,			/* 0x6b	*/
+		&&l_op_ldlh,			/* 0x6c	*/
+		&&l_op_ldll,			/* 0x6d	*/
+		&&l_op_ldlhl,			/* 0x6e	*/
+		&&l_op_ldla,			/* 0x6f	*/
+		&&l_op_ldhlb,			/* 0x70	*/
+		&&l_op_ldhlc,			/* 0x71	*/
+		&&l_op_ldhld,			/* 0x72	*/
+		&&l_op_ldhle,			/* 0x73	*/
+		&&l_op_ldhlh,			/* 0x74	*/
+		&&l_op_ldhll,			/* 0x75	*/
+		&&l_op_halt,			/* 0x76	*/
+		&&l_op_ldhla,			/* 0x77	*/
+		&&l_op_ldab,			/* 0x78	*/
+		&&l_op_ldac,			/* 0x79	*/
+		&&l_op_ldad,			/* 0x7a	*/
+		&&l_op_ldae,			/* 0x7b	*/
+		&&l_op_ldah,			/* 0x7c	*/
+		&&l_op_ldal,			/* 0x7d	*/
+		&&l_op_ldahl,			/* 0x7e	*/
+		&&l_op_ldaa,			/* 0x7f	*/
+		&&l_op_addb,			/* 0x80	*/
+		&&l_op_addc,			/* 0x81	*/
+		&&l_op_addd,			/* 0x82	*/
+		&&l_op_adde,			/* 0x83	*/
+		&&l_op_addh,			/* 0x84	*/
+		&&l_op_addl,			/* 0x85	*/
+		&&l_op_addhl,			/* 0x86	*/
+		&&l_op_adda,			/* 0x87	*/
+		&&l_op_adcb,			/* 0x88	*/
+		&&l_op_adcc,			/* 0x89	*/
+		&&l_op_adcd,			/* 0x8a	*/
+		&&l_op_adce,			/* 0x8b	*/
+		&&l_op_adch,			/* 0x8c	*/
+		&&l_op_adcl,			/* 0x8d	*/
+		&&l_op_adchl,			/* 0x8e	*/
+		&&l_op_adca,			/* 0x8f	*/
+		&&l_op_subb,			/* 0x90	*/
+		&&l_op_subc,			/* 0x91	*/
+		&&l_op_subd,			/* 0x92	*/
+		&&l_op_sube,			/* 0x93	*/
+		&&l_op_subh,			/* 0x94	*/
+		&&l_op_subl,			/* 0x95	*/
+		&&l_op_subhl,			/* 0x96	*/
+		&&l_op_suba,			/* 0x97	*/
+		&&l_op_sbcb,			/* 0x98	*/
+		&&l_op_sbcc,			/* 0x99	*/
+		&&l_op_sbcd,			/* 0x9a	*/
+		&&l_op_sbce,			/* 0x9b	*/
+		&&l_op_sbch,			/* 0x9c	*/
+		&&l_op_sbcl,			/* 0x9d	*/
+		&&l_op_sbchl,			/* 0x9e	*/
+		&&l_op_sbca,			/* 0x9f	*/
+		&&l_op_andb,			/* 0xa0	*/
+		&&l_op_andc,			/* 0xa1	*/
+		&&l_op_andd,			/* 0xa2	*/
+		&&l_op_ande,			/* 0xa3	*/
+		&&l_op_andh,			/* 0xa4	*/
+		&&l_op_andl,			/* 0xa5	*/
+		&&l_op_andhl,			/* 0xa6	*/
+		&&l_op_anda,			/* 0xa7	*/
+		&&l_op_xorb,			/* 0xa8	*/
+		&&l_op_xorc,			/* 0xa9	*/
+		&&l_op_xord,			/* 0xaa	*/
+		&&l_op_xore,			/* 0xab	*/
+		&&l_op_xorh,			/* 0xac	*/
+		&&l_op_xorl,			/* 0xad	*/
+		&&l_op_xorhl,			/* 0xae	*/
+		&&l_op_xora,			/* 0xaf	*/
+		&&l_op_orb,			/* 0xb0	*/
+		&&l_op_orc,			/* 0xb1	*/
+		&&l_op_ord,			/* 0xb2	*/
+		&&l_op_ore,			/* 0xb3	*/
+		&&l_op_orh,			/* 0xb4	*/
+		&&l_op_orl,			/* 0xb5	*/
+		&&l_op_orhl,			/* 0xb6	*/
+		&&l_op_ora,			/* 0xb7	*/
+		&&l_op_cpb,			/* 0xb8	*/
+		&&l_op_cpc,			/* 0xb9	*/
+		&&l_op_cpd,			/* 0xba	*/
+		&&l_op_cpe,			/* 0xbb	*/
+		&&l_op_cph,			/* 0xbc	*/
+		&&l_op_cplr,			/* 0xbd	*/
+		&&l_op_cphl,			/* 0xbe	*/
+		&&l_op_cpa,			/* 0xbf	*/
+		&&l_op_retnz,			/* 0xc0	*/
+		&&l_op_popbc,			/* 0xc1	*/
+		&&l_op_jpnz,			/* 0xc2	*/
+		&&l_op_jp,			/* 0xc3	*/
+		&&l_op_calnz,			/* 0xc4	*/
+		&&l_op_pushbc,			/* 0xc5	*/
+		&&l_op_addn,			/* 0xc6	*/
+		&&l_op_rst00,			/* 0xc7	*/
+		&&l_op_retz,			/* 0xc8	*/
+		&&l_op_ret,			/* 0xc9	*/
+		&&l_op_jpz,			/* 0xca	*/
+		&&l_op_cb_handel,		/* 0xcb	*/
+		&&l_op_calz,			/* 0xcc	*/
+		&&l_op_call,			/* 0xcd	*/
+		&&l_op_adcn,			/* 0xce	*/
+		&&l_op_rst08,			/* 0xcf	*/
+		&&l_op_retnc,			/* 0xd0	*/
+		&&l_op_popde,			/* 0xd1	*/
+		&&l_op_jpnc,			/* 0xd2	*/
+		&&l_op_out,			/* 0xd3	*/
+		&&l_op_calnc,			/* 0xd4	*/
+		&&l_op_pushde,			/* 0xd5	*/
+		&&l_op_subn,			/* 0xd6	*/
+		&&l_op_rst10,			/* 0xd7	*/
+		&&l_op_retc,			/* 0xd8	*/
+		&&l_op_exx,			/* 0xd9	*/
+		&&l_op_jpc,			/* 0xda	*/
+		&&l_op_in,			/* 0xdb	*/
+		&&l_op_calc,			/* 0xdc	*/
+		&&l_op_dd_handel,		/* 0xdd	*/
+		&&l_op_sbcn,			/* 0xde	*/
+		&&l_op_rst18,			/* 0xdf	*/
+		&&l_op_retpo,			/* 0xe0	*/
+		&&l_op_pophl,			/* 0xe1	*/
+		&&l_op_jppo,			/* 0xe2	*/
+		&&l_op_exsphl,			/* 0xe3	*/
+		&&l_op_calpo,			/* 0xe4	*/
+		&&l_op_pushhl,			/* 0xe5	*/
+		&&l_op_andn,			/* 0xe6	*/
+		&&l_op_rst20,			/* 0xe7	*/
+		&&l_op_retpe,			/* 0xe8	*/
+		&&l_op_jphl,			/* 0xe9	*/
+		&&l_op_jppe,			/* 0xea	*/
+		&&l_op_exdehl,			/* 0xeb	*/
+		&&l_op_calpe,			/* 0xec	*/
+		&&l_op_ed_handel,		/* 0xed	*/
+		&&l_op_xorn,			/* 0xee	*/
+		&&l_op_rst28,			/* 0xef	*/
+		&&l_op_retp,			/* 0xf0	*/
+		&&l_op_popaf,			/* 0xf1	*/
+		&&l_op_jpp,			/* 0xf2	*/
+		&&l_op_di,			/* 0xf3	*/
+		&&l_op_calp,			/* 0xf4	*/
+		&&l_op_pushaf,			/* 0xf5	*/
+		&&l_op_orn,			/* 0xf6	*/
+		&&l_op_rst30,			/* 0xf7	*/
+		&&l_op_retm,			/* 0xf8	*/
+		&&l_op_ldsphl,			/* 0xf9	*/
+		&&l_op_jpm,			/* 0xfa	*/
+		&&l_op_ei,			/* 0xfb	*/
+		&&l_op_calm,			/* 0xfc	*/
+		&&l_op_fd_handel,		/* 0xfd	*/
+		&&l_op_cpn,			/* 0xfe	*/
+		&&l_op_rst38			/* 0xff	*/
+	};
+
+	pre_op_f(CPU_FEAT);
+	goto *op_sim_thr[*PC++];		/* execute first opcode */
+
+	OP_THR(op_nop);
+	OP_THR(op_ldbcnn);
+	OP_THR(op_ldbca);
+	OP_THR(op_incbc);
+	OP_THR(op_incb);
+	OP_THR(op_decb);
+	OP_THR(op_ldbn);
+	OP_THR(op_rlca);
+	OP_THR(op_exafaf);
+	OP_THR(op_adhlbc);
+	OP_THR(op_ldabc);
+	OP_THR(op_decbc);
+	OP_THR(op_incc);
+	OP_THR(op_decc);
+	OP_THR(op_ldcn);
+	OP_THR(op_rrca);
+	OP_THR(op_djnz);
+	OP_THR(op_lddenn);
+	OP_THR(op_lddea);
+	OP_THR(op_incde);
+	OP_THR(op_incd);
+	OP_THR(op_decd);
+	OP_THR(op_lddn);
+	OP_THR(op_rla);
+	OP_THR(op_jr);
+	OP_THR(op_adhlde);
+	OP_THR(op_ldade);
+	OP_THR(op_decde);
+	OP_THR(op_ince);
+	OP_THR(op_dece);
+	OP_THR(op_lden);
+	OP_THR(op_rra);
+	OP_THR(op_jrnz);
+	OP_THR(op_ldhlnn);
+	OP_THR(op_ldinhl);
+	OP_THR(op_inchl);
+	OP_THR(op_inch);
+	OP_THR(op_dech);
+	OP_THR(op_ldhn);
+	OP_THR(op_daa);
+	OP_THR(op_jrz);
+	OP_THR(op_adhlhl);
+	OP_THR(op_ldhlin);
+	OP_THR(op_dechl);
+	OP_THR(op_incl);
+	OP_THR(op_decl);
+	OP_THR(op_ldln);
+	OP_THR(op_cpl);
+	OP_THR(op_jrnc);
+	OP_THR(op_ldspnn);
+	OP_THR(op_ldnna);
+	OP_THR(op_incsp);
+	OP_THR(op_incihl);
+	OP_THR(op_decihl);
+	OP_THR(op_ldhl1);
+	OP_THR(op_scf);
+	OP_THR(op_jrc);
+	OP_THR(op_adhlsp);
+	OP_THR(op_ldann);
+	OP_THR(op_decsp);
+	OP_THR(op_inca);
+	OP_THR(op_deca);
+	OP_THR(op_ldan);
+	OP_THR(op_ccf);
+	OP_THR(op_ldbb);
+	OP_THR(op_ldbc);
+	OP_THR(op_ldbd);
+	OP_THR(op_ldbe);
+	OP_THR(op_ldbh);
+	OP_THR(op_ldbl);
+	OP_THR(op_ldbhl);
+	OP_THR(op_ldba);
+	OP_THR(op_ldcb);
+	OP_THR(op_ldcc);
+	OP_THR(op_ldcd);
+	OP_THR(op_ldce);
+	OP_THR(op_ldch);
+	OP_THR(op_ldcl);
+	OP_THR(op_ldchl);
+	OP_THR(op_ldca);
+	OP_THR(op_lddb);
+	OP_THR(op_lddc);
+	OP_THR(op_lddd);
+	OP_THR(op_ldde);
+	OP_THR(op_lddh);
+	OP_THR(op_lddl);
+	OP_THR(op_lddhl);
+	OP_THR(op_ldda);
+	OP_THR(op_ldeb);
+	OP_THR(op_ldec);
+	OP_THR(op_lded);
+	OP_THR(op_ldee);
+	OP_THR(op_ldeh);
+	OP_THR(op_ldel);
+	OP_THR(op_ldehl);
+	OP_THR(op_ldea);
+	OP_THR(op_ldhb);
+	OP_THR(op_ldhc);
+	OP_THR(op_ldhd);
+	OP_THR(op_ldhe);
+	OP_THR(op_ldhh);
+	OP_THR(op_ldhl);
+	OP_THR(op_ldhhl);
+	OP_THR(op_ldha);
+	OP_THR(op_ldlb);
+	OP_THR(op_ldlc);
+	OP_THR(op_ldld);
+	OP_THR(op_ldle);
+	OP_THR(op_ldlh);
+	OP_THR(op_ldll);
+	OP_THR(op_ldlhl);
+	OP_THR(op_ldla);
+	OP_THR(op_ldhlb);
+	OP_THR(op_ldhlc);
+	OP_THR(op_ldhld);
+	OP_THR(op_ldhle);
+	OP_THR(op_ldhlh);
+	OP_THR(op_ldhll);
+	OP_THR(op_halt);
+	OP_THR(op_ldhla);
+	OP_THR(op_ldab);
+	OP_THR(op_ldac);
+	OP_THR(op_ldad);
+	OP_THR(op_ldae);
+	OP_THR(op_ldah);
+	OP_THR(op_ldal);
+	OP_THR(op_ldahl);
+	OP_THR(op_ldaa);
+	OP_THR(op_addb);
+	OP_THR(op_addc);
+	OP_THR(op_addd);
+	OP_THR(op_adde);
+	OP_THR(op_addh);
+	OP_THR(op_addl);
+	OP_THR(op_addhl);
+	OP_THR(op_adda);
+	OP_THR(op_adcb);
+	OP_THR(op_adcc);
+	OP_THR(op_adcd);
+	OP_THR(op_adce);
+	OP_THR(op_adch);
+	OP_THR(op_adcl);
+	OP_THR(op_adchl);
+	OP_THR(op_adca);
+	OP_THR(op_subb);
+	OP_THR(op_subc);
+	OP_THR(op_subd);
+	OP_THR(op_sube);
+	OP_THR(op_subh);
+	OP_THR(op_subl);
+	OP_THR(op_subhl);
+	OP_THR(op_suba);
+	OP_THR(op_sbcb);
+	OP_THR(op_sbcc);
+	OP_THR(op_sbcd);
+	OP_THR(op_sbce);
+	OP_THR(op_sbch);
+	OP_THR(op_sbcl);
+	OP_THR(op_sbchl);
+	OP_THR(op_sbca);
+	OP_THR(op_andb);
+	OP_THR(op_andc);
+	OP_THR(op_andd);
+	OP_THR(op_ande);
+	OP_THR(op_andh);
+	OP_THR(op_andl);
+	OP_THR(op_andhl);
+	OP_THR(op_anda);
+	OP_THR(op_xorb);
+	OP_THR(op_xorc);
+	OP_THR(op_xord);
+	OP_THR(op_xore);
+	OP_THR(op_xorh);
+	OP_THR(op_xorl);
+	OP_THR(op_xorhl);
+	OP_THR(op_xora);
+	OP_THR(op_orb);
+	OP_THR(op_orc);
+	OP_THR(op_ord);
+	OP_THR(op_ore);
+	OP_THR(op_orh);
+	OP_THR(op_orl);
+	OP_THR(op_orhl);
+	OP_THR(op_ora);
+	OP_THR(op_cpb);
+	OP_THR(op_cpc);
+	OP_THR(op_cpd);
+	OP_THR(op_cpe);
+	OP_THR(op_cph);
+	OP_THR(op_cplr);
+	OP_THR(op_cphl);
+	OP_THR(op_cpa);
+	OP_THR(op_retnz);
+	OP_THR(op_popbc);
+	OP_THR(op_jpnz);
+	OP_THR(op_jp);
+	OP_THR(op_calnz);
+	OP_THR(op_pushbc);
+	OP_THR(op_addn);
+	OP_THR(op_rst00);
+	OP_THR(op_retz);
+	OP_THR(op_ret);
+	OP_THR(op_jpz);
+	OP_THR(op_cb_handel);
+	OP_THR(op_calz);
+	OP_THR(op_call);
+	OP_THR(op_adcn);
+	OP_THR(op_rst08);
+	OP_THR(op_retnc);
+	OP_THR(op_popde);
+	OP_THR(op_jpnc);
+	OP_THR(op_out);
+	OP_THR(op_calnc);
+	OP_THR(op_pushde);
+	OP_THR(op_subn);
+	OP_THR(op_rst10);
+	OP_THR(op_retc);
+	OP_THR(op_exx);
+	OP_THR(op_jpc);
+	OP_THR(op_in);
+	OP_THR(op_calc);
+	OP_THR(op_dd_handel);
+	OP_THR(op_sbcn);
+	OP_THR(op_rst18);
+	OP_THR(op_retpo);
+	OP_THR(op_pophl);
+	OP_THR(op_jppo);
+	OP_THR(op_exsphl);
+	OP_THR(op_calpo);
+	OP_THR(op_pushhl);
+	OP_THR(op_andn);
+	OP_THR(op_rst20);
+	OP_THR(op_retpe);
+	OP_THR(op_jphl);
+	OP_THR(op_jppe);
+	OP_THR(op_exdehl);
+	OP_THR(op_calpe);
+	OP_THR(op_ed_handel);
+	OP_THR(op_xorn);
+	OP_THR(op_rst28);
+	OP_THR(op_retp);
+	OP_THR(op_popaf);
+	OP_THR(op_jpp);
+	OP_THR(op_di);
+	OP_THR(op_calp);
+	OP_THR(op_pushaf);
+	OP_THR(op_orn);
+	OP_THR(op_rst30);
+	OP_THR(op_retm);
+	OP_THR(op_ldsphl);
+	OP_THR(op_jpm);
+	OP_THR(op_ei);
+	OP_THR(op_calm);
+	OP_THR(op_fd_handel);
+	OP_THR(op_cpn);
+	OP_THR(op_rst38);
+
+leave:
+	return;
+#endif
+}
+
+#undef CPU_LOOP
+#undef CPU_FEAT
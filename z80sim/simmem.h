@@ -0,0 +1,178 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This module contains the functions for writing into the
+ * memory of the simulated Z80. All opcodes storing data
+ * into the memory must use them, so that it is possible
+ * to find out which parts of the memory were modified.
+ * The opcodes read data from the memory with memrdr(),
+ * so that the reads can be watched too. With WANT_MMIO they
+ * access the memory through the page pointers of simmio.c.
+ */
+
+#include <string.h>
+
+#ifdef WANT_TRACE
+/*
+ *	Add n bytes written at address addr, the first one data,
+ *	to the trace record of the current opcode, if tracing
+ */
+static inline void tr_mem(WORD addr, BYTE data, unsigned n)
+{
+	register struct trace *t = tr_cur;
+
+	if (t == NULL)
+		return;
+	if (!(t->t_eff & TR_MEM)) {
+		t->t_eff |= TR_MEM;
+		t->t_madr = addr;
+		t->t_mval = data;
+	}
+	n += t->t_mcnt;
+	t->t_mcnt = (n > 65535) ? 65535 : n;
+}
+#endif
+
+/*
+ *	Read a byte from the Z80 memory at address addr
+ */
+static inline BYTE memrdr(WORD addr)
+{
+#ifdef WANT_MMIO
+	register BYTE *p = cpu_ctx->mm_rdp[addr >> 8];
+
+	if (__builtin_expect(p == cpu_ctx->mm_trap, 0))
+		return(mm_read(addr));
+	p += addr & 0xff;
+#else
+	register BYTE *p = ram + addr;
+#endif
+
+#ifdef WANT_WATCH
+	if (wp_page[addr >> 8] & WP_READ)
+		wp_check(addr, *p, WP_READ);
+#endif
+	return(*p);
+}
+
+/*
+ *	Write byte data into the Z80 memory at address addr
+ */
+static inline void memwrt(WORD addr, BYTE data)
+{
+#ifdef WANT_MMIO
+	register BYTE *p = cpu_ctx->mm_wrp[addr >> 8];
+#endif
+
+#ifdef WANT_WATCH
+	if (wp_page[addr >> 8] & WP_WRITE)
+		wp_check(addr, data, WP_WRITE);
+#endif
+#ifdef WANT_TRACE
+	tr_mem(addr, data, 1);
+#endif
+#ifdef WANT_MMIO
+	if (__builtin_expect(p == cpu_ctx->mm_trap, 0)) {
+		if (!mm_write(addr, data))
+			return;		/* taken by the device */
+		p = ram + (addr & 0xff00);
+	}
+#endif
+#ifdef WANT_SNAP
+	sn_dirty[addr >> 8] = 1;	/* page modified since the snapshot */
+#endif
+#ifdef WANT_MMIO
+	p[addr & 0xff] = data;
+#else
+	*(ram + addr) = data;
+#endif
+}
+
+#ifdef WANT_MMIO
+/*
+ *	Test if one of the pages of n bytes at address addr
+ *	has the attributes in mask
+ */
+static inline int mematt(WORD addr, unsigned n, int mask)
+{
+	register unsigned p;
+
+	for (p = addr >> 8; p < (addr + n + 255) >> 8; p++)
+		if (mm_page[p] & mask)
+			return(1);
+	return(0);
+}
+#endif
+
+#ifdef WANT_SNAP
+/*
+ *	Mark the pages of n bytes at address addr as modified
+ *	since the snapshot
+ */
+static inline void memdty(WORD addr, unsigned n)
+{
+	register unsigned p;
+
+	for (p = addr >> 8; p < (addr + n + 255) >> 8; p++)
+		sn_dirty[p] = 1;
+}
+#endif
+
+/*
+ *	Copy n bytes from address src to address dst, both areas
+ *	must not cross the end of the memory. Overlapping areas
+ *	are copied like memmove() does.
+ */
+static inline void memmov(WORD dst, WORD src, unsigned n)
+{
+#ifdef WANT_MMIO
+	if (mm_used && (mematt(dst, n, MM_WR) || mematt(src, n, MM_RD))) {
+		if (dst <= src)		/* a byte after the other */
+			for (; n > 0; n--)
+				memwrt(dst++, memrdr(src++));
+		else
+			for (dst += n, src += n; n > 0; n--)
+				memwrt(--dst, memrdr(--src));
+		return;
+	}
+#endif
+#ifdef WANT_WATCH
+	if (wp_armed)
+		wp_move(dst, src, n);
+#endif
+#ifdef WANT_SNAP
+	memdty(dst, n);
+#endif
+#ifdef WANT_TRACE
+	tr_mem(dst, *(ram + src), n);
+#endif
+	memmove(ram + dst, ram + src, n);
+}
+
+/*
+ *	Fill n bytes at address addr with data,
+ *	the area must not cross the end of the memory
+ */
+static inline void memfil(WORD addr, BYTE data, unsigned n)
+{
+#ifdef WANT_MMIO
+	if (mm_used && mematt(addr, n, MM_WR)) {
+		for (; n > 0; n--)
+			memwrt(addr++, data);
+		return;
+	}
+#endif
+#ifdef WANT_WATCH
+	if (wp_armed)
+		wp_fill(addr, data, n);
+#endif
+#ifdef WANT_SNAP
+	memdty(addr, n);
+#endif
+#ifdef WANT_TRACE
+	tr_mem(addr, data, n);
+#endif
+	memset(ram + addr, data, n);
+}
@@ -0,0 +1,145 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This modul contains the attributes of the memory pages:
+ *
+ *	mm_ram()	: pages are plain RAM
+ *	mm_rom()	: pages are ROM, writes are ignored
+ *	mm_io()		: pages are memory mapped I/O of a device
+ *	mm_read()	: read a byte from a memory mapped I/O page
+ *	mm_write()	: write a byte into a ROM or I/O page
+ *
+ *	mm_init()	: set the page pointers of a CPU context
+ *
+ * For every 256 byte page of the memory mm_page holds, if the
+ * reads (MM_RD) or writes (MM_WR) of the opcodes are diverted.
+ * From this the CPU context gets a pointer per page for reads
+ * and one for writes, which memrdr() and memwrt() in simmem.h
+ * access without a call: plain RAM points into ram[], ROM is
+ * read from ram[] and written into the sink page mm_sink, where
+ * the writes are lost. Only a page with a handler points to the
+ * trap page mm_trap, which memrdr() and memwrt() compare with
+ * the pointer loaded anyway, to call the handler. A read handler
+ * returns the byte read, a write handler returns 1 if the byte
+ * shall be stored into ram[] too, e.g. the video memory of a
+ * device, which only watches the writes.
+ *
+ * Diverted are the reads and writes of the data of the opcodes,
+ * including the stack and the block moves and fills. Not
+ * diverted are the fetches of the opcodes and their operands
+ * through PC, they read ram[]: code runs from ROM as from RAM,
+ * but it can't run from a page with a read handler. Neither are
+ * the bytes read and written by the monitor and by the DMA of
+ * the devices.
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef WANT_MMIO
+
+BYTE mm_page[256];			/* accesses diverted in the pages */
+int mm_used;				/* number of pages diverted */
+
+static BYTE (*mm_rdf[256])(WORD);	/* read handlers of the pages */
+static int (*mm_wrf[256])(WORD, BYTE);	/* write handlers of the pages */
+
+/*
+ *	Set the pointers of page p of CPU context c
+ */
+static void mm_ptr(struct cpu_context *c, int p)
+{
+	register BYTE *m = c->mem + (p << 8);
+
+	c->mm_rdp[p] = mm_rdf[p] ? c->mm_trap : m;
+	c->mm_wrp[p] = mm_wrf[p] ? c->mm_trap
+				 : (mm_page[p] & MM_WR) ? c->mm_sink : m;
+}
+
+/*
+ *	Set the attributes of the pages of n bytes at address adr
+ */
+static void mm_set(WORD adr, unsigned n, int attr, BYTE (*rd)(WORD),
+		   int (*wr)(WORD, BYTE))
+{
+	register unsigned p;
+
+	for (p = adr >> 8; p < (adr + n + 255) >> 8 && p < 256; p++) {
+		if (mm_page[p] && !attr)
+			mm_used--;
+		else if (!mm_page[p] && attr)
+			mm_used++;
+		mm_page[p] = attr;
+		mm_rdf[p] = rd;
+		mm_wrf[p] = wr;
+		mm_ptr(cpu_ctx, p);
+	}
+}
+
+/*
+ *	Set the page pointers of CPU context c from the attributes
+ *	of the pages, after the memory of the context is set up
+ */
+void mm_init(struct cpu_context *c)
+{
+	register int p;
+
+	for (p = 0; p < 256; p++)
+		mm_ptr(c, p);
+}
+
+/*
+ *	The pages of n bytes at address adr are plain RAM
+ */
+void mm_ram(WORD adr, unsigned n)
+{
+	mm_set(adr, n, 0, NULL, NULL);
+}
+
+/*
+ *	The pages of n bytes at address adr are ROM
+ */
+void mm_rom(WORD adr, unsigned n)
+{
+	mm_set(adr, n, MM_WR, NULL, NULL);
+}
+
+/*
+ *	The pages of n bytes at address adr are memory mapped I/O,
+ *	read by function rd and written by function wr of a device,
+ *	a NULL function accesses the RAM of the pages directly
+ */
+void mm_io(WORD adr, unsigned n, BYTE (*rd)(WORD), int (*wr)(WORD, BYTE))
+{
+	mm_set(adr, n, (rd ? MM_RD : 0) | (wr ? MM_WR : 0), rd, wr);
+}
+
+/*
+ *	Read a byte from address adr in a page with a read handler
+ */
+BYTE mm_read(WORD adr)
+{
+	register BYTE data;
+
+	data = (*mm_rdf[adr >> 8])(adr);
+#ifdef WANT_WATCH
+	if (wp_page[adr >> 8] & WP_READ)
+		wp_check(adr, data, WP_READ);
+#endif
+	return(data);
+}
+
+/*
+ *	Write byte data to address adr in a page with a write
+ *	handler, returns 1 if the byte has to be stored into
+ *	ram[] too
+ */
+int mm_write(WORD adr, BYTE data)
+{
+	return((*mm_wrf[adr >> 8])(adr, data));
+}
+
+#endif
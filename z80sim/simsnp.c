@@ -0,0 +1,544 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This modul contains the snapshots of the machine:
+ *
+ *	sn_save()	: write a snapshot, only the pages modified
+ *	sn_close()	: wait for the last snapshot and close the file
+ *	sn_load()	: restore the machine from a snapshot
+ *	sn_bank()	: pages of a memory bank are switched
+ *	sn_all()	: the whole memory was modified
+ *	sn_poll()	: event for the periodic snapshots
+ *
+ * A snapshot file holds a header with the state of the CPU and
+ * the devices, followed by the 64KB memory and the memory banks
+ * of the machine in 256 byte pages at fixed positions. The
+ * pages written since the last snapshot are marked in sn_dirty
+ * by the memory functions in simmem.h, so that a snapshot into
+ * the same file only writes the modified pages and the header.
+ * While the pages are written the header is marked invalid, so
+ * that an interrupted snapshot is not restored.
+ *
+ * The CPU only copies the modified pages and the header into a
+ * buffer, a writer thread writes them into the file, so that the
+ * CPU emulation isn't slowed down by the file system. The next
+ * snapshot waits until the writer is done with the last one.
+ *
+ * The devices of the machine save and restore their state with
+ * io_snap() into struct snapio, io_bank() returns the memory
+ * of a bank. The 64KB memory is stored as the CPU sees it, the
+ * banks follow it; io_snap() brings the banks up to date with the
+ * pages of the segment, sn_bank() moves the modified marks of the
+ * pages switched from the memory to the bank. The disk images
+ * aren't part of a snapshot.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef WANT_SNAP
+
+#define SN_MAGIC	"Z80SNP1\n"	/* start of a snapshot file */
+#define SN_VERSION	3		/* version of the format */
+#define SN_MEMOFF	4096		/* position of the memory in the file */
+#define SN_POLL		1000000		/* T-states between checks of the time */
+
+struct snap {				/* header of a snapshot file */
+	char	s_magic[8];		/* SN_MAGIC */
+	unsigned s_version;		/* SN_VERSION */
+	unsigned s_valid;		/* 0 while the snapshot is written */
+	unsigned long long s_seq;	/* number of the snapshot */
+	long long s_clock;		/* T-states executed, informative */
+	WORD	s_reg[12];		/* AF BC DE HL AF' BC' DE' HL' */
+					/* IX IY SP PC */
+	BYTE	s_i, s_r, s_iff, s_im;	/* I, R, IFF and interrupt mode */
+	int	s_inttype;		/* interrupt requested */
+	unsigned s_intreq, s_intack;	/* devices requesting, in service */
+	BYTE	s_intvec[INT_DEV];	/* vectors of the devices */
+	WORD	s_intadr[INT_DEV];	/* addresses of IM 0 CALLs */
+	struct snapio s_io;		/* state of the devices and banks */
+};
+
+struct sn_ext {				/* part of the file in sn_buf */
+	off_t	e_pos;			/* position in the file */
+	size_t	e_len;			/* number of bytes */
+};
+
+extern int io_snap(struct snapio *, int);
+extern BYTE *io_bank(int);
+
+BYTE sn_dirty[256];			/* pages written since the snapshot */
+int sn_period;				/* seconds between the snapshots */
+
+static BYTE sn_bdirty[SN_BANKS][256];	/* pages of the banks modified */
+static BYTE sn_shown[256];		/* pages switched since the snapshot */
+static struct snap sn_head;		/* header of the file */
+static int sn_fd = -1;			/* the snapshot file */
+static char *sn_fn;			/* and its name */
+static long long sn_last;		/* time of the last snapshot */
+
+static BYTE *sn_buf;			/* data to write for the writer */
+static size_t sn_blen, sn_bsize;	/* bytes used and allocated */
+static struct sn_ext *sn_ext;		/* where the data goes to */
+static int sn_next, sn_mext;		/* parts used and allocated */
+static int sn_busy;			/* sn_buf not written yet */
+static int sn_err;			/* write error of the writer */
+static int sn_done;			/* writer has to stop */
+static int sn_on;			/* writer started */
+static pthread_t sn_thread;
+static pthread_mutex_t sn_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sn_cond = PTHREAD_COND_INITIALIZER;
+
+/*
+ *	Wall clock time in s
+ */
+static long long sn_time(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return(t.tv_sec);
+}
+
+/*
+ *	Writer thread, writes the parts in sn_buf into the file
+ */
+static void *sn_writer(void *arg)
+{
+	register BYTE *p;
+	register int i, err;
+
+	pthread_mutex_lock(&sn_lock);
+	for (;;) {
+		while (!sn_busy && !sn_done)
+			pthread_cond_wait(&sn_cond, &sn_lock);
+		if (!sn_busy)
+			break;
+		pthread_mutex_unlock(&sn_lock);
+		err = 0;
+		for (i = 0, p = sn_buf; i < sn_next && !err;
+		     p += sn_ext[i++].e_len)
+			if (pwrite(sn_fd, p, sn_ext[i].e_len, sn_ext[i].e_pos)
+			    != sn_ext[i].e_len)
+				err = 1;
+		pthread_mutex_lock(&sn_lock);
+		sn_err |= err;
+		sn_busy = 0;
+		pthread_cond_broadcast(&sn_cond);
+	}
+	pthread_mutex_unlock(&sn_lock);
+	return(NULL);
+}
+
+/*
+ *	Wait until the writer wrote the last snapshot, on error
+ *	the file is closed, so that the next snapshot starts a
+ *	new one, returns 0 on error
+ */
+static int sn_wait(void)
+{
+	register int err;
+
+	pthread_mutex_lock(&sn_lock);
+	while (sn_busy)
+		pthread_cond_wait(&sn_cond, &sn_lock);
+	err = sn_err;
+	sn_err = 0;
+	pthread_mutex_unlock(&sn_lock);
+	if (err) {
+		printf("error writing snapshot into file %s\n", sn_fn);
+		close(sn_fd);
+		sn_fd = -1;
+	}
+	return(!err);
+}
+
+/*
+ *	Copy n bytes at p for position pos in the file into sn_buf,
+ *	returns 0 if there is no memory
+ */
+static int sn_add(void *p, size_t n, off_t pos)
+{
+	register void *q;
+	register size_t size;
+
+	if (sn_next == sn_mext) {
+		size = sn_mext ? 2 * sn_mext : 64;
+		if ((q = realloc(sn_ext, size * sizeof(struct sn_ext))) == NULL)
+			return(0);
+		sn_ext = q;
+		sn_mext = size;
+	}
+	if (sn_blen + n > sn_bsize) {
+		for (size = sn_bsize ? sn_bsize : 65536; size < sn_blen + n;
+		     size *= 2)
+			;
+		if ((q = realloc(sn_buf, size)) == NULL)
+			return(0);
+		sn_buf = q;
+		sn_bsize = size;
+	}
+	memcpy(sn_buf + sn_blen, p, n);
+	sn_blen += n;
+	sn_ext[sn_next].e_pos = pos;
+	sn_ext[sn_next++].e_len = n;
+	return(1);
+}
+
+/*
+ *	Copy the pages p to p + n - 1 at address a
+ *	with the pages marked in d for the file at pos
+ */
+static int sn_pages(BYTE *a, BYTE *d, int p, int n, off_t pos, int full)
+{
+	register int i, j;
+
+	for (i = p; i < p + n; i = j) {
+		if (!full && !d[i]) {
+			j = i + 1;
+			continue;
+		}
+		for (j = i + 1; j < p + n && (full || d[j]); j++)
+			;		/* copy consecutive pages at once */
+		if (!sn_add(a + (i << 8), (j - i) << 8, pos + ((i - p) << 8)))
+			return(0);
+	}
+	return(1);
+}
+
+/*
+ *	Start the writer thread, returns 0 on error
+ */
+static int sn_start(void)
+{
+	sigset_t set, oset;
+	register int ok;
+
+	/* signals are handled by the main thread only */
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGQUIT);
+	pthread_sigmask(SIG_BLOCK, &set, &oset);
+	sn_done = 0;
+	ok = !pthread_create(&sn_thread, NULL, sn_writer, NULL);
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+	return(sn_on = ok);
+}
+
+/*
+ *	Write a snapshot of the machine into file fn, only the pages
+ *	modified since the last snapshot, if it was written into
+ *	the same file. The writer thread writes it, the error of
+ *	the last snapshot is reported here. Returns 0 on error.
+ */
+int sn_save(char *fn)
+{
+	register struct snap *s = &sn_head;
+	register int b, seg;
+	register BYTE *p;
+	struct snapio io;
+	off_t pos;
+	int full = 0;
+
+	if (!sn_wait())
+		return(0);
+	if (!sn_on && !sn_start()) {
+		puts("can't start the snapshot writer");
+		return(0);
+	}
+	if (sn_fd == -1) {
+		if ((sn_fd = open(fn, O_RDWR | O_CREAT | O_TRUNC, 0600)) == -1) {
+			printf("can't create file %s\n", fn);
+			return(0);
+		}
+		sn_fn = fn;
+		full = 1;
+	}
+	sn_blen = 0;
+	sn_next = 0;
+	memset((char *) &io, 0, sizeof(io));
+	io_snap(&io, 0);
+	if (io.s_nbank > SN_BANKS)
+		io.s_nbank = SN_BANKS;
+	if (io.s_nbank != s->s_io.s_nbank
+	    || io.s_segsize != s->s_io.s_segsize)
+		full = 1;		/* position of the pages changed */
+	seg = io.s_nbank ? io.s_segsize >> 8 : 0;
+
+	if (!full) {			/* invalid until complete */
+		s->s_valid = 0;
+		if (!sn_add(&s->s_valid, sizeof(s->s_valid),
+			    offsetof(struct snap, s_valid)))
+			goto error;
+	}
+
+	/* the memory as seen by the CPU, then the banks */
+	for (b = 0; b < 256; b++)
+		sn_dirty[b] |= sn_shown[b];
+	if (!sn_pages(ram, sn_dirty, 0, 256, SN_MEMOFF, full))
+		goto error;
+	pos = SN_MEMOFF + 65536;
+	for (b = 0; b < io.s_nbank; b++, pos += seg << 8) {
+		p = io_bank(b);
+		if (p != NULL && !sn_pages(p, sn_bdirty[b], 0, seg, pos, full))
+			goto error;
+	}
+	memset((char *) sn_dirty, 0, sizeof(sn_dirty));
+	memset((char *) sn_shown, 0, sizeof(sn_shown));
+	memset((char *) sn_bdirty, 0, sizeof(sn_bdirty));
+
+	LF_EVAL();
+	memcpy(s->s_magic, SN_MAGIC, sizeof(s->s_magic));
+	s->s_version = SN_VERSION;
+	s->s_valid = 1;
+	s->s_seq++;
+	s->s_clock = ev_clock;
+	s->s_reg[0] = (A << 8) + F;
+	s->s_reg[1] = (B << 8) + C;
+	s->s_reg[2] = (D << 8) + E;
+	s->s_reg[3] = (H << 8) + L;
+	s->s_reg[4] = (A_ << 8) + F_;
+	s->s_reg[5] = (B_ << 8) + C_;
+	s->s_reg[6] = (D_ << 8) + E_;
+	s->s_reg[7] = (H_ << 8) + L_;
+	s->s_reg[8] = IX;
+	s->s_reg[9] = IY;
+	s->s_reg[10] = STACK - ram;
+	s->s_reg[11] = PC - ram;
+	s->s_i = I;
+	s->s_r = R;
+	s->s_iff = IFF;
+	s->s_im = int_mode;
+	s->s_inttype = int_type;
+	s->s_intreq = cpu_ctx->int_req;
+	s->s_intack = cpu_ctx->int_ack;
+	memcpy(s->s_intvec, cpu_ctx->int_vec, sizeof(s->s_intvec));
+	memcpy(s->s_intadr, cpu_ctx->int_adr, sizeof(s->s_intadr));
+	s->s_io = io;
+	if (!sn_add(s, sizeof(struct snap), 0))
+		goto error;
+
+	pthread_mutex_lock(&sn_lock);	/* let the writer write it */
+	sn_busy = 1;
+	pthread_cond_broadcast(&sn_cond);
+	pthread_mutex_unlock(&sn_lock);
+	return(1);
+
+error:
+	printf("no memory for the snapshot into file %s\n", fn);
+	close(sn_fd);
+	sn_fd = -1;			/* next time a new file */
+	return(0);
+}
+
+/*
+ *	Wait until the last snapshot is written, stop the
+ *	writer and close the file, returns 0 on error
+ */
+int sn_close(void)
+{
+	register int ok;
+
+	ok = sn_wait();
+	if (sn_on) {
+		pthread_mutex_lock(&sn_lock);
+		sn_done = 1;
+		pthread_cond_broadcast(&sn_cond);
+		pthread_mutex_unlock(&sn_lock);
+		pthread_join(sn_thread, NULL);
+		sn_on = 0;
+	}
+	if (sn_fd != -1) {
+		close(sn_fd);
+		sn_fd = -1;
+	}
+	free(sn_buf);
+	free(sn_ext);
+	sn_buf = NULL;
+	sn_ext = NULL;
+	sn_blen = sn_bsize = 0;
+	sn_next = sn_mext = 0;
+	return(ok);
+}
+
+/*
+ *	Restore the machine from the snapshot in file fn,
+ *	returns 0 on error
+ */
+int sn_load(char *fn)
+{
+	register struct snap *s = &sn_head;
+	register int b, seg;
+	register BYTE *p;
+	int fd;
+
+	sn_wait();			/* sn_fd is replaced below */
+	if ((fd = open(fn, O_RDWR)) == -1) {
+		printf("can't open file %s\n", fn);
+		return(0);
+	}
+	if (read(fd, (char *) s, sizeof(struct snap)) != sizeof(struct snap)
+	    || memcmp(s->s_magic, SN_MAGIC, sizeof(s->s_magic))
+	    || s->s_version != SN_VERSION) {
+		printf("%s is no snapshot file\n", fn);
+		goto error;
+	}
+	if (!s->s_valid || s->s_io.s_nbank > SN_BANKS) {
+		printf("snapshot in file %s is incomplete\n", fn);
+		goto error;
+	}
+	if (s->s_io.s_nbank < 0
+	    || (s->s_io.s_nbank > 0
+		&& (s->s_io.s_segsize <= 0 || s->s_io.s_segsize > 65536
+		    || (s->s_io.s_segsize & 0xff)
+		    || s->s_io.s_selbnk < 0
+		    || s->s_io.s_selbnk >= s->s_io.s_nbank))) {
+		printf("snapshot in file %s has invalid banks\n", fn);
+		goto error;
+	}
+
+	A = s->s_reg[0] >> 8;
+	F = s->s_reg[0] & 0xff;
+	B = s->s_reg[1] >> 8;
+	C = s->s_reg[1] & 0xff;
+	D = s->s_reg[2] >> 8;
+	E = s->s_reg[2] & 0xff;
+	H = s->s_reg[3] >> 8;
+	L = s->s_reg[3] & 0xff;
+	A_ = s->s_reg[4] >> 8;
+	F_ = s->s_reg[4] & 0xff;
+	B_ = s->s_reg[5] >> 8;
+	C_ = s->s_reg[5] & 0xff;
+	D_ = s->s_reg[6] >> 8;
+	E_ = s->s_reg[6] & 0xff;
+	H_ = s->s_reg[7] >> 8;
+	L_ = s->s_reg[7] & 0xff;
+	IX = s->s_reg[8];
+	IY = s->s_reg[9];
+	STACK = ram + s->s_reg[10];
+	PC = ram + s->s_reg[11];
+	I = s->s_i;
+	R = s->s_r;
+	IFF = s->s_iff;
+	int_mode = s->s_im;
+	int_type = s->s_inttype;
+	cpu_ctx->int_req = s->s_intreq;
+	cpu_ctx->int_ack = s->s_intack;
+	memcpy(cpu_ctx->int_vec, s->s_intvec, sizeof(s->s_intvec));
+	memcpy(cpu_ctx->int_adr, s->s_intadr, sizeof(s->s_intadr));
+#ifdef WANT_LAZYF
+	lf_op = 0;
+#endif
+
+	/* the devices allocate the banks */
+	if (!io_snap(&s->s_io, 1)) {
+		printf("snapshot in file %s doesn't fit the devices\n", fn);
+		goto error;
+	}
+	seg = s->s_io.s_nbank ? s->s_io.s_segsize >> 8 : 0;
+	for (b = 0; b < s->s_io.s_nbank; b++) {
+		p = io_bank(b);
+		if (p != NULL && pread(fd, (char *) p, seg << 8,
+				       SN_MEMOFF + 65536 + b * (seg << 8))
+				 != seg << 8)
+			goto short_file;
+	}
+	/* last, the pages shown in the memory may share the banks */
+	if (pread(fd, (char *) ram, 65536, SN_MEMOFF) != 65536)
+		goto short_file;
+
+	/* the file matches the memory, continue with it */
+	if (sn_fd != -1)
+		close(sn_fd);
+	sn_fd = fd;
+	sn_fn = fn;
+	memset((char *) sn_dirty, 0, sizeof(sn_dirty));
+	memset((char *) sn_shown, 0, sizeof(sn_shown));
+	memset((char *) sn_bdirty, 0, sizeof(sn_bdirty));
+	return(1);
+
+short_file:
+	printf("snapshot in file %s is truncated\n", fn);
+error:
+	close(fd);
+	return(0);
+}
+
+/*
+ *	Check if file fn starts with the magic of a snapshot,
+ *	the core files written without WANT_SNAP have none
+ */
+int sn_test(char *fn)
+{
+	char magic[sizeof(SN_MAGIC) - 1];
+	register int fd, ok;
+
+	if ((fd = open(fn, O_RDONLY)) == -1)
+		return(0);
+	ok = read(fd, magic, sizeof(magic)) == sizeof(magic)
+	     && !memcmp(magic, SN_MAGIC, sizeof(magic));
+	close(fd);
+	return(ok);
+}
+
+/*
+ *	Called by the MMU for the n pages from page p of the memory
+ *	that hold bank b: the pages modified belong to bank b. If
+ *	out is set bank b is switched out, the memory has to be
+ *	saved again with the pages switched in.
+ */
+void sn_bank(int b, int p, int n, int out)
+{
+	for (; n > 0 && p < 256; n--, p++) {
+		if (b >= 0 && b < SN_BANKS)
+			sn_bdirty[b][p] |= sn_dirty[p];
+		if (out) {
+			sn_dirty[p] = 0;
+			sn_shown[p] = 1;
+		}
+	}
+}
+
+/*
+ *	The whole memory was modified, e.g. loaded from a file
+ */
+void sn_all(void)
+{
+	memset((char *) sn_dirty, 1, sizeof(sn_dirty));
+}
+
+/*
+ *	Event scheduled by ev_init() every SN_POLL T-states:
+ *	write a snapshot into SN_FILE every sn_period seconds.
+ *	The event is called between two opcodes only, so that
+ *	the state of the CPU is complete. While the CPU is halted
+ *	ev_idle() cancels it and schedules it again on wake up.
+ */
+void sn_poll(void)
+{
+	register long long now;
+
+	now = sn_time();
+	if (sn_last == 0)
+		sn_last = now;
+	else if (now - sn_last >= sn_period) {
+		if (!sn_save(SN_FILE))
+			sn_period = 0;	/* don't try again */
+		sn_last = now;
+	}
+	if (sn_period)
+		ev_add(SN_POLL, sn_poll);
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This modul contains the execution trace of the CPU emulation:
+ *
+ *	tr_open()	: start tracing into a file
+ *	tr_close()	: write the rest of the trace and close the file
+ *	tr_next()	: publish a chunk of records, wait for room
+ *	tr_sync()	: publish all records, the CPU stops
+ *	tr_io()		: add an I/O operation to the current record
+ *
+ * The CPU writes a record with a fixed size for every opcode into
+ * a ring in memory, see struct trace in sim.h. The memory written
+ * and the I/O ports used by the opcode are added to the record by
+ * memwrt() and the I/O functions through tr_cur. Only every TR_CHUNK
+ * records the CPU synchronizes with a writer thread, which writes
+ * the records published into the file, so that the CPU emulation
+ * isn't slowed down by the file system. If the writer can't keep
+ * up, the CPU waits for it, no records get lost. The file starts
+ * with TR_MAGIC and can be decoded with z80trace.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <pthread.h>
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef WANT_TRACE
+
+struct trace tr_ring[TR_RING];		/* records written by the CPU */
+TLOCAL struct trace *tr_cur;		/* record of the current opcode */
+unsigned long long tr_head;		/* records written by the CPU */
+int tr_on;				/* trace file open */
+
+static unsigned long long tr_pub;	/* records published */
+static unsigned long long tr_tail;	/* records written into the file */
+static int tr_fd = -1;			/* the trace file */
+static int tr_err;			/* write error, writer stopped */
+static int tr_done;			/* writer has to stop */
+static pthread_t tr_thread;
+static pthread_mutex_t tr_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tr_data = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t tr_room = PTHREAD_COND_INITIALIZER;
+
+/*
+ *	Write n bytes at p into the trace file
+ */
+static int tr_write(char *p, size_t n)
+{
+	register ssize_t i;
+
+	while (n > 0) {
+		if ((i = write(tr_fd, p, n)) <= 0)
+			return(0);
+		p += i;
+		n -= i;
+	}
+	return(1);
+}
+
+/*
+ *	Writer thread, writes the records published into the file
+ */
+static void *tr_writer(void *arg)
+{
+	register unsigned long long pub;
+	register unsigned i, n;
+
+	pthread_mutex_lock(&tr_lock);
+	for (;;) {
+		while (tr_pub == tr_tail && !tr_done)
+			pthread_cond_wait(&tr_data, &tr_lock);
+		if (tr_pub == tr_tail)
+			break;
+		pub = tr_pub;
+		pthread_mutex_unlock(&tr_lock);
+		while (tr_tail != pub && !tr_err) {
+			i = tr_tail & (TR_RING - 1);
+			n = (pub - tr_tail < TR_RING - i) ? pub - tr_tail
+							 : TR_RING - i;
+			if (!tr_write((char *) &tr_ring[i],
+				      n * sizeof(struct trace)))
+				tr_err = 1;
+			pthread_mutex_lock(&tr_lock);
+			tr_tail += n;
+			pthread_cond_signal(&tr_room);
+			pthread_mutex_unlock(&tr_lock);
+		}
+		pthread_mutex_lock(&tr_lock);
+		if (tr_err) {		/* drop everything, CPU mustn't wait */
+			tr_tail = tr_pub;
+			pthread_cond_signal(&tr_room);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&tr_lock);
+	return(NULL);
+}
+
+/*
+ *	Start tracing into file fn,
+ *	returns 0 if the file can't be created
+ */
+int tr_open(char *fn)
+{
+	sigset_t set, oset;
+
+	if (tr_on)
+		tr_close();
+	if ((tr_fd = open(fn, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1)
+		return(0);
+	if (!tr_write(TR_MAGIC, sizeof(TR_MAGIC) - 1)) {
+		close(tr_fd);
+		tr_fd = -1;
+		return(0);
+	}
+	tr_head = tr_pub = tr_tail = 0;
+	tr_err = tr_done = 0;
+
+	/* signals are handled by the main thread only */
+	sigemptyset(&set);
+	sigaddset(&set, SIGINT);
+	sigaddset(&set, SIGQUIT);
+	pthread_sigmask(SIG_BLOCK, &set, &oset);
+	if (pthread_create(&tr_thread, NULL, tr_writer, NULL)) {
+		pthread_sigmask(SIG_SETMASK, &oset, NULL);
+		close(tr_fd);
+		tr_fd = -1;
+		return(0);
+	}
+	pthread_sigmask(SIG_SETMASK, &oset, NULL);
+	tr_on = 1;
+	return(1);
+}
+
+/*
+ *	Write the rest of the trace and close the file,
+ *	reports the number of records written
+ */
+void tr_close(void)
+{
+	if (!tr_on)
+		return;
+	pthread_mutex_lock(&tr_lock);
+	tr_pub = tr_head;
+	tr_done = 1;
+	pthread_cond_signal(&tr_data);
+	pthread_mutex_unlock(&tr_lock);
+	pthread_join(tr_thread, NULL);
+	close(tr_fd);
+	tr_fd = -1;
+	tr_on = 0;
+	if (tr_err)
+		puts("error writing trace file, trace incomplete");
+	printf("%llu records traced\n", tr_head);
+}
+
+/*
+ *	Called by the CPU before a new chunk of records is started:
+ *	publish the records written and wait until the writer made
+ *	room for the next chunk in the ring
+ */
+void tr_next(void)
+{
+	pthread_mutex_lock(&tr_lock);
+	tr_pub = tr_head;
+	pthread_cond_signal(&tr_data);
+	while (tr_head + TR_CHUNK - tr_tail > TR_RING && !tr_err)
+		pthread_cond_wait(&tr_room, &tr_lock);
+	pthread_mutex_unlock(&tr_lock);
+}
+
+/*
+ *	Called when the CPU stops: publish all records,
+ *	so that the file is complete while in the monitor
+ */
+void tr_sync(void)
+{
+	tr_cur = NULL;
+	pthread_mutex_lock(&tr_lock);
+	tr_pub = tr_head;
+	pthread_cond_signal(&tr_data);
+	pthread_mutex_unlock(&tr_lock);
+}
+
+/*
+ *	Add the I/O operation kind (TR_IN or TR_OUT) of n bytes
+ *	with port and the first byte data to the record of the
+ *	current opcode, the block I/O opcodes add up the count
+ */
+void tr_io(int kind, BYTE port, BYTE data, unsigned n)
+{
+	register struct trace *t = tr_cur;
+
+	if (!(t->t_eff & (TR_IN | TR_OUT))) {
+		t->t_eff |= kind;
+		t->t_port = port;
+		t->t_pval = data;
+		t->t_pcnt = 0;
+	}
+	n += t->t_pcnt;
+	t->t_pcnt = (n > 65535) ? 65535 : n;
+}
+
+#endif
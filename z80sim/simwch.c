@@ -0,0 +1,220 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This modul contains the watchpoints on the memory:
+ *
+ *	wp_set()	: set a watchpoint from its description
+ *	wp_clear()	: clear a watchpoint
+ *	wp_check()	: check a byte read or written by the CPU
+ *	wp_read()	: check bytes read in bulk
+ *	wp_move()	: check bytes copied in bulk
+ *	wp_fill()	: check bytes filled in bulk
+ *
+ * A watchpoint stops the CPU after the opcode, which reads
+ * or writes a byte in its range of addresses, optionally
+ * only if the byte has a given value. The opcodes read the
+ * memory with memrdr() and write it with the functions in
+ * simmem.h, which look up the page of the address in wp_page
+ * first. Only if a watchpoint covers the page wp_check() is
+ * called, so that accesses of pages not watched take the
+ * direct path into ram[].
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "sim.h"
+#include "simglb.h"
+
+#ifdef WANT_WATCH
+
+extern int exatoi(char *);
+
+struct watch *watch;			/* table of the watchpoints */
+int wp_max;				/* size of the table */
+int wp_armed;				/* number of watchpoints set */
+int wp_last;				/* number of the watchpoint hit */
+int wp_how;				/* and the access, WP_READ or WP_WRITE */
+WORD wp_adr;				/* address accessed */
+BYTE wp_data;				/* byte read or written */
+BYTE wp_page[256];			/* accesses watched in the pages */
+TLOCAL int wp_run;			/* CPU of the monitor is running */
+
+/*
+ *	Build the accesses watched in the pages of the memory
+ */
+static void wp_pages(void)
+{
+	register struct watch *w;
+	register int i, p;
+
+	memset((char *) wp_page, 0, sizeof(wp_page));
+	for (i = 0, w = watch; i < wp_max; i++, w++)
+		if (w->wp_kind)
+			for (p = w->wp_lo >> 8; p <= w->wp_hi >> 8; p++)
+				wp_page[p] |= w->wp_kind;
+}
+
+/*
+ *	Set watchpoint n, or the first free one if n < 0,
+ *	from the description in s:
+ *
+ *		address[,to] [r][w] [=value]
+ *
+ *	without r and w the writes are watched.
+ *	Returns the number of the watchpoint or -1 on error.
+ */
+int wp_set(int n, char *s)
+{
+	register struct watch *w;
+	register int i;
+	int lo, hi, kind = 0, val = -1;
+
+	while (isspace((int)*s))
+		s++;
+	if (!isxdigit((int)*s))
+		goto error;
+	lo = hi = exatoi(s);
+	while (isxdigit((int)*s))
+		s++;
+	if (*s == ',') {
+		s++;
+		if (!isxdigit((int)*s))
+			goto error;
+		hi = exatoi(s);
+		while (isxdigit((int)*s))
+			s++;
+	}
+	for (;; s++) {
+		while (isspace((int)*s))
+			s++;
+		if (*s == 'r')
+			kind |= WP_READ;
+		else if (*s == 'w')
+			kind |= WP_WRITE;
+		else
+			break;
+	}
+	if (*s == '=') {
+		s++;
+		if (!isxdigit((int)*s))
+			goto error;
+		val = exatoi(s) & 0xff;
+		while (isxdigit((int)*s))
+			s++;
+		while (isspace((int)*s))
+			s++;
+	}
+	if (*s != '\0' || lo > 0xffff || hi > 0xffff || hi < lo)
+		goto error;
+
+	if (n < 0)			/* first free entry */
+		for (n = 0; n < wp_max && watch[n].wp_kind; n++)
+			;
+	if (n > 65535) {
+		printf("watchpoint %d not available\n", n);
+		return(-1);
+	}
+	if (n >= wp_max) {		/* grow the table */
+		i = (n < 2 * wp_max) ? 2 * wp_max : n + 4;
+		if ((w = realloc(watch, i * sizeof(struct watch))) == NULL) {
+			puts("no memory for watchpoint");
+			return(-1);
+		}
+		memset((char *) &w[wp_max], 0,
+		       (i - wp_max) * sizeof(struct watch));
+		watch = w;
+		wp_max = i;
+	}
+	w = &watch[n];
+	if (!w->wp_kind)
+		wp_armed++;
+	w->wp_lo = lo;
+	w->wp_hi = hi;
+	w->wp_kind = kind ? kind : WP_WRITE;
+	w->wp_val = val;
+	wp_pages();
+	return(n);
+
+error:
+	puts("invalid watchpoint");
+	return(-1);
+}
+
+/*
+ *	Clear watchpoint n
+ */
+void wp_clear(int n)
+{
+	if (n >= wp_max || !watch[n].wp_kind)
+		return;
+	watch[n].wp_kind = 0;
+	wp_armed--;
+	wp_pages();
+}
+
+/*
+ *	Check byte data read (kind WP_READ) or written (kind WP_WRITE)
+ *	at address adr against the watchpoints. The first watchpoint
+ *	hit stops the CPU after the current opcode.
+ */
+void wp_check(WORD adr, BYTE data, int kind)
+{
+	register struct watch *w;
+	register int i;
+
+	if (!wp_run || cpu_error != NONE)
+		return;
+	for (i = 0, w = watch; i < wp_max; i++, w++)
+		if ((w->wp_kind & kind) && adr >= w->wp_lo
+		    && adr <= w->wp_hi
+		    && (w->wp_val < 0 || w->wp_val == data)) {
+			wp_last = i;
+			wp_how = kind;
+			wp_adr = adr;
+			wp_data = data;
+			cpu_error = WATCHPT;
+			cpu_state = STOPPED;
+			return;
+		}
+}
+
+/*
+ *	Check n bytes read in bulk at address adr,
+ *	the addresses wrap around at the end of the memory
+ */
+void wp_read(WORD adr, unsigned n)
+{
+	for (; n > 0; n--, adr++)
+		if (wp_page[adr >> 8] & WP_READ)
+			wp_check(adr, *(ram + adr), WP_READ);
+}
+
+/*
+ *	Check n bytes copied in bulk from address src to address dst,
+ *	must be called before the bytes are copied
+ */
+void wp_move(WORD dst, WORD src, unsigned n)
+{
+	for (; n > 0; n--, src++, dst++) {
+		if (wp_page[src >> 8] & WP_READ)
+			wp_check(src, *(ram + src), WP_READ);
+		if (wp_page[dst >> 8] & WP_WRITE)
+			wp_check(dst, *(ram + src), WP_WRITE);
+	}
+}
+
+/*
+ *	Check n bytes filled in bulk with data at address adr
+ */
+void wp_fill(WORD adr, BYTE data, unsigned n)
+{
+	for (; n > 0; n--, adr++)
+		if (wp_page[adr >> 8] & WP_WRITE)
+			wp_check(adr, data, WP_WRITE);
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Z80SIM  -  a	Z80-CPU	simulator
+ *
+ * Copyright (C) 1987-2008 by Udo Munk
+ *
+ * This program decodes the execution trace written by the
+ * simulator with option -t or the command "t f", see simtrc.c.
+ * For every record the T-states executed, the address of
+ * execution and the registers before the opcode are printed,
+ * followed by the memory written and the I/O port used by
+ * the opcode and the disassembled opcode itself.
+ *
+ *	z80trace file [first [count]]
+ *
+ * prints count records from record number first on.
+ */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#ifdef WANT_TRACE
+
+#define NREC	1024		/* records read at once */
+
+extern void disass(unsigned char **, int);
+
+int main(int argc, char *argv[])
+{
+	register FILE *fp;
+	register struct trace *t;
+	register int i, n;
+	static struct trace buf[NREC];
+	char magic[sizeof(TR_MAGIC) - 1];
+	unsigned long long clock, first = 0, count = ~0ULL;
+	unsigned last = 0;
+	int start = 1;
+	BYTE *p;
+
+	if (argc < 2 || argc > 4) {
+		printf("usage:\t%s file [first [count]]\n", argv[0]);
+		return(1);
+	}
+	if (argc > 2)
+		first = strtoull(argv[2], NULL, 0);
+	if (argc > 3)
+		count = strtoull(argv[3], NULL, 0);
+	if ((fp = fopen(argv[1], "r")) == NULL) {
+		printf("can't open file %s\n", argv[1]);
+		return(1);
+	}
+	if (fread(magic, sizeof(magic), 1, fp) != 1
+	    || memcmp(magic, TR_MAGIC, sizeof(magic))) {
+		printf("%s is no trace file\n", argv[1]);
+		return(1);
+	}
+	if (first > 0 && fseeko(fp, sizeof(magic) + first
+				* sizeof(struct trace), SEEK_SET)) {
+		printf("can't seek to record %llu\n", first);
+		return(1);
+	}
+
+	while (count > 0 && (n = fread(buf, sizeof(struct trace),
+				       NREC, fp)) > 0) {
+		for (i = 0, t = buf; i < n && count > 0; i++, t++, count--) {
+			if (start) {	/* 32 bit clock extended to 64 bits */
+				clock = t->t_clock;
+				start = 0;
+			} else
+				clock += (unsigned) (t->t_clock - last);
+			last = t->t_clock;
+			printf("%10llu %12llu %04x AF=%04x BC=%04x DE=%04x HL=%04x IX=%04x IY=%04x SP=%04x",
+			       first++, clock, t->t_pc,
+			       t->t_reg[0], t->t_reg[1], t->t_reg[2],
+			       t->t_reg[3], t->t_reg[4], t->t_reg[5],
+			       t->t_reg[6]);
+			if (t->t_eff & TR_MEM) {
+				printf(" M:%04x=%02x", t->t_madr, t->t_mval);
+				if (t->t_mcnt > 1)
+					printf("+%u", t->t_mcnt - 1);
+			}
+			if (t->t_eff & TR_IN)
+				printf(" I:%02x=%02x", t->t_port, t->t_pval);
+			if (t->t_eff & TR_OUT)
+				printf(" O:%02x=%02x", t->t_port, t->t_pval);
+			if ((t->t_eff & (TR_IN | TR_OUT)) && t->t_pcnt > 1)
+				printf("+%u", t->t_pcnt - 1);
+			printf("  ");
+			p = t->t_op;
+			disass(&p, t->t_pc);
+		}
+	}
+	fclose(fp);
+	return(0);
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+	puts("simulator built without WANT_TRACE");
+	return(1);
+}
+
+#endif